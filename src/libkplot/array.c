@@ -65,8 +65,11 @@ kdata_array_fill_ysizes (struct kdata *d, const size_t *v)
     for (i = 0; 0 != rc && i < d->pairsz; i++)
       rc = kdata_set (d, i, d->pairs[i].x, v[i]);
   else
-    for (i = 0; i < d->pairsz; i++)
-      d->pairs[i].y = v[i];
+    {
+      kdata_invalidate (d);
+      for (i = 0; i < d->pairsz; i++)
+        d->pairs[i].y = v[i];
+    }
 
   return(rc);
 }
@@ -84,8 +87,11 @@ kdata_array_fill_ydoubles (struct kdata *d, const double *v)
     for (i = 0; 0 != rc && i < d->pairsz; i++)
       rc = kdata_set (d, i, d->pairs[i].x, v[i]);
   else
-    for (i = 0; i < d->pairsz; i++)
-      d->pairs[i].y = v[i];
+    {
+      kdata_invalidate (d);
+      for (i = 0; i < d->pairsz; i++)
+        d->pairs[i].y = v[i];
+    }
 
   return(rc);
 }
@@ -109,8 +115,11 @@ kdata_array_fill (struct kdata *d, void *arg,
         rc = kdata_set (d, i, kp.x, kp.y);
       }
   else
-    for (i = 0; i < d->pairsz; i++)
-      (*fp)(i, &d->pairs[i], arg);
+    {
+      kdata_invalidate (d);
+      for (i = 0; i < d->pairsz; i++)
+        (*fp)(i, &d->pairs[i], arg);
+    }
 
   return(rc);
 }
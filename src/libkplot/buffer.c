@@ -52,6 +52,7 @@ kdata_buffer_copy (struct kdata *dst, const struct kdata *src)
   void    *p;
   size_t i;
   int rc = 1;
+  struct kpair kp;
 
   if (KDATA_BUFFER != dst->type)
     return(0);
@@ -73,12 +74,17 @@ kdata_buffer_copy (struct kdata *dst, const struct kdata *src)
       dst->pairs = p;
     }
   dst->pairsz = src->pairsz;
+  kdata_invalidate (dst);
 
   if (dst->depsz)
     for (i = 0; 0 != rc && i < dst->pairsz; i++)
-      rc = kdata_set (dst, i,
-                      src->pairs[i].x,
-                      src->pairs[i].y);
+      {
+        kdata_pair_get (src, i, &kp);
+        rc = kdata_set (dst, i, kp.x, kp.y);
+      }
+  else if (KDATA_COLUMN == src->type)
+    for (i = 0; i < dst->pairsz; i++)
+      kdata_pair_get (src, i, &dst->pairs[i]);
   else
     memcpy (dst->pairs, src->pairs,
             dst->pairsz * sizeof(struct kpair));
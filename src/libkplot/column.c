@@ -0,0 +1,81 @@
+/*      $Id$ */
+/*
+ * Copyright (c) 2015 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "compat.h"
+
+#include <assert.h>
+#include <cairo.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kplot.h"
+#include "extern.h"
+
+/*
+ * Reference "sz" pairs stored in caller-owned columns.
+ * The abscissae start at "x" and the ordinates at "y", each being
+ * "xstride" and "ystride" bytes apart (zero meaning tightly-packed
+ * doubles).
+ * Nothing is copied: the columns must stay valid and unmodified as
+ * long as the data source lives.
+ * Several sources may share the same "x" column, in which case each
+ * holds its own release callback, so the caller should reference-count
+ * the underlying storage.
+ * When the last reference goes away, "fp" (if not NULL) is invoked with
+ * "arg".
+ */
+struct kdata *
+kdata_column_alloc (const double *x, size_t xstride,
+                    const double *y, size_t ystride, size_t sz,
+                    void (*fp)(void *), void *arg)
+{
+  struct kdata    *d;
+
+  if (0 != sz && (NULL == x || NULL == y))
+    return(NULL);
+
+  if (NULL == (d = calloc (1, sizeof(struct kdata))))
+    return(NULL);
+
+  d->pairsz = sz;
+  d->d.column.x = (const char *)x;
+  d->d.column.xstride = 0 == xstride ? sizeof(double) : xstride;
+  d->d.column.y = (const char *)y;
+  d->d.column.ystride = 0 == ystride ? sizeof(double) : ystride;
+  d->d.column.free = fp;
+  d->d.column.arg = arg;
+
+  d->refs = 1;
+  d->type = KDATA_COLUMN;
+  return(d);
+}
+
+/*
+ * Like kdata_column_alloc(), but referencing a caller-owned array of
+ * interleaved pairs.
+ */
+struct kdata *
+kdata_column_alloc_pairs (const struct kpair *np, size_t npsz,
+                          void (*fp)(void *), void *arg)
+{
+  if (0 != npsz && NULL == np)
+    return(NULL);
+
+  return(kdata_column_alloc
+           (NULL == np ? NULL : &np->x, sizeof(struct kpair),
+           NULL == np ? NULL : &np->y, sizeof(struct kpair),
+           npsz, fp, arg));
+}
@@ -27,22 +27,6 @@
 #include "kplot.h"
 #include "extern.h"
 
-/*
- * Simple function to check that the double-precision values in the
- * kpair are valid: normal (or 0.0) values.
- */
-static inline int
-kpair_vrfy (const struct kpair *data)
-{
-  if (0.0 != data->x && !isnormal (data->x))
-    return(0);
-
-  if (0.0 != data->y && !isnormal (data->y))
-    return(0);
-
-  return(1);
-}
-
 /*
  * Set the pair "kp" to the value at position "pos", which depends upon
  * the smoothing type (if stipulated).
@@ -54,21 +38,29 @@ kpair_set (const struct kplotdat *d, size_t pos, struct kpair *kp)
 {
   size_t j, sz, samps;
   ssize_t start;
+  struct kpair pair;
 
   switch (d->smthtype)
     {
     case (KSMOOTH_CDF):
-      kp->x = d->datas[0]->pairs[pos].x;
-      kp->y += d->datas[0]->pairs[pos].y / d->sum;
+      kdata_pair_get (d->datas[0], pos, &pair);
+      kp->x = pair.x;
+      kp->y += pair.y / d->sum;
       break;
 
     case (KSMOOTH_PMF):
-      kp->x = d->datas[0]->pairs[pos].x;
-      kp->y = d->datas[0]->pairs[pos].y / d->sum;
+      kdata_pair_get (d->datas[0], pos, &pair);
+      kp->x = pair.x;
+      kp->y = pair.y / d->sum;
       break;
 
     case (KSMOOTH_MOVAVG):
-      *kp = d->datas[0]->pairs[pos];
+      if (NULL != d->smthpairs)
+        {
+          *kp = d->smthpairs[pos];
+          break;
+        }
+      kdata_pair_get (d->datas[0], pos, kp);
       samps = d->smth.movsamples / 2;
       start = pos - samps;
       sz = pos + samps;
@@ -76,17 +68,18 @@ kpair_set (const struct kplotdat *d, size_t pos, struct kpair *kp)
         break;
       for (kp->y = 0.0, j = start; j <= sz; j++)
         {
-          if (!kpair_vrfy (&d->datas[0]->pairs[j]))
+          kdata_pair_get (d->datas[0], j, &pair);
+          if (!kpair_vrfy (&pair))
             break;
-          kp->y += d->datas[0]->pairs[j].y;
+          kp->y += pair.y;
         }
       kp->y /= (double)d->smth.movsamples;
       if (j <= sz)
-        *kp = d->datas[0]->pairs[pos];
+        kdata_pair_get (d->datas[0], pos, kp);
       break;
 
     default:
-      *kp = d->datas[0]->pairs[pos];
+      kdata_pair_get (d->datas[0], pos, kp);
       break;
     }
 }
@@ -134,63 +127,162 @@ kdata_extrema_yerr (struct kplotdat *d, struct kplotctx *ctx)
     }
 }
 
+/*
+ * Compute the moving average of the first data source into the
+ * smoothing buffer in one pass, keeping a running sum of the window.
+ * Like kpair_set() would, pairs without a full window of valid pairs
+ * around them keep their own value.
+ * On allocation failure the buffer is NULL, and kpair_set() falls back
+ * to computing each window in full.
+ */
+static void
+kplotdat_movavg (struct kplotdat *d)
+{
+  const struct kdata *src = d->datas[0];
+  size_t i, samps, bad;
+  double sum;
+  struct kpair kp;
+  void            *p;
+
+  if (0 == src->pairsz)
+    return;
+
+  p = reallocarray (d->smthpairs,
+                    src->pairsz, sizeof(struct kpair));
+  if (NULL == p)
+    {
+      free (d->smthpairs);
+      d->smthpairs = NULL;
+      return;
+    }
+  d->smthpairs = p;
+
+  for (i = 0; i < src->pairsz; i++)
+    kdata_pair_get (src, i, &d->smthpairs[i]);
+
+  samps = d->smth.movsamples / 2;
+  if (2 * samps >= src->pairsz)
+    return;
+
+  /*
+   * Invalid pairs are counted rather than summed, so that a gap only
+   * affects the windows it's actually in.
+   */
+  for (sum = 0.0, bad = 0, i = 0; i < 2 * samps; i++)
+    {
+      kdata_pair_get (src, i, &kp);
+      if (kpair_vrfy (&kp))
+        sum += kp.y;
+      else
+        bad++;
+    }
+
+  for (i = samps; i + samps < src->pairsz; i++)
+    {
+      kdata_pair_get (src, i + samps, &kp);
+      if (kpair_vrfy (&kp))
+        sum += kp.y;
+      else
+        bad++;
+
+      if (0 == bad)
+        d->smthpairs[i].y = sum / (double)d->smth.movsamples;
+
+      kdata_pair_get (src, i - samps, &kp);
+      if (kpair_vrfy (&kp))
+        sum -= kp.y;
+      else
+        bad--;
+    }
+}
+
 /*
  * Accumulate extrema of a single data source.
+ * Smoothing doesn't change the abscissae, and the CDF and PMF only need
+ * the sum and maximum of the ordinates, so the data source summary
+ * covers all but the moving average.
  */
 static void
 kdata_extrema_single (struct kplotdat *d, struct kplotctx *ctx)
 {
+  const struct kdatastat *st;
   size_t i;
-  double max;
-  struct kpair kp;
+  double max, lo, hi;
+  struct kpair kp, pair;
 
+  st = kdata_stat_get (d->datas[0]);
   max = -DBL_MAX;
-  d->sum = 0.0;
-  memset (&kp, 0, sizeof(struct kpair));
-  for (i = 0; i < d->datas[0]->pairsz; i++)
-    {
-      if (!kpair_vrfy (&d->datas[0]->pairs[i]))
-        continue;
-      kpair_set (d, i, &kp);
-      if (KSMOOTH_CDF == d->smthtype)
-        d->sum += d->datas[0]->pairs[i].y;
-      if (KSMOOTH_PMF == d->smthtype)
-        {
-          d->sum += d->datas[0]->pairs[i].y;
-          if (d->datas[0]->pairs[i].y > max)
-            max = d->datas[0]->pairs[i].y;
-        }
-      if (kp.x < ctx->minv.x)
-        ctx->minv.x = kp.x;
-      if (kp.x > ctx->maxv.x)
-        ctx->maxv.x = kp.x;
-      switch (d->smthtype)
-        {
-        case (KSMOOTH_CDF):
-        case (KSMOOTH_PMF):
-          break;
+  d->sum = st->ysum;
 
-        default:
-          if (kp.y < ctx->minv.y)
-            ctx->minv.y = kp.y;
-          if (kp.y > ctx->maxv.y)
-            ctx->maxv.y = kp.y;
-          break;
-        }
+  if (st->ninval < d->datas[0]->pairsz)
+    {
+      if (st->min.x < ctx->minv.x)
+        ctx->minv.x = st->min.x;
+      if (st->max.x > ctx->maxv.x)
+        ctx->maxv.x = st->max.x;
+      max = st->max.y;
     }
-  if (KSMOOTH_CDF == d->smthtype)
+
+  switch (d->smthtype)
     {
+    case (KSMOOTH_CDF):
       if (0.0 < ctx->minv.y)
         ctx->minv.y = 0.0;
       if (1.0 > ctx->maxv.y)
         ctx->maxv.y = 1.0;
-    }
-  else if (KSMOOTH_PMF == d->smthtype)
-    {
+      break;
+
+    case (KSMOOTH_PMF):
       if (0.0 < ctx->minv.y)
         ctx->minv.y = 0.0;
       if (max / d->sum > ctx->maxv.y)
         ctx->maxv.y = max / d->sum;
+      break;
+
+    case (KSMOOTH_MOVAVG):
+      kplotdat_movavg (d);
+      for (i = 0; i < d->datas[0]->pairsz; i++)
+        {
+          kdata_pair_get (d->datas[0], i, &pair);
+          if (!kpair_vrfy (&pair))
+            continue;
+          kpair_set (d, i, &kp);
+          if (kp.y < ctx->minv.y)
+            ctx->minv.y = kp.y;
+          if (kp.y > ctx->maxv.y)
+            ctx->maxv.y = kp.y;
+        }
+      break;
+
+    default:
+      if (st->ninval == d->datas[0]->pairsz)
+        break;
+      /*
+       * Only fit the ordinates within the fixed abscissae, looking
+       * them up in the range index: this needs ascending abscissae.
+       */
+      if ((EXTREMA_YVIEW & ctx->cfg.extrema) &&
+          ((EXTREMA_XMIN | EXTREMA_XMAX) & ctx->cfg.extrema))
+        {
+          if (kdata_yrange_x (d->datas[0],
+                              EXTREMA_XMIN & ctx->cfg.extrema ?
+                              ctx->cfg.extrema_xmin : -DBL_MAX,
+                              EXTREMA_XMAX & ctx->cfg.extrema ?
+                              ctx->cfg.extrema_xmax : DBL_MAX,
+                              &lo, &hi))
+            {
+              if (lo < ctx->minv.y)
+                ctx->minv.y = lo;
+              if (hi > ctx->maxv.y)
+                ctx->maxv.y = hi;
+            }
+          break;
+        }
+      if (st->min.y < ctx->minv.y)
+        ctx->minv.y = st->min.y;
+      if (st->max.y > ctx->maxv.y)
+        ctx->maxv.y = st->max.y;
+      break;
     }
 }
 
@@ -553,12 +645,277 @@ kplotctx_draw_yerrline_pairlines (struct kplotctx *ctx,
   cairo_restore (ctx->cr);
 }
 
+/*
+ * Above this many points per device pixel, lines are decimated.
+ * Each pixel column contributes at most four vertices, so there's no
+ * point in doing so below that.
+ */
+#define KDECIM_MINPPX   4.0
+
+/*
+ * Vertices of the current device pixel column as seen by the decimating
+ * line renderer: the first, the last, and the extremal ones in between.
+ * Positions count the points received in the column so that the minimum
+ * and maximum are emitted in data order.
+ */
+struct  kdecim {
+  double col;                  /* device pixel column */
+  size_t n;                  /* points in column */
+  struct kpair first;
+  struct kpair last;
+  struct kpair min;
+  struct kpair max;
+  size_t minpos;               /* position of minimum */
+  size_t maxpos;               /* position of maximum */
+};
+
+static void
+kdecim_flush (struct kplotctx *ctx, const struct kdecim *b)
+{
+  const struct kpair *p[2];
+  size_t pos[2], i;
+
+  if (0 == b->n)
+    return;
+
+  cairo_line_to (ctx->cr, b->first.x, b->first.y);
+  if (1 == b->n)
+    return;
+
+  if (b->minpos <= b->maxpos)
+    {
+      p[0] = &b->min;
+      pos[0] = b->minpos;
+      p[1] = &b->max;
+      pos[1] = b->maxpos;
+    }
+  else
+    {
+      p[0] = &b->max;
+      pos[0] = b->maxpos;
+      p[1] = &b->min;
+      pos[1] = b->minpos;
+    }
+
+  /* The first and last are already emitted around these. */
+  for (i = 0; i < 2; i++)
+    {
+      if (0 == pos[i] || b->n - 1 == pos[i])
+        continue;
+      if (1 == i && pos[0] == pos[1])
+        continue;
+      cairo_line_to (ctx->cr, p[i]->x, p[i]->y);
+    }
+
+  cairo_line_to (ctx->cr, b->last.x, b->last.y);
+}
+
+static void
+kdecim_add (struct kplotctx *ctx, struct kdecim *b,
+            const struct kpair *pair, double ox, double sx)
+{
+  double col;
+
+  col = floor (ox + pair->x * sx);
+
+  if (0 == b->n || col != b->col)
+    {
+      kdecim_flush (ctx, b);
+      b->col = col;
+      b->n = 1;
+      b->first = b->last = b->min = b->max = *pair;
+      b->minpos = b->maxpos = 0;
+      return;
+    }
+
+  if (pair->y < b->min.y)
+    {
+      b->min = *pair;
+      b->minpos = b->n;
+    }
+  if (pair->y > b->max.y)
+    {
+      b->max = *pair;
+      b->maxpos = b->n;
+    }
+  b->last = *pair;
+  b->n++;
+}
+
+/*
+ * Device x-coordinate of the user-space origin and the number of device
+ * pixels per user unit along the x-axis.
+ */
+static double
+kplotctx_device_xscale (const struct kplotctx *ctx, double *ox)
+{
+  double dx = 1.0, dy = 0.0, oy = 0.0;
+
+  *ox = 0.0;
+  cairo_user_to_device (ctx->cr, ox, &oy);
+  cairo_user_to_device_distance (ctx->cr, &dx, &dy);
+  return(sqrt (dx * dx + dy * dy));
+}
+
+/*
+ * Vertex sink of the line renderer.
+ * Vertices are first culled: a vertex beyond either side of the visible
+ * horizontal range whose neighbours are both on that same side can't
+ * show, so it's dropped, which matters when drawing narrow tiles of a
+ * wide plot.
+ * Each vertex is held until its successor is known.
+ * The surviving vertices are then decimated (see kdecim) or drawn.
+ */
+struct  kline {
+  int decim;                 /* decimate the vertices */
+  int area;                  /* fill down to the abscissa */
+  struct kpair first;          /* first vertex */
+  struct kdecim b;              /* decimation column */
+  double ox;                  /* see kplotctx_device_xscale() */
+  double sx;                  /* see kplotctx_device_xscale() */
+  double x0;                  /* left of visible range */
+  double x1;                  /* right of visible range */
+  int held;                  /* "hold" is set */
+  struct kpair hold;           /* last vertex */
+  int holdside;              /* side of "hold" */
+  int prevside;              /* side of the vertex before it */
+};
+
+static int
+kline_side (const struct kline *l, double x)
+{
+  if (x < l->x0)
+    return(-1);
+  return(x > l->x1 ? 1 : 0);
+}
+
+static void
+kline_emit (struct kplotctx *ctx, struct kline *l, const struct kpair *pair)
+{
+  if (l->decim)
+    kdecim_add (ctx, &l->b, pair, l->ox, l->sx);
+  else
+    cairo_line_to (ctx->cr, pair->x, pair->y);
+}
+
+/*
+ * Start a line at "first", the current point.
+ */
+static void
+kline_init (struct kplotctx *ctx, struct kline *l,
+            const struct kpair *first, int decim, int area)
+{
+  double y0, y1, margin;
+
+  memset (l, 0, sizeof(struct kline));
+  l->decim = decim;
+  l->area = area;
+  l->first = *first;
+  l->sx = kplotctx_device_xscale (ctx, &l->ox);
+
+  /* Allow for the stroke width and mitered joins. */
+  margin = cairo_get_line_width (ctx->cr) *
+           (cairo_get_miter_limit (ctx->cr) > 1.0 ?
+            cairo_get_miter_limit (ctx->cr) : 1.0);
+  cairo_clip_extents (ctx->cr, &l->x0, &y0, &l->x1, &y1);
+  l->x0 -= margin;
+  l->x1 += margin;
+  l->prevside = kline_side (l, first->x);
+}
+
+static void
+kline_add (struct kplotctx *ctx, struct kline *l, const struct kpair *pair)
+{
+  int side;
+
+  side = kline_side (l, pair->x);
+  if (l->held)
+    {
+      if (0 == l->holdside ||
+          l->prevside != l->holdside ||
+          side != l->holdside)
+        kline_emit (ctx, l, &l->hold);
+      l->prevside = l->holdside;
+    }
+
+  l->hold = *pair;
+  l->holdside = side;
+  l->held = 1;
+}
+
+/*
+ * Fill the region between the line path and the bottom of the plot with
+ * the line colour, keeping the path for the stroke.
+ * The fill is blended over what's beneath, so overlapping areas mix.
+ * Blending over is associative, so strips drawn by kplot_draw_tiles()
+ * composite to the same result as a serial draw.
+ */
+#define KAREA_ALPHA     0.4
+
+static void
+kline_fill (struct kplotctx *ctx, const struct kline *l)
+{
+  cairo_path_t *path;
+  double x, y;
+
+  if (!cairo_has_current_point (ctx->cr))
+    return;
+
+  path = cairo_copy_path (ctx->cr);
+  cairo_get_current_point (ctx->cr, &x, &y);
+  cairo_line_to (ctx->cr, x, ctx->h);
+  cairo_line_to (ctx->cr, l->first.x, ctx->h);
+  cairo_close_path (ctx->cr);
+
+  cairo_save (ctx->cr);
+  cairo_clip (ctx->cr);
+  cairo_set_operator (ctx->cr, CAIRO_OPERATOR_OVER);
+  cairo_paint_with_alpha (ctx->cr, KAREA_ALPHA);
+  cairo_restore (ctx->cr);
+
+  cairo_append_path (ctx->cr, path);
+  cairo_path_destroy (path);
+}
+
+static void
+kline_finish (struct kplotctx *ctx, struct kline *l)
+{
+  if (l->held &&
+      (0 == l->holdside || l->prevside != l->holdside))
+    kline_emit (ctx, l, &l->hold);
+  if (l->decim)
+    kdecim_flush (ctx, &l->b);
+  if (l->area)
+    kline_fill (ctx, l);
+  cairo_stroke (ctx->cr);
+}
+
+/*
+ * The mapping of kpoint_to_real() as a scale and offset per axis.
+ */
+static void
+kplotctx_real_affine (const struct kplotctx *ctx,
+                      struct kpair *scale, struct kpair *offs)
+{
+  scale->x = ctx->maxv.x == ctx->minv.x ? 0.0 :
+             ctx->w / (ctx->maxv.x - ctx->minv.x);
+  offs->x = -ctx->minv.x * scale->x;
+  scale->y = ctx->maxv.y == ctx->minv.y ? 0.0 :
+             -ctx->h / (ctx->maxv.y - ctx->minv.y);
+  offs->y = ctx->h - ctx->minv.y * scale->y;
+}
+
+/* Pairs mapped to the plot space at a time. */
+#define KREAL_BLOCK     512
+
 static void
 kplotctx_draw_lines (struct kplotctx *ctx, const struct kplotdat *d)
 {
-  size_t i;
-  struct kpair kp, pair;
-  int rc;
+  size_t i, j, n, blk;
+  struct kpair kp, pair, orig, scale, offs;
+  struct kpair reals[KREAL_BLOCK];
+  struct kline l;
+  int decim;
 
   ksubwin_lines (ctx, &d->cfgs[0]);
   memset (&kp, 0, sizeof(struct kpair));
@@ -575,17 +932,49 @@ kplotctx_draw_lines (struct kplotctx *ctx, const struct kplotdat *d)
   kplotctx_line_init (ctx, &d->cfgs[0].line);
   cairo_move_to (ctx->cr, pair.x, pair.y);
   memset (&kp, 0, sizeof(struct kpair));
+
+  /*
+   * With many points per device pixel column, only emit the first,
+   * minimum, maximum, and last of each column.
+   * The stroke covers exactly the same pixels, but the path no longer
+   * grows with the data.
+   */
+  decim = (double)(d->datas[0]->pairsz - i) >
+          KDECIM_MINPPX * ctx->w * kplotctx_device_xscale (ctx, &orig.x);
+  kline_init (ctx, &l, &pair, decim, KPLOT_AREA == d->types[0]);
+
+  /*
+   * Unsmoothed pair arrays are mapped to the plot space a block at a
+   * time by the vector kernels.
+   */
+  if (KSMOOTH_NONE == d->smthtype &&
+      KDATA_COLUMN != d->datas[0]->type)
+    {
+      kplotctx_real_affine (ctx, &scale, &offs);
+      for ( ; i < d->datas[0]->pairsz; i += blk)
+        {
+          blk = d->datas[0]->pairsz - i;
+          if (blk > KREAL_BLOCK)
+            blk = KREAL_BLOCK;
+          n = kpairs_to_real (&d->datas[0]->pairs[i],
+                              blk, reals, &scale, &offs);
+          for (j = 0; j < n; j++)
+            kline_add (ctx, &l, &reals[j]);
+        }
+      kline_finish (ctx, &l);
+      goto out;
+    }
+
   for ( ; i < d->datas[0]->pairsz; i++)
     {
-      if (!kpair_vrfy (&d->datas[0]->pairs[i]))
+      kdata_pair_get (d->datas[0], i, &orig);
+      if (!kpair_vrfy (&orig))
         continue;
       kpair_set (d, i, &kp);
-      rc = kplotctx_point_to_real (&kp, &pair, ctx);
-      if (!rc)
-        continue;
-      cairo_line_to (ctx->cr, pair.x, pair.y);
+      if (kplotctx_point_to_real (&kp, &pair, ctx))
+        kline_add (ctx, &l, &pair);
     }
-  cairo_stroke (ctx->cr);
+  kline_finish (ctx, &l);
 out:
   cairo_restore (ctx->cr);
 }
@@ -594,14 +983,15 @@ static void
 kplotctx_draw_points (struct kplotctx *ctx, const struct kplotdat *d)
 {
   size_t i;
-  struct kpair kp;
+  struct kpair kp, orig;
 
   ksubwin_points (ctx);
   memset (&kp, 0, sizeof(struct kpair));
   kplotctx_point_init (ctx, &d->cfgs[0].point);
   for (i = 0; i < d->datas[0]->pairsz; i++)
     {
-      if (!kpair_vrfy (&d->datas[0]->pairs[i]))
+      kdata_pair_get (d->datas[0], i, &orig);
+      if (!kpair_vrfy (&orig))
         continue;
       kpair_set (d, i, &kp);
       kplot_arc (&kp, &d->cfgs[0].point, ctx);
@@ -613,14 +1003,15 @@ static void
 kplotctx_draw_marks (struct kplotctx *ctx, const struct kplotdat *d)
 {
   size_t i;
-  struct kpair kp;
+  struct kpair kp, orig;
 
   ksubwin_points (ctx);
   memset (&kp, 0, sizeof(struct kpair));
   kplotctx_point_init (ctx, &d->cfgs[0].point);
   for (i = 0; i < d->datas[0]->pairsz; i++)
     {
-      if (!kpair_vrfy (&d->datas[0]->pairs[i]))
+      kdata_pair_get (d->datas[0], i, &orig);
+      if (!kpair_vrfy (&orig))
         continue;
       kpair_set (d, i, &kp);
       kplot_mark (&kp, &d->cfgs[0].point, ctx);
@@ -676,98 +1067,104 @@ kplotcfg_defaults (struct kplotcfg *cfg)
   cfg->xaxislabelpad = cfg->yaxislabelpad = 15.0;
 }
 
-void
-kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
+/*
+ * Compute the plot extrema and lay out and draw everything but the data
+ * itself: margins, labels, grid, border, and tics.
+ * The default palette is stored in "defs", which must remain valid as
+ * long as "ctx" is in use.
+ */
+static void
+kplotctx_init (struct kplotctx *ctx, struct kplot *p,
+               double w, double h, cairo_t *cr, struct kplotccfg *defs)
 {
-  size_t i, start, end;
-  struct kplotctx ctx;
+  size_t i;
   struct kplotdat *d;
-  struct kplotccfg defs[7];
 
-  memset (&ctx, 0, sizeof(struct kplotctx));
+  memset (ctx, 0, sizeof(struct kplotctx));
 
-  ctx.w = w;
-  ctx.h = h;
-  ctx.cr = cr;
-  ctx.minv.x = ctx.minv.y = DBL_MAX;
-  ctx.maxv.x = ctx.maxv.y = -DBL_MAX;
-  ctx.cfg = p->cfg;
+  ctx->w = w;
+  ctx->h = h;
+  ctx->cr = cr;
+  ctx->labels = &p->labels;
+  ctx->minv.x = ctx->minv.y = DBL_MAX;
+  ctx->maxv.x = ctx->maxv.y = -DBL_MAX;
+  ctx->cfg = p->cfg;
 
-  if (KPLOTCTYPE_DEFAULT == ctx.cfg.borderline.clr.type)
+  if (KPLOTCTYPE_DEFAULT == ctx->cfg.borderline.clr.type)
     {
-      ctx.cfg.borderline.clr.type = KPLOTCTYPE_RGBA;
-      ctx.cfg.borderline.clr.rgba[0] = 0.0;
-      ctx.cfg.borderline.clr.rgba[1] = 0.0;
-      ctx.cfg.borderline.clr.rgba[2] = 0.0;
-      ctx.cfg.borderline.clr.rgba[3] = 1.0;
+      ctx->cfg.borderline.clr.type = KPLOTCTYPE_RGBA;
+      ctx->cfg.borderline.clr.rgba[0] = 0.0;
+      ctx->cfg.borderline.clr.rgba[1] = 0.0;
+      ctx->cfg.borderline.clr.rgba[2] = 0.0;
+      ctx->cfg.borderline.clr.rgba[3] = 1.0;
     }
 
-  if (KPLOTCTYPE_DEFAULT == ctx.cfg.axislabelfont.clr.type)
+  if (KPLOTCTYPE_DEFAULT == ctx->cfg.axislabelfont.clr.type)
     {
-      ctx.cfg.axislabelfont.clr.type = KPLOTCTYPE_RGBA;
-      ctx.cfg.axislabelfont.clr.rgba[0] = 0.0;
-      ctx.cfg.axislabelfont.clr.rgba[1] = 0.0;
-      ctx.cfg.axislabelfont.clr.rgba[2] = 0.0;
-      ctx.cfg.axislabelfont.clr.rgba[3] = 1.0;
+      ctx->cfg.axislabelfont.clr.type = KPLOTCTYPE_RGBA;
+      ctx->cfg.axislabelfont.clr.rgba[0] = 0.0;
+      ctx->cfg.axislabelfont.clr.rgba[1] = 0.0;
+      ctx->cfg.axislabelfont.clr.rgba[2] = 0.0;
+      ctx->cfg.axislabelfont.clr.rgba[3] = 1.0;
     }
 
-  if (KPLOTCTYPE_DEFAULT == ctx.cfg.ticline.clr.type)
+  if (KPLOTCTYPE_DEFAULT == ctx->cfg.ticline.clr.type)
     {
-      ctx.cfg.ticline.clr.type = KPLOTCTYPE_RGBA;
-      ctx.cfg.ticline.clr.rgba[0] = 0.0;
-      ctx.cfg.ticline.clr.rgba[1] = 0.0;
-      ctx.cfg.ticline.clr.rgba[2] = 0.0;
-      ctx.cfg.ticline.clr.rgba[3] = 1.0;
+      ctx->cfg.ticline.clr.type = KPLOTCTYPE_RGBA;
+      ctx->cfg.ticline.clr.rgba[0] = 0.0;
+      ctx->cfg.ticline.clr.rgba[1] = 0.0;
+      ctx->cfg.ticline.clr.rgba[2] = 0.0;
+      ctx->cfg.ticline.clr.rgba[3] = 1.0;
     }
 
-  if (KPLOTCTYPE_DEFAULT == ctx.cfg.gridline.clr.type)
+  if (KPLOTCTYPE_DEFAULT == ctx->cfg.gridline.clr.type)
     {
-      ctx.cfg.gridline.clr.type = KPLOTCTYPE_RGBA;
-      ctx.cfg.gridline.clr.rgba[0] = 0.5;
-      ctx.cfg.gridline.clr.rgba[1] = 0.5;
-      ctx.cfg.gridline.clr.rgba[2] = 0.5;
-      ctx.cfg.gridline.clr.rgba[3] = 1.0;
+      ctx->cfg.gridline.clr.type = KPLOTCTYPE_RGBA;
+      ctx->cfg.gridline.clr.rgba[0] = 0.5;
+      ctx->cfg.gridline.clr.rgba[1] = 0.5;
+      ctx->cfg.gridline.clr.rgba[2] = 0.5;
+      ctx->cfg.gridline.clr.rgba[3] = 1.0;
     }
 
-  if (KPLOTCTYPE_DEFAULT == ctx.cfg.ticlabelfont.clr.type)
+  if (KPLOTCTYPE_DEFAULT == ctx->cfg.ticlabelfont.clr.type)
     {
-      ctx.cfg.ticlabelfont.clr.type = KPLOTCTYPE_RGBA;
-      ctx.cfg.ticlabelfont.clr.rgba[0] = 0.5;
-      ctx.cfg.ticlabelfont.clr.rgba[1] = 0.5;
-      ctx.cfg.ticlabelfont.clr.rgba[2] = 0.5;
-      ctx.cfg.ticlabelfont.clr.rgba[3] = 1.0;
+      ctx->cfg.ticlabelfont.clr.type = KPLOTCTYPE_RGBA;
+      ctx->cfg.ticlabelfont.clr.rgba[0] = 0.5;
+      ctx->cfg.ticlabelfont.clr.rgba[1] = 0.5;
+      ctx->cfg.ticlabelfont.clr.rgba[2] = 0.5;
+      ctx->cfg.ticlabelfont.clr.rgba[3] = 1.0;
     }
 
-  if (0 == ctx.cfg.clrsz)
+  if (0 == ctx->cfg.clrsz)
     {
-      ctx.cfg.clrs = defs;
-      ctx.cfg.clrsz = 7;
-      for (i = 0; i < ctx.cfg.clrsz; i++)
+      ctx->cfg.clrs = defs;
+      ctx->cfg.clrsz = 7;
+      for (i = 0; i < ctx->cfg.clrsz; i++)
         {
-          ctx.cfg.clrs[i].type = KPLOTCTYPE_RGBA;
-          ctx.cfg.clrs[i].rgba[3] = 1.0;
+          ctx->cfg.clrs[i].type = KPLOTCTYPE_RGBA;
+          ctx->cfg.clrs[i].rgba[3] = 1.0;
         }
-      ctx.cfg.clrs[0].rgba[0] = 0x94 / 255.0;
-      ctx.cfg.clrs[0].rgba[1] = 0x04 / 255.0;
-      ctx.cfg.clrs[0].rgba[2] = 0xd3 / 255.0;
-      ctx.cfg.clrs[1].rgba[0] = 0x00 / 255.0;
-      ctx.cfg.clrs[1].rgba[1] = 0x9e / 255.0;
-      ctx.cfg.clrs[1].rgba[2] = 0x73 / 255.0;
-      ctx.cfg.clrs[2].rgba[0] = 0x56 / 255.0;
-      ctx.cfg.clrs[2].rgba[1] = 0xb4 / 255.0;
-      ctx.cfg.clrs[2].rgba[2] = 0xe9 / 255.0;
-      ctx.cfg.clrs[3].rgba[0] = 0xe6 / 255.0;
-      ctx.cfg.clrs[3].rgba[1] = 0x9f / 255.0;
-      ctx.cfg.clrs[3].rgba[2] = 0x00 / 255.0;
-      ctx.cfg.clrs[4].rgba[0] = 0xf0 / 255.0;
-      ctx.cfg.clrs[4].rgba[1] = 0xe4 / 255.0;
-      ctx.cfg.clrs[4].rgba[2] = 0x42 / 255.0;
-      ctx.cfg.clrs[5].rgba[0] = 0x00 / 255.0;
-      ctx.cfg.clrs[5].rgba[1] = 0x72 / 255.0;
-      ctx.cfg.clrs[5].rgba[2] = 0xb2 / 255.0;
-      ctx.cfg.clrs[6].rgba[0] = 0xe5 / 255.0;
-      ctx.cfg.clrs[6].rgba[1] = 0x1e / 255.0;
-      ctx.cfg.clrs[6].rgba[2] = 0x10 / 255.0;
+      ctx->cfg.clrs[0].rgba[0] = 0x94 / 255.0;
+      ctx->cfg.clrs[0].rgba[1] = 0x04 / 255.0;
+      ctx->cfg.clrs[0].rgba[2] = 0xd3 / 255.0;
+      ctx->cfg.clrs[1].rgba[0] = 0x00 / 255.0;
+      ctx->cfg.clrs[1].rgba[1] = 0x9e / 255.0;
+      ctx->cfg.clrs[1].rgba[2] = 0x73 / 255.0;
+      ctx->cfg.clrs[2].rgba[0] = 0x56 / 255.0;
+      ctx->cfg.clrs[2].rgba[1] = 0xb4 / 255.0;
+      ctx->cfg.clrs[2].rgba[2] = 0xe9 / 255.0;
+      ctx->cfg.clrs[3].rgba[0] = 0xe6 / 255.0;
+      ctx->cfg.clrs[3].rgba[1] = 0x9f / 255.0;
+      ctx->cfg.clrs[3].rgba[2] = 0x00 / 255.0;
+      ctx->cfg.clrs[4].rgba[0] = 0xf0 / 255.0;
+      ctx->cfg.clrs[4].rgba[1] = 0xe4 / 255.0;
+      ctx->cfg.clrs[4].rgba[2] = 0x42 / 255.0;
+      ctx->cfg.clrs[5].rgba[0] = 0x00 / 255.0;
+      ctx->cfg.clrs[5].rgba[1] = 0x72 / 255.0;
+      ctx->cfg.clrs[5].rgba[2] = 0xb2 / 255.0;
+      ctx->cfg.clrs[6].rgba[0] = 0xe5 / 255.0;
+      ctx->cfg.clrs[6].rgba[1] = 0x1e / 255.0;
+      ctx->cfg.clrs[6].rgba[2] = 0x10 / 255.0;
     }
 
   for (i = 0; i < p->datasz; i++)
@@ -777,37 +1174,55 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
         {
         case (KPLOTS_YERRORBAR):
         case (KPLOTS_YERRORLINE):
-          kdata_extrema_yerr (d, &ctx);
+          kdata_extrema_yerr (d, ctx);
           break;
 
         case (KPLOTS_SINGLE):
-          kdata_extrema_single (d, &ctx);
+          kdata_extrema_single (d, ctx);
           break;
         }
     }
 
-  if (EXTREMA_XMIN & ctx.cfg.extrema)
-    ctx.minv.x = ctx.cfg.extrema_xmin;
-  if (EXTREMA_YMIN & ctx.cfg.extrema)
-    ctx.minv.y = ctx.cfg.extrema_ymin;
-  if (EXTREMA_XMAX & ctx.cfg.extrema)
-    ctx.maxv.x = ctx.cfg.extrema_xmax;
-  if (EXTREMA_YMAX & ctx.cfg.extrema)
-    ctx.maxv.y = ctx.cfg.extrema_ymax;
-
-  if (ctx.minv.x > ctx.maxv.x)
-    ctx.minv.x = ctx.maxv.x = 0.0;
-  if (ctx.minv.y > ctx.maxv.y)
-    ctx.minv.y = ctx.maxv.y = 0.0;
-
-  kplotctx_margin_init (&ctx);
-  kplotctx_label_init (&ctx);
-  kplotctx_grid_init (&ctx);
-  kplotctx_border_init (&ctx);
-  kplotctx_tic_init (&ctx);
+  if (EXTREMA_XMIN & ctx->cfg.extrema)
+    ctx->minv.x = ctx->cfg.extrema_xmin;
+  if (EXTREMA_YMIN & ctx->cfg.extrema)
+    ctx->minv.y = ctx->cfg.extrema_ymin;
+  if (EXTREMA_XMAX & ctx->cfg.extrema)
+    ctx->maxv.x = ctx->cfg.extrema_xmax;
+  if (EXTREMA_YMAX & ctx->cfg.extrema)
+    ctx->maxv.y = ctx->cfg.extrema_ymax;
+
+  if (ctx->minv.x > ctx->maxv.x)
+    ctx->minv.x = ctx->maxv.x = 0.0;
+  if (ctx->minv.y > ctx->maxv.y)
+    ctx->minv.y = ctx->maxv.y = 0.0;
+
+  kplotctx_margin_init (ctx);
+  kplotctx_label_init (ctx);
+  kplotctx_grid_init (ctx);
+  kplotctx_border_init (ctx);
+  kplotctx_tic_init (ctx);
+
+  ctx->h = ctx->dims.y;
+  ctx->w = ctx->dims.x;
+
+  p->area.valid = 1;
+  p->area.offs = ctx->offs;
+  p->area.dims = ctx->dims;
+  p->area.minv = ctx->minv;
+  p->area.maxv = ctx->maxv;
+}
 
-  ctx.h = ctx.dims.y;
-  ctx.w = ctx.dims.x;
+/*
+ * Draw the data series of "p" into a context prepared by kplotctx_init().
+ * This only reads from "ctx" and "p", so it may run concurrently on copies
+ * of the same context drawing to different surfaces.
+ */
+static void
+kplotctx_draw_datas (struct kplotctx *ctx, const struct kplot *p)
+{
+  size_t i, start, end;
+  const struct kplotdat *d;
 
   for (i = 0; i < p->datasz; i++)
     {
@@ -818,25 +1233,26 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
           switch (d->types[0])
             {
             case (KPLOT_POINTS):
-              kplotctx_draw_points (&ctx, d);
+              kplotctx_draw_points (ctx, d);
               break;
 
             case (KPLOT_MARKS):
-              kplotctx_draw_marks (&ctx, d);
+              kplotctx_draw_marks (ctx, d);
               break;
 
             case (KPLOT_LINES):
-              kplotctx_draw_lines (&ctx, d);
+            case (KPLOT_AREA):
+              kplotctx_draw_lines (ctx, d);
               break;
 
             case (KPLOT_LINESPOINTS):
-              kplotctx_draw_points (&ctx, d);
-              kplotctx_draw_lines (&ctx, d);
+              kplotctx_draw_points (ctx, d);
+              kplotctx_draw_lines (ctx, d);
               break;
 
             case (KPLOT_LINESMARKS):
-              kplotctx_draw_marks (&ctx, d);
-              kplotctx_draw_lines (&ctx, d);
+              kplotctx_draw_marks (ctx, d);
+              kplotctx_draw_lines (ctx, d);
               break;
 
             default:
@@ -848,7 +1264,7 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
         case (KPLOTS_YERRORBAR):
         case (KPLOTS_YERRORLINE):
           start = kplotctx_draw_yerrline_start
-                    (&ctx, d, &end);
+                    (ctx, d, &end);
           if (start == end)
             break;
           assert (d->datasz > 1);
@@ -856,31 +1272,32 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
             {
             case (KPLOT_POINTS):
               kplotctx_draw_yerrline_basepoints
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_MARKS):
               kplotctx_draw_yerrline_basemarks
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINES):
+            case (KPLOT_AREA):
               kplotctx_draw_yerrline_baselines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINESPOINTS):
               kplotctx_draw_yerrline_basepoints
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               kplotctx_draw_yerrline_baselines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINESMARKS):
               kplotctx_draw_yerrline_basemarks
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               kplotctx_draw_yerrline_baselines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             default:
@@ -891,31 +1308,32 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
             {
             case (KPLOT_POINTS):
               kplotctx_draw_yerrline_pairpoints
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_MARKS):
               kplotctx_draw_yerrline_pairmarks
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINES):
+            case (KPLOT_AREA):
               kplotctx_draw_yerrline_pairlines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINESPOINTS):
               kplotctx_draw_yerrline_pairpoints
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               kplotctx_draw_yerrline_pairlines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             case (KPLOT_LINESMARKS):
               kplotctx_draw_yerrline_pairmarks
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               kplotctx_draw_yerrline_pairlines
-                (&ctx, start, end, d);
+                (ctx, start, end, d);
               break;
 
             default:
@@ -924,7 +1342,7 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
             }
           if (KPLOTS_YERRORBAR == d->stype)
             kplotctx_draw_yerrline_pairbars
-              (&ctx, start, end, d);
+              (ctx, start, end, d);
           break;
 
         default:
@@ -933,6 +1351,179 @@ kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
     }
 }
 
+void
+kplot_draw (struct kplot *p, double w, double h, cairo_t *cr)
+{
+  struct kplotctx ctx;
+  struct kplotccfg defs[7];
+
+  kplotctx_init (&ctx, p, w, h, cr, defs);
+  kplotctx_draw_datas (&ctx, p);
+}
+
+/*
+ * One vertical strip of a plot drawn by kplot_draw_tiles().
+ * Strip bounds are in the user space of the target surface, that is,
+ * device pixels less the device offset and scale.
+ */
+struct  ktile {
+  struct kplotctx ctx;         /* private copy of the plot context */
+  const struct kplot *p;        /* plot being drawn */
+  cairo_matrix_t mtx;           /* transformation of the target */
+  cairo_surface_t *surf;        /* strip raster */
+  double x;                     /* left of strip */
+  double y;                     /* top of strip */
+  double w;                     /* width of strip */
+  double h;                     /* height of strip */
+};
+
+/*
+ * Draw the data of a plot into its strip.
+ * The strip surface bounds clip away whatever lies outside of it, and
+ * kplotctx_draw_lines() culls what's clipped before building paths.
+ */
+static void
+ktile_draw (void *arg)
+{
+  struct ktile *t = arg;
+  cairo_t *cr;
+
+  cr = cairo_create (t->surf);
+  cairo_translate (cr, -t->x, -t->y);
+  cairo_transform (cr, &t->mtx);
+  t->ctx.cr = cr;
+  kplotctx_draw_datas (&t->ctx, t->p);
+  cairo_destroy (cr);
+  cairo_surface_flush (t->surf);
+}
+
+static void
+ktiles_free (struct ktile *tiles, size_t tilesz)
+{
+  size_t i;
+
+  for (i = 0; i < tilesz; i++)
+    if (NULL != tiles[i].surf)
+      cairo_surface_destroy (tiles[i].surf);
+  free (tiles);
+}
+
+/*
+ * Like kplot_draw(), but split the data drawing into "tilesz" vertical
+ * strips of the plot, each drawn to its own image surface.
+ * The strips are handed to "run" as an array of "tilesz" opaque
+ * arguments for the given drawing function: it may invoke them in any
+ * order or concurrently, but must return only when all are done.
+ * The strips are then composited onto "cr".
+ * Strips are aligned to device pixels, so the result is the same as
+ * with kplot_draw() for an axis-aligned transformation.
+ * Returns zero if strips could not be allocated, in which case the plot
+ * is drawn serially.
+ */
+int
+kplot_draw_tiles (struct kplot *p, double w, double h, cairo_t *cr,
+                  size_t tilesz,
+                  void (*run)(void (*)(void *), void **, size_t, void *),
+                  void *arg)
+{
+  struct kplotctx ctx;
+  struct kplotccfg defs[7];
+  struct ktile *tiles;
+  void **args;
+  cairo_surface_t *target;
+  cairo_matrix_t mtx;
+  double x0, y0, x1, y1, v, sx, sy, ox, oy, c0, c1;
+  size_t i;
+  int rc;
+
+  kplotctx_init (&ctx, p, w, h, cr, defs);
+
+  if (tilesz < 2 || NULL == run)
+    {
+      kplotctx_draw_datas (&ctx, p);
+      return(1);
+    }
+
+  /* Device pixel bounds of the whole plot. */
+  x0 = y0 = 0.0;
+  x1 = w;
+  y1 = h;
+  cairo_user_to_device (cr, &x0, &y0);
+  cairo_user_to_device (cr, &x1, &y1);
+  if (x0 > x1)
+    {
+      v = x0;
+      x0 = x1;
+      x1 = v;
+    }
+  if (y0 > y1)
+    {
+      v = y0;
+      y0 = y1;
+      y1 = v;
+    }
+  x0 = floor (x0);
+  y0 = floor (y0);
+  x1 = ceil (x1);
+  y1 = ceil (y1);
+
+  if (x1 - x0 < (double)tilesz || y1 <= y0)
+    {
+      kplotctx_draw_datas (&ctx, p);
+      return(1);
+    }
+
+  target = cairo_get_target (cr);
+  cairo_surface_get_device_scale (target, &sx, &sy);
+  cairo_surface_get_device_offset (target, &ox, &oy);
+  cairo_get_matrix (cr, &mtx);
+
+  rc = 0;
+  tiles = calloc (tilesz, sizeof(struct ktile));
+  args = calloc (tilesz, sizeof(void *));
+  if (NULL == tiles || NULL == args)
+    goto out;
+
+  for (i = 0; i < tilesz; i++)
+    {
+      c0 = x0 + floor ((x1 - x0) * i / tilesz);
+      c1 = x0 + floor ((x1 - x0) * (i + 1) / tilesz);
+      tiles[i].surf = cairo_image_surface_create
+                        (CAIRO_FORMAT_ARGB32, (int)(c1 - c0), (int)(y1 - y0));
+      if (CAIRO_STATUS_SUCCESS != cairo_surface_status (tiles[i].surf))
+        goto out;
+      cairo_surface_set_device_scale (tiles[i].surf, sx, sy);
+      tiles[i].ctx = ctx;
+      tiles[i].p = p;
+      tiles[i].mtx = mtx;
+      tiles[i].x = (c0 - ox) / sx;
+      tiles[i].y = (y0 - oy) / sy;
+      tiles[i].w = (c1 - c0) / sx;
+      tiles[i].h = (y1 - y0) / sy;
+      args[i] = &tiles[i];
+    }
+
+  run (ktile_draw, args, tilesz, arg);
+
+  cairo_save (cr);
+  cairo_identity_matrix (cr);
+  for (i = 0; i < tilesz; i++)
+    {
+      cairo_set_source_surface (cr, tiles[i].surf, tiles[i].x, tiles[i].y);
+      cairo_rectangle (cr, tiles[i].x, tiles[i].y, tiles[i].w, tiles[i].h);
+      cairo_fill (cr);
+    }
+  cairo_restore (cr);
+  rc = 1;
+out:
+  if (0 == rc)
+    kplotctx_draw_datas (&ctx, p);
+  if (NULL != tiles)
+    ktiles_free (tiles, tilesz);
+  free (args);
+  return(rc);
+}
+
 int
 kplotcfg_default_palette (struct kplotccfg **pp, size_t *szp)
 {
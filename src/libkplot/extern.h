@@ -37,17 +37,100 @@ struct  kdatastddev {
   double          *m2s;       /* incremental variance parameter */
 };
 
+/*
+ * Caller-owned columns: pair "i" is read from "x" and "y" at "i" times
+ * the respective byte stride.
+ * The "free" callback, if any, is invoked with "arg" once the last
+ * reference to the data source goes away.
+ */
+struct  kdatacolumn {
+  const char      *x;       /* first abscissa */
+  size_t xstride;                 /* bytes between abscissae */
+  const char      *y;       /* first ordinate */
+  size_t ystride;                 /* bytes between ordinates */
+  void (*free)(void *);         /* release callback */
+  void            *arg;       /* release callback argument */
+};
+
 struct  kdatavector {
   size_t stepsz;                 /* vector increase slush size */
   size_t pairbufsz;                 /* allocated buffer size */
 };
 
+/*
+ * Bounded window of the last "cap" pairs pushed.
+ * The pairs live in a buffer twice the capacity and "pairs" points at
+ * the oldest one, so they stay contiguous for the readers: the window
+ * slides back to the start of the buffer once it reaches its end.
+ * Besides, four monotonic queues hold the sequence numbers of the pairs
+ * that may yet become the minimum and maximum abscissa and ordinate, so
+ * the extrema are known without a scan when the oldest pair goes away.
+ */
+#define KRING_XMIN      0
+#define KRING_XMAX      1
+#define KRING_YMIN      2
+#define KRING_YMAX      3
+#define KRING_QUEUES    4
+
+struct  kdataring {
+  struct kpair    *buf;       /* twice the capacity */
+  size_t cap;                 /* maximum number of pairs */
+  size_t head;                 /* offset of the oldest pair in buf */
+  size_t seq;                 /* sequence number of the oldest pair */
+  size_t          *queue[KRING_QUEUES]; /* circular, of capacity cap */
+  size_t qfirst[KRING_QUEUES];       /* first slot of each queue */
+  size_t qsz[KRING_QUEUES];          /* length of each queue */
+};
+
+/*
+ * Summary of the valid pairs (see kpair_vrfy()) of a data source.
+ * It's computed on demand and kept up to date by kdata_set() as long as
+ * no extremal value is overwritten.
+ */
+struct  kdatastat {
+  int valid;                 /* summary is current */
+  size_t ninval;                 /* number of invalid pairs */
+  struct kpair min;           /* minimum x and y values */
+  struct kpair max;           /* maximum x and y values */
+  double xsum;                 /* sum of valid abscissae */
+  double ysum;                 /* sum of valid ordinates */
+};
+
+#define KRANGE_BLOCK    64
+
+/*
+ * Range index of the ordinates of a data source (see kdata_yrange()):
+ * the extrema of each block of KRANGE_BLOCK pairs, then a sparse table
+ * whose level "k" holds the extrema of every run of 2^k blocks.
+ * It's built on demand and dropped whenever the pairs change.
+ */
+struct  krange {
+  int valid;                 /* index is current */
+  size_t blocksz;                 /* number of blocks */
+  size_t levelsz;                 /* number of table levels */
+  size_t tablesz;                 /* allocated entries per table */
+  double          *min;       /* levels of minima */
+  double          *max;       /* levels of maxima */
+};
+
+/*
+ * Result of kpairs_reduce().
+ */
+struct  kreduce {
+  size_t ninval;                 /* number of invalid pairs */
+  struct kpair min;           /* minimum x and y values */
+  struct kpair max;           /* maximum x and y values */
+  struct kpair sum;           /* sums of x and y values */
+};
+
 enum    kdatatype {
   KDATA_ARRAY,
   KDATA_BUCKET,
   KDATA_BUFFER,
+  KDATA_COLUMN,
   KDATA_HIST,
   KDATA_MEAN,
+  KDATA_RING,
   KDATA_STDDEV,
   KDATA_VECTOR
 };
@@ -75,15 +158,37 @@ struct  kdata {
   struct kdep     *deps;       /* dependants */
   size_t depsz;                 /* number of dependants */
   enum kdatatype type;
+  struct kdatastat stat;         /* cached summary */
+  struct krange range;          /* cached range index */
   union {
     struct kdatahist hist;
     struct kdatavector vector;
+    struct kdataring ring;
     struct kdatabucket bucket;
     struct kdatamean mean;
     struct kdatastddev stddev;
+    struct kdatacolumn column;
   } d;
 };
 
+/*
+ * Read the pair at position "pos", which must be valid.
+ * Column sources don't have a pair array: they're read in place from
+ * the caller's buffers.
+ */
+static inline void
+kdata_pair_get (const struct kdata *d, size_t pos, struct kpair *kp)
+{
+  if (KDATA_COLUMN != d->type)
+    {
+      *kp = d->pairs[pos];
+      return;
+    }
+
+  kp->x = *(const double *)(d->d.column.x + pos * d->d.column.xstride);
+  kp->y = *(const double *)(d->d.column.y + pos * d->d.column.ystride);
+}
+
 struct  kplotdat {
   struct kdata    **datas;       /* referenced data */
   size_t datasz;                  /* number of data sets */
@@ -93,16 +198,63 @@ struct  kplotdat {
   enum ksmthtype smthtype;          /* smoothing type */
   struct ksmthcfg smth;         /* smooth configuration */
   double sum;                  /* used for KSMOOTH_CDF */
+  struct kpair    *smthpairs;       /* used for KSMOOTH_MOVAVG */
+};
+
+/*
+ * A tic or axis label as last drawn: its text (formatted from a value,
+ * for tic labels) and its extents in a given font and transformation.
+ * Formatters are assumed to always give the same text for a value.
+ */
+struct  klabel {
+  char str[128];          /* label text */
+  int fmtd;                  /* text formatted from "v" */
+  double v;                  /* value formatted */
+  void (*fmt)(double, char *, size_t); /* formatter or NULL */
+  char family[64];           /* font family */
+  double sz;                  /* font size */
+  cairo_font_slant_t slant;          /* font slant */
+  cairo_font_weight_t weight;         /* font weight */
+  double mtx[4];             /* linear part of user matrix */
+  cairo_text_extents_t e;    /* measured extents */
+  unsigned int used;                 /* last use, zero if unused */
+};
+
+#define KLABEL_MAX      32
+
+/*
+ * Per-plot cache of labels, so that redrawing doesn't format or measure
+ * the same labels over and over.
+ * Labels whose text or font family doesn't fit aren't cached.
+ */
+struct  klabelcache {
+  struct klabel labels[KLABEL_MAX]; /* least recently used evicted */
+  struct klabel scratch;          /* uncacheable tic label */
+  unsigned int used;                 /* use counter */
+};
+
+/*
+ * Data area and range of the last drawing (see kplot_get_area()).
+ */
+struct  kplotarea {
+  int valid;                 /* plot has been drawn */
+  struct kpair offs;           /* offset of data area */
+  struct kpair dims;           /* dimensions of data area */
+  struct kpair minv;           /* minimum data point values */
+  struct kpair maxv;           /* maximum data point values */
 };
 
 struct  kplot {
   struct kplotdat *datas;       /* data sets per plot */
   size_t datasz;                 /* number of data sets */
   struct kplotcfg cfg;        /* configuration */
+  struct klabelcache labels;         /* label cache */
+  struct kplotarea area;           /* last drawn area */
 };
 
 struct  kplotctx {
   cairo_t         *cr;       /* cairo context */
+  struct klabelcache *labels;         /* plot's label cache */
   double h;                 /* height of context */
   double w;                 /* width of context */
   struct kpair minv;           /* minimum data point values */
@@ -125,6 +277,21 @@ __BEGIN_DECLS
 int kdata_dep_add (struct kdata *, struct kdata *, ksetfunc);
 int      kdata_dep_run (struct kdata *, size_t);
 int      kdata_set (struct kdata *, size_t, double, double);
+void     kdata_invalidate (struct kdata *);
+
+void     kdata_stat_add (struct kdata *, size_t);
+void     kdata_ring_free (struct kdata *);
+const struct kdatastat *kdata_stat_get (const struct kdata *);
+
+int      kpair_vrfy (const struct kpair *);
+
+void     krange_free (struct krange *);
+
+void     kpairs_reduce (const struct kpair *, size_t, struct kreduce *);
+void     kpairs_sqdev (const struct kpair *, size_t,
+                       const struct kpair *, struct kpair *);
+size_t   kpairs_to_real (const struct kpair *, size_t, struct kpair *,
+                         const struct kpair *, const struct kpair *);
 
 void     kplotctx_border_init (struct kplotctx *);
 void     kplotctx_grid_init (struct kplotctx *);
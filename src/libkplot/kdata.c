@@ -52,6 +52,15 @@ kdata_destroy (struct kdata *d)
       free (d->d.stddev.m2s);
       break;
 
+    case (KDATA_COLUMN):
+      if (NULL != d->d.column.free)
+        (*d->d.column.free)(d->d.column.arg);
+      break;
+
+    case (KDATA_RING):
+      kdata_ring_free (d);
+      break;
+
     default:
       break;
     }
@@ -60,6 +69,7 @@ kdata_destroy (struct kdata *d)
   for (i = 0; i < d->depsz; i++)
     kdata_destroy (d->deps[i].dep);
 
+  krange_free (&d->range);
   free (d->deps);
   free (d->pairs);
   free (d);
@@ -77,6 +87,169 @@ kdatacfg_defaults (struct kdatacfg *cfg)
   cfg->line.clr.type = KPLOTCTYPE_DEFAULT;
 }
 
+/*
+ * Simple function to check that the double-precision values in the
+ * kpair are valid: normal (or 0.0) values.
+ */
+int
+kpair_vrfy (const struct kpair *data)
+{
+  if (0.0 != data->x && !isnormal (data->x))
+    return(0);
+
+  if (0.0 != data->y && !isnormal (data->y))
+    return(0);
+
+  return(1);
+}
+
+/*
+ * Account for the pair at position "pos", which must not yet be part
+ * of the summary: either newly appended or just taken out of it with
+ * kdata_stat_remove().
+ */
+void
+kdata_stat_add (struct kdata *d, size_t pos)
+{
+  struct kdatastat *st = &d->stat;
+  struct kpair kp;
+
+  if (0 == st->valid)
+    return;
+
+  kdata_pair_get (d, pos, &kp);
+  if (!kpair_vrfy (&kp))
+    {
+      st->ninval++;
+      return;
+    }
+
+  st->xsum += kp.x;
+  st->ysum += kp.y;
+
+  /* The only valid pair: it's all of the extrema. */
+  if (st->ninval + 1 == d->pairsz)
+    {
+      st->min = st->max = kp;
+      return;
+    }
+
+  if (kp.x < st->min.x)
+    st->min.x = kp.x;
+  if (kp.x > st->max.x)
+    st->max.x = kp.x;
+  if (kp.y < st->min.y)
+    st->min.y = kp.y;
+  if (kp.y > st->max.y)
+    st->max.y = kp.y;
+}
+
+/*
+ * Take the pair at position "pos" out of the summary before it's
+ * overwritten.
+ * If it holds an extremal value, we can't know the runner-up, so the
+ * summary is dropped and rebuilt on the next kdata_stat_get().
+ */
+static void
+kdata_stat_remove (struct kdata *d, size_t pos)
+{
+  struct kdatastat *st = &d->stat;
+  struct kpair kp;
+
+  if (0 == st->valid)
+    return;
+
+  kdata_pair_get (d, pos, &kp);
+  if (!kpair_vrfy (&kp))
+    {
+      st->ninval--;
+      return;
+    }
+
+  if (kp.x == st->min.x || kp.x == st->max.x ||
+      kp.y == st->min.y || kp.y == st->max.y)
+    {
+      st->valid = 0;
+      return;
+    }
+
+  st->xsum -= kp.x;
+  st->ysum -= kp.y;
+}
+
+/*
+ * Drop the cached summary and range index after the pairs were written
+ * other than by kdata_set().
+ */
+void
+kdata_invalidate (struct kdata *d)
+{
+  d->stat.valid = 0;
+  d->range.valid = 0;
+}
+
+/*
+ * Get the summary of the valid pairs, scanning them if it's not current.
+ * The summary is a cache, so we allow ourselves to modify it through
+ * the const pointer.
+ */
+const struct kdatastat *
+kdata_stat_get (const struct kdata *d)
+{
+  struct kdatastat *st = (struct kdatastat *)&d->stat;
+  struct kreduce r;
+  struct kpair kp;
+  size_t i;
+
+  if (0 != st->valid)
+    return(st);
+
+  /* Pair arrays go through the vector kernels. */
+  if (KDATA_COLUMN != d->type)
+    {
+      kpairs_reduce (d->pairs, d->pairsz, &r);
+      st->ninval = r.ninval;
+      st->min = r.min;
+      st->max = r.max;
+      st->xsum = r.sum.x;
+      st->ysum = r.sum.y;
+      st->valid = 1;
+      return(st);
+    }
+
+  memset (st, 0, sizeof(struct kdatastat));
+  for (i = 0; i < d->pairsz; i++)
+    {
+      kdata_pair_get (d, i, &kp);
+      if (!kpair_vrfy (&kp))
+        {
+          st->ninval++;
+          continue;
+        }
+
+      st->xsum += kp.x;
+      st->ysum += kp.y;
+
+      if (st->ninval == i)
+        {
+          st->min = st->max = kp;
+          continue;
+        }
+
+      if (kp.x < st->min.x)
+        st->min.x = kp.x;
+      if (kp.x > st->max.x)
+        st->max.x = kp.x;
+      if (kp.y < st->min.y)
+        st->min.y = kp.y;
+      if (kp.y > st->max.y)
+        st->max.y = kp.y;
+    }
+
+  st->valid = 1;
+  return(st);
+}
+
 /*
  * We've modified a value at (pair) position "pos".
  * Pass this through to the underlying functional sources, if any.
@@ -86,14 +259,13 @@ kdata_dep_run (struct kdata *data, size_t pos)
 {
   size_t i;
   int rc;
-  double x, y;
+  struct kpair kp;
 
-  x = data->pairs[pos].x;
-  y = data->pairs[pos].y;
+  kdata_pair_get (data, pos, &kp);
 
   for (rc = 1, i = 0; 0 != rc && i < data->depsz; i++)
     rc = data->deps[i].func
-           (data->deps[i].dep, pos, x, y);
+           (data->deps[i].dep, pos, kp.x, kp.y);
 
   return(rc);
 }
@@ -129,23 +301,31 @@ kdata_pmfvar (const struct kdata *data)
 {
   double ysum, mean, var;
   size_t i;
+  struct kpair kp;
 
   if (0 == data->pairsz)
     return(0.0);
 
   for (ysum = 0.0, i = 0; i < data->pairsz; i++)
-    ysum += data->pairs[i].y;
+    {
+      kdata_pair_get (data, i, &kp);
+      ysum += kp.y;
+    }
 
   if (ysum == 0.0)
     return(0.0);
 
   for (mean = 0.0, i = 0; i < data->pairsz; i++)
-    mean += data->pairs[i].y / ysum * data->pairs[i].x;
+    {
+      kdata_pair_get (data, i, &kp);
+      mean += kp.y / ysum * kp.x;
+    }
 
   for (var = 0.0, i = 0; i < data->pairsz; i++)
-    var += data->pairs[i].y / ysum *
-           (data->pairs[i].x - mean) *
-           (data->pairs[i].x - mean);
+    {
+      kdata_pair_get (data, i, &kp);
+      var += kp.y / ysum * (kp.x - mean) * (kp.x - mean);
+    }
 
   return(var);
 }
@@ -161,18 +341,25 @@ kdata_pmfmean (const struct kdata *data)
 {
   double ysum, sum;
   size_t i;
+  struct kpair kp;
 
   if (0 == data->pairsz)
     return(0.0);
 
   for (ysum = 0.0, i = 0; i < data->pairsz; i++)
-    ysum += data->pairs[i].y;
+    {
+      kdata_pair_get (data, i, &kp);
+      ysum += kp.y;
+    }
 
   if (ysum == 0.0)
     return(0.0);
 
   for (sum = 0.0, i = 0; i < data->pairsz; i++)
-    sum += data->pairs[i].y / ysum * data->pairs[i].x;
+    {
+      kdata_pair_get (data, i, &kp);
+      sum += kp.y / ysum * kp.x;
+    }
 
   return(sum);
 }
@@ -180,28 +367,46 @@ kdata_pmfmean (const struct kdata *data)
 double
 kdata_xmean (const struct kdata *data)
 {
+  const struct kdatastat *st;
   double sum;
   size_t i;
+  struct kpair kp;
 
   if (0 == data->pairsz)
     return(0.0);
 
+  st = kdata_stat_get (data);
+  if (0 == st->ninval)
+    return(st->xsum / (double)data->pairsz);
+
   for (sum = 0.0, i = 0; i < data->pairsz; i++)
-    sum += data->pairs[i].x;
+    {
+      kdata_pair_get (data, i, &kp);
+      sum += kp.x;
+    }
   return(sum / (double)data->pairsz);
 }
 
 double
 kdata_ymean (const struct kdata *data)
 {
+  const struct kdatastat *st;
   double sum;
   size_t i;
+  struct kpair kp;
 
   if (0 == data->pairsz)
     return(0.0);
 
+  st = kdata_stat_get (data);
+  if (0 == st->ninval)
+    return(st->ysum / (double)data->pairsz);
+
   for (sum = 0.0, i = 0; i < data->pairsz; i++)
-    sum += data->pairs[i].y;
+    {
+      kdata_pair_get (data, i, &kp);
+      sum += kp.y;
+    }
   return(sum / (double)data->pairsz);
 }
 
@@ -210,14 +415,24 @@ kdata_xstddev (const struct kdata *data)
 {
   double sum, mean;
   size_t i;
+  struct kpair kp, m;
 
   if (0 == data->pairsz)
     return(0.0);
 
   mean = kdata_xmean (data);
-  for (sum = 0.0, i = 0; i < data->pairsz; i++)
-    sum += (data->pairs[i].x - mean) *
-           (data->pairs[i].x - mean);
+  if (KDATA_COLUMN != data->type)
+    {
+      m.x = m.y = mean;
+      kpairs_sqdev (data->pairs, data->pairsz, &m, &kp);
+      sum = kp.x;
+    }
+  else
+    for (sum = 0.0, i = 0; i < data->pairsz; i++)
+      {
+        kdata_pair_get (data, i, &kp);
+        sum += (kp.x - mean) * (kp.x - mean);
+      }
   return(sqrt (sum / (double)data->pairsz));
 }
 
@@ -226,34 +441,64 @@ kdata_ystddev (const struct kdata *data)
 {
   double sum, mean;
   size_t i;
+  struct kpair kp, m;
 
   if (0 == data->pairsz)
     return(0.0);
 
-  mean = kdata_xmean (data);
-  for (sum = 0.0, i = 0; i < data->pairsz; i++)
-    sum += (data->pairs[i].y - mean) *
-           (data->pairs[i].y - mean);
+  mean = kdata_ymean (data);
+  if (KDATA_COLUMN != data->type)
+    {
+      m.x = m.y = mean;
+      kpairs_sqdev (data->pairs, data->pairsz, &m, &kp);
+      sum = kp.y;
+    }
+  else
+    for (sum = 0.0, i = 0; i < data->pairsz; i++)
+      {
+        kdata_pair_get (data, i, &kp);
+        sum += (kp.y - mean) * (kp.y - mean);
+      }
   return(sqrt (sum / (double)data->pairsz));
 }
 
 ssize_t
 kdata_xmax (const struct kdata *d, struct kpair *kp)
 {
+  const struct kdatastat *st;
   size_t i, max;
-  struct kpair pair;
+  struct kpair pair, cur;
 
   if (0 == d->pairsz)
     return(-1);
 
-  max = 0;
-  pair = d->pairs[max];
-  for (i = 1; i < d->pairsz; i++)
-    if (d->pairs[i].x > pair.x)
+  /*
+   * Without invalid pairs, the summary has the value: just look for
+   * where it first is.
+   */
+  st = kdata_stat_get (d);
+  if (0 == st->ninval)
+    for (i = 0; i < d->pairsz; i++)
       {
-        pair = d->pairs[i];
-        max = i;
+        kdata_pair_get (d, i, &cur);
+        if (cur.x != st->max.x)
+          continue;
+        if (NULL != kp)
+          *kp = cur;
+        return(i);
       }
+
+  max = 0;
+  kdata_pair_get (d, max, &pair);
+  for (i = 1; i < d->pairsz; i++)
+    {
+      kdata_pair_get (d, i, &cur);
+      if (cur.x > pair.x)
+        {
+          pair = cur;
+          max = i;
+        }
+    }
   if (NULL != kp)
     *kp = pair;
   return(max);
@@ -262,20 +507,40 @@ kdata_xmax (const struct kdata *d, struct kpair *kp)
 ssize_t
 kdata_xmin (const struct kdata *d, struct kpair *kp)
 {
+  const struct kdatastat *st;
   size_t i, min;
-  struct kpair pair;
+  struct kpair pair, cur;
 
   if (0 == d->pairsz)
     return(-1);
 
-  min = 0;
-  pair = d->pairs[min];
-  for (i = 1; i < d->pairsz; i++)
-    if (d->pairs[i].x < pair.x)
+  /*
+   * Without invalid pairs, the summary has the value: just look for
+   * where it first is.
+   */
+  st = kdata_stat_get (d);
+  if (0 == st->ninval)
+    for (i = 0; i < d->pairsz; i++)
       {
-        pair = d->pairs[i];
-        min = i;
+        kdata_pair_get (d, i, &cur);
+        if (cur.x != st->min.x)
+          continue;
+        if (NULL != kp)
+          *kp = cur;
+        return(i);
       }
+
+  min = 0;
+  kdata_pair_get (d, min, &pair);
+  for (i = 1; i < d->pairsz; i++)
+    {
+      kdata_pair_get (d, i, &cur);
+      if (cur.x < pair.x)
+        {
+          pair = cur;
+          min = i;
+        }
+    }
   if (NULL != kp)
     *kp = pair;
   return(min);
@@ -284,20 +549,40 @@ kdata_xmin (const struct kdata *d, struct kpair *kp)
 ssize_t
 kdata_ymax (const struct kdata *d, struct kpair *kp)
 {
+  const struct kdatastat *st;
   size_t i, max;
-  struct kpair pair;
+  struct kpair pair, cur;
 
   if (0 == d->pairsz)
     return(-1);
 
-  max = 0;
-  pair = d->pairs[max];
-  for (i = 1; i < d->pairsz; i++)
-    if (d->pairs[i].y > pair.y)
+  /*
+   * Without invalid pairs, the summary has the value: just look for
+   * where it first is.
+   */
+  st = kdata_stat_get (d);
+  if (0 == st->ninval)
+    for (i = 0; i < d->pairsz; i++)
       {
-        pair = d->pairs[i];
-        max = i;
+        kdata_pair_get (d, i, &cur);
+        if (cur.y != st->max.y)
+          continue;
+        if (NULL != kp)
+          *kp = cur;
+        return(i);
       }
+
+  max = 0;
+  kdata_pair_get (d, max, &pair);
+  for (i = 1; i < d->pairsz; i++)
+    {
+      kdata_pair_get (d, i, &cur);
+      if (cur.y > pair.y)
+        {
+          pair = cur;
+          max = i;
+        }
+    }
   if (NULL != kp)
     *kp = pair;
   return(max);
@@ -306,20 +591,40 @@ kdata_ymax (const struct kdata *d, struct kpair *kp)
 ssize_t
 kdata_ymin (const struct kdata *d, struct kpair *kp)
 {
+  const struct kdatastat *st;
   size_t i, min;
-  struct kpair pair;
+  struct kpair pair, cur;
 
   if (0 == d->pairsz)
     return(-1);
 
-  min = 0;
-  pair = d->pairs[min];
-  for (i = 1; i < d->pairsz; i++)
-    if (d->pairs[i].y < pair.y)
+  /*
+   * Without invalid pairs, the summary has the value: just look for
+   * where it first is.
+   */
+  st = kdata_stat_get (d);
+  if (0 == st->ninval)
+    for (i = 0; i < d->pairsz; i++)
       {
-        pair = d->pairs[i];
-        min = i;
+        kdata_pair_get (d, i, &cur);
+        if (cur.y != st->min.y)
+          continue;
+        if (NULL != kp)
+          *kp = cur;
+        return(i);
       }
+
+  min = 0;
+  kdata_pair_get (d, min, &pair);
+  for (i = 1; i < d->pairsz; i++)
+    {
+      kdata_pair_get (d, i, &cur);
+      if (cur.y < pair.y)
+        {
+          pair = cur;
+          min = i;
+        }
+    }
   if (NULL != kp)
     *kp = pair;
   return(min);
@@ -331,17 +636,25 @@ kdata_get (const struct kdata *d, size_t pos, struct kpair *kp)
   if (pos >= d->pairsz)
     return(0);
 
-  *kp = d->pairs[pos];
+  kdata_pair_get (d, pos, kp);
   return(1);
 }
 
 int
 kdata_set (struct kdata *d, size_t pos, double x, double y)
 {
-  if (pos >= d->pairsz)
+  /*
+   * Column sources are read-only views of the caller's buffers and
+   * rings only change at their ends.
+   */
+  if (KDATA_COLUMN == d->type || KDATA_RING == d->type ||
+      pos >= d->pairsz)
     return(0);
 
+  kdata_stat_remove (d, pos);
   d->pairs[pos].x = x;
   d->pairs[pos].y = y;
+  kdata_stat_add (d, pos);
+  d->range.valid = 0;
   return(d->depsz ? kdata_dep_run (d, pos) : 1);
 }
@@ -0,0 +1,417 @@
+/*      $Id$ */
+/*
+ * Copyright (c) 2015 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "compat.h"
+
+#include <assert.h>
+#include <cairo.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Vector kernels are only built for x86-64, where SSE2 is always there
+ * and AVX2 can be compiled per function and selected at runtime.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+# define KERNEL_X86 1
+# include <immintrin.h>
+#endif
+
+#include "kplot.h"
+#include "extern.h"
+
+struct  kkernels {
+  void (*reduce)(const struct kpair *, size_t, struct kreduce *);
+  void (*sqdev)(const struct kpair *, size_t,
+                const struct kpair *, struct kpair *);
+  size_t (*to_real)(const struct kpair *, size_t, struct kpair *,
+                    const struct kpair *, const struct kpair *);
+};
+
+static void
+kpairs_reduce_scalar (const struct kpair *p, size_t sz, struct kreduce *r)
+{
+  size_t i;
+
+  memset (r, 0, sizeof(struct kreduce));
+  for (i = 0; i < sz; i++)
+    {
+      if (!kpair_vrfy (&p[i]))
+        {
+          r->ninval++;
+          continue;
+        }
+      r->sum.x += p[i].x;
+      r->sum.y += p[i].y;
+      if (r->ninval == i)
+        {
+          r->min = r->max = p[i];
+          continue;
+        }
+      if (p[i].x < r->min.x)
+        r->min.x = p[i].x;
+      if (p[i].x > r->max.x)
+        r->max.x = p[i].x;
+      if (p[i].y < r->min.y)
+        r->min.y = p[i].y;
+      if (p[i].y > r->max.y)
+        r->max.y = p[i].y;
+    }
+}
+
+static void
+kpairs_sqdev_scalar (const struct kpair *p, size_t sz,
+                     const struct kpair *mean, struct kpair *out)
+{
+  size_t i;
+
+  out->x = out->y = 0.0;
+  for (i = 0; i < sz; i++)
+    {
+      out->x += (p[i].x - mean->x) * (p[i].x - mean->x);
+      out->y += (p[i].y - mean->y) * (p[i].y - mean->y);
+    }
+}
+
+static size_t
+kpairs_to_real_scalar (const struct kpair *p, size_t sz,
+                       struct kpair *out, const struct kpair *scale,
+                       const struct kpair *offs)
+{
+  size_t i, j;
+
+  for (i = j = 0; i < sz; i++)
+    {
+      if (!kpair_vrfy (&p[i]))
+        continue;
+      out[j].x = p[i].x * scale->x + offs->x;
+      out[j].y = p[i].y * scale->y + offs->y;
+      j++;
+    }
+
+  return(j);
+}
+
+static const struct kkernels kernels_scalar = {
+  kpairs_reduce_scalar,
+  kpairs_sqdev_scalar,
+  kpairs_to_real_scalar
+};
+
+#ifdef KERNEL_X86
+
+/*
+ * Lanes of "v" that kpair_vrfy() would accept: zero, or normal.
+ */
+static inline __m128d
+kvalid_sse2 (__m128d v)
+{
+  const __m128d a = _mm_andnot_pd (_mm_set1_pd (-0.0), v);
+
+  return(_mm_or_pd (_mm_cmpeq_pd (v, _mm_setzero_pd ()),
+                    _mm_and_pd (_mm_cmpge_pd (a, _mm_set1_pd (DBL_MIN)),
+                                _mm_cmple_pd (a, _mm_set1_pd (DBL_MAX)))));
+}
+
+/*
+ * Both lanes set if the whole pair "v" is valid, none otherwise.
+ */
+static inline __m128d
+kpairvalid_sse2 (__m128d v)
+{
+  __m128d ok = kvalid_sse2 (v);
+
+  return(_mm_and_pd (ok, _mm_shuffle_pd (ok, ok, 1)));
+}
+
+static void
+kpairs_reduce_sse2 (const struct kpair *p, size_t sz, struct kreduce *r)
+{
+  const __m128d inf = _mm_set1_pd (HUGE_VAL);
+  const __m128d ninf = _mm_set1_pd (-HUGE_VAL);
+  __m128d v, ok, vmin = inf, vmax = ninf,
+          vsum = _mm_setzero_pd ();
+  size_t i, bad = 0;
+
+  for (i = 0; i < sz; i++)
+    {
+      v = _mm_loadu_pd (&p[i].x);
+      ok = kpairvalid_sse2 (v);
+      bad += 3 != _mm_movemask_pd (ok);
+      vmin = _mm_min_pd (vmin, _mm_or_pd (_mm_and_pd (ok, v),
+                                          _mm_andnot_pd (ok, inf)));
+      vmax = _mm_max_pd (vmax, _mm_or_pd (_mm_and_pd (ok, v),
+                                          _mm_andnot_pd (ok, ninf)));
+      vsum = _mm_add_pd (vsum, _mm_and_pd (ok, v));
+    }
+
+  memset (r, 0, sizeof(struct kreduce));
+  r->ninval = bad;
+  if (bad == sz)
+    return;
+  _mm_storeu_pd (&r->min.x, vmin);
+  _mm_storeu_pd (&r->max.x, vmax);
+  _mm_storeu_pd (&r->sum.x, vsum);
+}
+
+static void
+kpairs_sqdev_sse2 (const struct kpair *p, size_t sz,
+                   const struct kpair *mean, struct kpair *out)
+{
+  const __m128d m = _mm_loadu_pd (&mean->x);
+  __m128d d, acc = _mm_setzero_pd ();
+  size_t i;
+
+  for (i = 0; i < sz; i++)
+    {
+      d = _mm_sub_pd (_mm_loadu_pd (&p[i].x), m);
+      acc = _mm_add_pd (acc, _mm_mul_pd (d, d));
+    }
+
+  _mm_storeu_pd (&out->x, acc);
+}
+
+static size_t
+kpairs_to_real_sse2 (const struct kpair *p, size_t sz,
+                     struct kpair *out, const struct kpair *scale,
+                     const struct kpair *offs)
+{
+  const __m128d s = _mm_loadu_pd (&scale->x);
+  const __m128d o = _mm_loadu_pd (&offs->x);
+  __m128d v;
+  size_t i, j;
+
+  /* Always store, but only move on past valid pairs. */
+  for (i = j = 0; i < sz; i++)
+    {
+      v = _mm_loadu_pd (&p[i].x);
+      _mm_storeu_pd (&out[j].x, _mm_add_pd (_mm_mul_pd (v, s), o));
+      j += 3 == _mm_movemask_pd (kpairvalid_sse2 (v));
+    }
+
+  return(j);
+}
+
+static const struct kkernels kernels_sse2 = {
+  kpairs_reduce_sse2,
+  kpairs_sqdev_sse2,
+  kpairs_to_real_sse2
+};
+
+/*
+ * The AVX2 kernels take two pairs at a time, finishing odd lengths
+ * with the SSE2 ones.
+ */
+
+__attribute__((target("avx2")))
+static inline __m256d
+kpairvalid_avx2 (__m256d v)
+{
+  const __m256d a = _mm256_andnot_pd (_mm256_set1_pd (-0.0), v);
+  __m256d ok;
+
+  ok = _mm256_or_pd
+         (_mm256_cmp_pd (v, _mm256_setzero_pd (), _CMP_EQ_OQ),
+         _mm256_and_pd
+           (_mm256_cmp_pd (a, _mm256_set1_pd (DBL_MIN), _CMP_GE_OQ),
+           _mm256_cmp_pd (a, _mm256_set1_pd (DBL_MAX), _CMP_LE_OQ)));
+
+  /* Swap x and y within each pair. */
+  return(_mm256_and_pd (ok, _mm256_permute_pd (ok, 0x5)));
+}
+
+__attribute__((target("avx2")))
+static void
+kpairs_reduce_avx2 (const struct kpair *p, size_t sz, struct kreduce *r)
+{
+  const __m256d inf = _mm256_set1_pd (HUGE_VAL);
+  const __m256d ninf = _mm256_set1_pd (-HUGE_VAL);
+  __m256d v, ok, vmin = inf, vmax = ninf,
+          vsum = _mm256_setzero_pd ();
+  __m128d lmin, lmax, lsum;
+  struct kreduce tail;
+  size_t i, bad = 0;
+  int m;
+
+  for (i = 0; i + 1 < sz; i += 2)
+    {
+      v = _mm256_loadu_pd (&p[i].x);
+      ok = kpairvalid_avx2 (v);
+      m = _mm256_movemask_pd (ok);
+      bad += (0 == (m & 0x1)) + (0 == (m & 0x4));
+      vmin = _mm256_min_pd (vmin, _mm256_blendv_pd (inf, v, ok));
+      vmax = _mm256_max_pd (vmax, _mm256_blendv_pd (ninf, v, ok));
+      vsum = _mm256_add_pd (vsum, _mm256_and_pd (ok, v));
+    }
+
+  lmin = _mm_min_pd (_mm256_castpd256_pd128 (vmin),
+                     _mm256_extractf128_pd (vmin, 1));
+  lmax = _mm_max_pd (_mm256_castpd256_pd128 (vmax),
+                     _mm256_extractf128_pd (vmax, 1));
+  lsum = _mm_add_pd (_mm256_castpd256_pd128 (vsum),
+                     _mm256_extractf128_pd (vsum, 1));
+
+  if (i < sz)
+    {
+      kpairs_reduce_sse2 (&p[i], sz - i, &tail);
+      bad += tail.ninval;
+      if (0 == tail.ninval)
+        {
+          lmin = _mm_min_pd (lmin, _mm_loadu_pd (&tail.min.x));
+          lmax = _mm_max_pd (lmax, _mm_loadu_pd (&tail.max.x));
+          lsum = _mm_add_pd (lsum, _mm_loadu_pd (&tail.sum.x));
+        }
+    }
+
+  memset (r, 0, sizeof(struct kreduce));
+  r->ninval = bad;
+  if (bad == sz)
+    return;
+  _mm_storeu_pd (&r->min.x, lmin);
+  _mm_storeu_pd (&r->max.x, lmax);
+  _mm_storeu_pd (&r->sum.x, lsum);
+}
+
+__attribute__((target("avx2")))
+static void
+kpairs_sqdev_avx2 (const struct kpair *p, size_t sz,
+                   const struct kpair *mean, struct kpair *out)
+{
+  const __m256d m = _mm256_setr_pd (mean->x, mean->y, mean->x, mean->y);
+  __m256d d, acc = _mm256_setzero_pd ();
+  __m128d lacc;
+  struct kpair tail;
+  size_t i;
+
+  for (i = 0; i + 1 < sz; i += 2)
+    {
+      d = _mm256_sub_pd (_mm256_loadu_pd (&p[i].x), m);
+      acc = _mm256_add_pd (acc, _mm256_mul_pd (d, d));
+    }
+
+  lacc = _mm_add_pd (_mm256_castpd256_pd128 (acc),
+                     _mm256_extractf128_pd (acc, 1));
+
+  if (i < sz)
+    {
+      kpairs_sqdev_sse2 (&p[i], sz - i, mean, &tail);
+      lacc = _mm_add_pd (lacc, _mm_loadu_pd (&tail.x));
+    }
+
+  _mm_storeu_pd (&out->x, lacc);
+}
+
+__attribute__((target("avx2")))
+static size_t
+kpairs_to_real_avx2 (const struct kpair *p, size_t sz,
+                     struct kpair *out, const struct kpair *scale,
+                     const struct kpair *offs)
+{
+  const __m256d s = _mm256_setr_pd (scale->x, scale->y,
+                                    scale->x, scale->y);
+  const __m256d o = _mm256_setr_pd (offs->x, offs->y,
+                                    offs->x, offs->y);
+  __m256d v, t;
+  size_t i, j;
+  int m;
+
+  for (i = j = 0; i + 1 < sz; i += 2)
+    {
+      v = _mm256_loadu_pd (&p[i].x);
+      t = _mm256_add_pd (_mm256_mul_pd (v, s), o);
+      m = _mm256_movemask_pd (kpairvalid_avx2 (v));
+      _mm_storeu_pd (&out[j].x, _mm256_castpd256_pd128 (t));
+      j += 0 != (m & 0x1);
+      _mm_storeu_pd (&out[j].x, _mm256_extractf128_pd (t, 1));
+      j += 0 != (m & 0x4);
+    }
+
+  if (i < sz)
+    j += kpairs_to_real_sse2 (&p[i], sz - i, &out[j], scale, offs);
+
+  return(j);
+}
+
+static const struct kkernels kernels_avx2 = {
+  kpairs_reduce_avx2,
+  kpairs_sqdev_avx2,
+  kpairs_to_real_avx2
+};
+
+#endif /* KERNEL_X86 */
+
+/*
+ * Pick the widest kernels the CPU runs, once.
+ * Plots may be drawn from several threads, hence the atomics.
+ */
+static const struct kkernels *
+kkernels_get (void)
+{
+#ifdef KERNEL_X86
+  static const struct kkernels *k;
+  const struct kkernels *p;
+
+  if (NULL != (p = __atomic_load_n (&k, __ATOMIC_ACQUIRE)))
+    return(p);
+
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    p = &kernels_avx2;
+  else if (__builtin_cpu_supports ("sse2"))
+    p = &kernels_sse2;
+  else
+    p = &kernels_scalar;
+  __atomic_store_n (&k, p, __ATOMIC_RELEASE);
+  return(p);
+#else
+  return(&kernels_scalar);
+#endif
+}
+
+/*
+ * Reduce the valid pairs (see kpair_vrfy()) of "p": count the invalid
+ * ones and get the minimum, maximum, and sum of the others.
+ * If there are no valid pairs, these are all zero.
+ */
+void
+kpairs_reduce (const struct kpair *p, size_t sz, struct kreduce *r)
+{
+  kkernels_get ()->reduce (p, sz, r);
+}
+
+/*
+ * Sum the squared deviations of all pairs from "mean".
+ */
+void
+kpairs_sqdev (const struct kpair *p, size_t sz,
+              const struct kpair *mean, struct kpair *out)
+{
+  kkernels_get ()->sqdev (p, sz, mean, out);
+}
+
+/*
+ * Map the valid pairs of "p" with the affine transform "scale" and
+ * "offs", packing them into "out", which must hold "sz" pairs.
+ * Returns the number of pairs written.
+ */
+size_t
+kpairs_to_real (const struct kpair *p, size_t sz, struct kpair *out,
+                const struct kpair *scale, const struct kpair *offs)
+{
+  return(kkernels_get ()->to_real (p, sz, out, scale, offs));
+}
@@ -47,6 +47,7 @@ kplotdat_free (struct kplotdat *p)
   free (p->datas);
   free (p->cfgs);
   free (p->types);
+  free (p->smthpairs);
 }
 
 struct kplot *
@@ -117,6 +118,30 @@ kplot_get_plotcfg (struct kplot *p)
   return(&p->cfg);
 }
 
+/*
+ * Get the data area of the last drawing of the plot, in the user space
+ * it was drawn in, and the range of data it spans.
+ * This lets callers map between pointer positions and data values.
+ * Returns zero if the plot hasn't been drawn yet.
+ */
+int
+kplot_get_area (const struct kplot *p, struct kpair *offs,
+                struct kpair *dims, struct kpair *minv, struct kpair *maxv)
+{
+  if (0 == p->area.valid)
+    return(0);
+
+  if (NULL != offs)
+    *offs = p->area.offs;
+  if (NULL != dims)
+    *dims = p->area.dims;
+  if (NULL != minv)
+    *minv = p->area.minv;
+  if (NULL != maxv)
+    *maxv = p->area.maxv;
+  return(1);
+}
+
 static void
 kplot_data_remove_all (struct kplot *p)
 {
@@ -267,6 +292,7 @@ kplotdat_attach (struct kplot *p, size_t sz, struct kdata **d,
       d[i]->refs++;
     }
 
+  p->datas[p->datasz].smthpairs = NULL;
   p->datas[p->datasz].smthtype = smthtype;
   if (NULL != smth)
     {
@@ -320,9 +346,16 @@ kplot_attach_datas (struct kplot *p, size_t sz,
                     struct kdata **d, const enum kplottype *t,
                     const struct kdatacfg *const *cfg, enum kplotstype st)
 {
+  size_t i;
+
   if (sz < 2)
     return(0);
 
+  /* Error plots read the pairs of both sources in lock-step. */
+  for (i = 0; i < sz; i++)
+    if (KDATA_COLUMN == d[i]->type)
+      return(0);
+
   return(kplotdat_attach (p, sz, d,
                           cfg, t, st, KSMOOTH_NONE, NULL));
 }
@@ -27,7 +27,8 @@ enum    kplottype {
   KPLOT_MARKS,
   KPLOT_LINES,
   KPLOT_LINESPOINTS,
-  KPLOT_LINESMARKS
+  KPLOT_LINESMARKS,
+  KPLOT_AREA
 };
 
 enum    ksmthtype {
@@ -161,6 +162,7 @@ struct  kplotcfg {
 #define EXTREMA_XMAX      0x02
 #define EXTREMA_YMIN      0x04
 #define EXTREMA_YMAX      0x08
+#define EXTREMA_YVIEW     0x10
   unsigned int extrema;
   double extrema_xmin;
   double extrema_xmax;
@@ -191,6 +193,12 @@ int              kdata_bucket_set (struct kdata *, size_t, double, double);
 struct kdata    *kdata_buffer_alloc (size_t);
 int              kdata_buffer_copy (struct kdata *, const struct kdata *);
 
+struct kdata    *kdata_column_alloc (const double *, size_t,
+                                     const double *, size_t, size_t,
+                                     void (*)(void *), void *);
+struct kdata    *kdata_column_alloc_pairs (const struct kpair *, size_t,
+                                           void (*)(void *), void *);
+
 int              kdata_hist_add (struct kdata *, double, double);
 struct kdata    *kdata_hist_alloc (double, double, size_t);
 int              kdata_hist_set (struct kdata *, double, double);
@@ -198,6 +206,10 @@ int              kdata_hist_set (struct kdata *, double, double);
 struct kdata    *kdata_mean_alloc (struct kdata *);
 int              kdata_mean_attach (struct kdata *, struct kdata *);
 
+struct kdata    *kdata_ring_alloc (size_t);
+int              kdata_ring_pop (struct kdata *);
+int              kdata_ring_push (struct kdata *, double, double);
+
 struct kdata    *kdata_stddev_alloc (struct kdata *);
 int              kdata_stddev_attach (struct kdata *, struct kdata *);
 
@@ -212,12 +224,17 @@ double           kdata_pmfstddev (const struct kdata *);
 ssize_t          kdata_xmax (const struct kdata *, struct kpair *);
 double           kdata_xmean (const struct kdata *);
 ssize_t          kdata_xmin (const struct kdata *, struct kpair *);
+size_t           kdata_xindex (const struct kdata *, double);
 
 double           kdata_xstddev (const struct kdata *);
 ssize_t          kdata_ymax (const struct kdata *, struct kpair *);
 double           kdata_ymean (const struct kdata *);
 double           kdata_ystddev (const struct kdata *);
 ssize_t          kdata_ymin (const struct kdata *, struct kpair *);
+int              kdata_yrange (const struct kdata *, size_t, size_t,
+                               double *, double *);
+int              kdata_yrange_x (const struct kdata *, double, double,
+                                 double *, double *);
 
 void             kdatacfg_defaults (struct kdatacfg *);
 void             kplotcfg_defaults (struct kplotcfg *);
@@ -235,10 +252,16 @@ int              kplot_attach_datas (struct kplot *, size_t,
                                      struct kdata **, const enum kplottype *,
                                      const struct kdatacfg *const *, enum kplotstype);
 void             kplot_draw (struct kplot *, double, double, cairo_t *);
+int              kplot_draw_tiles (struct kplot *, double, double, cairo_t *,
+                                   size_t, void (*)(void (*)(void *), void **,
+                                                    size_t, void *), void *);
 void             kplot_free (struct kplot *);
 int              kplot_get_datacfg (struct kplot *, size_t,
                                     struct kdatacfg **, size_t *);
 struct kplotcfg *kplot_get_plotcfg (struct kplot *);
+int              kplot_get_area (const struct kplot *, struct kpair *,
+                                 struct kpair *, struct kpair *,
+                                 struct kpair *);
 
 
 __END_DECLS
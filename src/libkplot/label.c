@@ -21,17 +21,162 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "kplot.h"
 #include "extern.h"
 
+/*
+ * Whether the label was measured with the font "font" and the user
+ * matrix "mtx".
+ */
+static int
+klabel_font_eq (const struct klabel *l,
+                const struct kplotfont *font, const double *mtx)
+{
+  size_t i;
+
+  if (l->sz != font->sz ||
+      l->slant != font->slant ||
+      l->weight != font->weight)
+    return(0);
+
+  for (i = 0; i < 4; i++)
+    if (l->mtx[i] != mtx[i])
+      return(0);
+
+  return(0 == strcmp (l->family, font->family));
+}
+
+/*
+ * Look up the label with the text "str", or, if "fmtd", the one
+ * formatted from "v" by "fmt", in the currently selected font "font".
+ * On a miss, the least recently used slot is cleared, keyed with the
+ * font and returned with "used" still zero.
+ * Fonts with an unusual family are never cached: the scratch label is
+ * returned instead.
+ */
+static struct klabel *
+klabel_lookup (struct kplotctx *ctx, const struct kplotfont *font,
+               const char *str, int fmtd, double v,
+               void (*fmt)(double, char *, size_t))
+{
+  struct klabelcache *c = ctx->labels;
+  struct klabel   *l, *lru;
+  cairo_matrix_t m;
+  double mtx[4];
+  size_t i;
+
+  if (NULL == font->family ||
+      strlen (font->family) >= sizeof(c->scratch.family))
+    {
+      memset (&c->scratch, 0, sizeof(struct klabel));
+      return(&c->scratch);
+    }
+
+  cairo_get_matrix (ctx->cr, &m);
+  mtx[0] = m.xx;
+  mtx[1] = m.yx;
+  mtx[2] = m.xy;
+  mtx[3] = m.yy;
+
+  for (lru = l = c->labels, i = 0; i < KLABEL_MAX; i++, l++)
+    {
+      if (l->used < lru->used)
+        lru = l;
+      if (0 == l->used || l->fmtd != fmtd)
+        continue;
+      if (fmtd ? (l->v != v || l->fmt != fmt) :
+          0 != strcmp (l->str, str))
+        continue;
+      if (!klabel_font_eq (l, font, mtx))
+        continue;
+      l->used = ++c->used;
+      return(l);
+    }
+
+  l = lru;
+  memset (l, 0, sizeof(struct klabel));
+  snprintf (l->family, sizeof(l->family), "%s", font->family);
+  l->sz = font->sz;
+  l->slant = font->slant;
+  l->weight = font->weight;
+  memcpy (l->mtx, mtx, sizeof(mtx));
+  return(l);
+}
+
+/*
+ * Measure a label klabel_lookup() didn't find, its text being set, and
+ * mark it used.
+ */
+static void
+klabel_measure (struct kplotctx *ctx, struct klabel *l)
+{
+  cairo_text_extents (ctx->cr, l->str, &l->e);
+  if (l != &ctx->labels->scratch)
+    l->used = ++ctx->labels->used;
+}
+
+/*
+ * Get the tic label for value "v": formatted with "fmt", if not NULL,
+ * or "%g" otherwise, and measured in the selected font "font".
+ * The result is only valid until the next label is requested.
+ */
+static const struct klabel *
+kplotctx_ticlabel (struct kplotctx *ctx, const struct kplotfont *font,
+                   double v, void (*fmt)(double, char *, size_t))
+{
+  struct klabel   *l;
+
+  l = klabel_lookup (ctx, font, NULL, 1, v, fmt);
+  if (0 != l->used)
+    return(l);
+
+  l->fmtd = 1;
+  l->v = v;
+  l->fmt = fmt;
+  if (NULL == fmt)
+    snprintf (l->str, sizeof(l->str), "%g", v);
+  else
+    (*fmt)(v, l->str, sizeof(l->str));
+
+  klabel_measure (ctx, l);
+  return(l);
+}
+
+/*
+ * Get the extents of the text "v" in the selected font "font".
+ * Texts too long for the cache are measured every time.
+ */
+static void
+kplotctx_text_extents (struct kplotctx *ctx, const struct kplotfont *font,
+                       const char *v, cairo_text_extents_t *e)
+{
+  struct klabel   *l;
+
+  if (strlen (v) >= sizeof(l->str))
+    {
+      cairo_text_extents (ctx->cr, v, e);
+      return;
+    }
+
+  l = klabel_lookup (ctx, font, v, 0, 0.0, NULL);
+  if (0 == l->used)
+    {
+      snprintf (l->str, sizeof(l->str), "%s", v);
+      klabel_measure (ctx, l);
+    }
+
+  *e = l->e;
+}
+
 static void
 bbox_extents (struct kplotctx *ctx, const char *v,
               double *h, double *w, double rot)
 {
   cairo_text_extents_t e;
 
-  cairo_text_extents (ctx->cr, v, &e);
+  kplotctx_text_extents (ctx, &ctx->cfg.axislabelfont, v, &e);
   *h = fabs (e.width * sin (rot)) + fabs (e.height * cos (rot));
   *w = fabs (e.width * cos (rot)) + fabs (e.height * sin (rot));
 }
@@ -39,7 +184,7 @@ bbox_extents (struct kplotctx *ctx, const char *v,
 void
 kplotctx_label_init (struct kplotctx *ctx)
 {
-  char buf[128];
+  const struct klabel *l;
   size_t i;
   cairo_text_extents_t e;
   double maxh, maxw, offs, lastx,
@@ -59,18 +204,12 @@ kplotctx_label_init (struct kplotctx *ctx)
       offs = 1 == ctx->cfg.xtics ? 0.5 :
              i / (double)(ctx->cfg.xtics - 1);
 
-      /* Call out to xformat function. */
-      if (NULL == ctx->cfg.xticlabelfmt)
-        snprintf (buf, sizeof(buf), "%g",
-                  ctx->minv.x + offs *
-                  (ctx->maxv.x - ctx->minv.x));
-      else
-        (*ctx->cfg.xticlabelfmt)
-          (ctx->minv.x + offs *
-          (ctx->maxv.x - ctx->minv.x),
-          buf, sizeof(buf));
-
-      cairo_text_extents (ctx->cr, buf, &e);
+      /* Call out to xformat function, unless cached. */
+      l = kplotctx_ticlabel (ctx, &ctx->cfg.ticlabelfont,
+                             ctx->minv.x + offs *
+                             (ctx->maxv.x - ctx->minv.x),
+                             ctx->cfg.xticlabelfmt);
+      e = l->e;
 
       /*
        * Important: if we're on the last x-axis value, then
@@ -105,17 +244,11 @@ kplotctx_label_init (struct kplotctx *ctx)
       offs = 1 == ctx->cfg.ytics ? 0.5 :
              i / (double)(ctx->cfg.ytics - 1);
 
-      if (NULL == ctx->cfg.yticlabelfmt)
-        snprintf (buf, sizeof(buf), "%g",
-                  ctx->minv.y + offs *
-                  (ctx->maxv.y - ctx->minv.y));
-      else
-        (*ctx->cfg.yticlabelfmt)
-          (ctx->minv.y + offs *
-          (ctx->maxv.y - ctx->minv.y),
-          buf, sizeof(buf));
-
-      cairo_text_extents (ctx->cr, buf, &e);
+      l = kplotctx_ticlabel (ctx, &ctx->cfg.ticlabelfont,
+                             ctx->minv.y + offs *
+                             (ctx->maxv.y - ctx->minv.y),
+                             ctx->cfg.yticlabelfmt);
+      e = l->e;
 
       /*
        * If we're the first or last tic label, record our
@@ -235,17 +368,11 @@ kplotctx_label_init (struct kplotctx *ctx)
       offs = 1 == ctx->cfg.xtics ? 0.5 :
              i / (double)(ctx->cfg.xtics - 1);
 
-      if (NULL == ctx->cfg.xticlabelfmt)
-        snprintf (buf, sizeof(buf), "%g",
-                  ctx->minv.x + offs *
-                  (ctx->maxv.x - ctx->minv.x));
-      else
-        (*ctx->cfg.xticlabelfmt)
-          (ctx->minv.x + offs *
-          (ctx->maxv.x - ctx->minv.x),
-          buf, sizeof(buf));
-
-      cairo_text_extents (ctx->cr, buf, &e);
+      l = kplotctx_ticlabel (ctx, &ctx->cfg.ticlabelfont,
+                             ctx->minv.x + offs *
+                             (ctx->maxv.x - ctx->minv.x),
+                             ctx->cfg.xticlabelfmt);
+      e = l->e;
 
       if (TICLABEL_BOTTOM & ctx->cfg.ticlabel)
         {
@@ -269,7 +396,7 @@ kplotctx_label_init (struct kplotctx *ctx)
                            ctx->offs.y + ctx->dims.y +
                            maxh + ctx->cfg.xticlabelpad);
 
-          cairo_show_text (ctx->cr, buf);
+          cairo_show_text (ctx->cr, l->str);
           if (ctx->cfg.xticlabelrot > 0.0)
             cairo_restore (ctx->cr);
         }
@@ -280,7 +407,7 @@ kplotctx_label_init (struct kplotctx *ctx)
                          ctx->offs.x + offs * ctx->dims.x -
                          (e.width / 2.0),
                          ctx->offs.y - maxh);
-          cairo_show_text (ctx->cr, buf);
+          cairo_show_text (ctx->cr, l->str);
         }
     }
 
@@ -290,17 +417,11 @@ kplotctx_label_init (struct kplotctx *ctx)
       offs = 1 == ctx->cfg.ytics ? 0.5 :
              i / (double)(ctx->cfg.ytics - 1);
 
-      if (NULL == ctx->cfg.yticlabelfmt)
-        snprintf (buf, sizeof(buf), "%g",
-                  ctx->minv.y + offs *
-                  (ctx->maxv.y - ctx->minv.y));
-      else
-        (*ctx->cfg.yticlabelfmt)
-          (ctx->minv.y + offs *
-          (ctx->maxv.y - ctx->minv.y),
-          buf, sizeof(buf));
-
-      cairo_text_extents (ctx->cr, buf, &e);
+      l = kplotctx_ticlabel (ctx, &ctx->cfg.ticlabelfont,
+                             ctx->minv.y + offs *
+                             (ctx->maxv.y - ctx->minv.y),
+                             ctx->cfg.yticlabelfmt);
+      e = l->e;
 
       if (TICLABEL_LEFT & ctx->cfg.ticlabel)
         {
@@ -310,7 +431,7 @@ kplotctx_label_init (struct kplotctx *ctx)
                          (ctx->offs.y + ctx->dims.y) -
                          (offs * ctx->dims.y) +
                          (e.height / 2.0));
-          cairo_show_text (ctx->cr, buf);
+          cairo_show_text (ctx->cr, l->str);
         }
       if (TICLABEL_RIGHT & ctx->cfg.ticlabel)
         {
@@ -320,7 +441,7 @@ kplotctx_label_init (struct kplotctx *ctx)
                          (ctx->offs.y + ctx->dims.y) -
                          (offs * ctx->dims.y) +
                          (e.height / 2.0));
-          cairo_show_text (ctx->cr, buf);
+          cairo_show_text (ctx->cr, l->str);
         }
     }
 
@@ -341,7 +462,8 @@ kplotctx_label_init (struct kplotctx *ctx)
                        (MARGIN_BOTTOM & ctx->cfg.margin ?
                         ctx->h - ctx->cfg.marginsz : ctx->h) - h / 2.0);
       cairo_rotate (ctx->cr, ctx->cfg.xaxislabelrot);
-      cairo_text_extents (ctx->cr, ctx->cfg.xaxislabel, &e);
+      kplotctx_text_extents (ctx, &ctx->cfg.axislabelfont,
+                             ctx->cfg.xaxislabel, &e);
       w = -e.width / 2.0;
       h = e.height / 2.0;
       cairo_translate (ctx->cr, w, h);
@@ -360,7 +482,8 @@ kplotctx_label_init (struct kplotctx *ctx)
                        (MARGIN_TOP & ctx->cfg.margin ?
                         ctx->cfg.marginsz : 0.0) + h / 2.0);
       cairo_rotate (ctx->cr, ctx->cfg.xaxislabelrot);
-      cairo_text_extents (ctx->cr, ctx->cfg.x2axislabel, &e);
+      kplotctx_text_extents (ctx, &ctx->cfg.axislabelfont,
+                             ctx->cfg.x2axislabel, &e);
       w = -e.width / 2.0;
       h = e.height / 2.0;
       cairo_translate (ctx->cr, w, h);
@@ -379,7 +502,8 @@ kplotctx_label_init (struct kplotctx *ctx)
                         ctx->cfg.marginsz : 0.0) + w / 2.0,
                        ctx->offs.y + ctx->dims.y / 2.0);
       cairo_rotate (ctx->cr, ctx->cfg.yaxislabelrot);
-      cairo_text_extents (ctx->cr, ctx->cfg.yaxislabel, &e);
+      kplotctx_text_extents (ctx, &ctx->cfg.axislabelfont,
+                             ctx->cfg.yaxislabel, &e);
       w = -e.width / 2.0;
       h = e.height / 2.0;
       cairo_translate (ctx->cr, w, h);
@@ -398,7 +522,8 @@ kplotctx_label_init (struct kplotctx *ctx)
                         ctx->w - ctx->cfg.marginsz : ctx->w) - w / 2.0,
                        ctx->offs.y + ctx->dims.y / 2.0);
       cairo_rotate (ctx->cr, ctx->cfg.yaxislabelrot);
-      cairo_text_extents (ctx->cr, ctx->cfg.y2axislabel, &e);
+      kplotctx_text_extents (ctx, &ctx->cfg.axislabelfont,
+                             ctx->cfg.y2axislabel, &e);
       w = -e.width / 2.0;
       h = e.height / 2.0;
       cairo_translate (ctx->cr, w, h);
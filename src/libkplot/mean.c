@@ -74,6 +74,14 @@ kdata_mean_alloc (struct kdata *dep)
   struct kdata    *d;
   size_t i;
 
+  /*
+   * Column sources are never modified, so we'd never be updated, and
+   * ring positions shift as the oldest pairs go away.
+   */
+  if (NULL != dep &&
+      (KDATA_COLUMN == dep->type || KDATA_RING == dep->type))
+    return(NULL);
+
   if (NULL == (d = calloc (1, sizeof(struct kdata))))
     return(NULL);
 
@@ -109,6 +117,10 @@ kdata_mean_attach (struct kdata *d, struct kdata *dep)
   if (KDATA_MEAN != d->type)
     return(0);
 
+  if (NULL != dep &&
+      (KDATA_COLUMN == dep->type || KDATA_RING == dep->type))
+    return(0);
+
   if (NULL == dep)
     return(1);
 
@@ -134,6 +146,7 @@ kdata_mean_attach (struct kdata *d, struct kdata *dep)
       d->pairsz = dep->pairsz;
       for (i = 0; i < dep->pairsz; i++)
         d->pairs[i].x = dep->pairs[i].x;
+      kdata_invalidate (d);
     }
 
   kdata_dep_add (d, dep, kdata_mean_set);
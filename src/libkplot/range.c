@@ -0,0 +1,242 @@
+/*      $Id$ */
+/*
+ * Copyright (c) 2015 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "compat.h"
+
+#include <assert.h>
+#include <cairo.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kplot.h"
+#include "extern.h"
+
+/*
+ * Fold the ordinates of the valid pairs in [pos, pos + sz) into "min"
+ * and "max".
+ */
+static void
+krange_scan (const struct kdata *d, size_t pos, size_t sz,
+             double *min, double *max)
+{
+  struct kreduce r;
+  struct kpair kp;
+  size_t i;
+
+  if (0 == sz)
+    return;
+
+  /* Pair arrays go through the vector kernels. */
+  if (KDATA_COLUMN != d->type)
+    {
+      kpairs_reduce (&d->pairs[pos], sz, &r);
+      if (r.ninval == sz)
+        return;
+      if (r.min.y < *min)
+        *min = r.min.y;
+      if (r.max.y > *max)
+        *max = r.max.y;
+      return;
+    }
+
+  for (i = pos; i < pos + sz; i++)
+    {
+      kdata_pair_get (d, i, &kp);
+      if (!kpair_vrfy (&kp))
+        continue;
+      if (kp.y < *min)
+        *min = kp.y;
+      if (kp.y > *max)
+        *max = kp.y;
+    }
+}
+
+/*
+ * (Re)build the range index of "d", reusing its tables if they're large
+ * enough.
+ * Blocks without valid pairs have a minimum of DBL_MAX and a maximum of
+ * -DBL_MAX, so they drop out of comparisons.
+ * The index is a cache, so we allow ourselves to modify it through the
+ * const pointer.
+ * Returns zero on memory exhaustion.
+ */
+static int
+krange_build (const struct kdata *d)
+{
+  struct krange *r = (struct krange *)&d->range;
+  size_t i, k, half, nb, levels;
+  double *lo, *hi;
+  void *p;
+
+  nb = (d->pairsz + KRANGE_BLOCK - 1) / KRANGE_BLOCK;
+  for (levels = 1; ((size_t)1 << levels) <= nb; levels++)
+    /* Spin. */ ;
+
+  if (nb * levels > r->tablesz)
+    {
+      if (NULL == (p = reallocarray (r->min, nb * levels, sizeof(double))))
+        return(0);
+      r->min = p;
+      if (NULL == (p = reallocarray (r->max, nb * levels, sizeof(double))))
+        return(0);
+      r->max = p;
+      r->tablesz = nb * levels;
+    }
+
+  for (i = 0; i < nb; i++)
+    {
+      r->min[i] = DBL_MAX;
+      r->max[i] = -DBL_MAX;
+      krange_scan (d, i * KRANGE_BLOCK,
+                   d->pairsz - i * KRANGE_BLOCK < KRANGE_BLOCK ?
+                   d->pairsz - i * KRANGE_BLOCK : KRANGE_BLOCK,
+                   &r->min[i], &r->max[i]);
+    }
+
+  /* Level "k" combines two overlapping runs of level "k - 1". */
+  for (k = 1; k < levels; k++)
+    {
+      half = (size_t)1 << (k - 1);
+      lo = &r->min[(k - 1) * nb];
+      hi = &r->max[(k - 1) * nb];
+      for (i = 0; i + 2 * half <= nb; i++)
+        {
+          r->min[k * nb + i] = lo[i] < lo[i + half] ?
+                               lo[i] : lo[i + half];
+          r->max[k * nb + i] = hi[i] > hi[i + half] ?
+                               hi[i] : hi[i + half];
+        }
+    }
+
+  r->blocksz = nb;
+  r->levelsz = levels;
+  r->valid = 1;
+  return(1);
+}
+
+void
+krange_free (struct krange *r)
+{
+  free (r->min);
+  free (r->max);
+  memset (r, 0, sizeof(struct krange));
+}
+
+/*
+ * Extrema of the ordinates of the valid pairs in [start, end).
+ * The partial blocks at either end are scanned, and the whole blocks in
+ * between looked up in the range index, which is built on first use.
+ * Returns zero if there are no valid pairs in the range.
+ */
+int
+kdata_yrange (const struct kdata *d, size_t start, size_t end,
+              double *min, double *max)
+{
+  const struct krange *r = &d->range;
+  size_t bs, be, k;
+  double lo, hi;
+
+  lo = DBL_MAX;
+  hi = -DBL_MAX;
+
+  if (end > d->pairsz)
+    end = d->pairsz;
+
+  if (start >= end)
+    return(0);
+
+  /* Short ranges, or no memory for the index: scan it all. */
+  if (end - start <= 2 * KRANGE_BLOCK ||
+      (0 == r->valid && ! krange_build (d)))
+    {
+      krange_scan (d, start, end - start, &lo, &hi);
+      goto out;
+    }
+
+  bs = (start + KRANGE_BLOCK - 1) / KRANGE_BLOCK;
+  be = end / KRANGE_BLOCK;
+  assert (bs < be);
+
+  krange_scan (d, start, bs * KRANGE_BLOCK - start, &lo, &hi);
+  krange_scan (d, be * KRANGE_BLOCK, end - be * KRANGE_BLOCK, &lo, &hi);
+
+  for (k = 0; ((size_t)2 << k) <= be - bs; k++)
+    /* Spin. */ ;
+
+  bs += k * r->blocksz;
+  be += k * r->blocksz - ((size_t)1 << k);
+  if (r->min[bs] < lo)
+    lo = r->min[bs];
+  if (r->min[be] < lo)
+    lo = r->min[be];
+  if (r->max[bs] > hi)
+    hi = r->max[bs];
+  if (r->max[be] > hi)
+    hi = r->max[be];
+out:
+  if (lo > hi)
+    return(0);
+  if (NULL != min)
+    *min = lo;
+  if (NULL != max)
+    *max = hi;
+  return(1);
+}
+
+/*
+ * Position of the first pair whose abscissa is not less than "x" (or,
+ * if "after" is set, is greater than "x"), or the number of pairs if
+ * there's none.
+ * The abscissae must be ascending.
+ */
+static size_t
+kdata_xsearch (const struct kdata *d, double x, int after)
+{
+  size_t lo, hi, mid;
+  struct kpair kp;
+
+  lo = 0;
+  hi = d->pairsz;
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+      kdata_pair_get (d, mid, &kp);
+      if (kp.x < x || (after && kp.x == x))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return(lo);
+}
+
+size_t
+kdata_xindex (const struct kdata *d, double x)
+{
+  return(kdata_xsearch (d, x, 0));
+}
+
+/*
+ * Like kdata_yrange(), but for the pairs with abscissae in
+ * [xmin, xmax], which must be ascending.
+ */
+int
+kdata_yrange_x (const struct kdata *d, double xmin, double xmax,
+                double *min, double *max)
+{
+  return(kdata_yrange (d, kdata_xsearch (d, xmin, 0),
+                       kdata_xsearch (d, xmax, 1), min, max));
+}
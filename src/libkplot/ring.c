@@ -0,0 +1,238 @@
+/*      $Id$ */
+/*
+ * Copyright (c) 2015 Kristaps Dzonsons <kristaps@bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "compat.h"
+
+#include <assert.h>
+#include <cairo.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kplot.h"
+#include "extern.h"
+
+/*
+ * Value of the pair with sequence number "seq" tracked by queue "q".
+ */
+static double
+kring_value (const struct kdata *d, int q, size_t seq)
+{
+  const struct kpair *kp = &d->pairs[seq - d->d.ring.seq];
+
+  return(KRING_XMIN == q || KRING_XMAX == q ? kp->x : kp->y);
+}
+
+static size_t
+kring_front (const struct kdata *d, int q)
+{
+  const struct kdataring *r = &d->d.ring;
+
+  return(r->queue[q][r->qfirst[q]]);
+}
+
+/*
+ * Queue the newest pair, which must be valid.
+ * Pairs that can't be an extremum anymore (the new one is at least as
+ * good and outlives them) are dropped from the back, so each queue is
+ * ordered from the current extremum to the newest pair.
+ */
+static void
+kring_queue_push (struct kdata *d, int q, size_t seq)
+{
+  struct kdataring *r = &d->d.ring;
+  double v = kring_value (d, q, seq);
+  double last;
+  size_t back;
+
+  while (r->qsz[q] > 0)
+    {
+      back = (r->qfirst[q] + r->qsz[q] - 1) % r->cap;
+      last = kring_value (d, q, r->queue[q][back]);
+      if (KRING_XMIN == q || KRING_YMIN == q ? last < v : last > v)
+        break;
+      r->qsz[q]--;
+    }
+
+  r->queue[q][(r->qfirst[q] + r->qsz[q]) % r->cap] = seq;
+  r->qsz[q]++;
+}
+
+/*
+ * Take the oldest pair out of the summary once it's gone from the
+ * window: the extrema are the fronts of the queues.
+ */
+static void
+kring_stat_remove (struct kdata *d, const struct kpair *kp)
+{
+  struct kdatastat *st = &d->stat;
+
+  if (0 == st->valid)
+    return;
+
+  if (!kpair_vrfy (kp))
+    {
+      st->ninval--;
+      return;
+    }
+
+  st->xsum -= kp->x;
+  st->ysum -= kp->y;
+
+  /* No valid pair left: kdata_stat_add() starts over. */
+  if (0 == d->d.ring.qsz[KRING_XMIN])
+    return;
+
+  st->min.x = kring_value (d, KRING_XMIN, kring_front (d, KRING_XMIN));
+  st->max.x = kring_value (d, KRING_XMAX, kring_front (d, KRING_XMAX));
+  st->min.y = kring_value (d, KRING_YMIN, kring_front (d, KRING_YMIN));
+  st->max.y = kring_value (d, KRING_YMAX, kring_front (d, KRING_YMAX));
+}
+
+/*
+ * Allocate a window of at most "cap" pairs.
+ * Pushing past the capacity drops the oldest pair, so the source can be
+ * fed a stream and scroll with it.
+ * Both ends are amortised constant time, and so is keeping the summary
+ * (see kdata_stat_get()) current.
+ */
+struct kdata *
+kdata_ring_alloc (size_t cap)
+{
+  struct kdata    *d;
+  int q;
+
+  if (0 == cap)
+    return(NULL);
+
+  if (NULL == (d = calloc (1, sizeof(struct kdata))))
+    return(NULL);
+
+  d->refs = 1;
+  d->type = KDATA_RING;
+  d->d.ring.cap = cap;
+  d->d.ring.buf = reallocarray (NULL, cap, 2 * sizeof(struct kpair));
+  if (NULL == d->d.ring.buf)
+    {
+      free (d);
+      return(NULL);
+    }
+
+  for (q = 0; q < KRING_QUEUES; q++)
+    {
+      d->d.ring.queue[q] = reallocarray (NULL, cap, sizeof(size_t));
+      if (NULL == d->d.ring.queue[q])
+        {
+          kdata_ring_free (d);
+          free (d);
+          return(NULL);
+        }
+    }
+
+  d->pairs = d->d.ring.buf;
+  return(d);
+}
+
+/*
+ * Release the ring storage: "pairs" points into it.
+ */
+void
+kdata_ring_free (struct kdata *d)
+{
+  int q;
+
+  for (q = 0; q < KRING_QUEUES; q++)
+    free (d->d.ring.queue[q]);
+
+  free (d->d.ring.buf);
+  d->pairs = NULL;
+}
+
+/*
+ * Drop the oldest pair.
+ */
+int
+kdata_ring_pop (struct kdata *d)
+{
+  struct kdataring *r;
+  struct kpair kp;
+  int q;
+
+  if (KDATA_RING != d->type || 0 == d->pairsz)
+    return(0);
+
+  r = &d->d.ring;
+  kp = d->pairs[0];
+
+  for (q = 0; q < KRING_QUEUES; q++)
+    if (r->qsz[q] > 0 && kring_front (d, q) == r->seq)
+      {
+        r->qfirst[q] = (r->qfirst[q] + 1) % r->cap;
+        r->qsz[q]--;
+      }
+
+  r->seq++;
+  d->pairsz--;
+
+  /* An empty window starts over at the beginning of the buffer. */
+  r->head = 0 == d->pairsz ? 0 : r->head + 1;
+  d->pairs = r->buf + r->head;
+
+  kring_stat_remove (d, &kp);
+  d->range.valid = 0;
+  return(1);
+}
+
+/*
+ * Append a pair, dropping the oldest one if the window is full.
+ * Rings don't have dependants: their positions shift.
+ */
+int
+kdata_ring_push (struct kdata *d, double x, double y)
+{
+  struct kdataring *r;
+  int q;
+
+  if (KDATA_RING != d->type)
+    return(0);
+
+  r = &d->d.ring;
+  if (d->pairsz == r->cap)
+    kdata_ring_pop (d);
+
+  /*
+   * Slide the window back to the start of the buffer: this happens at
+   * most once every "cap" pushes.
+   */
+  if (r->head + d->pairsz == 2 * r->cap)
+    {
+      memmove (r->buf, d->pairs, d->pairsz * sizeof(struct kpair));
+      r->head = 0;
+      d->pairs = r->buf;
+    }
+
+  d->pairs[d->pairsz].x = x;
+  d->pairs[d->pairsz].y = y;
+  d->pairsz++;
+
+  if (kpair_vrfy (&d->pairs[d->pairsz - 1]))
+    for (q = 0; q < KRING_QUEUES; q++)
+      kring_queue_push (d, q, r->seq + d->pairsz - 1);
+
+  /* The new pair isn't in the summary yet: don't go by kdata_set(). */
+  kdata_stat_add (d, d->pairsz - 1);
+  d->range.valid = 0;
+  return(1);
+}
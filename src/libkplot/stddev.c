@@ -96,6 +96,14 @@ kdata_stddev_alloc (struct kdata *dep)
   struct kdata    *d;
   size_t i;
 
+  /*
+   * Column sources are never modified, so we'd never be updated, and
+   * ring positions shift as the oldest pairs go away.
+   */
+  if (NULL != dep &&
+      (KDATA_COLUMN == dep->type || KDATA_RING == dep->type))
+    return(NULL);
+
   if (NULL == (d = calloc (1, sizeof(struct kdata))))
     return(NULL);
 
@@ -138,6 +146,10 @@ kdata_stddev_attach (struct kdata *d, struct kdata *dep)
   if (KDATA_STDDEV != d->type)
     return(0);
 
+  if (NULL != dep &&
+      (KDATA_COLUMN == dep->type || KDATA_RING == dep->type))
+    return(0);
+
   if (NULL == dep)
     return(1);
 
@@ -183,6 +195,7 @@ kdata_stddev_attach (struct kdata *d, struct kdata *dep)
       d->pairsz = dep->pairsz;
       for (i = 0; i < dep->pairsz; i++)
         d->pairs[i].x = dep->pairs[i].x;
+      kdata_invalidate (d);
     }
 
   kdata_dep_add (d, dep, kdata_stddev_set);
@@ -59,8 +59,13 @@ kdata_vector_append (struct kdata *d, double x, double y)
       d->pairs = p;
     }
 
+  /* The new pair isn't in the summary yet: don't go by kdata_set(). */
   d->pairsz++;
-  return(kdata_set (d, d->pairsz - 1, x, y));
+  d->pairs[d->pairsz - 1].x = x;
+  d->pairs[d->pairsz - 1].y = y;
+  kdata_stat_add (d, d->pairsz - 1);
+  d->range.valid = 0;
+  return(d->depsz ? kdata_dep_run (d, d->pairsz - 1) : 1);
 }
 
 int
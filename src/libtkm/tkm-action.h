@@ -34,6 +34,11 @@ typedef enum _ActionType {
   ACTION_OPEN_DATABASE_FILE,
   ACTION_LOAD_SESSIONS,
   ACTION_LOAD_DATA,
+  ACTION_LOAD_VIEWPORT,
+  ACTION_LOAD_TAIL,
+  ACTION_OPEN_STREAM,
+  ACTION_LOAD_TABLES,
+  ACTION_DROP_CACHES,
   ACTION_TERMINATE
 } ActionType;
 
@@ -41,6 +46,8 @@ typedef enum _ActionStatusType {
   ACTION_STATUS_PROGRESS,
   ACTION_STATUS_FAILED,
   ACTION_STATUS_COMPLETE,
+  /* dropped for a newer action doing the same work */
+  ACTION_STATUS_SUPERSEDED,
 } ActionStatusType;
 
 typedef struct _TkmAction {
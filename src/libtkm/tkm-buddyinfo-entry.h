@@ -42,7 +42,7 @@ typedef struct _TkmBuddyInfoEntry {
   gchar *zone;
   gchar *data;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmBuddyInfoEntry;
 
 TkmBuddyInfoEntry *tkm_buddyinfo_entry_new (void);
@@ -70,6 +70,11 @@ void tkm_buddyinfo_entry_set_data (TkmBuddyInfoEntry *entry,
 GPtrArray *tkm_buddyinfo_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_buddyinfo_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_buddyinfo_entry_append_record (GPtrArray *entries, int argc,
+                                            char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmBuddyInfoEntry, tkm_buddyinfo_entry_unref);
 
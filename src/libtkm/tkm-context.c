@@ -108,6 +108,11 @@ tkm_context_execute_action (TkmContext *ctx, TkmAction *action)
     case ACTION_OPEN_DATABASE_FILE:
     case ACTION_LOAD_SESSIONS:
     case ACTION_LOAD_DATA:
+    case ACTION_LOAD_VIEWPORT:
+    case ACTION_LOAD_TAIL:
+    case ACTION_OPEN_STREAM:
+    case ACTION_LOAD_TABLES:
+    case ACTION_DROP_CACHES:
       tkm_entrypool_push_action (ctx->entrypool, action);
       break;
 
@@ -194,6 +199,55 @@ tkm_context_get_diskstat_entries (TkmContext *ctx)
   return tkm_entrypool_get_diskstat_entries (ctx->entrypool);
 }
 
+void
+tkm_context_register_view (TkmContext *ctx, const gchar *name, guint tables)
+{
+  g_assert (ctx);
+  tkm_entrypool_register_view (ctx->entrypool, name, tables);
+}
+
+void
+tkm_context_set_visible_view (TkmContext *ctx, const gchar *name)
+{
+  g_assert (ctx);
+  tkm_entrypool_set_visible_view (ctx->entrypool, name);
+}
+
+guint
+tkm_context_get_missing_tables (TkmContext *ctx)
+{
+  g_assert (ctx);
+  return tkm_entrypool_get_missing_tables (ctx->entrypool);
+}
+
+gsize
+tkm_context_get_table_bytes (TkmContext *ctx, EntryPoolTable table)
+{
+  g_assert (ctx);
+  return tkm_entrypool_get_table_bytes (ctx->entrypool, table);
+}
+
+guint
+tkm_context_get_data_generation (TkmContext *ctx)
+{
+  g_assert (ctx);
+  return tkm_entrypool_get_data_generation (ctx->entrypool);
+}
+
+guint
+tkm_context_get_data_epoch (TkmContext *ctx)
+{
+  g_assert (ctx);
+  return tkm_entrypool_get_data_epoch (ctx->entrypool);
+}
+
+guint
+tkm_context_get_tables_generation (TkmContext *ctx)
+{
+  g_assert (ctx);
+  return tkm_entrypool_get_tables_generation (ctx->entrypool);
+}
+
 void
 tkm_context_data_lock (TkmContext *ctx)
 {
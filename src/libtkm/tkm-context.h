@@ -61,6 +61,16 @@ GPtrArray *tkm_context_get_diskstat_entries (TkmContext *ctx);
 
 void tkm_context_execute_action (TkmContext *ctx, TkmAction *action);
 
+void tkm_context_register_view (TkmContext *ctx, const gchar *name,
+                                guint tables);
+void tkm_context_set_visible_view (TkmContext *ctx, const gchar *name);
+guint tkm_context_get_missing_tables (TkmContext *ctx);
+gsize tkm_context_get_table_bytes (TkmContext *ctx, EntryPoolTable table);
+
+guint tkm_context_get_data_generation (TkmContext *ctx);
+guint tkm_context_get_data_epoch (TkmContext *ctx);
+guint tkm_context_get_tables_generation (TkmContext *ctx);
+
 void tkm_context_data_lock (TkmContext *ctx);
 gboolean tkm_context_data_try_lock (TkmContext *ctx);
 void tkm_context_data_unlock (TkmContext *ctx);
@@ -22,10 +22,21 @@
  */
 
 #include "tkm-cpustat-entry.h"
+#include "tkm-series.h"
 
 static const gchar *timeSourceColumn[]
   = { "SystemTime", "MonotonicTime", "ReceiveTime" };
 
+static const TkmSeriesColumn cpuStatSeriesColumns[] = {
+  { "SystemTime", SERIES_AGGREGATE_MIN },
+  { "MonotonicTime", SERIES_AGGREGATE_MIN },
+  { "ReceiveTime", SERIES_AGGREGATE_MIN },
+  { "CPUStatAll", SERIES_AGGREGATE_AVG },
+  { "CPUStatUsr", SERIES_AGGREGATE_AVG },
+  { "CPUStatSys", SERIES_AGGREGATE_AVG },
+  { "CPUStatIow", SERIES_AGGREGATE_AVG },
+};
+
 /**
  * @enum CpuStat query type
  */
@@ -49,7 +60,7 @@ tkm_cpustat_entry_new (void)
 {
   TkmCpuStatEntry *entry = g_new0 (TkmCpuStatEntry, 1);
 
-  g_ref_count_init (&entry->rc);
+  g_atomic_ref_count_init (&entry->rc);
 
   return entry;
 }
@@ -58,7 +69,7 @@ TkmCpuStatEntry *
 tkm_cpustat_entry_ref (TkmCpuStatEntry *entry)
 {
   g_assert (entry);
-  g_ref_count_inc (&entry->rc);
+  g_atomic_ref_count_inc (&entry->rc);
   return entry;
 }
 
@@ -67,7 +78,7 @@ tkm_cpustat_entry_unref (TkmCpuStatEntry *entry)
 {
   g_assert (entry);
 
-  if (g_ref_count_dec (&entry->rc) == TRUE)
+  if (g_atomic_ref_count_dec (&entry->rc) == TRUE)
     {
       if (entry->name != NULL)
         g_free (entry->name);
@@ -290,11 +301,74 @@ cpustat_entry_free (gpointer data)
   tkm_cpustat_entry_unref (e);
 }
 
+GPtrArray *
+tkm_cpustat_entry_get_sampled_entries (sqlite3 *db, const char *session_hash,
+                                       DataTimeSource time_source,
+                                       gulong start_time, gulong end_time,
+                                       gulong step, GError **error)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  GPtrArray *entries = g_ptr_array_new ();
+  CpuStatQueryData data
+    = { .type = CPUSTAT_GET_ENTRIES, .response = (gpointer) & entries };
+
+  g_ptr_array_set_free_func (entries, cpustat_entry_free);
+
+  g_assert (db);
+
+  /* Fold the rows of each step seconds into one, enough for overview charts */
+  if (step > 0)
+    {
+      TkmSeriesQuery query = { .table = TKM_CPUSTAT_TABLE_NAME,
+                               .key = "CPUStatName",
+                               .time_source = time_source,
+                               .start_time = start_time,
+                               .end_time = end_time,
+                               .bucket = step,
+                               .n_columns = G_N_ELEMENTS (cpuStatSeriesColumns),
+                               .columns = cpuStatSeriesColumns };
+
+      sql = tkm_series_query_sql (&query, session_hash);
+    }
+  else
+    sql = g_strdup_printf ("SELECT * FROM '%s' "
+                           "WHERE %s >= %lu AND "
+                           " %s < %lu AND SessionId IS "
+                           "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
+                           TKM_CPUSTAT_TABLE_NAME,
+                           timeSourceColumn[time_source], start_time,
+                           timeSourceColumn[time_source], end_time,
+                           TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (db, sql, cpustat_sqlite_callback, &data, &query_error)
+      != SQLITE_OK)
+    {
+      g_ptr_array_free (entries, TRUE);
+      entries = NULL;
+
+      g_set_error (error, g_quark_from_static_string ("CpuStatGetAll"), 1,
+                   "SQL query error");
+      g_warning ("Fail to get cpustat list. SQL error %s", query_error);
+      sqlite3_free (query_error);
+    }
+
+  return entries;
+}
+
 GPtrArray *
 tkm_cpustat_entry_get_all_entries (sqlite3 *db, const char *session_hash,
                                    DataTimeSource time_source,
                                    gulong start_time, gulong end_time,
                                    GError **error)
+{
+  return tkm_cpustat_entry_get_sampled_entries (db, session_hash, time_source,
+                                                start_time, end_time, 0, error);
+}
+
+GPtrArray *
+tkm_cpustat_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error)
 {
   g_autofree gchar *sql = NULL;
   gchar *query_error = NULL;
@@ -306,12 +380,15 @@ tkm_cpustat_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   g_assert (db);
 
+  /* The rowid range keeps the scan to the rows appended since last time */
   sql = g_strdup_printf ("SELECT * FROM '%s' "
-                         "WHERE %s >= %lu AND "
-                         " %s < %lu AND SessionId IS "
-                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
-                         TKM_CPUSTAT_TABLE_NAME, timeSourceColumn[time_source],
-                         start_time, timeSourceColumn[time_source], end_time,
+                         "WHERE rowid > %" G_GINT64_FORMAT " AND "
+                         "rowid <= %" G_GINT64_FORMAT " AND "
+                         "%s >= %lu AND SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1) "
+                         "ORDER BY rowid;",
+                         TKM_CPUSTAT_TABLE_NAME, first_rowid, last_rowid,
+                         timeSourceColumn[time_source], start_time,
                          TKM_SESSIONS_TABLE_NAME, session_hash);
   if (sqlite3_exec (db, sql, cpustat_sqlite_callback, &data, &query_error)
       != SQLITE_OK)
@@ -319,11 +396,28 @@ tkm_cpustat_entry_get_all_entries (sqlite3 *db, const char *session_hash,
       g_ptr_array_free (entries, TRUE);
       entries = NULL;
 
-      g_set_error (error, g_quark_from_static_string ("CpuStatGetAll"), 1,
+      g_set_error (error, g_quark_from_static_string ("CpuStatGetTail"), 1,
                    "SQL query error");
-      g_warning ("Fail to get cpustat list. SQL error %s", query_error);
+      g_warning ("Fail to get cpustat tail. SQL error %s", query_error);
       sqlite3_free (query_error);
     }
 
   return entries;
 }
+
+gboolean
+tkm_cpustat_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                 char **colname)
+{
+  CpuStatQueryData data
+    = { .type = CPUSTAT_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  cpustat_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
@@ -44,7 +44,7 @@ typedef struct _TkmCpuStatEntry {
   guint usr;
   guint iow;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmCpuStatEntry;
 
 TkmCpuStatEntry *tkm_cpustat_entry_new (void);
@@ -75,6 +75,17 @@ GPtrArray *tkm_cpustat_entry_get_all_entries (sqlite3 *db,
                                               DataTimeSource time_source,
                                               gulong start_time,
                                               gulong end_time, GError **error);
+GPtrArray *tkm_cpustat_entry_get_sampled_entries (sqlite3 *db,
+                                                  const char *session_hash,
+                                                  DataTimeSource time_source,
+                                                  gulong start_time,
+                                                  gulong end_time, gulong step,
+                                                  GError **error);
+GPtrArray *tkm_cpustat_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_cpustat_entry_append_record (GPtrArray *entries, int argc,
+                                         char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmCpuStatEntry, tkm_cpustat_entry_unref);
 
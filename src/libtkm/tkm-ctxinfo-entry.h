@@ -52,7 +52,7 @@ typedef struct _TkmCtxInfoEntry {
   glong mem_rss;
   glong mem_pss;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmCtxInfoEntry;
 
 TkmCtxInfoEntry *tkm_ctxinfo_entry_new (void);
@@ -82,6 +82,11 @@ GPtrArray *tkm_ctxinfo_entry_get_all_entries (sqlite3 *db,
                                               DataTimeSource time_source,
                                               gulong start_time,
                                               gulong end_time, GError **error);
+GPtrArray *tkm_ctxinfo_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_ctxinfo_entry_append_record (GPtrArray *entries, int argc,
+                                          char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmCtxInfoEntry, tkm_ctxinfo_entry_unref);
 
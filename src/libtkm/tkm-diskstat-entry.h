@@ -65,7 +65,7 @@ typedef struct _TkmDiskStatEntry {
   glong io_spent_ms;
   glong io_weighted_ms;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmDiskStatEntry;
 
 TkmDiskStatEntry *tkm_diskstat_entry_new (void);
@@ -90,6 +90,11 @@ void tkm_diskstat_entry_set_data (TkmDiskStatEntry *entry,
 GPtrArray *tkm_diskstat_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_diskstat_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_diskstat_entry_append_record (GPtrArray *entries, int argc,
+                                           char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmDiskStatEntry, tkm_diskstat_entry_unref);
 
@@ -32,10 +32,44 @@
 #include "tkm-procevent-entry.h"
 #include "tkm-procinfo-entry.h"
 #include "tkm-session-entry.h"
+#include "tkm-stream.h"
+#include "tkm-task.h"
 #include "tkm-wireless-entry.h"
 
 #include <fcntl.h>
 
+/* Buckets loaded for the series charts of a long window */
+#define ENTRYPOOL_OVERVIEW_POINTS (2048)
+
+/* How long a query waits on a capture the writer holds locked */
+#define ENTRYPOOL_BUSY_TIMEOUT_MS (250)
+
+/* Rows a record stream keeps per table, the oldest are dropped first */
+#define ENTRYPOOL_STREAM_ROWS (65536)
+
+/* Longest a decoded stream record waits before it is merged */
+#define ENTRYPOOL_STREAM_MERGE_MS (100)
+
+/* Tables drawn as chart series, the others are listed by the views */
+#define ENTRYPOOL_SERIES_TABLES                                               \
+  (EPOOL_TABLE_BIT (EPOOL_TABLE_CPUSTAT)                                      \
+   | EPOOL_TABLE_BIT (EPOOL_TABLE_MEMINFO)                                    \
+   | EPOOL_TABLE_BIT (EPOOL_TABLE_PRESSURE)                                   \
+   | EPOOL_TABLE_BIT (EPOOL_TABLE_PROCEVENT))
+
+/* Columns of the timestamps of each time source */
+static const gchar *timeSourceColumn[]
+  = { "SystemTime", "MonotonicTime", "ReceiveTime" };
+
+/* Time chunks the loaded window is accounted and evicted in */
+#define ENTRYPOOL_CHUNK_SECONDS (3600)
+
+/* Most batches a window read under a memory budget is split in */
+#define ENTRYPOOL_LOAD_BATCHES (16)
+
+/* Allocation estimate for each string held by an entry */
+#define ENTRYPOOL_STRING_BYTES (32)
+
 /**
  * @brief Post new event
  *
@@ -63,6 +97,16 @@ static gboolean entrypool_source_dispatch (GSource *source,
 static gboolean entrypool_source_callback (gpointer _entrypool,
                                            gpointer _event);
 
+/**
+ * @brief Drop the events of a batch made redundant by later ones
+ */
+static void entrypool_batch_merge (GPtrArray *batch);
+
+/**
+ * @brief Release an event and its action
+ */
+static void entrypool_event_free (TkmEntryPoolEvent *event);
+
 /**
  * @brief GSource destroy notification callback function
  */
@@ -95,6 +139,38 @@ static void do_load_sessions (TkmEntryPool *entrypool,
  */
 static void do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event);
 
+/**
+ * @brief Extend loaded chart data to a viewport
+ */
+static void do_load_viewport (TkmEntryPool *entrypool,
+                              TkmEntryPoolEvent *event);
+
+/**
+ * @brief Append the rows written to the database since the last load
+ */
+static void do_load_tail (TkmEntryPool *entrypool, TkmEntryPoolEvent *event);
+
+/**
+ * @brief Load the tables the visible view needs into the loaded window
+ */
+static void do_load_tables (TkmEntryPool *entrypool,
+                            TkmEntryPoolEvent *event);
+
+/**
+ * @brief Evict the loaded chunks not in view
+ */
+static void do_drop_caches (TkmEntryPool *entrypool, TkmEntryPoolEvent *event);
+
+/**
+ * @brief Start reading a record stream
+ */
+static void do_open_stream (TkmEntryPool *entrypool, TkmEntryPoolEvent *event);
+
+/**
+ * @brief Stop the record stream reader if any
+ */
+static void stream_stop (TkmEntryPool *entrypool);
+
 /**
  * @brief GSourceFuncs vtable
  */
@@ -105,11 +181,21 @@ static GSourceFuncs entrypool_source_funcs = {
 static void
 post_entrypool_event (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
 {
+  gboolean wakeup = FALSE;
+
   g_assert (entrypool);
   g_assert (event);
 
-  g_async_queue_push (entrypool->queue, event);
-  if (entrypool->context != NULL)
+  /*
+   * Dispatch drains the whole queue, only the first event pushed since
+   * then has to wake the loop up.
+   */
+  g_async_queue_lock (entrypool->queue);
+  g_async_queue_push_unlocked (entrypool->queue, event);
+  wakeup = g_async_queue_length_unlocked (entrypool->queue) == 1;
+  g_async_queue_unlock (entrypool->queue);
+
+  if (wakeup && entrypool->context != NULL)
     g_main_context_wakeup (entrypool->context);
 }
 
@@ -128,16 +214,107 @@ entrypool_source_dispatch (GSource *source, GSourceFunc callback,
                            gpointer _entrypool)
 {
   TkmEntryPool *entrypool = (TkmEntryPool *)source;
-  gpointer event = g_async_queue_try_pop (entrypool->queue);
+  g_autoptr (GPtrArray) batch = g_ptr_array_new ();
+  gboolean status = TRUE;
+  gpointer event = NULL;
 
   TKM_UNUSED (callback);
   TKM_UNUSED (_entrypool);
 
-  if (event == NULL)
-    return G_SOURCE_CONTINUE;
+  while ((event = g_async_queue_try_pop (entrypool->queue)) != NULL)
+    g_ptr_array_add (batch, event);
+
+  entrypool_batch_merge (batch);
+
+  for (guint i = 0; i < batch->len; i++)
+    {
+      event = g_ptr_array_index (batch, i);
+      if (event != NULL && entrypool->callback (entrypool, event) != TRUE)
+        status = FALSE;
+    }
+
+  return status == TRUE ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/* Events after which later ones no longer act on the same data */
+static gboolean
+entrypool_event_replaces_data (TkmEntryPoolEvent *event)
+{
+  switch (event->type)
+    {
+    case EPOOL_EVENT_OPEN_DATABASE_FILE:
+    case EPOOL_EVENT_LOAD_SESSIONS:
+    case EPOOL_EVENT_LOAD_DATA:
+    case EPOOL_EVENT_OPEN_STREAM:
+      return TRUE;
+
+    default:
+      break;
+    }
+
+  return FALSE;
+}
+
+/*
+ * A later event of the same type and for the same session or path does
+ * everything the older one would. Streams are never merged, each open
+ * restarts the reader.
+ */
+static gboolean
+entrypool_event_supersedes (TkmEntryPoolEvent *event,
+                            TkmEntryPoolEvent *older)
+{
+  GList *args = NULL;
+  GList *older_args = NULL;
+
+  if (event->type != older->type || event->type == EPOOL_EVENT_OPEN_STREAM)
+    return FALSE;
+
+  args = tkm_action_get_args (event->action);
+  older_args = tkm_action_get_args (older->action);
+
+  return g_strcmp0 (args != NULL ? args->data : NULL,
+                    older_args != NULL ? older_args->data : NULL)
+         == 0;
+}
+
+static void
+entrypool_batch_merge (GPtrArray *batch)
+{
+  for (guint i = 0; i < batch->len; i++)
+    {
+      TkmEntryPoolEvent *event = g_ptr_array_index (batch, i);
+      TkmActionStatusCallback callback = NULL;
+      gboolean superseded = FALSE;
+
+      for (guint j = i + 1; j < batch->len && !superseded; j++)
+        {
+          TkmEntryPoolEvent *later = g_ptr_array_index (batch, j);
+
+          superseded = entrypool_event_supersedes (later, event);
+          if (entrypool_event_replaces_data (later))
+            break;
+        }
+
+      if (!superseded)
+        continue;
+
+      /* Owners still hear back, the spinner counts every action */
+      callback = tkm_action_get_callback (event->action);
+      if (callback != NULL)
+        callback (ACTION_STATUS_SUPERSEDED, event->action);
+
+      entrypool_event_free (event);
+      g_ptr_array_index (batch, i) = NULL;
+    }
+}
 
-  return entrypool->callback (entrypool, event) == TRUE ? G_SOURCE_CONTINUE
-                                                        : G_SOURCE_REMOVE;
+static void
+entrypool_event_free (TkmEntryPoolEvent *event)
+{
+  tkm_action_unref (event->action);
+  g_clear_object (&event->cancellable);
+  g_free (event);
 }
 
 static gboolean
@@ -163,12 +340,31 @@ entrypool_source_callback (gpointer _entrypool, gpointer _event)
       do_load_data (entrypool, event);
       break;
 
+    case EPOOL_EVENT_LOAD_VIEWPORT:
+      do_load_viewport (entrypool, event);
+      break;
+
+    case EPOOL_EVENT_LOAD_TAIL:
+      do_load_tail (entrypool, event);
+      break;
+
+    case EPOOL_EVENT_OPEN_STREAM:
+      do_open_stream (entrypool, event);
+      break;
+
+    case EPOOL_EVENT_LOAD_TABLES:
+      do_load_tables (entrypool, event);
+      break;
+
+    case EPOOL_EVENT_DROP_CACHES:
+      do_drop_caches (entrypool, event);
+      break;
+
     default:
       break;
     }
 
-  tkm_action_unref (event->action);
-  g_free (event);
+  entrypool_event_free (event);
 
   return TRUE;
 }
@@ -237,6 +433,8 @@ main_entries_free (TkmEntryPool *entrypool)
       g_ptr_array_free (entrypool->diskstat_entries, TRUE);
       entrypool->diskstat_entries = NULL;
     }
+
+  g_atomic_int_set (&entrypool->loaded_tables, 0);
 }
 
 static void
@@ -259,6 +457,8 @@ do_load_sessions (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
 
   entrypool->session_entries
     = tkm_session_entry_get_all_entries (entrypool->input_database, &error);
+  g_atomic_int_inc (&entrypool->data_epoch);
+  g_atomic_int_inc (&entrypool->data_generation);
 
   tkm_entrypool_data_unlock (entrypool);
 
@@ -275,6 +475,481 @@ do_load_sessions (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
     }
 }
 
+static int
+last_rowid_callback (void *data, int argc, char **argv, char **colname)
+{
+  gint64 *rowid = (gint64 *)data;
+
+  TKM_UNUSED (colname);
+
+  if (argc > 0 && argv[0] != NULL)
+    *rowid = g_ascii_strtoll (argv[0], NULL, 10);
+
+  return SQLITE_OK;
+}
+
+/* The largest rowid is read from the end of the table b-tree */
+static gint64
+table_last_rowid (sqlite3 *db, const gchar *table)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  gint64 rowid = 0;
+
+  sql = g_strdup_printf ("SELECT MAX(rowid) FROM '%s';", table);
+  if (sqlite3_exec (db, sql, last_rowid_callback, &rowid, &query_error)
+      != SQLITE_OK)
+    {
+      g_warning ("Fail to get %s last rowid. SQL error %s", table,
+                 query_error);
+      sqlite3_free (query_error);
+    }
+
+  return rowid;
+}
+
+/* Largest rowid of the session rows before end_time */
+static gint64
+table_window_rowid (TkmEntryPool *entrypool, const gchar *table,
+                    const gchar *session_hash, gulong end_time)
+{
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  gint64 rowid = 0;
+
+  sql = g_strdup_printf ("SELECT MAX(rowid) FROM '%s' WHERE %s < %lu AND "
+                         "SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
+                         table, timeSourceColumn[time_source], end_time,
+                         TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (entrypool->input_database, sql, last_rowid_callback,
+                    &rowid, &query_error)
+      != SQLITE_OK)
+    {
+      g_warning ("Fail to get %s window rowid. SQL error %s", table,
+                 query_error);
+      sqlite3_free (query_error);
+    }
+
+  return rowid;
+}
+
+static GPtrArray **
+entrypool_table_pool (TkmEntryPool *entrypool, EntryPoolTable table)
+{
+  switch (table)
+    {
+    case EPOOL_TABLE_PROCINFO:
+      return &entrypool->procinfo_entries;
+    case EPOOL_TABLE_CTXINFO:
+      return &entrypool->ctxinfo_entries;
+    case EPOOL_TABLE_PROCACCT:
+      return &entrypool->procacct_entries;
+    case EPOOL_TABLE_CPUSTAT:
+      return &entrypool->cpustat_entries;
+    case EPOOL_TABLE_MEMINFO:
+      return &entrypool->meminfo_entries;
+    case EPOOL_TABLE_PROCEVENT:
+      return &entrypool->procevent_entries;
+    case EPOOL_TABLE_PRESSURE:
+      return &entrypool->pressure_entries;
+    case EPOOL_TABLE_BUDDYINFO:
+      return &entrypool->buddyinfo_entries;
+    case EPOOL_TABLE_WIRELESS:
+      return &entrypool->wireless_entries;
+    case EPOOL_TABLE_DISKSTAT:
+      return &entrypool->diskstat_entries;
+    default:
+      break;
+    }
+
+  g_assert_not_reached ();
+  return NULL;
+}
+
+/*
+ * Rows of a table in [start_timestamp, end_timestamp). The series drawn
+ * by the history charts are folded in buckets of step seconds.
+ */
+static GPtrArray *
+entrypool_table_fetch (TkmEntryPool *entrypool, EntryPoolTable table,
+                       const gchar *session_hash, gulong start_timestamp,
+                       gulong end_timestamp, gulong step)
+{
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  sqlite3 *db = entrypool->input_database;
+
+  switch (table)
+    {
+    case EPOOL_TABLE_PROCINFO:
+      return tkm_procinfo_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_CTXINFO:
+      return tkm_ctxinfo_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_PROCACCT:
+      return tkm_procacct_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_CPUSTAT:
+      return tkm_cpustat_entry_get_sampled_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, step,
+        NULL);
+    case EPOOL_TABLE_MEMINFO:
+      return tkm_meminfo_entry_get_sampled_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, step,
+        NULL);
+    case EPOOL_TABLE_PROCEVENT:
+      return tkm_procevent_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_PRESSURE:
+      return tkm_pressure_entry_get_sampled_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, step,
+        NULL);
+    case EPOOL_TABLE_BUDDYINFO:
+      return tkm_buddyinfo_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_WIRELESS:
+      return tkm_wireless_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    case EPOOL_TABLE_DISKSTAT:
+      return tkm_diskstat_entry_get_all_entries (
+        db, session_hash, time_source, start_timestamp, end_timestamp, NULL);
+    default:
+      break;
+    }
+
+  g_assert_not_reached ();
+  return NULL;
+}
+
+typedef gulong (*EntryPoolTimestampFunc) (gpointer entry,
+                                          DataTimeSource time_source);
+typedef gpointer (*EntryPoolRefFunc) (gpointer entry);
+typedef GPtrArray *(*EntryPoolTailFunc) (sqlite3 *db,
+                                         const char *session_hash,
+                                         DataTimeSource time_source,
+                                         gulong start_time, gint64 first_rowid,
+                                         gint64 last_rowid, GError **error);
+typedef gboolean (*EntryPoolRecordFunc) (GPtrArray *entries, int argc,
+                                         char **argv, char **colname);
+
+/* How the rows of a table are accounted, evicted, followed and streamed */
+typedef struct _EntryPoolTableInfo {
+  const gchar *name;
+  EntryPoolTailFunc tail;
+  EntryPoolRecordFunc append;
+  gsize row_bytes;
+  EntryPoolTimestampFunc timestamp;
+  EntryPoolRefFunc ref;
+  GDestroyNotify unref;
+} EntryPoolTableInfo;
+
+/* An entry, its pool slot and its strings */
+#define ENTRYPOOL_ROW_BYTES(type, strings)                                    \
+  (sizeof(type) + sizeof(gpointer) + ENTRYPOOL_STRING_BYTES * (strings))
+
+static const EntryPoolTableInfo entrypool_tables[EPOOL_TABLE_COUNT] = {
+  [EPOOL_TABLE_PROCINFO]
+  = { TKM_PROCINFO_TABLE_NAME, tkm_procinfo_entry_get_tail_entries,
+      tkm_procinfo_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmProcInfoEntry, 2),
+      (EntryPoolTimestampFunc)tkm_procinfo_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_procinfo_entry_ref,
+      (GDestroyNotify)tkm_procinfo_entry_unref },
+  [EPOOL_TABLE_CTXINFO]
+  = { TKM_CTXINFO_TABLE_NAME, tkm_ctxinfo_entry_get_tail_entries,
+      tkm_ctxinfo_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmCtxInfoEntry, 2),
+      (EntryPoolTimestampFunc)tkm_ctxinfo_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_ctxinfo_entry_ref,
+      (GDestroyNotify)tkm_ctxinfo_entry_unref },
+  [EPOOL_TABLE_PROCACCT]
+  = { TKM_PROCACCT_TABLE_NAME, tkm_procacct_entry_get_tail_entries,
+      tkm_procacct_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmProcAcctEntry, 1),
+      (EntryPoolTimestampFunc)tkm_procacct_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_procacct_entry_ref,
+      (GDestroyNotify)tkm_procacct_entry_unref },
+  [EPOOL_TABLE_CPUSTAT]
+  = { TKM_CPUSTAT_TABLE_NAME, tkm_cpustat_entry_get_tail_entries,
+      tkm_cpustat_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmCpuStatEntry, 1),
+      (EntryPoolTimestampFunc)tkm_cpustat_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_cpustat_entry_ref,
+      (GDestroyNotify)tkm_cpustat_entry_unref },
+  [EPOOL_TABLE_MEMINFO]
+  = { TKM_MEMINFO_TABLE_NAME, tkm_meminfo_entry_get_tail_entries,
+      tkm_meminfo_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmMemInfoEntry, 0),
+      (EntryPoolTimestampFunc)tkm_meminfo_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_meminfo_entry_ref,
+      (GDestroyNotify)tkm_meminfo_entry_unref },
+  [EPOOL_TABLE_PROCEVENT]
+  = { TKM_PROCEVENT_TABLE_NAME, tkm_procevent_entry_get_tail_entries,
+      tkm_procevent_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmProcEventEntry, 0),
+      (EntryPoolTimestampFunc)tkm_procevent_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_procevent_entry_ref,
+      (GDestroyNotify)tkm_procevent_entry_unref },
+  [EPOOL_TABLE_PRESSURE]
+  = { TKM_PRESSURE_TABLE_NAME, tkm_pressure_entry_get_tail_entries,
+      tkm_pressure_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmPressureEntry, 0),
+      (EntryPoolTimestampFunc)tkm_pressure_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_pressure_entry_ref,
+      (GDestroyNotify)tkm_pressure_entry_unref },
+  [EPOOL_TABLE_BUDDYINFO]
+  = { TKM_BUDDYINFO_TABLE_NAME, tkm_buddyinfo_entry_get_tail_entries,
+      tkm_buddyinfo_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmBuddyInfoEntry, 3),
+      (EntryPoolTimestampFunc)tkm_buddyinfo_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_buddyinfo_entry_ref,
+      (GDestroyNotify)tkm_buddyinfo_entry_unref },
+  [EPOOL_TABLE_WIRELESS]
+  = { TKM_WIRELESS_TABLE_NAME, tkm_wireless_entry_get_tail_entries,
+      tkm_wireless_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmWirelessEntry, 2),
+      (EntryPoolTimestampFunc)tkm_wireless_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_wireless_entry_ref,
+      (GDestroyNotify)tkm_wireless_entry_unref },
+  [EPOOL_TABLE_DISKSTAT]
+  = { TKM_DISKSTAT_TABLE_NAME, tkm_diskstat_entry_get_tail_entries,
+      tkm_diskstat_entry_append_record,
+      ENTRYPOOL_ROW_BYTES (TkmDiskStatEntry, 1),
+      (EntryPoolTimestampFunc)tkm_diskstat_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_diskstat_entry_ref,
+      (GDestroyNotify)tkm_diskstat_entry_unref },
+};
+
+/* Memory budget of the entry pools in bytes, 0 when it is not limited */
+static gsize
+entrypool_memory_budget (TkmEntryPool *entrypool)
+{
+  return (gsize)tkm_settings_get_memory_budget (entrypool->settings) * 1024
+         * 1024;
+}
+
+static gsize
+entrypool_table_bytes (TkmEntryPool *entrypool, EntryPoolTable table)
+{
+  GPtrArray *entries = *entrypool_table_pool (entrypool, table);
+
+  if (entries == NULL)
+    return 0;
+
+  return entries->len * entrypool_tables[table].row_bytes;
+}
+
+static gsize
+entrypool_bytes (TkmEntryPool *entrypool)
+{
+  gsize bytes = 0;
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    bytes += entrypool_table_bytes (entrypool, t);
+
+  return bytes;
+}
+
+/* Mark the chunks [start, end) spans as the most recently viewed */
+static void
+entrypool_chunks_view (TkmEntryPool *entrypool, gulong start, gulong end)
+{
+  entrypool->viewed_start = start;
+  entrypool->viewed_end = MAX (end, start + 1);
+  entrypool->view_serial++;
+
+  for (gulong chunk = start / ENTRYPOOL_CHUNK_SECONDS;
+       chunk <= (entrypool->viewed_end - 1) / ENTRYPOOL_CHUNK_SECONDS;
+       chunk++)
+    {
+      g_hash_table_insert (entrypool->chunks_viewed, GSIZE_TO_POINTER (chunk),
+                           GUINT_TO_POINTER (entrypool->view_serial));
+    }
+}
+
+/* Chunks never viewed come first */
+static guint
+entrypool_chunk_serial (TkmEntryPool *entrypool, gulong chunk)
+{
+  return GPOINTER_TO_UINT (g_hash_table_lookup (entrypool->chunks_viewed,
+                                                GSIZE_TO_POINTER (chunk)));
+}
+
+static gboolean
+entrypool_chunk_in_view (TkmEntryPool *entrypool, gulong chunk)
+{
+  return chunk * ENTRYPOOL_CHUNK_SECONDS < entrypool->viewed_end
+         && (chunk + 1) * ENTRYPOOL_CHUNK_SECONDS > entrypool->viewed_start;
+}
+
+/* Entries in [start, end), the pool may not be ordered by time */
+static GPtrArray *
+entries_clip (GPtrArray *entries, const EntryPoolTableInfo *info,
+              DataTimeSource time_source, gulong start, gulong end)
+{
+  GPtrArray *result = g_ptr_array_new_full (entries->len, info->unref);
+
+  for (guint i = 0; i < entries->len; i++)
+    {
+      gpointer entry = g_ptr_array_index (entries, i);
+      gulong timestamp = info->timestamp (entry, time_source);
+
+      if (timestamp >= start && timestamp < end)
+        g_ptr_array_add (result, info->ref (entry));
+    }
+
+  /* Readers may still hold the old pool, it goes with their reference */
+  g_ptr_array_unref (entries);
+
+  return result;
+}
+
+/*
+ * Evict chunks from the ends of the loaded window until the entry pools
+ * fit in budget. The chunks in view and at least one chunk are kept. Only
+ * the ends are evicted so the pools keep covering a single range, which
+ * the viewport loads read back as it is scrolled to. Called with the data
+ * lock held, returns TRUE if rows were dropped.
+ */
+static gboolean
+entrypool_chunks_evict (TkmEntryPool *entrypool, gsize budget)
+{
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  g_autofree gsize *bytes = NULL;
+  GHashTableIter iter;
+  gpointer key = NULL;
+  gsize total = 0;
+  gulong first = 0;
+  gulong count = 0;
+  gulong lo = 0;
+  gulong hi = 0;
+  gulong start = 0;
+  gulong end = 0;
+
+  /* A record stream has nothing to read evicted rows back from */
+  if (entrypool->input_database == NULL
+      || entrypool->loaded_end <= entrypool->loaded_start)
+    return FALSE;
+
+  total = entrypool_bytes (entrypool);
+  if (total <= budget)
+    return FALSE;
+
+  first = entrypool->loaded_start / ENTRYPOOL_CHUNK_SECONDS;
+  count = (entrypool->loaded_end - 1) / ENTRYPOOL_CHUNK_SECONDS - first + 1;
+  bytes = g_new0 (gsize, count);
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      const EntryPoolTableInfo *info = &entrypool_tables[t];
+      GPtrArray *entries = *entrypool_table_pool (entrypool, t);
+
+      for (guint i = 0; entries != NULL && i < entries->len; i++)
+        {
+          gulong chunk = info->timestamp (g_ptr_array_index (entries, i),
+                                          time_source)
+                         / ENTRYPOOL_CHUNK_SECONDS;
+
+          chunk = CLAMP (chunk, first, first + count - 1);
+          bytes[chunk - first] += info->row_bytes;
+        }
+    }
+
+  hi = count - 1;
+  while (total > budget && lo < hi)
+    {
+      gboolean front = !entrypool_chunk_in_view (entrypool, first + lo);
+      gboolean back = !entrypool_chunk_in_view (entrypool, first + hi);
+
+      if (!front && !back)
+        break;
+
+      /* Ties go to the back, the processes view shows the window start */
+      if (front
+          && (!back
+              || entrypool_chunk_serial (entrypool, first + lo)
+                     < entrypool_chunk_serial (entrypool, first + hi)))
+        total -= bytes[lo++];
+      else
+        total -= bytes[hi--];
+    }
+
+  if (lo == 0 && hi == count - 1)
+    return FALSE;
+
+  start = lo > 0 ? (first + lo) * ENTRYPOOL_CHUNK_SECONDS
+                 : entrypool->loaded_start;
+  end = hi < count - 1 ? (first + hi + 1) * ENTRYPOOL_CHUNK_SECONDS
+                       : entrypool->loaded_end;
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      GPtrArray **pool = entrypool_table_pool (entrypool, t);
+
+      if (*pool != NULL)
+        *pool = entries_clip (*pool, &entrypool_tables[t], time_source, start,
+                              end);
+    }
+
+  entrypool->loaded_start = start;
+  entrypool->loaded_end = end;
+  entrypool->refined_start = MAX (entrypool->refined_start, start);
+  entrypool->refined_end = MIN (entrypool->refined_end, end);
+  if (entrypool->refined_start >= entrypool->refined_end)
+    {
+      entrypool->refined_start = entrypool->refined_end = 0;
+      entrypool->refined_step = entrypool->loaded_step;
+    }
+
+  g_hash_table_iter_init (&iter, entrypool->chunks_viewed);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      gulong chunk = GPOINTER_TO_SIZE (key);
+
+      if (chunk < first + lo || chunk > first + hi)
+        g_hash_table_iter_remove (&iter);
+    }
+
+  g_atomic_int_inc (&entrypool->tables_generation);
+  g_debug ("Evicted loaded chunks, %lu to %lu kept", start, end);
+
+  return TRUE;
+}
+
+/* Keep the entry pools within the memory budget if there is one */
+static gboolean
+entrypool_budget_enforce (TkmEntryPool *entrypool)
+{
+  gsize budget = entrypool_memory_budget (entrypool);
+
+  if (budget == 0)
+    return FALSE;
+
+  return entrypool_chunks_evict (entrypool, budget);
+}
+
+/* Tables of the visible view, all of them if no view says otherwise */
+static guint
+entrypool_visible_tables (TkmEntryPool *entrypool)
+{
+  guint tables = EPOOL_TABLES_ALL;
+  gpointer value = NULL;
+
+  g_mutex_lock (&entrypool->views_lock);
+  if (entrypool->visible_view != NULL
+      && g_hash_table_lookup_extended (entrypool->view_tables,
+                                       entrypool->visible_view, NULL, &value))
+    tables = GPOINTER_TO_UINT (value);
+  g_mutex_unlock (&entrypool->views_lock);
+
+  return tables;
+}
+
 static void
 do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
 {
@@ -284,6 +959,12 @@ do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
   gulong start_timestamp = 0;
   gulong end_timestamp = 0;
   gulong last_timestamp = 0;
+  gulong span = 0;
+  gulong step = 0;
+  gulong batch = 0;
+  gulong from = 0;
+  gsize budget = 0;
+  guint tables = 0;
   GList *ts_node = NULL;
   GList *args = NULL;
 
@@ -298,6 +979,14 @@ do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
   ts_node = g_list_next (args);
   start_timestamp = g_ascii_strtoull (ts_node->data, NULL, 10);
 
+  /* A record stream has no database to load windows from */
+  if (entrypool->input_database == NULL)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
   tkm_entrypool_data_lock (entrypool);
 
   /* cleanup existing entries */
@@ -314,92 +1003,109 @@ do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
   last_timestamp = tkm_session_entry_get_last_timestamp (
     active_session, tkm_settings_get_data_time_source (entrypool->settings));
 
-  switch (tkm_settings_get_data_time_interval (entrypool->settings))
+  span = tkm_settings_get_data_time_span (entrypool->settings);
+  end_timestamp = (span > 0 && (start_timestamp + span) < last_timestamp)
+                      ? (start_timestamp + span)
+                      : last_timestamp;
+
+  /*
+   * Long windows only need a chart width of buckets for the overview, the
+   * viewport loads refine the ranges the user zooms into.
+   */
+  step = (end_timestamp - MIN (start_timestamp, end_timestamp))
+         / ENTRYPOOL_OVERVIEW_POINTS;
+  if (step < 2)
+    step = 0;
+
+  /*
+   * Only the visible view waits for its tables, procacct alone is often
+   * bigger than all the others together and the dashboard never reads it.
+   */
+  tables = entrypool_visible_tables (entrypool);
+
+  /*
+   * Under a memory budget the window is read in batches of whole chunks
+   * and cut short once the budget is used up, the viewport loads read the
+   * rest when it is scrolled to.
+   */
+  budget = entrypool_memory_budget (entrypool);
+  batch = (end_timestamp - MIN (start_timestamp, end_timestamp))
+              / ENTRYPOOL_CHUNK_SECONDS / ENTRYPOOL_LOAD_BATCHES
+          + 1;
+  batch *= ENTRYPOOL_CHUNK_SECONDS;
+
+  from = start_timestamp;
+  do
     {
-    case DATA_TIME_INTERVAL_10S:
-      end_timestamp = (start_timestamp + 10) < last_timestamp
-                          ? (start_timestamp + 10)
-                          : last_timestamp;
-      break;
+      gulong to = end_timestamp;
 
-    case DATA_TIME_INTERVAL_1M:
-      end_timestamp = (start_timestamp + 60) < last_timestamp
-                          ? (start_timestamp + 60)
-                          : last_timestamp;
-      break;
+      if (budget > 0)
+        {
+          to = from / ENTRYPOOL_CHUNK_SECONDS * ENTRYPOOL_CHUNK_SECONDS
+               + batch;
 
-    case DATA_TIME_INTERVAL_10M:
-      end_timestamp = (start_timestamp + 600) < last_timestamp
-                          ? (start_timestamp + 600)
-                          : last_timestamp;
-      break;
+          /* A bucket split across two batches would be drawn twice */
+          if (step > 0)
+            to = (to + step - 1) / step * step;
 
-    case DATA_TIME_INTERVAL_1H:
-      end_timestamp = (start_timestamp + 3600) < last_timestamp
-                          ? (start_timestamp + 3600)
-                          : last_timestamp;
-      break;
+          to = MIN (end_timestamp, to);
+        }
 
-    case DATA_TIME_INTERVAL_24H:
-      end_timestamp = (start_timestamp + 86400) < last_timestamp
-                          ? (start_timestamp + 86400)
-                          : last_timestamp;
-      break;
+      for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+        {
+          GPtrArray **pool = entrypool_table_pool (entrypool, t);
+          GPtrArray *rows = NULL;
 
-    default:
-      end_timestamp = last_timestamp;
-      break;
+          if (!(tables & EPOOL_TABLE_BIT (t)))
+            continue;
+
+          rows = entrypool_table_fetch (entrypool, t, session_hash, from, to,
+                                        step);
+          if (rows == NULL)
+            continue;
+
+          if (*pool != NULL)
+            g_ptr_array_extend_and_steal (*pool, rows);
+          else
+            *pool = rows;
+        }
+
+      from = to;
+    }
+  while (from < end_timestamp
+         && (budget == 0 || entrypool_bytes (entrypool) < budget));
+
+  if (from < end_timestamp)
+    g_debug ("Memory budget reached, window loaded up to %lu", from);
+  end_timestamp = from;
+
+  /*
+   * The tail loads pick up the rows past these marks from the window end
+   * on. The marks are taken at the window end, not at the last row, so
+   * rows written since the sessions were read are not skipped.
+   */
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      entrypool->tail_rowid[t] = table_window_rowid (
+        entrypool, entrypool_tables[t].name, session_hash, end_timestamp);
     }
 
-  entrypool->cpustat_entries = tkm_cpustat_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->meminfo_entries = tkm_meminfo_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->procevent_entries = tkm_procevent_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->pressure_entries = tkm_pressure_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->buddyinfo_entries = tkm_buddyinfo_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->wireless_entries = tkm_wireless_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->diskstat_entries = tkm_diskstat_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->procinfo_entries = tkm_procinfo_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->ctxinfo_entries = tkm_ctxinfo_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
-
-  entrypool->procacct_entries = tkm_procacct_entry_get_all_entries (
-    entrypool->input_database, session_hash,
-    tkm_settings_get_data_time_source (entrypool->settings), start_timestamp,
-    end_timestamp, NULL);
+  g_free (entrypool->loaded_session);
+  entrypool->loaded_session = g_strdup (session_hash);
+  entrypool->loaded_start = start_timestamp;
+  entrypool->loaded_end = end_timestamp;
+  entrypool->loaded_step = step;
+  entrypool->refined_start = entrypool->refined_end = 0;
+  entrypool->refined_step = step;
+  g_atomic_int_set (&entrypool->loaded_tables, tables);
+
+  /* The processes view shows the start of the window, keep it in view */
+  g_hash_table_remove_all (entrypool->chunks_viewed);
+  entrypool_chunks_view (entrypool, start_timestamp, start_timestamp + 1);
+  g_atomic_int_inc (&entrypool->tables_generation);
+
+  g_atomic_int_inc (&entrypool->data_epoch);
+  g_atomic_int_inc (&entrypool->data_generation);
 
   tkm_entrypool_data_unlock (entrypool);
 
@@ -407,23 +1113,669 @@ do_load_data (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
     callback (ACTION_STATUS_COMPLETE, event->action);
 }
 
-static void
-close_database (TkmEntryPool *entrypool)
+typedef GPtrArray *(*EntryPoolFetchFunc) (sqlite3 *db,
+                                          const char *session_hash,
+                                          DataTimeSource time_source,
+                                          gulong start_time, gulong end_time,
+                                          gulong step, GError **error);
+/*
+ * Entry pools drawn by the history charts. The process tables are left
+ * out on purpose, the processes view shows the snapshot at the start of
+ * the loaded window and its charts only zoom within it. The pools with
+ * a timestamp function are bucketed for long windows and refined when
+ * zoomed into.
+ */
+typedef struct _EntryPoolViewportSeries {
+  EntryPoolFetchFunc fetch;
+  EntryPoolTimestampFunc timestamp;
+  EntryPoolRefFunc ref;
+  GDestroyNotify unref;
+  EntryPoolTable table;
+  GPtrArray **entries;
+  GPtrArray *before;
+  GPtrArray *after;
+  GPtrArray *refined;
+} EntryPoolViewportSeries;
+
+/* One range of a viewport series, fetched on the task pool */
+typedef struct _EntryPoolViewportFetch {
+  TkmTask parent;
+
+  const gchar *input_file;
+  const gchar *session_hash;
+  EntryPoolFetchFunc fetch;
+  DataTimeSource time_source;
+  gulong start;
+  gulong end;
+  gulong step;
+  GPtrArray **result;
+} EntryPoolViewportFetch;
+
+static gboolean
+viewport_fetch_exec (TkmTask *task, gpointer context)
 {
-  if (entrypool->input_file != NULL)
-    {
-      g_free (entrypool->input_file);
-      entrypool->input_file = NULL;
-    }
+  EntryPoolViewportFetch *fetch = (EntryPoolViewportFetch *)task;
+  sqlite3 *db = NULL;
+  gulong interrupt = 0;
 
-  if (entrypool->input_database != NULL)
+  TKM_UNUSED (context);
+  g_assert (fetch);
+
+  /* Each fetch reads on a connection of its own so they run side by side */
+  if (sqlite3_open_v2 (fetch->input_file, &db, SQLITE_OPEN_READONLY, NULL)
+      != SQLITE_OK)
     {
-      sqlite3_close (entrypool->input_database);
-      entrypool->input_database = NULL;
+      g_warning ("Cannot open database %s for viewport", fetch->input_file);
+      sqlite3_close (db);
+      return FALSE;
     }
-}
 
-static void
+  sqlite3_busy_timeout (db, ENTRYPOOL_BUSY_TIMEOUT_MS);
+
+  /* A newer viewport interrupts the queries of this one */
+  interrupt = tkm_task_interrupt_connect (tkm_task_get_cancellable (task), db);
+  *fetch->result
+    = fetch->fetch (db, fetch->session_hash, fetch->time_source, fetch->start,
+                    fetch->end, fetch->step, NULL);
+  tkm_task_interrupt_disconnect (tkm_task_get_cancellable (task), interrupt);
+
+  sqlite3_close (db);
+
+  return *fetch->result != NULL;
+}
+
+static void
+viewport_fetch_push (TkmEntryPool *entrypool, TkmTaskGroup *group,
+                     GPtrArray *fetches, EntryPoolFetchFunc func,
+                     const gchar *session_hash, DataTimeSource time_source,
+                     gulong start, gulong end, gulong step, GPtrArray **result)
+{
+  EntryPoolViewportFetch *fetch = g_new0 (EntryPoolViewportFetch, 1);
+
+  fetch->input_file = entrypool->input_file;
+  fetch->session_hash = session_hash;
+  fetch->fetch = func;
+  fetch->time_source = time_source;
+  fetch->start = start;
+  fetch->end = end;
+  fetch->step = step;
+  fetch->result = result;
+
+  /* Ahead of background work, behind the renders the user waits for */
+  tkm_task_init (TKM_TASK (fetch), NULL, viewport_fetch_exec);
+  tkm_task_set_priority (TKM_TASK (fetch), TASK_PRIORITY_PREFETCH);
+  tkm_task_group_add (group, TKM_TASK (fetch));
+  g_ptr_array_add (fetches, fetch);
+
+  /* A fetch that can't be queued completes failed right away */
+  if (!tkm_task_run (TKM_TASK (fetch), entrypool->taskpool))
+    g_warning ("Fail to queue viewport fetch");
+}
+
+static void
+viewport_fetch_free (gpointer _fetch)
+{
+  EntryPoolViewportFetch *fetch = (EntryPoolViewportFetch *)_fetch;
+
+  tkm_task_clear (TKM_TASK (fetch));
+  g_free (fetch);
+}
+
+static GPtrArray *
+entries_extend (GPtrArray *entries, GPtrArray *before, GPtrArray *after)
+{
+  if (before != NULL)
+    {
+      if (entries != NULL)
+        g_ptr_array_extend_and_steal (before, entries);
+      entries = before;
+    }
+
+  if (after != NULL)
+    {
+      if (entries != NULL)
+        g_ptr_array_extend_and_steal (entries, after);
+      else
+        entries = after;
+    }
+
+  return entries;
+}
+
+/* Replace the time ordered entries in [start, end) with the refined ones */
+static GPtrArray *
+entries_refine (GPtrArray *entries, EntryPoolViewportSeries *series,
+                DataTimeSource time_source, gulong start, gulong end)
+{
+  GPtrArray *result = NULL;
+  guint first = 0;
+  guint last = 0;
+
+  if (series->refined == NULL)
+    return entries;
+
+  if (entries == NULL)
+    return series->refined;
+
+  while (first < entries->len
+         && series->timestamp (g_ptr_array_index (entries, first),
+                               time_source)
+                < start)
+    first++;
+
+  last = first;
+  while (last < entries->len
+         && series->timestamp (g_ptr_array_index (entries, last), time_source)
+                < end)
+    last++;
+
+  result = g_ptr_array_new_full (
+    entries->len - (last - first) + series->refined->len, series->unref);
+
+  for (guint i = 0; i < first; i++)
+    g_ptr_array_add (result, series->ref (g_ptr_array_index (entries, i)));
+
+  g_ptr_array_extend_and_steal (result, series->refined);
+
+  for (guint i = last; i < entries->len; i++)
+    g_ptr_array_add (result, series->ref (g_ptr_array_index (entries, i)));
+
+  g_ptr_array_unref (entries);
+
+  return result;
+}
+
+static void
+do_load_viewport (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
+{
+  TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  const gchar *session_hash = NULL;
+  gulong start_timestamp = 0;
+  gulong end_timestamp = 0;
+  gulong refine_start = 0;
+  gulong refine_end = 0;
+  gulong step = 0;
+  g_autoptr (TkmTaskGroup) group = NULL;
+  g_autoptr (GPtrArray) fetches = NULL;
+  gboolean refine = FALSE;
+  GList *args = NULL;
+  EntryPoolViewportSeries series[] = {
+    { tkm_cpustat_entry_get_sampled_entries,
+      (EntryPoolTimestampFunc)tkm_cpustat_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_cpustat_entry_ref,
+      (GDestroyNotify)tkm_cpustat_entry_unref, EPOOL_TABLE_CPUSTAT,
+      &entrypool->cpustat_entries, NULL, NULL, NULL },
+    { tkm_meminfo_entry_get_sampled_entries,
+      (EntryPoolTimestampFunc)tkm_meminfo_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_meminfo_entry_ref,
+      (GDestroyNotify)tkm_meminfo_entry_unref, EPOOL_TABLE_MEMINFO,
+      &entrypool->meminfo_entries, NULL, NULL, NULL },
+    { tkm_pressure_entry_get_sampled_entries,
+      (EntryPoolTimestampFunc)tkm_pressure_entry_get_timestamp,
+      (EntryPoolRefFunc)tkm_pressure_entry_ref,
+      (GDestroyNotify)tkm_pressure_entry_unref, EPOOL_TABLE_PRESSURE,
+      &entrypool->pressure_entries, NULL, NULL, NULL },
+    { tkm_procevent_entry_get_sampled_entries, NULL, NULL, NULL,
+      EPOOL_TABLE_PROCEVENT, &entrypool->procevent_entries, NULL, NULL,
+      NULL },
+  };
+
+  g_assert (entrypool);
+  g_assert (event);
+
+  args = tkm_action_get_args (event->action);
+  g_assert (args);
+
+  session_hash = (const gchar *)(g_list_nth_data (args, 0));
+  start_timestamp = g_ascii_strtoull (g_list_nth_data (args, 1), NULL, 10);
+  end_timestamp = g_ascii_strtoull (g_list_nth_data (args, 2), NULL, 10);
+  step = g_ascii_strtoull (g_list_nth_data (args, 3), NULL, 10);
+
+  /*
+   * The loaded range is only changed on this thread so it can be read
+   * without the data lock. Viewports of an older load or superseded by a
+   * newer one while queued are ignored.
+   */
+  if (entrypool->input_database == NULL
+      || g_strcmp0 (entrypool->loaded_session, session_hash) != 0
+      || g_cancellable_is_cancelled (event->cancellable))
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  /* Chunks of the viewport are the last evicted */
+  entrypool_chunks_view (entrypool, start_timestamp, end_timestamp);
+
+  /* A viewport finer than the loaded buckets refetches what it overlaps */
+  refine_start = MAX (start_timestamp, entrypool->loaded_start);
+  refine_end = MIN (end_timestamp, entrypool->loaded_end);
+
+  if (step < entrypool->loaded_step && refine_start < refine_end)
+    {
+      refine = !(start_timestamp >= entrypool->refined_start
+                 && end_timestamp <= entrypool->refined_end
+                 && step >= entrypool->refined_step);
+    }
+
+  if (start_timestamp >= entrypool->loaded_start
+      && end_timestamp <= entrypool->loaded_end && !refine)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_COMPLETE, event->action);
+      return;
+    }
+
+  /*
+   * Scrolling and zooming push viewports faster than long windows load,
+   * a newer one cancels the fetches of this one and interrupts their
+   * queries.
+   */
+  group = tkm_task_group_new_with_cancellable (event->cancellable);
+  fetches = g_ptr_array_new_with_free_func (viewport_fetch_free);
+
+  /*
+   * Only query the newly exposed ranges and keep what we have. Tables not
+   * loaded yet get the whole window once their view is shown. The ranges
+   * are fetched in parallel as prefetches and joined here.
+   */
+  for (guint i = 0; i < G_N_ELEMENTS (series); i++)
+    {
+      if (!(entrypool->loaded_tables & EPOOL_TABLE_BIT (series[i].table)))
+        continue;
+
+      if (start_timestamp < entrypool->loaded_start)
+        viewport_fetch_push (entrypool, group, fetches, series[i].fetch,
+                             session_hash, time_source, start_timestamp,
+                             entrypool->loaded_start, step,
+                             &series[i].before);
+
+      if (end_timestamp > entrypool->loaded_end)
+        viewport_fetch_push (entrypool, group, fetches, series[i].fetch,
+                             session_hash, time_source, entrypool->loaded_end,
+                             end_timestamp, step, &series[i].after);
+
+      if (refine && series[i].timestamp != NULL)
+        viewport_fetch_push (entrypool, group, fetches, series[i].fetch,
+                             session_hash, time_source, refine_start,
+                             refine_end, step, &series[i].refined);
+    }
+
+  /* Failed fetches leave their range out, as the serial queries did */
+  tkm_task_group_join (group);
+
+  /* Interrupted queries return partial or no rows, keep what we have */
+  if (g_cancellable_is_cancelled (event->cancellable))
+    {
+      for (guint i = 0; i < G_N_ELEMENTS (series); i++)
+        {
+          g_clear_pointer (&series[i].before, g_ptr_array_unref);
+          g_clear_pointer (&series[i].after, g_ptr_array_unref);
+          g_clear_pointer (&series[i].refined, g_ptr_array_unref);
+        }
+
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  tkm_entrypool_data_lock (entrypool);
+
+  for (guint i = 0; i < G_N_ELEMENTS (series); i++)
+    {
+      *series[i].entries = entries_refine (*series[i].entries, &series[i],
+                                           time_source, refine_start,
+                                           refine_end);
+      *series[i].entries = entries_extend (*series[i].entries,
+                                           series[i].before, series[i].after);
+    }
+
+  if (start_timestamp < entrypool->loaded_start)
+    entrypool->loaded_start = start_timestamp;
+  if (end_timestamp > entrypool->loaded_end)
+    entrypool->loaded_end = end_timestamp;
+
+  if (refine || step < entrypool->loaded_step)
+    {
+      entrypool->refined_start = start_timestamp;
+      entrypool->refined_end = end_timestamp;
+      entrypool->refined_step = step;
+    }
+
+  entrypool_budget_enforce (entrypool);
+
+  g_atomic_int_inc (&entrypool->data_epoch);
+  g_atomic_int_inc (&entrypool->data_generation);
+
+  tkm_entrypool_data_unlock (entrypool);
+
+  if (callback != NULL)
+    callback (ACTION_STATUS_COMPLETE, event->action);
+}
+
+static void
+entries_trim (GPtrArray *entries, EntryPoolTimestampFunc timestamp,
+              DataTimeSource time_source, gulong start)
+{
+  guint count = 0;
+
+  if (entries == NULL)
+    return;
+
+  while (count < entries->len
+         && timestamp (g_ptr_array_index (entries, count), time_source)
+                < start)
+    count++;
+
+  if (count > 0)
+    g_ptr_array_remove_range (entries, 0, count);
+}
+
+static void
+do_load_tail (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
+{
+  TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  GPtrArray *tails[EPOOL_TABLE_COUNT] = { NULL };
+  TkmCpuStatEntry *last_cpustat = NULL;
+  const gchar *session_hash = NULL;
+  gulong end_timestamp = 0;
+  gboolean tables_changed = FALSE;
+  gboolean slid = FALSE;
+  gulong span = 0;
+  GList *args = NULL;
+
+  g_assert (entrypool);
+  g_assert (event);
+
+  args = tkm_action_get_args (event->action);
+  g_assert (args);
+
+  session_hash = (const gchar *)(g_list_nth_data (args, 0));
+
+  if (entrypool->input_database == NULL
+      || g_strcmp0 (entrypool->loaded_session, session_hash) != 0)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  /*
+   * Only the rows past the high-water marks are read, so a poll costs the
+   * same however long the capture has been running.
+   */
+  end_timestamp = entrypool->loaded_end;
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      const EntryPoolTableInfo *info = &entrypool_tables[t];
+      gint64 last_rowid = 0;
+
+      /* Loaded later over the whole window, past rows included */
+      if (!(entrypool->loaded_tables & EPOOL_TABLE_BIT (t)))
+        continue;
+
+      last_rowid = table_last_rowid (entrypool->input_database, info->name);
+      if (last_rowid <= entrypool->tail_rowid[t])
+        continue;
+
+      tails[t] = info->tail (entrypool->input_database, session_hash,
+                             time_source, entrypool->loaded_end,
+                             entrypool->tail_rowid[t], last_rowid, NULL);
+      if (tails[t] == NULL)
+        continue;
+
+      entrypool->tail_rowid[t] = last_rowid;
+
+      if (tails[t]->len > 0)
+        {
+          gpointer last = g_ptr_array_index (tails[t], tails[t]->len - 1);
+
+          end_timestamp
+            = MAX (end_timestamp, info->timestamp (last, time_source) + 1);
+        }
+    }
+
+  if (end_timestamp == entrypool->loaded_end)
+    {
+      for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+        g_clear_pointer (&tails[t], g_ptr_array_unref);
+
+      if (callback != NULL)
+        callback (ACTION_STATUS_COMPLETE, event->action);
+      return;
+    }
+
+  if (tails[EPOOL_TABLE_CPUSTAT] != NULL
+      && tails[EPOOL_TABLE_CPUSTAT]->len > 0)
+    {
+      last_cpustat = g_ptr_array_index (tails[EPOOL_TABLE_CPUSTAT],
+                                        tails[EPOOL_TABLE_CPUSTAT]->len - 1);
+    }
+
+  tkm_entrypool_data_lock (entrypool);
+
+  if (last_cpustat != NULL && entrypool->session_entries != NULL)
+    {
+      for (guint i = 0; i < entrypool->session_entries->len; i++)
+        {
+          TkmSessionEntry *session
+            = g_ptr_array_index (entrypool->session_entries, i);
+
+          if (g_strcmp0 (tkm_session_entry_get_hash (session), session_hash)
+              != 0)
+            continue;
+
+          for (DataTimeSource source = DATA_TIME_SOURCE_SYSTEM;
+               source <= DATA_TIME_SOURCE_RECEIVE; source++)
+            {
+              tkm_session_entry_set_last_timestamp (
+                session, source,
+                tkm_cpustat_entry_get_timestamp (last_cpustat, source));
+            }
+        }
+    }
+
+  entrypool->loaded_end = end_timestamp;
+
+  /* Slide the window so the pools stay the size of the time interval */
+  span = tkm_settings_get_data_time_span (entrypool->settings);
+  if (span > 0 && entrypool->loaded_end - entrypool->loaded_start > span)
+    {
+      entrypool->loaded_start = entrypool->loaded_end - span;
+      slid = TRUE;
+    }
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      const EntryPoolTableInfo *info = &entrypool_tables[t];
+      GPtrArray **pool = entrypool_table_pool (entrypool, t);
+
+      if (ENTRYPOOL_SERIES_TABLES & EPOOL_TABLE_BIT (t))
+        {
+          /* Charts read the series under the data lock, grow them in place */
+          *pool = entries_extend (*pool, NULL, tails[t]);
+          if (*pool != NULL)
+            entries_trim (*pool, info->timestamp, time_source,
+                          entrypool->loaded_start);
+          continue;
+        }
+
+      /*
+       * The views hand these pools to background tasks that read them
+       * without the lock, so they are replaced rather than changed.
+       */
+      if (*pool != NULL
+          && ((tails[t] != NULL && tails[t]->len > 0) || slid))
+        {
+          *pool = entries_clip (*pool, info, time_source,
+                                entrypool->loaded_start, G_MAXULONG);
+          tables_changed = TRUE;
+        }
+      *pool = entries_extend (*pool, NULL, tails[t]);
+    }
+
+  /* The live view follows the end of the capture */
+  entrypool_chunks_view (entrypool, entrypool->loaded_end - 1,
+                         entrypool->loaded_end);
+  if (entrypool_budget_enforce (entrypool))
+    g_atomic_int_inc (&entrypool->data_epoch);
+
+  if (tables_changed)
+    g_atomic_int_inc (&entrypool->tables_generation);
+  g_atomic_int_inc (&entrypool->data_generation);
+
+  tkm_entrypool_data_unlock (entrypool);
+
+  if (callback != NULL)
+    callback (ACTION_STATUS_COMPLETE, event->action);
+}
+
+static void
+do_load_tables (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
+{
+  TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
+  GPtrArray *pools[EPOOL_TABLE_COUNT] = { NULL };
+  const gchar *session_hash = NULL;
+  guint missing = 0;
+  GList *args = NULL;
+
+  g_assert (entrypool);
+  g_assert (event);
+
+  args = tkm_action_get_args (event->action);
+  g_assert (args);
+
+  session_hash = (const gchar *)(g_list_nth_data (args, 0));
+
+  if (entrypool->input_database == NULL
+      || g_strcmp0 (entrypool->loaded_session, session_hash) != 0)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  missing = entrypool_visible_tables (entrypool) & ~entrypool->loaded_tables;
+  if (missing == 0)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_COMPLETE, event->action);
+      return;
+    }
+
+  /* Same window and buckets as the tables loaded before */
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      if (!(missing & EPOOL_TABLE_BIT (t)))
+        continue;
+
+      pools[t] = entrypool_table_fetch (entrypool, t, session_hash,
+                                        entrypool->loaded_start,
+                                        entrypool->loaded_end,
+                                        entrypool->loaded_step);
+      entrypool->tail_rowid[t]
+        = table_window_rowid (entrypool, entrypool_tables[t].name,
+                              session_hash, entrypool->loaded_end);
+    }
+
+  tkm_entrypool_data_lock (entrypool);
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      GPtrArray **pool = entrypool_table_pool (entrypool, t);
+
+      if (!(missing & EPOOL_TABLE_BIT (t)))
+        continue;
+
+      g_clear_pointer (pool, g_ptr_array_unref);
+      *pool = pools[t];
+    }
+
+  /* The new series only have the overview buckets, refine them again */
+  if (missing & ENTRYPOOL_SERIES_TABLES)
+    {
+      entrypool->refined_start = entrypool->refined_end = 0;
+      entrypool->refined_step = entrypool->loaded_step;
+    }
+
+  g_atomic_int_or (&entrypool->loaded_tables, missing);
+
+  /* The budget covered the tables loaded first, make room for these */
+  entrypool_budget_enforce (entrypool);
+  g_atomic_int_inc (&entrypool->tables_generation);
+
+  g_atomic_int_inc (&entrypool->data_epoch);
+  g_atomic_int_inc (&entrypool->data_generation);
+
+  tkm_entrypool_data_unlock (entrypool);
+
+  if (callback != NULL)
+    callback (ACTION_STATUS_COMPLETE, event->action);
+}
+
+static void
+do_drop_caches (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
+{
+  TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
+  gboolean evicted = FALSE;
+
+  g_assert (entrypool);
+  g_assert (event);
+
+  if (entrypool->input_database == NULL)
+    {
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  /* Pages sqlite cached for the loads are read again when needed */
+  sqlite3_db_release_memory (entrypool->input_database);
+
+  tkm_entrypool_data_lock (entrypool);
+
+  /* Only the chunks in view stay, viewport loads bring back the others */
+  evicted = entrypool_chunks_evict (entrypool, 0);
+  if (evicted)
+    {
+      g_atomic_int_inc (&entrypool->data_epoch);
+      g_atomic_int_inc (&entrypool->data_generation);
+    }
+
+  tkm_entrypool_data_unlock (entrypool);
+
+  if (callback != NULL)
+    callback (evicted ? ACTION_STATUS_COMPLETE : ACTION_STATUS_FAILED,
+              event->action);
+}
+
+static void
+close_database (TkmEntryPool *entrypool)
+{
+  stream_stop (entrypool);
+
+  if (entrypool->input_file != NULL)
+    {
+      g_free (entrypool->input_file);
+      entrypool->input_file = NULL;
+    }
+
+  if (entrypool->input_database != NULL)
+    {
+      sqlite3_close (entrypool->input_database);
+      entrypool->input_database = NULL;
+    }
+
+  /* Viewports are relative to data loaded from this database */
+  g_clear_pointer (&entrypool->loaded_session, g_free);
+}
+
+static void
 do_open_database_file (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
 {
   TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
@@ -448,11 +1800,371 @@ do_open_database_file (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
     }
   else
     {
+      /*
+       * The capture may still be written, wait out the short writer locks
+       * instead of failing and keep to shared reads on a WAL journal.
+       */
+      sqlite3_busy_timeout (entrypool->input_database,
+                            ENTRYPOOL_BUSY_TIMEOUT_MS);
+      sqlite3_exec (entrypool->input_database, "PRAGMA query_only = 1;", NULL,
+                    NULL, NULL);
+
       if (callback != NULL)
         callback (ACTION_STATUS_COMPLETE, event->action);
     }
 }
 
+typedef struct _EntryPoolStream {
+  TkmEntryPool *entrypool;
+  TkmAction *action;
+  GObject *connection;
+  GInputStream *input;
+  GCancellable *cancellable;
+  GPtrArray *sessions;
+  /* rows decoded since the last merge, per table */
+  GPtrArray *batch[EPOOL_TABLE_COUNT];
+  gboolean announced;
+} EntryPoolStream;
+
+static void
+stream_pools_reset (TkmEntryPool *entrypool)
+{
+  main_entries_free (entrypool);
+  g_atomic_int_inc (&entrypool->data_epoch);
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      *entrypool_table_pool (entrypool, t)
+        = g_ptr_array_new_with_free_func (entrypool_tables[t].unref);
+    }
+
+  entrypool->loaded_start = entrypool->loaded_end = 0;
+  entrypool->loaded_step = entrypool->refined_step = 0;
+  entrypool->refined_start = entrypool->refined_end = 0;
+  g_atomic_int_set (&entrypool->loaded_tables, EPOOL_TABLES_ALL);
+}
+
+static void
+stream_record_decode (EntryPoolStream *stream, TkmStreamRecord *record)
+{
+  if (g_strcmp0 (record->table, TKM_SESSIONS_TABLE_NAME) == 0)
+    {
+      TkmSessionEntry *session = NULL;
+
+      if (!tkm_session_entry_append_record (stream->sessions,
+                                            record->n_fields, record->values,
+                                            record->names))
+        return;
+
+      session = g_ptr_array_index (stream->sessions, stream->sessions->len - 1);
+
+      /* The views index the session by hash and size charts per core */
+      if (tkm_session_entry_get_hash (session) == NULL
+          || tkm_session_entry_get_hash (session)[0] == '\0'
+          || tkm_session_entry_get_device_cpus (session) == 0)
+        {
+          g_warning ("Stream session record without Hash or CoreCount, "
+                     "ignored");
+          g_ptr_array_remove_index (stream->sessions,
+                                    stream->sessions->len - 1);
+          return;
+        }
+
+      /* Sessions of a database take the device name from another table */
+      for (gint i = 0; i < record->n_fields; i++)
+        {
+          if (g_strcmp0 (record->names[i], "DeviceName") == 0)
+            tkm_session_entry_set_device_name (session, record->values[i]);
+        }
+      return;
+    }
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      if (g_strcmp0 (record->table, entrypool_tables[t].name) == 0)
+        {
+          entrypool_tables[t].append (stream->batch[t], record->n_fields,
+                                      record->values, record->names);
+          return;
+        }
+    }
+}
+
+static void
+stream_merge (EntryPoolStream *stream)
+{
+  TkmEntryPool *entrypool = stream->entrypool;
+  TkmActionStatusCallback callback = tkm_action_get_callback (stream->action);
+  DataTimeSource time_source
+    = tkm_settings_get_data_time_source (entrypool->settings);
+  TkmSessionEntry *session = NULL;
+  gboolean tables_changed = FALSE;
+  gboolean has_rows = FALSE;
+  gboolean merged = FALSE;
+
+  tkm_entrypool_data_lock (entrypool);
+
+  /* A session record starts over, the records that follow belong to it */
+  if (stream->sessions->len > 0)
+    {
+      session = g_ptr_array_steal_index (stream->sessions,
+                                         stream->sessions->len - 1);
+      g_ptr_array_set_size (stream->sessions, 0);
+      tkm_session_entry_set_active (session, TRUE);
+
+      /* Readers may still hold the old sessions, as with database loads */
+      if (entrypool->session_entries != NULL)
+        g_ptr_array_free (entrypool->session_entries, FALSE);
+      entrypool->session_entries = g_ptr_array_new_with_free_func (
+        (GDestroyNotify)tkm_session_entry_unref);
+      g_ptr_array_add (entrypool->session_entries, session);
+
+      stream_pools_reset (entrypool);
+      g_free (entrypool->loaded_session);
+      entrypool->loaded_session
+        = g_strdup (tkm_session_entry_get_hash (session));
+
+      stream->announced = FALSE;
+      merged = TRUE;
+    }
+  else if (entrypool->session_entries != NULL
+           && entrypool->session_entries->len > 0)
+    {
+      session = g_ptr_array_index (entrypool->session_entries, 0);
+    }
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      const EntryPoolTableInfo *info = &entrypool_tables[t];
+      GPtrArray **pool = entrypool_table_pool (entrypool, t);
+      GPtrArray *entries = *pool;
+
+      if (stream->batch[t]->len == 0)
+        continue;
+
+      /* Records ahead of the first session have nothing to belong to */
+      if (session == NULL || entries == NULL)
+        {
+          g_ptr_array_set_size (stream->batch[t], 0);
+          continue;
+        }
+
+      if (!(ENTRYPOOL_SERIES_TABLES & EPOOL_TABLE_BIT (t)))
+        {
+          /*
+           * The views hand these pools to background tasks that read them
+           * without the lock, so they are replaced rather than changed.
+           */
+          GPtrArray *copy = g_ptr_array_new_full (
+            entries->len + stream->batch[t]->len, info->unref);
+          guint first = 0;
+
+          /* Trimmed here, the copy holds the rows that are kept */
+          if (entries->len + stream->batch[t]->len > ENTRYPOOL_STREAM_ROWS)
+            first = MIN (entries->len, entries->len + stream->batch[t]->len
+                                         - ENTRYPOOL_STREAM_ROWS);
+
+          for (guint i = first; i < entries->len; i++)
+            g_ptr_array_add (copy, info->ref (g_ptr_array_index (entries, i)));
+
+          g_ptr_array_unref (entries);
+          *pool = entries = copy;
+          tables_changed = TRUE;
+        }
+
+      g_ptr_array_extend_and_steal (entries, stream->batch[t]);
+      stream->batch[t] = g_ptr_array_new_with_free_func (info->unref);
+
+      /* Drop the oldest rows in slices so trimming stays amortized */
+      if (entries->len > ENTRYPOOL_STREAM_ROWS + ENTRYPOOL_STREAM_ROWS / 8)
+        g_ptr_array_remove_range (entries, 0,
+                                  entries->len - ENTRYPOOL_STREAM_ROWS);
+
+      merged = TRUE;
+    }
+
+  if (session != NULL && entrypool->cpustat_entries != NULL
+      && entrypool->cpustat_entries->len > 0)
+    {
+      GPtrArray *entries = entrypool->cpustat_entries;
+      TkmCpuStatEntry *first = g_ptr_array_index (entries, 0);
+      TkmCpuStatEntry *last = g_ptr_array_index (entries, entries->len - 1);
+
+      for (DataTimeSource source = DATA_TIME_SOURCE_SYSTEM;
+           source <= DATA_TIME_SOURCE_RECEIVE; source++)
+        {
+          tkm_session_entry_set_first_timestamp (
+            session, source, tkm_cpustat_entry_get_timestamp (first, source));
+          tkm_session_entry_set_last_timestamp (
+            session, source, tkm_cpustat_entry_get_timestamp (last, source));
+        }
+
+      entrypool->loaded_start
+        = tkm_cpustat_entry_get_timestamp (first, time_source);
+      entrypool->loaded_end
+        = tkm_cpustat_entry_get_timestamp (last, time_source) + 1;
+    }
+
+  if (tables_changed)
+    g_atomic_int_inc (&entrypool->tables_generation);
+  if (merged)
+    g_atomic_int_inc (&entrypool->data_generation);
+
+  /* The pools belong to the readers once the lock is released */
+  has_rows = entrypool->cpustat_entries != NULL
+             && entrypool->cpustat_entries->len > 0;
+
+  tkm_entrypool_data_unlock (entrypool);
+
+  if (!merged || callback == NULL)
+    return;
+
+  /* The session is shown once it has chart rows, later merges extend it */
+  if (!stream->announced)
+    {
+      if (has_rows)
+        {
+          stream->announced = TRUE;
+          callback (ACTION_STATUS_COMPLETE, stream->action);
+        }
+    }
+  else
+    callback (ACTION_STATUS_PROGRESS, stream->action);
+}
+
+static void
+stream_free (EntryPoolStream *stream)
+{
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    g_ptr_array_unref (stream->batch[t]);
+
+  g_ptr_array_unref (stream->sessions);
+  g_object_unref (stream->input);
+  g_clear_object (&stream->connection);
+  g_object_unref (stream->cancellable);
+  tkm_action_unref (stream->action);
+
+  g_free (stream);
+}
+
+static gpointer
+stream_read_thread (gpointer data)
+{
+  EntryPoolStream *stream = (EntryPoolStream *)data;
+  g_autoptr (GDataInputStream) input = NULL;
+  g_autoptr (GError) error = NULL;
+  gint64 merge_time = g_get_monotonic_time ();
+  gchar *line = NULL;
+
+  input = g_data_input_stream_new (stream->input);
+
+  while ((line = g_data_input_stream_read_line (input, NULL,
+                                                stream->cancellable, &error))
+         != NULL)
+    {
+      TkmStreamRecord record;
+
+      if (tkm_stream_record_parse (&record, line))
+        stream_record_decode (stream, &record);
+
+      g_free (line);
+
+      /* Merge once the input is drained or the records waited long enough */
+      if (g_buffered_input_stream_get_available (
+            G_BUFFERED_INPUT_STREAM (input))
+              == 0
+          || g_get_monotonic_time () - merge_time
+                 >= ENTRYPOOL_STREAM_MERGE_MS * G_TIME_SPAN_MILLISECOND)
+        {
+          stream_merge (stream);
+          merge_time = g_get_monotonic_time ();
+        }
+    }
+
+  /* A cancelled reader leaves the pools to whoever stopped it */
+  if (!g_cancellable_is_cancelled (stream->cancellable))
+    stream_merge (stream);
+
+  if (error == NULL)
+    g_info ("Record stream ended");
+  else if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    g_warning ("Record stream read failed %s", error->message);
+
+  stream_free (stream);
+
+  return NULL;
+}
+
+static void
+stream_stop (TkmEntryPool *entrypool)
+{
+  if (entrypool->stream_thread == NULL)
+    return;
+
+  g_cancellable_cancel (entrypool->stream_cancellable);
+  g_thread_join (entrypool->stream_thread);
+
+  entrypool->stream_thread = NULL;
+  g_clear_object (&entrypool->stream_cancellable);
+}
+
+static void
+do_open_stream (TkmEntryPool *entrypool, TkmEntryPoolEvent *event)
+{
+  TkmActionStatusCallback callback = tkm_action_get_callback (event->action);
+  g_autoptr (GError) error = NULL;
+  EntryPoolStream *stream = NULL;
+  GObject *connection = NULL;
+  GInputStream *input = NULL;
+  const gchar *address = NULL;
+  GList *args = NULL;
+
+  g_assert (entrypool);
+  g_assert (event);
+
+  args = tkm_action_get_args (event->action);
+  g_assert (args);
+
+  address = (const gchar *)(g_list_first (args)->data);
+
+  close_database (entrypool);
+
+  entrypool->stream_cancellable = g_cancellable_new ();
+  input = tkm_stream_open (address, &connection,
+                           entrypool->stream_cancellable, &error);
+  if (input == NULL)
+    {
+      g_warning ("Cannot open record stream %s. %s", address, error->message);
+      g_clear_object (&entrypool->stream_cancellable);
+      if (callback != NULL)
+        callback (ACTION_STATUS_FAILED, event->action);
+      return;
+    }
+
+  stream = g_new0 (EntryPoolStream, 1);
+  stream->entrypool = entrypool;
+  stream->action = tkm_action_ref (event->action);
+  stream->connection = connection;
+  stream->input = input;
+  stream->cancellable = g_object_ref (entrypool->stream_cancellable);
+  stream->sessions = g_ptr_array_new_with_free_func (
+    (GDestroyNotify)tkm_session_entry_unref);
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      stream->batch[t]
+        = g_ptr_array_new_with_free_func (entrypool_tables[t].unref);
+    }
+
+  tkm_entrypool_data_lock (entrypool);
+  stream_pools_reset (entrypool);
+  g_atomic_int_inc (&entrypool->data_generation);
+  tkm_entrypool_data_unlock (entrypool);
+
+  entrypool->input_file = g_strdup (address);
+  entrypool->stream_thread
+    = g_thread_new ("TkmStreamThread", stream_read_thread, stream);
+}
+
 static void
 entrypool_source_destroy_notify (gpointer _entrypool)
 {
@@ -482,6 +2194,11 @@ tkm_entrypool_new (GMainContext *context, TkmTaskPool *taskpool,
 
   g_ref_count_init (&entrypool->rc);
   g_mutex_init (&entrypool->entries_lock);
+  g_mutex_init (&entrypool->viewport_lock);
+  g_mutex_init (&entrypool->views_lock);
+  entrypool->view_tables
+    = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  entrypool->chunks_viewed = g_hash_table_new (g_direct_hash, g_direct_equal);
   entrypool->callback = entrypool_source_callback;
   entrypool->queue = g_async_queue_new_full (entrypool_queue_destroy_notify);
   entrypool->taskpool = tkm_taskpool_ref (taskpool);
@@ -524,15 +2241,24 @@ tkm_entrypool_unref (TkmEntryPool *entrypool)
 
   if (g_ref_count_dec (&entrypool->rc) == TRUE)
     {
+      /* The stream reader merges with the settings, stop it first */
+      stream_stop (entrypool);
+
       if (entrypool->taskpool != NULL)
         tkm_taskpool_unref (entrypool->taskpool);
 
       if (entrypool->settings != NULL)
         tkm_settings_unref (entrypool->settings);
 
+      g_clear_object (&entrypool->viewport_cancellable);
+      g_hash_table_destroy (entrypool->view_tables);
+      g_hash_table_destroy (entrypool->chunks_viewed);
+      g_free (entrypool->visible_view);
+
       if (entrypool->input_file != NULL)
         g_free (entrypool->input_file);
 
+      g_free (entrypool->loaded_session);
       main_entries_free (entrypool);
 
       g_async_queue_unref (entrypool->queue);
@@ -563,6 +2289,37 @@ tkm_entrypool_push_action (TkmEntryPool *entrypool, TkmAction *action)
       e->type = EPOOL_EVENT_LOAD_DATA;
       break;
 
+    case ACTION_LOAD_VIEWPORT:
+      e->type = EPOOL_EVENT_LOAD_VIEWPORT;
+      e->cancellable = g_cancellable_new ();
+
+      /* Only the last viewport matters, queued or already loading */
+      g_mutex_lock (&entrypool->viewport_lock);
+      if (entrypool->viewport_cancellable != NULL)
+        {
+          g_cancellable_cancel (entrypool->viewport_cancellable);
+          g_object_unref (entrypool->viewport_cancellable);
+        }
+      entrypool->viewport_cancellable = g_object_ref (e->cancellable);
+      g_mutex_unlock (&entrypool->viewport_lock);
+      break;
+
+    case ACTION_LOAD_TAIL:
+      e->type = EPOOL_EVENT_LOAD_TAIL;
+      break;
+
+    case ACTION_OPEN_STREAM:
+      e->type = EPOOL_EVENT_OPEN_STREAM;
+      break;
+
+    case ACTION_LOAD_TABLES:
+      e->type = EPOOL_EVENT_LOAD_TABLES;
+      break;
+
+    case ACTION_DROP_CACHES:
+      e->type = EPOOL_EVENT_DROP_CACHES;
+      break;
+
     default:
       break;
     }
@@ -649,6 +2406,78 @@ tkm_entrypool_get_diskstat_entries (TkmEntryPool *entrypool)
   return entrypool->diskstat_entries;
 }
 
+void
+tkm_entrypool_register_view (TkmEntryPool *entrypool, const gchar *name,
+                             guint tables)
+{
+  g_assert (entrypool);
+  g_assert (name);
+
+  g_mutex_lock (&entrypool->views_lock);
+  g_hash_table_insert (entrypool->view_tables, g_strdup (name),
+                       GUINT_TO_POINTER (tables));
+  g_mutex_unlock (&entrypool->views_lock);
+}
+
+void
+tkm_entrypool_set_visible_view (TkmEntryPool *entrypool, const gchar *name)
+{
+  g_assert (entrypool);
+
+  g_mutex_lock (&entrypool->views_lock);
+  g_free (entrypool->visible_view);
+  entrypool->visible_view = g_strdup (name);
+  g_mutex_unlock (&entrypool->views_lock);
+}
+
+/*
+ * Tables the visible view reads that the loaded window doesn't have yet,
+ * none while nothing is loaded.
+ */
+guint
+tkm_entrypool_get_missing_tables (TkmEntryPool *entrypool)
+{
+  guint loaded = 0;
+
+  g_assert (entrypool);
+
+  loaded = (guint)g_atomic_int_get (&entrypool->loaded_tables);
+  if (loaded == 0)
+    return 0;
+
+  return entrypool_visible_tables (entrypool) & ~loaded;
+}
+
+gsize
+tkm_entrypool_get_table_bytes (TkmEntryPool *entrypool, EntryPoolTable table)
+{
+  g_assert (entrypool);
+  g_assert (table < EPOOL_TABLE_COUNT);
+
+  return entrypool_table_bytes (entrypool, table);
+}
+
+guint
+tkm_entrypool_get_data_generation (TkmEntryPool *entrypool)
+{
+  g_assert (entrypool);
+  return (guint)g_atomic_int_get (&entrypool->data_generation);
+}
+
+guint
+tkm_entrypool_get_data_epoch (TkmEntryPool *entrypool)
+{
+  g_assert (entrypool);
+  return (guint)g_atomic_int_get (&entrypool->data_epoch);
+}
+
+guint
+tkm_entrypool_get_tables_generation (TkmEntryPool *entrypool)
+{
+  g_assert (entrypool);
+  return (guint)g_atomic_int_get (&entrypool->tables_generation);
+}
+
 void
 tkm_entrypool_data_lock (TkmEntryPool *entrypool)
 {
@@ -37,15 +37,40 @@ G_BEGIN_DECLS
 typedef enum _EntryPoolEventType {
   EPOOL_EVENT_OPEN_DATABASE_FILE,
   EPOOL_EVENT_LOAD_SESSIONS,
-  EPOOL_EVENT_LOAD_DATA
+  EPOOL_EVENT_LOAD_DATA,
+  EPOOL_EVENT_LOAD_VIEWPORT,
+  EPOOL_EVENT_LOAD_TAIL,
+  EPOOL_EVENT_OPEN_STREAM,
+  EPOOL_EVENT_LOAD_TABLES,
+  EPOOL_EVENT_DROP_CACHES
 } EntryPoolEventType;
 
+/* Tables a view reads, registered as masks of EPOOL_TABLE_BIT() */
+typedef enum _EntryPoolTable {
+  EPOOL_TABLE_PROCINFO,
+  EPOOL_TABLE_CTXINFO,
+  EPOOL_TABLE_PROCACCT,
+  EPOOL_TABLE_CPUSTAT,
+  EPOOL_TABLE_MEMINFO,
+  EPOOL_TABLE_PROCEVENT,
+  EPOOL_TABLE_PRESSURE,
+  EPOOL_TABLE_BUDDYINFO,
+  EPOOL_TABLE_WIRELESS,
+  EPOOL_TABLE_DISKSTAT,
+  EPOOL_TABLE_COUNT
+} EntryPoolTable;
+
+#define EPOOL_TABLE_BIT(t) (1u << (t))
+#define EPOOL_TABLES_ALL (EPOOL_TABLE_BIT (EPOOL_TABLE_COUNT) - 1)
+
 typedef gboolean (*TkmEntryPoolCallback) (gpointer _entrypool,
                                           gpointer _event);
 
 typedef struct _TkmEntryPoolEvent {
   EntryPoolEventType type;
   TkmAction *action;
+  /* cancelled when a newer event supersedes this one */
+  GCancellable *cancellable;
 } TkmEntryPoolEvent;
 
 typedef struct _TkmEntryPool {
@@ -75,6 +100,56 @@ typedef struct _TkmEntryPool {
   GPtrArray *wireless_entries;
   GPtrArray *diskstat_entries;
 
+  /* session and time range the entry pools above hold */
+  gchar *loaded_session;
+  gulong loaded_start;
+  gulong loaded_end;
+  /* bucket width of the series pools, 0 for raw rows */
+  gulong loaded_step;
+  /* range zoomed into and loaded at a finer bucket width */
+  gulong refined_start;
+  gulong refined_end;
+  gulong refined_step;
+  /* rowid high-water marks of the tables followed by the tail loads */
+  gint64 tail_rowid[EPOOL_TABLE_COUNT];
+
+  /* reader of a record stream fed instead of a database */
+  GThread *stream_thread;
+  GCancellable *stream_cancellable;
+
+  /* token of the last viewport pushed, guarded by the viewport lock */
+  GMutex viewport_lock;
+  GCancellable *viewport_cancellable;
+
+  /*
+   * Tables each view reads and the view shown, guarded by the views lock.
+   * Loads only fill the tables of the visible view, the others are loaded
+   * into the same window when their view is first shown.
+   */
+  GMutex views_lock;
+  GHashTable *view_tables;
+  gchar *visible_view;
+  /* tables the entry pools hold for the loaded window */
+  guint loaded_tables;
+
+  /*
+   * The loaded window is accounted in chunks of ENTRYPOOL_CHUNK_SECONDS.
+   * Over the memory budget the chunks at its ends are evicted, least
+   * recently viewed first, and read back from the database when a
+   * viewport reaches them again. Only used on the entrypool thread.
+   */
+  GHashTable *chunks_viewed;
+  guint view_serial;
+  gulong viewed_start;
+  gulong viewed_end;
+
+  /* bumped each time the entry pools above change */
+  gint data_generation;
+  /* bumped only when they are replaced rather than extended at the end */
+  gint data_epoch;
+  /* bumped when rows of the tables not drawn as series change */
+  gint tables_generation;
+
   grefcount rc;
 } TkmEntryPool;
 
@@ -97,6 +172,19 @@ GPtrArray *tkm_entrypool_get_diskstat_entries (TkmEntryPool *entrypool);
 void tkm_entrypool_unref (TkmEntryPool *entrypool);
 void tkm_entrypool_push_action (TkmEntryPool *entrypool, TkmAction *action);
 
+void tkm_entrypool_register_view (TkmEntryPool *entrypool, const gchar *name,
+                                  guint tables);
+void tkm_entrypool_set_visible_view (TkmEntryPool *entrypool,
+                                     const gchar *name);
+guint tkm_entrypool_get_missing_tables (TkmEntryPool *entrypool);
+/* Estimated memory held by a table, called with the data lock held */
+gsize tkm_entrypool_get_table_bytes (TkmEntryPool *entrypool,
+                                     EntryPoolTable table);
+
+guint tkm_entrypool_get_data_generation (TkmEntryPool *entrypool);
+guint tkm_entrypool_get_data_epoch (TkmEntryPool *entrypool);
+guint tkm_entrypool_get_tables_generation (TkmEntryPool *entrypool);
+
 void tkm_entrypool_data_lock (TkmEntryPool *entrypool);
 gboolean tkm_entrypool_data_try_lock (TkmEntryPool *entrypool);
 void tkm_entrypool_data_unlock (TkmEntryPool *entrypool);
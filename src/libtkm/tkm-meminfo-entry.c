@@ -22,10 +22,27 @@
  */
 
 #include "tkm-meminfo-entry.h"
+#include "tkm-series.h"
 
 static const gchar *timeSourceColumn[]
   = { "SystemTime", "MonotonicTime", "ReceiveTime" };
 
+static const TkmSeriesColumn memInfoSeriesColumns[] = {
+  { "SystemTime", SERIES_AGGREGATE_MIN },
+  { "MonotonicTime", SERIES_AGGREGATE_MIN },
+  { "ReceiveTime", SERIES_AGGREGATE_MIN },
+  { "MemTotal", SERIES_AGGREGATE_AVG },
+  { "MemFree", SERIES_AGGREGATE_AVG },
+  { "MemAvail", SERIES_AGGREGATE_AVG },
+  { "MemCached", SERIES_AGGREGATE_AVG },
+  { "MemAvailPercent", SERIES_AGGREGATE_AVG },
+  { "SwapTotal", SERIES_AGGREGATE_AVG },
+  { "SwapFree", SERIES_AGGREGATE_AVG },
+  { "SwapCached", SERIES_AGGREGATE_AVG },
+  { "CmaTotal", SERIES_AGGREGATE_AVG },
+  { "CmaFree", SERIES_AGGREGATE_AVG },
+};
+
 /**
  * @enum MemInfo query type
  */
@@ -49,7 +66,7 @@ tkm_meminfo_entry_new (void)
 {
   TkmMemInfoEntry *entry = g_new0 (TkmMemInfoEntry, 1);
 
-  g_ref_count_init (&entry->rc);
+  g_atomic_ref_count_init (&entry->rc);
 
   return entry;
 }
@@ -58,7 +75,7 @@ TkmMemInfoEntry *
 tkm_meminfo_entry_ref (TkmMemInfoEntry *entry)
 {
   g_assert (entry);
-  g_ref_count_inc (&entry->rc);
+  g_atomic_ref_count_inc (&entry->rc);
   return entry;
 }
 
@@ -67,7 +84,7 @@ tkm_meminfo_entry_unref (TkmMemInfoEntry *entry)
 {
   g_assert (entry);
 
-  if (g_ref_count_dec (&entry->rc) == TRUE)
+  if (g_atomic_ref_count_dec (&entry->rc) == TRUE)
     {
       g_free (entry);
     }
@@ -329,11 +346,74 @@ meminfo_entry_free (gpointer data)
   tkm_meminfo_entry_unref (e);
 }
 
+GPtrArray *
+tkm_meminfo_entry_get_sampled_entries (sqlite3 *db, const char *session_hash,
+                                       DataTimeSource time_source,
+                                       gulong start_time, gulong end_time,
+                                       gulong step, GError **error)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  GPtrArray *entries = g_ptr_array_new ();
+  MemInfoQueryData data
+    = { .type = MEMINFO_GET_ENTRIES, .response = (gpointer) & entries };
+
+  g_ptr_array_set_free_func (entries, meminfo_entry_free);
+
+  g_assert (db);
+
+  /* Fold the rows of each step seconds into one, enough for overview charts */
+  if (step > 0)
+    {
+      TkmSeriesQuery query = { .table = TKM_MEMINFO_TABLE_NAME,
+                               .key = NULL,
+                               .time_source = time_source,
+                               .start_time = start_time,
+                               .end_time = end_time,
+                               .bucket = step,
+                               .n_columns = G_N_ELEMENTS (memInfoSeriesColumns),
+                               .columns = memInfoSeriesColumns };
+
+      sql = tkm_series_query_sql (&query, session_hash);
+    }
+  else
+    sql = g_strdup_printf ("SELECT * FROM '%s' "
+                           "WHERE %s >= %lu AND "
+                           " %s < %lu AND SessionId IS "
+                           "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
+                           TKM_MEMINFO_TABLE_NAME,
+                           timeSourceColumn[time_source], start_time,
+                           timeSourceColumn[time_source], end_time,
+                           TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (db, sql, meminfo_sqlite_callback, &data, &query_error)
+      != SQLITE_OK)
+    {
+      g_ptr_array_free (entries, TRUE);
+      entries = NULL;
+
+      g_set_error (error, g_quark_from_static_string ("MemInfoGetAll"), 1,
+                   "SQL query error");
+      g_warning ("Fail to get meminfo list. SQL error %s", query_error);
+      sqlite3_free (query_error);
+    }
+
+  return entries;
+}
+
 GPtrArray *
 tkm_meminfo_entry_get_all_entries (sqlite3 *db, const char *session_hash,
                                    DataTimeSource time_source,
                                    gulong start_time, gulong end_time,
                                    GError **error)
+{
+  return tkm_meminfo_entry_get_sampled_entries (db, session_hash, time_source,
+                                                start_time, end_time, 0, error);
+}
+
+GPtrArray *
+tkm_meminfo_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error)
 {
   g_autofree gchar *sql = NULL;
   gchar *query_error = NULL;
@@ -345,12 +425,15 @@ tkm_meminfo_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   g_assert (db);
 
+  /* The rowid range keeps the scan to the rows appended since last time */
   sql = g_strdup_printf ("SELECT * FROM '%s' "
-                         "WHERE %s >= %lu AND "
-                         " %s < %lu AND SessionId IS "
-                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
-                         TKM_MEMINFO_TABLE_NAME, timeSourceColumn[time_source],
-                         start_time, timeSourceColumn[time_source], end_time,
+                         "WHERE rowid > %" G_GINT64_FORMAT " AND "
+                         "rowid <= %" G_GINT64_FORMAT " AND "
+                         "%s >= %lu AND SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1) "
+                         "ORDER BY rowid;",
+                         TKM_MEMINFO_TABLE_NAME, first_rowid, last_rowid,
+                         timeSourceColumn[time_source], start_time,
                          TKM_SESSIONS_TABLE_NAME, session_hash);
   if (sqlite3_exec (db, sql, meminfo_sqlite_callback, &data, &query_error)
       != SQLITE_OK)
@@ -358,11 +441,28 @@ tkm_meminfo_entry_get_all_entries (sqlite3 *db, const char *session_hash,
       g_ptr_array_free (entries, TRUE);
       entries = NULL;
 
-      g_set_error (error, g_quark_from_static_string ("MemInfoGetAll"), 1,
+      g_set_error (error, g_quark_from_static_string ("MemInfoGetTail"), 1,
                    "SQL query error");
-      g_warning ("Fail to get meminfo list. SQL error %s", query_error);
+      g_warning ("Fail to get meminfo tail. SQL error %s", query_error);
       sqlite3_free (query_error);
     }
 
   return entries;
 }
+
+gboolean
+tkm_meminfo_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                 char **colname)
+{
+  MemInfoQueryData data
+    = { .type = MEMINFO_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  meminfo_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
@@ -64,7 +64,7 @@ typedef struct _TkmMemInfoEntry {
   guint cma_total;
   guint cma_free;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmMemInfoEntry;
 
 TkmMemInfoEntry *tkm_meminfo_entry_new (void);
@@ -89,6 +89,17 @@ GPtrArray *tkm_meminfo_entry_get_all_entries (sqlite3 *db,
                                               DataTimeSource time_source,
                                               gulong start_time,
                                               gulong end_time, GError **error);
+GPtrArray *tkm_meminfo_entry_get_sampled_entries (sqlite3 *db,
+                                                  const char *session_hash,
+                                                  DataTimeSource time_source,
+                                                  gulong start_time,
+                                                  gulong end_time, gulong step,
+                                                  GError **error);
+GPtrArray *tkm_meminfo_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_meminfo_entry_append_record (GPtrArray *entries, int argc,
+                                         char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmMemInfoEntry, tkm_meminfo_entry_unref);
 
@@ -22,10 +22,41 @@
  */
 
 #include "tkm-pressure-entry.h"
+#include "tkm-series.h"
 
 static const gchar *timeSourceColumn[]
   = { "SystemTime", "MonotonicTime", "ReceiveTime" };
 
+static const TkmSeriesColumn pressureSeriesColumns[] = {
+  { "SystemTime", SERIES_AGGREGATE_MIN },
+  { "MonotonicTime", SERIES_AGGREGATE_MIN },
+  { "ReceiveTime", SERIES_AGGREGATE_MIN },
+  { "CPUSomeAvg10", SERIES_AGGREGATE_AVG },
+  { "CPUSomeAvg60", SERIES_AGGREGATE_AVG },
+  { "CPUSomeAvg300", SERIES_AGGREGATE_AVG },
+  { "CPUSomeTotal", SERIES_AGGREGATE_MAX },
+  { "CPUFullAvg10", SERIES_AGGREGATE_AVG },
+  { "CPUFullAvg60", SERIES_AGGREGATE_AVG },
+  { "CPUFullAvg300", SERIES_AGGREGATE_AVG },
+  { "CPUFullTotal", SERIES_AGGREGATE_MAX },
+  { "MEMSomeAvg10", SERIES_AGGREGATE_AVG },
+  { "MEMSomeAvg60", SERIES_AGGREGATE_AVG },
+  { "MEMSomeAvg300", SERIES_AGGREGATE_AVG },
+  { "MEMSomeTotal", SERIES_AGGREGATE_MAX },
+  { "MEMFullAvg10", SERIES_AGGREGATE_AVG },
+  { "MEMFullAvg60", SERIES_AGGREGATE_AVG },
+  { "MEMFullAvg300", SERIES_AGGREGATE_AVG },
+  { "MEMFullTotal", SERIES_AGGREGATE_MAX },
+  { "IOSomeAvg10", SERIES_AGGREGATE_AVG },
+  { "IOSomeAvg60", SERIES_AGGREGATE_AVG },
+  { "IOSomeAvg300", SERIES_AGGREGATE_AVG },
+  { "IOSomeTotal", SERIES_AGGREGATE_MAX },
+  { "IOFullAvg10", SERIES_AGGREGATE_AVG },
+  { "IOFullAvg60", SERIES_AGGREGATE_AVG },
+  { "IOFullAvg300", SERIES_AGGREGATE_AVG },
+  { "IOFullTotal", SERIES_AGGREGATE_MAX },
+};
+
 /**
  * @enum Pressure query type
  */
@@ -503,11 +534,75 @@ pressure_entry_free (gpointer data)
   tkm_pressure_entry_unref (e);
 }
 
+GPtrArray *
+tkm_pressure_entry_get_sampled_entries (sqlite3 *db, const char *session_hash,
+                                        DataTimeSource time_source,
+                                        gulong start_time, gulong end_time,
+                                        gulong step, GError **error)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  GPtrArray *entries = g_ptr_array_new ();
+  PressureQueryData data
+    = { .type = PRESSURE_GET_ENTRIES, .response = (gpointer) & entries };
+
+  g_ptr_array_set_free_func (entries, pressure_entry_free);
+
+  g_assert (db);
+
+  /* Fold the rows of each step seconds into one, enough for overview charts */
+  if (step > 0)
+    {
+      TkmSeriesQuery query = { .table = TKM_PRESSURE_TABLE_NAME,
+                               .key = NULL,
+                               .time_source = time_source,
+                               .start_time = start_time,
+                               .end_time = end_time,
+                               .bucket = step,
+                               .columns = pressureSeriesColumns };
+
+      query.n_columns = G_N_ELEMENTS (pressureSeriesColumns);
+
+      sql = tkm_series_query_sql (&query, session_hash);
+    }
+  else
+    sql = g_strdup_printf ("SELECT * FROM '%s' "
+                           "WHERE %s >= %lu AND "
+                           " %s < %lu AND SessionId IS "
+                           "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
+                           TKM_PRESSURE_TABLE_NAME,
+                           timeSourceColumn[time_source], start_time,
+                           timeSourceColumn[time_source], end_time,
+                           TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (db, sql, pressure_sqlite_callback, &data, &query_error)
+      != SQLITE_OK)
+    {
+      g_ptr_array_free (entries, TRUE);
+      entries = NULL;
+
+      g_set_error (error, g_quark_from_static_string ("PressureGetAll"), 1,
+                   "SQL query error");
+      g_warning ("Fail to get pressure list. SQL error %s", query_error);
+      sqlite3_free (query_error);
+    }
+
+  return entries;
+}
+
 GPtrArray *
 tkm_pressure_entry_get_all_entries (sqlite3 *db, const char *session_hash,
                                     DataTimeSource time_source,
                                     gulong start_time, gulong end_time,
                                     GError **error)
+{
+  return tkm_pressure_entry_get_sampled_entries (db, session_hash, time_source,
+                                                 start_time, end_time, 0, error);
+}
+
+GPtrArray *
+tkm_pressure_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error)
 {
   g_autofree gchar *sql = NULL;
   gchar *query_error = NULL;
@@ -519,13 +614,15 @@ tkm_pressure_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   g_assert (db);
 
+  /* The rowid range keeps the scan to the rows appended since last time */
   sql = g_strdup_printf ("SELECT * FROM '%s' "
-                         "WHERE %s >= %lu AND "
-                         " %s < %lu AND SessionId IS "
-                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
-                         TKM_PRESSURE_TABLE_NAME,
+                         "WHERE rowid > %" G_GINT64_FORMAT " AND "
+                         "rowid <= %" G_GINT64_FORMAT " AND "
+                         "%s >= %lu AND SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1) "
+                         "ORDER BY rowid;",
+                         TKM_PRESSURE_TABLE_NAME, first_rowid, last_rowid,
                          timeSourceColumn[time_source], start_time,
-                         timeSourceColumn[time_source], end_time,
                          TKM_SESSIONS_TABLE_NAME, session_hash);
   if (sqlite3_exec (db, sql, pressure_sqlite_callback, &data, &query_error)
       != SQLITE_OK)
@@ -533,11 +630,28 @@ tkm_pressure_entry_get_all_entries (sqlite3 *db, const char *session_hash,
       g_ptr_array_free (entries, TRUE);
       entries = NULL;
 
-      g_set_error (error, g_quark_from_static_string ("PressureGetAll"), 1,
+      g_set_error (error, g_quark_from_static_string ("PressureGetTail"), 1,
                    "SQL query error");
-      g_warning ("Fail to get pressure list. SQL error %s", query_error);
+      g_warning ("Fail to get pressure tail. SQL error %s", query_error);
       sqlite3_free (query_error);
     }
 
   return entries;
 }
+
+gboolean
+tkm_pressure_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                  char **colname)
+{
+  PressureQueryData data
+    = { .type = PRESSURE_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  pressure_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
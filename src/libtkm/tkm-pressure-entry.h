@@ -118,6 +118,14 @@ void tkm_pressure_entry_set_data_avg (TkmPressureEntry *entry,
 GPtrArray *tkm_pressure_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_pressure_entry_get_sampled_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gulong end_time, gulong step, GError **error);
+GPtrArray *tkm_pressure_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_pressure_entry_append_record (GPtrArray *entries, int argc,
+                                          char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmPressureEntry, tkm_pressure_entry_unref);
 
@@ -49,7 +49,7 @@ tkm_procacct_entry_new (void)
 {
   TkmProcAcctEntry *entry = g_new0 (TkmProcAcctEntry, 1);
 
-  g_ref_count_init (&entry->rc);
+  g_atomic_ref_count_init (&entry->rc);
 
   return entry;
 }
@@ -58,7 +58,7 @@ TkmProcAcctEntry *
 tkm_procacct_entry_ref (TkmProcAcctEntry *entry)
 {
   g_assert (entry);
-  g_ref_count_inc (&entry->rc);
+  g_atomic_ref_count_inc (&entry->rc);
   return entry;
 }
 
@@ -67,7 +67,7 @@ tkm_procacct_entry_unref (TkmProcAcctEntry *entry)
 {
   g_assert (entry);
 
-  if (g_ref_count_dec (&entry->rc) == TRUE)
+  if (g_atomic_ref_count_dec (&entry->rc) == TRUE)
     {
       if (entry->name != NULL)
         g_free (entry->name);
@@ -654,3 +654,60 @@ tkm_procacct_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   return entries;
 }
+
+GPtrArray *
+tkm_procacct_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  GPtrArray *entries = g_ptr_array_new ();
+  ProcAcctQueryData data
+    = { .type = PROCACCT_GET_ENTRIES, .response = (gpointer) & entries };
+
+  g_ptr_array_set_free_func (entries, procacct_entry_free);
+
+  g_assert (db);
+
+  /* The rowid range keeps the scan to the rows appended since last time */
+  sql = g_strdup_printf ("SELECT * FROM '%s' "
+                         "WHERE rowid > %" G_GINT64_FORMAT " AND "
+                         "rowid <= %" G_GINT64_FORMAT " AND "
+                         "%s >= %lu AND SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1) "
+                         "ORDER BY rowid;",
+                         TKM_PROCACCT_TABLE_NAME, first_rowid, last_rowid,
+                         timeSourceColumn[time_source], start_time,
+                         TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (db, sql, procacct_sqlite_callback, &data, &query_error)
+      != SQLITE_OK)
+    {
+      g_ptr_array_free (entries, TRUE);
+      entries = NULL;
+
+      g_set_error (error, g_quark_from_static_string ("ProcAcctGetTail"), 1,
+                   "SQL query error");
+      g_warning ("Fail to get procacct tail. SQL error %s", query_error);
+      sqlite3_free (query_error);
+    }
+
+  return entries;
+}
+
+gboolean
+tkm_procacct_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                  char **colname)
+{
+  ProcAcctQueryData data
+    = { .type = PROCACCT_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  procacct_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
@@ -113,7 +113,7 @@ typedef struct _TkmProcAcctEntry {
   glong trashing_delay_total;
   glong trashing_delay_avg;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmProcAcctEntry;
 
 TkmProcAcctEntry *tkm_procacct_entry_new (void);
@@ -138,6 +138,11 @@ void tkm_procacct_entry_set_data (TkmProcAcctEntry *entry,
 GPtrArray *tkm_procacct_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_procacct_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_procacct_entry_append_record (GPtrArray *entries, int argc,
+                                           char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmProcAcctEntry, tkm_procacct_entry_unref);
 
@@ -270,12 +270,13 @@ procevent_entry_free (gpointer data)
 }
 
 GPtrArray *
-tkm_procevent_entry_get_all_entries (sqlite3 *db, const char *session_hash,
-                                     DataTimeSource time_source,
-                                     gulong start_time, gulong end_time,
-                                     GError **error)
+tkm_procevent_entry_get_sampled_entries (sqlite3 *db, const char *session_hash,
+                                         DataTimeSource time_source,
+                                         gulong start_time, gulong end_time,
+                                         gulong step, GError **error)
 {
   g_autofree gchar *sql = NULL;
+  g_autofree gchar *sampling = NULL;
   gchar *query_error = NULL;
   GPtrArray *entries = g_ptr_array_new ();
   ProcEventQueryData data
@@ -285,14 +286,21 @@ tkm_procevent_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   g_assert (db);
 
+  /* Keep a single row per step seconds, enough for overview charts */
+  if (step > 0)
+    sampling = g_strdup_printf (" GROUP BY %s / %lu ORDER BY %s",
+                                timeSourceColumn[time_source], step,
+                                timeSourceColumn[time_source]);
+
   sql = g_strdup_printf ("SELECT * FROM '%s' "
                          "WHERE %s >= %lu AND "
                          " %s < %lu AND SessionId IS "
-                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1);",
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1)%s;",
                          TKM_PROCEVENT_TABLE_NAME,
                          timeSourceColumn[time_source], start_time,
                          timeSourceColumn[time_source], end_time,
-                         TKM_SESSIONS_TABLE_NAME, session_hash);
+                         TKM_SESSIONS_TABLE_NAME, session_hash,
+                         sampling != NULL ? sampling : "");
   if (sqlite3_exec (db, sql, procevent_sqlite_callback, &data, &query_error)
       != SQLITE_OK)
     {
@@ -307,3 +315,70 @@ tkm_procevent_entry_get_all_entries (sqlite3 *db, const char *session_hash,
 
   return entries;
 }
+
+GPtrArray *
+tkm_procevent_entry_get_all_entries (sqlite3 *db, const char *session_hash,
+                                     DataTimeSource time_source,
+                                     gulong start_time, gulong end_time,
+                                     GError **error)
+{
+  return tkm_procevent_entry_get_sampled_entries (db, session_hash, time_source,
+                                                  start_time, end_time, 0, error);
+}
+
+GPtrArray *
+tkm_procevent_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error)
+{
+  g_autofree gchar *sql = NULL;
+  gchar *query_error = NULL;
+  GPtrArray *entries = g_ptr_array_new ();
+  ProcEventQueryData data
+    = { .type = PROCEVENT_GET_ENTRIES, .response = (gpointer) & entries };
+
+  g_ptr_array_set_free_func (entries, procevent_entry_free);
+
+  g_assert (db);
+
+  /* The rowid range keeps the scan to the rows appended since last time */
+  sql = g_strdup_printf ("SELECT * FROM '%s' "
+                         "WHERE rowid > %" G_GINT64_FORMAT " AND "
+                         "rowid <= %" G_GINT64_FORMAT " AND "
+                         "%s >= %lu AND SessionId IS "
+                         "(SELECT Id FROM '%s' WHERE Hash IS '%s' LIMIT 1) "
+                         "ORDER BY rowid;",
+                         TKM_PROCEVENT_TABLE_NAME, first_rowid, last_rowid,
+                         timeSourceColumn[time_source], start_time,
+                         TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (sqlite3_exec (db, sql, procevent_sqlite_callback, &data, &query_error)
+      != SQLITE_OK)
+    {
+      g_ptr_array_free (entries, TRUE);
+      entries = NULL;
+
+      g_set_error (error, g_quark_from_static_string ("ProcEventGetTail"), 1,
+                   "SQL query error");
+      g_warning ("Fail to get procevent tail. SQL error %s", query_error);
+      sqlite3_free (query_error);
+    }
+
+  return entries;
+}
+
+gboolean
+tkm_procevent_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                   char **colname)
+{
+  ProcEventQueryData data
+    = { .type = PROCEVENT_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  procevent_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
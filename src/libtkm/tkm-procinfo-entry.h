@@ -56,7 +56,7 @@ typedef struct _TkmProcInfoEntry {
   glong mem_rss;
   glong mem_pss;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmProcInfoEntry;
 
 TkmProcInfoEntry *tkm_procinfo_entry_new (void);
@@ -85,6 +85,11 @@ void tkm_procinfo_entry_set_data (TkmProcInfoEntry *entry,
 GPtrArray *tkm_procinfo_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_procinfo_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_procinfo_entry_append_record (GPtrArray *entries, int argc,
+                                           char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmProcInfoEntry, tkm_procinfo_entry_unref);
 
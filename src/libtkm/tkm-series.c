@@ -0,0 +1,72 @@
+/*
+ * SPDX license identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2019-2022 Alin Popa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Alin Popa <alin.popa@fxdata.ro>
+ * \file tkm-series.c
+ */
+
+#include "tkm-series.h"
+
+static const gchar *timeSourceColumn[]
+  = { "SystemTime", "MonotonicTime", "ReceiveTime" };
+
+static const gchar *aggregateFunction[]
+  = { "AVG", "MIN", "MAX", "SUM", "COUNT" };
+
+gchar *
+tkm_series_query_sql (const TkmSeriesQuery *query, const char *session_hash)
+{
+  const gchar *time_column = NULL;
+  GString *sql = NULL;
+  gulong bucket;
+
+  g_assert (query);
+  g_assert (query->table);
+  g_assert (query->n_columns == 0 || query->columns);
+
+  time_column = timeSourceColumn[query->time_source];
+  bucket = MAX (query->bucket, 1);
+
+  sql = g_string_new ("SELECT ");
+  if (query->key != NULL)
+    g_string_append_printf (sql, "\"%s\", ", query->key);
+
+  g_string_append_printf (sql, "(%s / %lu) * %lu AS SeriesTime", time_column,
+                          bucket, bucket);
+
+  /* Aliased after the table columns so the entry callbacks can parse them */
+  for (guint i = 0; i < query->n_columns; i++)
+    g_string_append_printf (sql, ", %s(\"%s\") AS \"%s\"",
+                            aggregateFunction[query->columns[i].aggregate],
+                            query->columns[i].name, query->columns[i].name);
+
+  g_string_append_printf (sql,
+                          " FROM '%s' WHERE %s >= %lu AND %s < %lu AND "
+                          "SessionId IS (SELECT Id FROM '%s' WHERE Hash IS "
+                          "'%s' LIMIT 1) GROUP BY ",
+                          query->table, time_column, query->start_time,
+                          time_column, query->end_time,
+                          TKM_SESSIONS_TABLE_NAME, session_hash);
+  if (query->key != NULL)
+    g_string_append_printf (sql, "\"%s\", ", query->key);
+
+  g_string_append (sql, "SeriesTime ORDER BY SeriesTime;");
+
+  return g_string_free (sql, FALSE);
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX license identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2019-2022 Alin Popa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Alin Popa <alin.popa@fxdata.ro>
+ * \file tkm-series.h
+ */
+
+#pragma once
+
+#include "tkm-types.h"
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum _TkmSeriesAggregate {
+  SERIES_AGGREGATE_AVG,
+  SERIES_AGGREGATE_MIN,
+  SERIES_AGGREGATE_MAX,
+  SERIES_AGGREGATE_SUM,
+  SERIES_AGGREGATE_COUNT,
+} TkmSeriesAggregate;
+
+/* A table column and how its rows are folded into a bucket */
+typedef struct _TkmSeriesColumn {
+  const gchar *name;
+  TkmSeriesAggregate aggregate;
+} TkmSeriesColumn;
+
+/*
+ * Rows of a table in [start_time, end_time) of a session, grouped in
+ * buckets of bucket seconds and per value of the key column if set. The
+ * aggregated columns are named after the table columns so the result can
+ * be read by the entry callbacks of the table.
+ */
+typedef struct _TkmSeriesQuery {
+  const gchar *table;
+  const gchar *key;
+  DataTimeSource time_source;
+  gulong start_time;
+  gulong end_time;
+  gulong bucket;
+  guint n_columns;
+  const TkmSeriesColumn *columns;
+} TkmSeriesQuery;
+
+gchar *tkm_series_query_sql (const TkmSeriesQuery *query,
+                             const char *session_hash);
+
+G_END_DECLS
@@ -456,3 +456,20 @@ tkm_session_entry_get_all_entries (sqlite3 *db, GError **error)
 
   return entries;
 }
+
+gboolean
+tkm_session_entry_append_record (GPtrArray *entries, int argc, char **argv,
+                                 char **colname)
+{
+  SessionQueryData data
+    = { .type = SESSION_GET_ENTRIES, .response = (gpointer) & entries };
+  guint len = 0;
+
+  g_assert (entries);
+
+  /* Stream records carry the columns of a query row */
+  len = entries->len;
+  session_sqlite_callback (&data, argc, argv, colname);
+
+  return entries->len > len;
+}
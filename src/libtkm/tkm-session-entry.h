@@ -85,6 +85,8 @@ void tkm_session_entry_set_active (TkmSessionEntry *entry, gboolean state);
 gboolean tkm_session_entry_get_active (TkmSessionEntry *entry);
 
 GPtrArray *tkm_session_entry_get_all_entries (sqlite3 *db, GError **error);
+gboolean tkm_session_entry_append_record (GPtrArray *entries, int argc,
+                                         char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmSessionEntry, tkm_session_entry_unref);
 
@@ -30,6 +30,7 @@ tkm_settings_new (void)
 
   settings->time_interval = DATA_TIME_INTERVAL_1M;
   settings->time_source = DATA_TIME_SOURCE_SYSTEM;
+  settings->memory_budget = 0;
 
   g_ref_count_init (&settings->rc);
 
@@ -83,3 +84,46 @@ tkm_settings_set_data_time_interval (TkmSettings *settings,
   g_assert (settings);
   settings->time_interval = ti;
 }
+
+gulong
+tkm_settings_get_data_time_span (TkmSettings *settings)
+{
+  g_assert (settings);
+
+  switch (settings->time_interval)
+    {
+    case DATA_TIME_INTERVAL_10S:
+      return 10;
+
+    case DATA_TIME_INTERVAL_1M:
+      return 60;
+
+    case DATA_TIME_INTERVAL_10M:
+      return 600;
+
+    case DATA_TIME_INTERVAL_1H:
+      return 3600;
+
+    case DATA_TIME_INTERVAL_24H:
+      return 86400;
+
+    default:
+      break;
+    }
+
+  return 0;
+}
+
+guint
+tkm_settings_get_memory_budget (TkmSettings *settings)
+{
+  g_assert (settings);
+  return settings->memory_budget;
+}
+
+void
+tkm_settings_set_memory_budget (TkmSettings *settings, guint budget)
+{
+  g_assert (settings);
+  settings->memory_budget = budget;
+}
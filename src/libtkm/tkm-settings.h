@@ -33,6 +33,7 @@ G_BEGIN_DECLS
 typedef struct _TkmSettings {
   DataTimeSource time_source;
   DataTimeInterval time_interval;
+  guint memory_budget;
 
   grefcount rc;
 } TkmSettings;
@@ -47,6 +48,11 @@ void tkm_settings_set_data_time_source (TkmSettings *settings,
 DataTimeInterval tkm_settings_get_data_time_interval (TkmSettings *settings);
 void tkm_settings_set_data_time_interval (TkmSettings *settings,
                                           DataTimeInterval ti);
+/* Seconds spanned by the time interval, 0 when it is not limited */
+gulong tkm_settings_get_data_time_span (TkmSettings *settings);
+/* MiB the loaded entries may take, 0 when it is not limited */
+guint tkm_settings_get_memory_budget (TkmSettings *settings);
+void tkm_settings_set_memory_budget (TkmSettings *settings, guint budget);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmSettings, tkm_settings_unref);
 
@@ -0,0 +1,106 @@
+/*
+ * SPDX license identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2019-2022 Alin Popa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Alin Popa <alin.popa@fxdata.ro>
+ * \file tkm-stream.c
+ */
+
+#include "tkm-stream.h"
+
+#include <gio/gunixinputstream.h>
+#include <gio/gunixsocketaddress.h>
+#include <string.h>
+#include <unistd.h>
+
+gboolean
+tkm_stream_record_parse (TkmStreamRecord *record, gchar *line)
+{
+  gchar *field = NULL;
+  gchar *next = NULL;
+
+  g_assert (record);
+  g_assert (line);
+
+  record->table = NULL;
+  record->n_fields = 0;
+
+  g_strchomp (line);
+  if (line[0] == '\0' || line[0] == '#')
+    return FALSE;
+
+  next = strchr (line, '\t');
+  if (next != NULL)
+    *next++ = '\0';
+
+  record->table = line;
+
+  while ((field = next) != NULL
+         && record->n_fields < TKM_STREAM_RECORD_FIELDS_MAX)
+    {
+      gchar *value = NULL;
+
+      next = strchr (field, '\t');
+      if (next != NULL)
+        *next++ = '\0';
+
+      value = strchr (field, '=');
+      if (value == NULL)
+        continue;
+
+      *value++ = '\0';
+      record->names[record->n_fields] = field;
+      record->values[record->n_fields] = value;
+      record->n_fields++;
+    }
+
+  return record->n_fields > 0;
+}
+
+GInputStream *
+tkm_stream_open (const gchar *address, GObject **connection,
+                 GCancellable *cancellable, GError **error)
+{
+  g_autoptr (GSocketClient) client = NULL;
+  g_autoptr (GSocketAddress) socket_address = NULL;
+  GSocketConnection *socket_connection = NULL;
+  const gchar *path = address;
+
+  g_assert (address);
+  g_assert (connection);
+
+  *connection = NULL;
+
+  if (g_strcmp0 (address, TKM_STREAM_STDIN) == 0)
+    return g_unix_input_stream_new (STDIN_FILENO, FALSE);
+
+  if (g_str_has_prefix (address, "unix:"))
+    path = address + strlen ("unix:");
+
+  client = g_socket_client_new ();
+  socket_address = g_unix_socket_address_new (path);
+  socket_connection = g_socket_client_connect (
+    client, G_SOCKET_CONNECTABLE (socket_address), cancellable, error);
+  if (socket_connection == NULL)
+    return NULL;
+
+  *connection = G_OBJECT (socket_connection);
+
+  return g_object_ref (
+    g_io_stream_get_input_stream (G_IO_STREAM (socket_connection)));
+}
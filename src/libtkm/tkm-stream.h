@@ -0,0 +1,72 @@
+/*
+ * SPDX license identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2019-2022 Alin Popa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Alin Popa <alin.popa@fxdata.ro>
+ * \file tkm-stream.h
+ */
+
+#pragma once
+
+#include "tkm-types.h"
+
+#include <gio/gio.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Stream address read from the standard input */
+#define TKM_STREAM_STDIN "-"
+
+/* Fields a single stream record can carry */
+#define TKM_STREAM_RECORD_FIELDS_MAX (64)
+
+/*
+ * A record of a taskmonitor stream. Each line holds the name of the table
+ * the record belongs to followed by tab separated Column=Value fields, with
+ * the table and column names of the capture database:
+ *
+ *   tkmSysProcStat<TAB>SystemTime=1650000000<TAB>CPUStatName=cpu0<TAB>...
+ *
+ * A session record starts a session, the records that follow belong to
+ * it. It needs a non empty Hash and a CoreCount above 0, Name and
+ * DeviceName are optional. Session records missing either are ignored:
+ *
+ *   tkmSessions<TAB>Name=capture<TAB>Hash=4f2a...<TAB>CoreCount=4
+ *
+ * The fields point into the parsed line, in the layout sqlite3_exec hands
+ * to its callbacks so the entry parsers can decode them.
+ */
+typedef struct _TkmStreamRecord {
+  const gchar *table;
+  gint n_fields;
+  gchar *names[TKM_STREAM_RECORD_FIELDS_MAX];
+  gchar *values[TKM_STREAM_RECORD_FIELDS_MAX];
+} TkmStreamRecord;
+
+gboolean tkm_stream_record_parse (TkmStreamRecord *record, gchar *line);
+
+/*
+ * Open a record stream, TKM_STREAM_STDIN or the path of a Unix socket
+ * optionally prefixed with "unix:". The returned object keeps the
+ * connection open and is released after the input stream.
+ */
+GInputStream *tkm_stream_open (const gchar *address, GObject **connection,
+                               GCancellable *cancellable, GError **error);
+
+G_END_DECLS
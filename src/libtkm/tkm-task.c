@@ -32,6 +32,57 @@ tkm_task_init (TkmTask *task, gpointer status_cb, gpointer exec_cb)
   task->status_cb = status_cb;
   task->exec_cb = exec_cb;
   task->run_status = TRUE;
+  task->priority = TASK_PRIORITY_INTERACTIVE;
+  task->cancellable = g_cancellable_new ();
+}
+
+void
+tkm_task_clear (TkmTask *task)
+{
+  g_assert (task);
+  g_mutex_clear (&task->mutex);
+  g_cond_clear (&task->cond);
+  g_clear_object (&task->cancellable);
+}
+
+void
+tkm_task_set_priority (TkmTask *task, TkmTaskPriority priority)
+{
+  g_assert (task);
+  g_assert (priority < TASK_PRIORITY_COUNT);
+  task->priority = priority;
+}
+
+void
+tkm_task_set_cancellable (TkmTask *task, GCancellable *cancellable)
+{
+  g_assert (task);
+  g_assert (cancellable);
+
+  g_object_ref (cancellable);
+  g_clear_object (&task->cancellable);
+  task->cancellable = cancellable;
+}
+
+GCancellable *
+tkm_task_get_cancellable (TkmTask *task)
+{
+  g_assert (task);
+  return task->cancellable;
+}
+
+void
+tkm_task_cancel (TkmTask *task)
+{
+  g_assert (task);
+  g_cancellable_cancel (task->cancellable);
+}
+
+gboolean
+tkm_task_is_cancelled (TkmTask *task)
+{
+  g_assert (task);
+  return g_cancellable_is_cancelled (task->cancellable);
 }
 
 gboolean
@@ -75,3 +126,189 @@ tkm_task_run_status (TkmTask *task)
   g_assert (task);
   return task->run_status;
 }
+
+static void
+task_group_leave (TkmTaskGroup *group, gboolean status)
+{
+  TkmTaskGroupFunc notify = NULL;
+  gpointer notify_data = NULL;
+  gboolean complete = FALSE;
+
+  g_mutex_lock (&group->mutex);
+  if (!status)
+    group->failed = TRUE;
+  if (--group->pending == 0)
+    {
+      g_cond_broadcast (&group->cond);
+      notify = group->notify;
+      notify_data = group->notify_data;
+      complete = !group->failed;
+      group->notify = NULL;
+    }
+  g_mutex_unlock (&group->mutex);
+
+  /* The last task to complete reports for all of them */
+  if (notify != NULL)
+    notify (group, complete, notify_data);
+
+  tkm_task_group_unref (group);
+}
+
+void
+tkm_task_complete (TkmTask *task)
+{
+  TkmTaskGroup *group = NULL;
+  gboolean status = FALSE;
+
+  g_assert (task);
+
+  /* The task can be released by a waiter as soon as it is signalled */
+  group = task->group;
+  status = task->run_status;
+
+  g_mutex_lock (&task->mutex);
+  task->complete = TRUE;
+  g_cond_signal (&task->cond);
+  g_mutex_unlock (&task->mutex);
+
+  if (group != NULL)
+    task_group_leave (group, status);
+}
+
+static void
+task_interrupt_database (GCancellable *cancellable, gpointer db)
+{
+  TKM_UNUSED (cancellable);
+  sqlite3_interrupt ((sqlite3 *)db);
+}
+
+gulong
+tkm_task_interrupt_connect (GCancellable *cancellable, sqlite3 *db)
+{
+  g_assert (cancellable);
+  g_assert (db);
+
+  /* Runs the handler right away if the token is already cancelled */
+  return g_cancellable_connect (cancellable,
+                                G_CALLBACK (task_interrupt_database), db,
+                                NULL);
+}
+
+void
+tkm_task_interrupt_disconnect (GCancellable *cancellable, gulong handler)
+{
+  g_assert (cancellable);
+
+  /* Waits for a running handler so the interrupt can't outlive the query */
+  g_cancellable_disconnect (cancellable, handler);
+}
+
+TkmTaskGroup *
+tkm_task_group_new (void)
+{
+  g_autoptr (GCancellable) cancellable = g_cancellable_new ();
+
+  return tkm_task_group_new_with_cancellable (cancellable);
+}
+
+TkmTaskGroup *
+tkm_task_group_new_with_cancellable (GCancellable *cancellable)
+{
+  TkmTaskGroup *group = g_new0 (TkmTaskGroup, 1);
+
+  g_assert (cancellable);
+
+  g_mutex_init (&group->mutex);
+  g_cond_init (&group->cond);
+  group->cancellable = g_object_ref (cancellable);
+  g_atomic_ref_count_init (&group->rc);
+
+  return group;
+}
+
+TkmTaskGroup *
+tkm_task_group_ref (TkmTaskGroup *group)
+{
+  g_assert (group);
+  g_atomic_ref_count_inc (&group->rc);
+  return group;
+}
+
+void
+tkm_task_group_unref (TkmTaskGroup *group)
+{
+  g_assert (group);
+
+  if (g_atomic_ref_count_dec (&group->rc) == TRUE)
+    {
+      g_object_unref (group->cancellable);
+      g_mutex_clear (&group->mutex);
+      g_cond_clear (&group->cond);
+      g_free (group);
+    }
+}
+
+void
+tkm_task_group_add (TkmTaskGroup *group, TkmTask *task)
+{
+  g_assert (group);
+  g_assert (task);
+  g_assert (task->group == NULL);
+
+  tkm_task_set_cancellable (task, group->cancellable);
+  task->group = tkm_task_group_ref (group);
+
+  g_mutex_lock (&group->mutex);
+  group->pending++;
+  g_mutex_unlock (&group->mutex);
+}
+
+void
+tkm_task_group_cancel (TkmTaskGroup *group)
+{
+  g_assert (group);
+  g_cancellable_cancel (group->cancellable);
+}
+
+gboolean
+tkm_task_group_join (TkmTaskGroup *group)
+{
+  gboolean complete = FALSE;
+
+  g_assert (group);
+
+  g_mutex_lock (&group->mutex);
+  while (group->pending > 0)
+    g_cond_wait (&group->cond, &group->mutex);
+  complete = !group->failed;
+  g_mutex_unlock (&group->mutex);
+
+  return complete;
+}
+
+void
+tkm_task_group_notify (TkmTaskGroup *group, TkmTaskGroupFunc func,
+                       gpointer user_data)
+{
+  gboolean complete = FALSE;
+  gboolean done = FALSE;
+
+  g_assert (group);
+  g_assert (func);
+
+  g_mutex_lock (&group->mutex);
+  g_assert (group->notify == NULL);
+  done = group->pending == 0;
+  if (done)
+    complete = !group->failed;
+  else
+    {
+      group->notify = func;
+      group->notify_data = user_data;
+    }
+  g_mutex_unlock (&group->mutex);
+
+  /* Everything already completed, report right away */
+  if (done)
+    func (group, complete, user_data);
+}
@@ -28,6 +28,7 @@
 
 #include <gio/gio.h>
 #include <glib.h>
+#include <sqlite3.h>
 
 G_BEGIN_DECLS
 
@@ -35,8 +36,31 @@ typedef enum _TaskStatusType {
   TASK_STATUS_PROGRESS,
   TASK_STATUS_FAILED,
   TASK_STATUS_COMPLETE,
+  TASK_STATUS_CANCELLED,
 } TaskStatusType;
 
+typedef struct _TkmTaskGroup TkmTaskGroup;
+
+/* Called once, complete is FALSE if any task failed or was cancelled */
+typedef void (*TkmTaskGroupFunc) (TkmTaskGroup *group, gboolean complete,
+                                  gpointer user_data);
+
+/*
+ * Tasks added to a group share its cancellation token, the group can be
+ * joined or notified once they are all pushed.
+ */
+struct _TkmTaskGroup {
+  GMutex mutex;
+  GCond cond;
+  guint pending;
+  gboolean failed;
+  TkmTaskGroupFunc notify;
+  gpointer notify_data;
+  GCancellable *cancellable;
+  /* released by the workers completing its tasks */
+  gatomicrefcount rc;
+};
+
 typedef struct _TkmTask {
   gboolean run_status;
   GMutex mutex;
@@ -44,6 +68,13 @@ typedef struct _TkmTask {
   gboolean complete;
   gpointer status_cb;
   gpointer exec_cb;
+
+  /* scheduling, set up before the task is pushed */
+  TkmTaskPriority priority;
+  GCancellable *cancellable;
+  TkmTaskGroup *group;
+  gint64 sequence;
+  gint64 queued_time;
 } TkmTask;
 
 typedef void (*TkmTaskStatusCallback) (TaskStatusType status_type,
@@ -51,9 +82,36 @@ typedef void (*TkmTaskStatusCallback) (TaskStatusType status_type,
 typedef gboolean (*TkmTaskExecCallback) (TkmTask *task, gpointer context);
 
 void tkm_task_init (TkmTask *task, gpointer status_cb, gpointer exec_cb);
+void tkm_task_clear (TkmTask *task);
+void tkm_task_set_priority (TkmTask *task, TkmTaskPriority priority);
+void tkm_task_set_cancellable (TkmTask *task, GCancellable *cancellable);
+GCancellable *tkm_task_get_cancellable (TkmTask *task);
+void tkm_task_cancel (TkmTask *task);
+gboolean tkm_task_is_cancelled (TkmTask *task);
 gboolean tkm_task_run (TkmTask *task, TkmTaskPool *pool);
 gboolean tkm_task_run_wait (TkmTask *task, TkmTaskPool *pool);
 void tkm_task_wait (TkmTask *task);
 gboolean tkm_task_run_status (TkmTask *task);
+/* Called by the pool once the status callback returned */
+void tkm_task_complete (TkmTask *task);
+
+/*
+ * Interrupt the statements running on db when the token is cancelled,
+ * so long queries stop at the next row instead of running to the end.
+ */
+gulong tkm_task_interrupt_connect (GCancellable *cancellable, sqlite3 *db);
+void tkm_task_interrupt_disconnect (GCancellable *cancellable, gulong handler);
+
+TkmTaskGroup *tkm_task_group_new (void);
+TkmTaskGroup *tkm_task_group_new_with_cancellable (GCancellable *cancellable);
+TkmTaskGroup *tkm_task_group_ref (TkmTaskGroup *group);
+void tkm_task_group_unref (TkmTaskGroup *group);
+void tkm_task_group_add (TkmTaskGroup *group, TkmTask *task);
+void tkm_task_group_cancel (TkmTaskGroup *group);
+gboolean tkm_task_group_join (TkmTaskGroup *group);
+void tkm_task_group_notify (TkmTaskGroup *group, TkmTaskGroupFunc func,
+                            gpointer user_data);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmTaskGroup, tkm_task_group_unref);
 
 #define TKM_TASK(x) (TkmTask *)(x)
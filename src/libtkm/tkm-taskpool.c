@@ -25,33 +25,71 @@
 #include "tkm-context.h"
 #include "tkm-task.h"
 
+static gint
+task_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const TkmTask *ta = (const TkmTask *)a;
+  const TkmTask *tb = (const TkmTask *)b;
+
+  TKM_UNUSED (user_data);
+
+  if (ta->priority != tb->priority)
+    return ta->priority < tb->priority ? -1 : 1;
+
+  return ta->sequence < tb->sequence ? -1 : (ta->sequence > tb->sequence);
+}
+
 static void
-thread_worker (gpointer task, gpointer context)
+thread_worker (gpointer task, gpointer pool)
 {
+  TkmTaskPool *p = (TkmTaskPool *)pool;
   TkmTask *t = TKM_TASK (task);
-  gboolean run_status = TRUE;
+  TaskStatusType status = TASK_STATUS_COMPLETE;
+  TkmTaskPoolStats *stats = NULL;
+  gint64 wait = 0;
 
   g_assert (task);
-  g_assert (context);
-
-  if (t->exec_cb != NULL)
+  g_assert (pool);
+
+  stats = &p->stats[t->priority];
+  wait = g_get_monotonic_time () - t->queued_time;
+
+  g_mutex_lock (&p->stats_lock);
+  stats->queued--;
+  stats->running++;
+  stats->wait_total += wait;
+  stats->wait_max = MAX (stats->wait_max, wait);
+  g_mutex_unlock (&p->stats_lock);
+
+  /* Cancelled tasks still report so their owners can release them */
+  if (tkm_task_is_cancelled (t))
+    status = TASK_STATUS_CANCELLED;
+  else if (t->exec_cb != NULL)
     {
       TkmTaskExecCallback callback = (TkmTaskExecCallback)t->exec_cb;
-      run_status = callback (t, context);
+
+      if (!callback (t, p->context))
+        status = tkm_task_is_cancelled (t) ? TASK_STATUS_CANCELLED
+                                           : TASK_STATUS_FAILED;
     }
 
+  t->run_status = (status == TASK_STATUS_COMPLETE);
+
+  g_mutex_lock (&p->stats_lock);
+  stats->running--;
+  if (status == TASK_STATUS_CANCELLED)
+    stats->cancelled++;
+  else
+    stats->completed++;
+  g_mutex_unlock (&p->stats_lock);
+
   if (t->status_cb != NULL)
     {
       TkmTaskStatusCallback callback = (TkmTaskStatusCallback)t->status_cb;
-      callback (
-        ((run_status == TRUE) ? TASK_STATUS_COMPLETE : TASK_STATUS_FAILED),
-        t);
+      callback (status, t);
     }
 
-  g_mutex_lock (&t->mutex);
-  t->complete = TRUE;
-  g_cond_signal (&t->cond);
-  g_mutex_unlock (&t->mutex);
+  tkm_task_complete (t);
 }
 
 TkmTaskPool *
@@ -61,12 +99,15 @@ tkm_taskpool_new (guint max_threads, gpointer context)
 
   p->max_threads = max_threads;
   p->context = tkm_context_ref (context);
-  p->pool = g_thread_pool_new (thread_worker, p->context, p->max_threads, TRUE,
-                               NULL);
+  g_mutex_init (&p->stats_lock);
+  p->pool
+    = g_thread_pool_new (thread_worker, p, p->max_threads, TRUE, NULL);
   g_ref_count_init (&p->rc);
 
   g_assert (p->pool);
 
+  g_thread_pool_set_sort_function (p->pool, task_compare, NULL);
+
   return p;
 }
 
@@ -91,6 +132,7 @@ tkm_taskpool_unref (TkmTaskPool *p)
       if (p->pool)
         g_thread_pool_free (p->pool, TRUE, TRUE);
 
+      g_mutex_clear (&p->stats_lock);
       g_free (p);
     }
 }
@@ -98,5 +140,43 @@ tkm_taskpool_unref (TkmTaskPool *p)
 gboolean
 tkm_taskpool_push (TkmTaskPool *p, gpointer task)
 {
-  return g_thread_pool_push (p->pool, task, NULL);
+  TkmTask *t = TKM_TASK (task);
+  gboolean status = FALSE;
+
+  g_assert (p);
+  g_assert (task);
+
+  t->queued_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&p->stats_lock);
+  t->sequence = p->sequence++;
+  p->stats[t->priority].queued++;
+  g_mutex_unlock (&p->stats_lock);
+
+  status = g_thread_pool_push (p->pool, task, NULL);
+  if (!status)
+    {
+      g_mutex_lock (&p->stats_lock);
+      p->stats[t->priority].queued--;
+      g_mutex_unlock (&p->stats_lock);
+
+      /* Nothing will run it, don't leave its group or waiters hanging */
+      t->run_status = FALSE;
+      tkm_task_complete (t);
+    }
+
+  return status;
+}
+
+void
+tkm_taskpool_get_stats (TkmTaskPool *p, TkmTaskPriority priority,
+                        TkmTaskPoolStats *stats)
+{
+  g_assert (p);
+  g_assert (priority < TASK_PRIORITY_COUNT);
+  g_assert (stats);
+
+  g_mutex_lock (&p->stats_lock);
+  *stats = p->stats[priority];
+  g_mutex_unlock (&p->stats_lock);
 }
@@ -30,10 +30,34 @@
 
 G_BEGIN_DECLS
 
+/*
+ * Queued tasks run by class and in push order within a class, so renders
+ * the user waits for don't queue behind prefetches and background work.
+ */
+typedef enum _TkmTaskPriority {
+  TASK_PRIORITY_INTERACTIVE,
+  TASK_PRIORITY_PREFETCH,
+  TASK_PRIORITY_BACKGROUND,
+  TASK_PRIORITY_COUNT,
+} TkmTaskPriority;
+
+/* Counters of one priority class, times in microseconds */
+typedef struct _TkmTaskPoolStats {
+  guint queued;
+  guint running;
+  guint64 completed;
+  guint64 cancelled;
+  gint64 wait_total;
+  gint64 wait_max;
+} TkmTaskPoolStats;
+
 typedef struct _TkmTaskPool {
   GThreadPool *pool;
   guint max_threads;
   gpointer context;
+  gint64 sequence;
+  GMutex stats_lock;
+  TkmTaskPoolStats stats[TASK_PRIORITY_COUNT];
   grefcount rc;
 } TkmTaskPool;
 
@@ -41,6 +65,8 @@ TkmTaskPool *tkm_taskpool_new (guint max_threads, gpointer context);
 TkmTaskPool *tkm_taskpool_ref (TkmTaskPool *p);
 void tkm_taskpool_unref (TkmTaskPool *p);
 gboolean tkm_taskpool_push (TkmTaskPool *p, gpointer task);
+void tkm_taskpool_get_stats (TkmTaskPool *p, TkmTaskPriority priority,
+                             TkmTaskPoolStats *stats);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmTaskPool, tkm_taskpool_unref);
 
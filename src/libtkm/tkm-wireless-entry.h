@@ -60,7 +60,7 @@ typedef struct _TkmWirelessEntry {
   glong discarded_misc;
   glong missed_beacon;
 
-  grefcount rc;
+  gatomicrefcount rc;
 } TkmWirelessEntry;
 
 TkmWirelessEntry *tkm_wireless_entry_new (void);
@@ -88,6 +88,11 @@ void tkm_wireless_entry_set_data (TkmWirelessEntry *entry,
 GPtrArray *tkm_wireless_entry_get_all_entries (
   sqlite3 *db, const char *session_hash, DataTimeSource time_source,
   gulong start_time, gulong end_time, GError **error);
+GPtrArray *tkm_wireless_entry_get_tail_entries (
+  sqlite3 *db, const char *session_hash, DataTimeSource time_source,
+  gulong start_time, gint64 first_rowid, gint64 last_rowid, GError **error);
+gboolean tkm_wireless_entry_append_record (GPtrArray *entries, int argc,
+                                           char **argv, char **colname);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmWirelessEntry, tkm_wireless_entry_unref);
 
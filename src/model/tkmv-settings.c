@@ -254,6 +254,12 @@ tkmv_settings_load_general_settings (TkmvSettings *tkms)
                                                  "default-time-interval"));
   tkms->auto_timeline_refresh
     = g_settings_get_boolean (tkms->gsettings, "auto-timeline-refresh");
+  tkms->process_chart_mode = (ProcessChartMode)g_settings_get_uint (
+    tkms->gsettings, "process-chart-mode");
+  tkms->process_chart_top_count
+    = g_settings_get_uint (tkms->gsettings, "process-chart-top-count");
+  tkmv_settings_set_memory_budget (
+    tkms, g_settings_get_uint (tkms->gsettings, "memory-budget"));
 }
 
 void
@@ -266,6 +272,12 @@ tkmv_settings_store_general_settings (TkmvSettings *tkms)
                        (guint)tkmv_settings_get_time_interval (tkms));
   g_settings_set_boolean (tkms->gsettings, "auto-timeline-refresh",
                           tkms->auto_timeline_refresh);
+  g_settings_set_uint (tkms->gsettings, "process-chart-mode",
+                       (guint)tkms->process_chart_mode);
+  g_settings_set_uint (tkms->gsettings, "process-chart-top-count",
+                       tkms->process_chart_top_count);
+  g_settings_set_uint (tkms->gsettings, "memory-budget",
+                       tkmv_settings_get_memory_budget (tkms));
 }
 
 DataTimeSource
@@ -314,6 +326,51 @@ tkmv_settings_set_auto_timeline_refresh (TkmvSettings *tkms, gboolean state)
   tkms->auto_timeline_refresh = state;
 }
 
+ProcessChartMode
+tkmv_settings_get_process_chart_mode (TkmvSettings *tkms)
+{
+  g_assert (tkms);
+  return tkms->process_chart_mode;
+}
+
+void
+tkmv_settings_set_process_chart_mode (TkmvSettings *tkms,
+                                      ProcessChartMode mode)
+{
+  g_assert (tkms);
+  tkms->process_chart_mode = mode;
+}
+
+guint
+tkmv_settings_get_process_chart_top_count (TkmvSettings *tkms)
+{
+  g_assert (tkms);
+  return tkms->process_chart_top_count;
+}
+
+void
+tkmv_settings_set_process_chart_top_count (TkmvSettings *tkms, guint count)
+{
+  g_assert (tkms);
+  tkms->process_chart_top_count = count;
+}
+
+guint
+tkmv_settings_get_memory_budget (TkmvSettings *tkms)
+{
+  g_assert (tkms);
+  g_assert (tkms->tkm_settings);
+  return tkm_settings_get_memory_budget (tkms->tkm_settings);
+}
+
+void
+tkmv_settings_set_memory_budget (TkmvSettings *tkms, guint budget)
+{
+  g_assert (tkms);
+  g_assert (tkms->tkm_settings);
+  tkm_settings_set_memory_budget (tkms->tkm_settings, budget);
+}
+
 void
 tkmv_settings_save (TkmvSettings *tkms)
 {
@@ -23,6 +23,7 @@
 
 #include "tkm-settings.h"
 #include "tkmv-settings-recent-file.h"
+#include "tkmv-types.h"
 
 G_BEGIN_DECLS
 
@@ -35,6 +36,8 @@ typedef struct _TkmvSettings {
   GList *recent_files;
   gsize recent_files_count;
   gboolean auto_timeline_refresh;
+  ProcessChartMode process_chart_mode;
+  guint process_chart_top_count;
 
   grefcount rc;
 } TkmvSettings;
@@ -63,6 +66,14 @@ void tkmv_settings_set_time_interval (TkmvSettings *tkms, DataTimeInterval ti);
 gboolean tkmv_settings_get_auto_timeline_refresh (TkmvSettings *tkms);
 void tkmv_settings_set_auto_timeline_refresh (TkmvSettings *tkms,
                                               gboolean state);
+ProcessChartMode tkmv_settings_get_process_chart_mode (TkmvSettings *tkms);
+void tkmv_settings_set_process_chart_mode (TkmvSettings *tkms,
+                                           ProcessChartMode mode);
+guint tkmv_settings_get_process_chart_top_count (TkmvSettings *tkms);
+void tkmv_settings_set_process_chart_top_count (TkmvSettings *tkms,
+                                                guint count);
+guint tkmv_settings_get_memory_budget (TkmvSettings *tkms);
+void tkmv_settings_set_memory_budget (TkmvSettings *tkms, guint budget);
 
 void tkmv_settings_load_general_settings (TkmvSettings *tkms);
 void tkmv_settings_store_general_settings (TkmvSettings *tkms);
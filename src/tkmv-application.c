@@ -35,6 +35,12 @@ struct _TkmvApplication {
 
   /* Main window */
   TkmvWindow *main_window;
+
+  /* Record stream given on the command line */
+  gchar *stream_address;
+
+  /* Low memory warnings from the system */
+  GMemoryMonitor *memory_monitor;
 };
 
 G_DEFINE_TYPE (TkmvApplication, tkmv_application, ADW_TYPE_APPLICATION)
@@ -51,8 +57,10 @@ tkmv_application_finalize (GObject *object)
 {
   TkmvApplication *self = (TkmvApplication *)object;
 
+  g_clear_object (&self->memory_monitor);
   tkm_context_unref (self->tkm_context);
   tkmv_settings_unref (self->settings);
+  g_free (self->stream_address);
 
   G_OBJECT_CLASS (tkmv_application_parent_class)->finalize (object);
   tkmv_application_singleton = NULL;
@@ -64,6 +72,23 @@ tkmv_application_startup (GApplication *application)
   G_APPLICATION_CLASS (tkmv_application_parent_class)->startup (application);
 }
 
+static gint
+tkmv_application_handle_local_options (GApplication *application,
+                                       GVariantDict *options)
+{
+  TkmvApplication *self = TKMV_APPLICATION (application);
+
+  if (g_variant_dict_lookup (options, "stream", "s", &self->stream_address))
+    {
+      /* The stream, stdin in particular, is read by this very process */
+      g_application_set_flags (application,
+                               g_application_get_flags (application)
+                                 | G_APPLICATION_NON_UNIQUE);
+    }
+
+  return -1;
+}
+
 static void
 tkmv_application_activate (GApplication *app)
 {
@@ -84,6 +109,12 @@ tkmv_application_activate (GApplication *app)
 
   /* Ask the window manager/compositor to present the window. */
   gtk_window_present (GTK_WINDOW (self->main_window));
+
+  if (self->stream_address != NULL)
+    {
+      tkmv_application_open_stream (self, self->stream_address);
+      g_clear_pointer (&self->stream_address, g_free);
+    }
 }
 
 static void
@@ -94,6 +125,7 @@ tkmv_application_class_init (TkmvApplicationClass *klass)
 
   object_class->finalize = tkmv_application_finalize;
   app_class->startup = tkmv_application_startup;
+  app_class->handle_local_options = tkmv_application_handle_local_options;
 
   /*
    * We connect to the activate callback to create a window when the
@@ -239,6 +271,19 @@ tkmv_application_get_context (TkmvApplication *app)
   return app->tkm_context;
 }
 
+static void
+low_memory_warning (GMemoryMonitor *monitor,
+                    GMemoryMonitorWarningLevel level, gpointer user_data)
+{
+  TkmvApplication *self = TKMV_APPLICATION (user_data);
+
+  TKMV_UNUSED (monitor);
+
+  /* Loaded chunks out of view are read back when scrolled to */
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_LOW)
+    tkmv_application_drop_caches (self);
+}
+
 static void
 tkmv_application_init (TkmvApplication *self)
 {
@@ -246,6 +291,10 @@ tkmv_application_init (TkmvApplication *self)
   self->tkm_context
     = tkm_context_new (tkmv_settings_get_tkm_settings (self->settings));
 
+  self->memory_monitor = g_memory_monitor_dup_default ();
+  g_signal_connect (self->memory_monitor, "low-memory-warning",
+                    G_CALLBACK (low_memory_warning), self);
+
   g_autoptr (GSimpleAction) quit_action = g_simple_action_new ("quit", NULL);
   g_signal_connect_swapped (quit_action, "activate",
                             G_CALLBACK (g_application_quit), self);
@@ -300,6 +349,12 @@ tkmv_application_init (TkmvApplication *self)
     "r",
     NULL,
   });
+  g_application_add_main_option (
+    G_APPLICATION (self), "stream", 's', G_OPTION_FLAG_NONE,
+    G_OPTION_ARG_STRING,
+    "Read a taskmonitor record stream from a Unix socket or - for stdin",
+    "ADDRESS");
+
   /* Set our singletone instance */
   tkmv_application_singleton = self;
 }
@@ -364,6 +419,52 @@ tkmv_application_open_file (TkmvApplication *app, const gchar *path)
   tkm_context_execute_action (app->tkm_context, action);
 }
 
+static void
+async_action_open_stream_status (ActionStatusType status_type,
+                                 TkmAction *action)
+{
+  TkmvApplication *self = TKMV_APPLICATION (tkm_action_get_user_data (action));
+
+  switch (status_type)
+    {
+    case ACTION_STATUS_FAILED:
+      g_warning ("Failed to open the record stream");
+      tkmv_window_progress_spinner_stop (self->main_window);
+      break;
+
+    case ACTION_STATUS_COMPLETE:
+      /* First rows of a session, later ones arrive as progress */
+      tkmv_window_update_views_content (self->main_window);
+      tkmv_window_progress_spinner_stop (self->main_window);
+      g_info ("Record stream session loaded");
+      break;
+
+    case ACTION_STATUS_PROGRESS:
+      tkmv_window_update_stream_content (self->main_window);
+      break;
+
+    default:
+      break;
+    }
+}
+
+void
+tkmv_application_open_stream (TkmvApplication *app, const gchar *address)
+{
+  g_autoptr (TkmAction) action = NULL;
+
+  g_assert (app);
+  g_assert (address);
+
+  action = tkm_action_new (ACTION_OPEN_STREAM, NULL,
+                           async_action_open_stream_status, app);
+
+  action->args = g_list_append (action->args, g_strdup (address));
+
+  tkmv_window_progress_spinner_start (app->main_window);
+  tkm_context_execute_action (app->tkm_context, action);
+}
+
 static void
 async_action_load_sessions_status (ActionStatusType status_type,
                                    TkmAction *action)
@@ -430,6 +531,11 @@ async_action_load_data_status (ActionStatusType status_type, TkmAction *action)
     {
       tkmv_window_update_views_content (self->main_window);
       g_message ("Data loaded");
+
+      /* The page shown may have changed while the window was loading */
+      if (tkm_context_get_missing_tables (self->tkm_context) != 0)
+        tkmv_application_load_tables (
+          self, g_list_nth_data (tkm_action_get_args (action), 0));
       break;
     }
 
@@ -460,3 +566,153 @@ tkmv_application_load_data (TkmvApplication *app, const gchar *session_hash,
   tkm_context_execute_action (app->tkm_context, action);
 }
 
+static void
+async_action_load_viewport_status (ActionStatusType status_type,
+                                   TkmAction *action)
+{
+  TkmvApplication *self = TKMV_APPLICATION (tkm_action_get_user_data (action));
+
+  switch (status_type)
+    {
+    case ACTION_STATUS_FAILED:
+      g_debug ("Loading viewport data skipped");
+      break;
+
+    case ACTION_STATUS_COMPLETE:
+      tkmv_window_update_charts_content (self->main_window);
+      break;
+
+    default:
+      break;
+    }
+}
+
+void
+tkmv_application_load_viewport (TkmvApplication *app,
+                                const gchar *session_hash, guint start_time,
+                                guint end_time, guint step)
+{
+  g_autoptr (TkmAction) action = NULL;
+
+  g_assert (app);
+  g_assert (session_hash);
+
+  action = tkm_action_new (ACTION_LOAD_VIEWPORT, NULL,
+                           async_action_load_viewport_status, app);
+
+  action->args = g_list_append (action->args, g_strdup (session_hash));
+  action->args
+    = g_list_append (action->args, g_strdup_printf ("%u", start_time));
+  action->args = g_list_append (action->args, g_strdup_printf ("%u", end_time));
+  action->args = g_list_append (action->args, g_strdup_printf ("%u", step));
+
+  tkm_context_execute_action (app->tkm_context, action);
+}
+
+static void
+async_action_load_tail_status (ActionStatusType status_type, TkmAction *action)
+{
+  TkmvApplication *self = TKMV_APPLICATION (tkm_action_get_user_data (action));
+
+  switch (status_type)
+    {
+    case ACTION_STATUS_FAILED:
+      g_debug ("Loading tail data skipped");
+      break;
+
+    default:
+      break;
+    }
+
+  tkmv_window_update_live_content (self->main_window);
+}
+
+void
+tkmv_application_load_tail (TkmvApplication *app, const gchar *session_hash)
+{
+  g_autoptr (TkmAction) action = NULL;
+
+  g_assert (app);
+  g_assert (session_hash);
+
+  action = tkm_action_new (ACTION_LOAD_TAIL, NULL,
+                           async_action_load_tail_status, app);
+
+  action->args = g_list_append (action->args, g_strdup (session_hash));
+
+  tkm_context_execute_action (app->tkm_context, action);
+}
+
+static void
+async_action_load_tables_status (ActionStatusType status_type,
+                                 TkmAction *action)
+{
+  TkmvApplication *self = TKMV_APPLICATION (tkm_action_get_user_data (action));
+
+  switch (status_type)
+    {
+    case ACTION_STATUS_FAILED:
+      g_debug ("Loading view tables skipped");
+      break;
+
+    case ACTION_STATUS_COMPLETE:
+      tkmv_window_update_views_content (self->main_window);
+      break;
+
+    default:
+      break;
+    }
+
+  tkmv_window_progress_spinner_stop (self->main_window);
+}
+
+void
+tkmv_application_load_tables (TkmvApplication *app, const gchar *session_hash)
+{
+  g_autoptr (TkmAction) action = NULL;
+
+  g_assert (app);
+  g_assert (session_hash);
+
+  action = tkm_action_new (ACTION_LOAD_TABLES, NULL,
+                           async_action_load_tables_status, app);
+
+  action->args = g_list_append (action->args, g_strdup (session_hash));
+
+  tkmv_window_progress_spinner_start (app->main_window);
+  tkm_context_execute_action (app->tkm_context, action);
+}
+
+static void
+async_action_drop_caches_status (ActionStatusType status_type,
+                                 TkmAction *action)
+{
+  TkmvApplication *self = TKMV_APPLICATION (tkm_action_get_user_data (action));
+
+  switch (status_type)
+    {
+    case ACTION_STATUS_FAILED:
+      g_debug ("Dropping caches skipped");
+      break;
+
+    case ACTION_STATUS_COMPLETE:
+      tkmv_window_update_views_content (self->main_window);
+      break;
+
+    default:
+      break;
+    }
+}
+
+void
+tkmv_application_drop_caches (TkmvApplication *app)
+{
+  g_autoptr (TkmAction) action = NULL;
+
+  g_assert (app);
+
+  action = tkm_action_new (ACTION_DROP_CACHES, NULL,
+                           async_action_drop_caches_status, app);
+
+  tkm_context_execute_action (app->tkm_context, action);
+}
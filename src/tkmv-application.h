@@ -39,8 +39,19 @@ TkmContext *tkmv_application_get_context (TkmvApplication *app);
 TkmvSettings *tkmv_application_get_settings (TkmvApplication *app);
 
 void tkmv_application_open_file (TkmvApplication *app, const gchar *path);
+void tkmv_application_open_stream (TkmvApplication *app,
+                                   const gchar *address);
 void tkmv_application_load_sessions (TkmvApplication *app);
 void tkmv_application_load_data (TkmvApplication *app,
                                  const gchar *session_hash, guint start_time);
+void tkmv_application_load_viewport (TkmvApplication *app,
+                                     const gchar *session_hash,
+                                     guint start_time, guint end_time,
+                                     guint step);
+void tkmv_application_load_tail (TkmvApplication *app,
+                                 const gchar *session_hash);
+void tkmv_application_load_tables (TkmvApplication *app,
+                                   const gchar *session_hash);
+void tkmv_application_drop_caches (TkmvApplication *app);
 
 G_END_DECLS
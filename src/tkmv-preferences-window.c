@@ -29,6 +29,34 @@ struct _TkmvPreferencesWindow {
   AdwComboRow *source_combo_row;
   AdwComboRow *interval_combo_row;
   GtkSwitch *refresh_action_switch;
+
+  /* Process charts */
+  AdwComboRow *chart_mode_combo_row;
+  GtkSpinButton *chart_top_spin_button;
+
+  /* Memory */
+  GtkSpinButton *memory_budget_spin_button;
+  AdwPreferencesGroup *memory_usage_group;
+  AdwPreferencesGroup *task_pool_group;
+};
+
+static const gchar *memory_usage_titles[EPOOL_TABLE_COUNT] = {
+  [EPOOL_TABLE_PROCINFO] = "Process info",
+  [EPOOL_TABLE_CTXINFO] = "Context info",
+  [EPOOL_TABLE_PROCACCT] = "Process accounting",
+  [EPOOL_TABLE_CPUSTAT] = "CPU stat",
+  [EPOOL_TABLE_MEMINFO] = "Memory info",
+  [EPOOL_TABLE_PROCEVENT] = "Process events",
+  [EPOOL_TABLE_PRESSURE] = "Pressure",
+  [EPOOL_TABLE_BUDDYINFO] = "Buddy info",
+  [EPOOL_TABLE_WIRELESS] = "Wireless",
+  [EPOOL_TABLE_DISKSTAT] = "Disk stat",
+};
+
+static const gchar *task_pool_titles[TASK_PRIORITY_COUNT] = {
+  [TASK_PRIORITY_INTERACTIVE] = "Interactive tasks",
+  [TASK_PRIORITY_PREFETCH] = "Prefetch tasks",
+  [TASK_PRIORITY_BACKGROUND] = "Background tasks",
 };
 
 G_DEFINE_TYPE (TkmvPreferencesWindow, tkmv_preferences_window,
@@ -62,6 +90,74 @@ tkmv_preferences_window_class_init (TkmvPreferencesWindowClass *klass)
                                         interval_combo_row);
   gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
                                         refresh_action_switch);
+  gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
+                                        chart_mode_combo_row);
+  gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
+                                        chart_top_spin_button);
+  gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
+                                        memory_budget_spin_button);
+  gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
+                                        memory_usage_group);
+  gtk_widget_class_bind_template_child (widget_class, TkmvPreferencesWindow,
+                                        task_pool_group);
+}
+
+static void
+tkmv_preferences_window_load_memory_usage (TkmvPreferencesWindow *self)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+
+  g_assert (self);
+
+  tkm_context_data_lock (context);
+
+  for (EntryPoolTable t = 0; t < EPOOL_TABLE_COUNT; t++)
+    {
+      g_autofree gchar *size
+        = g_format_size (tkm_context_get_table_bytes (context, t));
+      GtkWidget *row = adw_action_row_new ();
+
+      adw_preferences_row_set_title (ADW_PREFERENCES_ROW (row),
+                                     memory_usage_titles[t]);
+      adw_action_row_set_subtitle (ADW_ACTION_ROW (row), size);
+      adw_preferences_group_add (self->memory_usage_group, row);
+    }
+
+  tkm_context_data_unlock (context);
+}
+
+static void
+tkmv_preferences_window_load_task_pool (TkmvPreferencesWindow *self)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+
+  g_assert (self);
+
+  for (TkmTaskPriority p = 0; p < TASK_PRIORITY_COUNT; p++)
+    {
+      GtkWidget *row = adw_action_row_new ();
+      g_autofree gchar *counts = NULL;
+      TkmTaskPoolStats stats;
+      guint64 runs = 0;
+
+      tkm_taskpool_get_stats (context->taskpool, p, &stats);
+      runs = stats.completed + stats.cancelled;
+
+      /* Waits are in microseconds, shown in milliseconds */
+      counts = g_strdup_printf (
+        "%u queued, %u running, %" G_GUINT64_FORMAT " done, %" G_GUINT64_FORMAT
+        " cancelled, wait %.1f ms average, %.1f ms longest",
+        stats.queued, stats.running, stats.completed, stats.cancelled,
+        runs > 0 ? (gdouble)stats.wait_total / runs / 1000.0 : 0.0,
+        (gdouble)stats.wait_max / 1000.0);
+
+      adw_preferences_row_set_title (ADW_PREFERENCES_ROW (row),
+                                     task_pool_titles[p]);
+      adw_action_row_set_subtitle (ADW_ACTION_ROW (row), counts);
+      adw_preferences_group_add (self->task_pool_group, row);
+    }
 }
 
 static void
@@ -81,6 +177,14 @@ tkmv_preferences_window_load_settings (TkmvPreferencesWindow *self)
     (guint)tkmv_settings_get_time_interval (settings));
   gtk_switch_set_state (self->refresh_action_switch,
                         tkmv_settings_get_auto_timeline_refresh (settings));
+  adw_combo_row_set_selected (
+    self->chart_mode_combo_row,
+    (guint)tkmv_settings_get_process_chart_mode (settings));
+  gtk_spin_button_set_value (
+    self->chart_top_spin_button,
+    tkmv_settings_get_process_chart_top_count (settings));
+  gtk_spin_button_set_value (self->memory_budget_spin_button,
+                             tkmv_settings_get_memory_budget (settings));
 }
 
 static void
@@ -128,12 +232,55 @@ refresh_action_state_set (GtkSwitch *self, gboolean state, gpointer user_data)
   return FALSE;
 }
 
+static void
+chart_mode_combo_row_selected (AdwComboRow *self, GParamSpec *pspec,
+                               gpointer user_data)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+
+  TKMV_UNUSED (pspec);
+  TKMV_UNUSED (user_data);
+
+  tkmv_settings_set_process_chart_mode (
+    settings, (ProcessChartMode)adw_combo_row_get_selected (self));
+  tkmv_settings_store_general_settings (settings);
+}
+
+static void
+chart_top_spin_button_changed (GtkSpinButton *self, gpointer user_data)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+
+  TKMV_UNUSED (user_data);
+
+  tkmv_settings_set_process_chart_top_count (
+    settings, (guint)gtk_spin_button_get_value_as_int (self));
+  tkmv_settings_store_general_settings (settings);
+}
+
+static void
+memory_budget_spin_button_changed (GtkSpinButton *self, gpointer user_data)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+
+  TKMV_UNUSED (user_data);
+
+  tkmv_settings_set_memory_budget (
+    settings, (guint)gtk_spin_button_get_value_as_int (self));
+  tkmv_settings_store_general_settings (settings);
+}
+
 static void
 tkmv_preferences_window_init (TkmvPreferencesWindow *self)
 {
   gtk_widget_init_template (GTK_WIDGET (self));
 
   tkmv_preferences_window_load_settings (self);
+  tkmv_preferences_window_load_memory_usage (self);
+  tkmv_preferences_window_load_task_pool (self);
 
   g_signal_connect (G_OBJECT (self->source_combo_row), "notify::selected",
                     G_CALLBACK (source_combo_row_selected), self);
@@ -141,4 +288,11 @@ tkmv_preferences_window_init (TkmvPreferencesWindow *self)
                     G_CALLBACK (interval_combo_row_selected), self);
   g_signal_connect (G_OBJECT (self->refresh_action_switch), "state-set",
                     G_CALLBACK (refresh_action_state_set), self);
+  g_signal_connect (G_OBJECT (self->chart_mode_combo_row), "notify::selected",
+                    G_CALLBACK (chart_mode_combo_row_selected), self);
+  g_signal_connect (G_OBJECT (self->chart_top_spin_button), "value-changed",
+                    G_CALLBACK (chart_top_spin_button_changed), self);
+  g_signal_connect (G_OBJECT (self->memory_budget_spin_button),
+                    "value-changed",
+                    G_CALLBACK (memory_budget_spin_button_changed), self);
 }
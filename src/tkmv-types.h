@@ -26,4 +26,9 @@ G_BEGIN_DECLS
 #define TKMV_UNUSED(x) (void)(x)
 #endif
 
+typedef enum _ProcessChartMode {
+  PROCESS_CHART_MODE_LINES,
+  PROCESS_CHART_MODE_STACKED
+} ProcessChartMode;
+
 G_END_DECLS
@@ -28,12 +28,50 @@
 #include "views/tkmv-processes-view.h"
 #include "views/tkmv-systeminfo-view.h"
 
+/* How often a capture that is still written is checked for new rows */
+#define LIVE_POLL_INTERVAL_MS (1000)
+
+/* Shortest time between two redraws of data that keeps arriving */
+#define LIVE_FRAME_INTERVAL_MS (100)
+
+/* Playback shows this fraction of the loaded window around the cursor */
+#define PLAY_WINDOW_FRACTION (4)
+
+/* How long a view refresh waits for a load holding the data lock */
+#define VIEWS_REFRESH_RETRY_MS (50)
+
+/* Speed factors of the playback speed combobox entries */
+static const guint play_speeds[] = { 1, 10, 60, 600 };
+
+/* Pages of the views stack, refreshed separately */
+typedef enum _WindowView {
+  WINDOW_VIEW_DASHBOARD,
+  WINDOW_VIEW_PROCESSES,
+  WINDOW_VIEW_SYSTEMINFO,
+  WINDOW_VIEW_COUNT,
+} WindowView;
+
+#define WINDOW_VIEW_BIT(v) (1U << (v))
+#define WINDOW_VIEWS_ALL (WINDOW_VIEW_BIT (WINDOW_VIEW_COUNT) - 1)
+
+static const gchar *window_view_names[WINDOW_VIEW_COUNT]
+  = { "dashboard", "processes", "systeminfo" };
+
 static void window_views_init (TkmvWindow *self);
 static void window_toolbar_init (TkmvWindow *self);
 static void tkmv_window_update_toolbar (TkmvWindow *window);
 static gboolean update_views_content_invoke (gpointer _self);
+static gint window_visible_view (TkmvWindow *self);
+static void views_refresh_schedule (TkmvWindow *self);
+static gboolean views_refresh_invoke (gpointer _self);
+static gboolean update_charts_content_invoke (gpointer _self);
+static void update_tables_content (TkmvWindow *window);
+static gboolean update_live_content_invoke (gpointer _self);
+static gboolean update_stream_content_invoke (gpointer _self);
 static void tools_visible_child_changed (GObject *stack, GParamSpec *pspec,
                                          TkmvWindow *self);
+static void views_visible_child_changed (GObject *stack, GParamSpec *pspec,
+                                         TkmvWindow *self);
 static void tools_session_list_changed (GtkComboBox *self,
                                         gpointer _tkmv_window);
 static void tools_time_source_changed (GtkComboBox *self,
@@ -44,6 +82,15 @@ static void tools_timestamp_scale_value_changed (GtkRange *self,
                                                  gpointer _tkmv_window);
 static void tools_set_timestamp_text (TkmvWindow *self, DataTimeSource source,
                                       guint timestamp_sec);
+static void timeline_live_button_toggled (GtkToggleButton *self,
+                                          gpointer user_data);
+static gboolean live_poll_timeout (gpointer user_data);
+static void timeline_play_button_toggled (GtkToggleButton *self,
+                                          gpointer user_data);
+static gboolean play_tick_callback (GtkWidget *widget,
+                                    GdkFrameClock *frame_clock,
+                                    gpointer user_data);
+static TkmSessionEntry *active_session_lookup (void);
 
 static void load_window_size (TkmvWindow *self);
 static void open_file_menu_add_file (gpointer _rf, gpointer _window);
@@ -72,10 +119,19 @@ struct _TkmvWindow {
   TkmvSysteminfoView *systeminfo_view;
 
   /* Template widgets */
+  AdwViewStack *stack;
   GtkViewport *dashboard_viewport;
   GtkViewport *processes_viewport;
   GtkViewport *systeminfo_viewport;
 
+  /* Views with stale content, the shown one is refreshed in slices */
+  guint views_dirty;
+  guint refresh_source;
+  gint refresh_view;
+  guint refresh_slice;
+  /* Tables generation the views were last updated for */
+  guint tables_generation;
+
   GtkToggleButton *tools_button;
   GtkSearchBar *tools_bar;
   GtkSpinner *main_spinner;
@@ -90,6 +146,23 @@ struct _TkmvWindow {
   GtkLabel *timestamp_text;
   GtkAdjustment *timestamp_scale_adjustment;
   GtkButton *timeline_refresh_button;
+  GtkToggleButton *timeline_live_button;
+  GtkComboBoxText *play_speed_combobox;
+  GtkToggleButton *timeline_play_button;
+
+  /* Live tail of a capture that is still written */
+  guint live_source;
+  gboolean live_pending;
+  guint live_generation;
+  gint64 live_frame_time;
+  guint live_frame_source;
+
+  /* Playback of the loaded window on the frame clock */
+  guint play_tick;
+  gint64 play_frame_time;
+  double play_start;
+  double play_end;
+  double play_cursor;
 
   /* Session info */
   GtkDialog *session_info_dialog;
@@ -116,6 +189,7 @@ tkmv_window_class_init (TkmvWindowClass *klass)
 
   gtk_widget_class_set_template_from_resource (
     widget_class, "/ro/fxdata/taskmonitor/viewer/gtk/tkmv-window.ui");
+  gtk_widget_class_bind_template_child (widget_class, TkmvWindow, stack);
   gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
                                         dashboard_viewport);
   gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
@@ -144,6 +218,12 @@ tkmv_window_class_init (TkmvWindowClass *klass)
                                         timestamp_text);
   gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
                                         timeline_refresh_button);
+  gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
+                                        timeline_live_button);
+  gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
+                                        play_speed_combobox);
+  gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
+                                        timeline_play_button);
 
   gtk_widget_class_bind_template_child (widget_class, TkmvWindow,
                                         session_info_dialog);
@@ -177,6 +257,8 @@ tkmv_window_class_init (TkmvWindowClass *klass)
   /* Bind callbacks */
   gtk_widget_class_bind_template_callback (widget_class,
                                            tools_visible_child_changed);
+  gtk_widget_class_bind_template_callback (widget_class,
+                                           views_visible_child_changed);
 }
 
 static void
@@ -222,6 +304,14 @@ window_views_init (TkmvWindow *self)
   self->systeminfo_view = g_object_new (TKMV_TYPE_SYSTEMINFO_VIEW, NULL);
   gtk_viewport_set_child (self->systeminfo_viewport,
                           GTK_WIDGET (self->systeminfo_view));
+
+  self->views_dirty = 0;
+  self->refresh_view = -1;
+
+  /* The views registered their tables, loads start with the shown one */
+  tkm_context_set_visible_view (
+    tkmv_application_get_context (tkmv_application_instance ()),
+    adw_view_stack_get_visible_child_name (self->stack));
 }
 
 static void
@@ -405,6 +495,10 @@ tools_timestamp_scale_value_changed (GtkRange *self, gpointer _tkmv_window)
   tools_set_timestamp_text (window, tkmv_settings_get_time_source (settings),
                             gtk_range_get_value (self));
 
+  /* Moving back in time leaves the live tail and the playback */
+  gtk_toggle_button_set_active (window->timeline_live_button, FALSE);
+  gtk_toggle_button_set_active (window->timeline_play_button, FALSE);
+
   if (tkmv_settings_get_auto_timeline_refresh (settings))
     {
       tkmv_application_load_data (tkmv_application_instance (),
@@ -502,6 +596,192 @@ timeline_refresh_button_clicked (GtkButton *self, gpointer user_data)
   tkmv_window_request_update_data (window);
 }
 
+static TkmSessionEntry *
+active_session_lookup (void)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  GPtrArray *sessions = tkm_context_get_session_entries (context);
+
+  if (sessions == NULL)
+    return NULL;
+
+  for (guint i = 0; i < sessions->len; i++)
+    {
+      if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
+        return g_ptr_array_index (sessions, i);
+    }
+
+  return NULL;
+}
+
+static void
+timeline_live_button_toggled (GtkToggleButton *self, gpointer user_data)
+{
+  TkmvWindow *window = (TkmvWindow *)user_data;
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  TkmSessionEntry *active_session = NULL;
+  gulong span = 0;
+  guint first = 0;
+  guint last = 0;
+
+  g_assert (window);
+
+  if (window->live_source != 0)
+    {
+      g_source_remove (window->live_source);
+      window->live_source = 0;
+    }
+
+  if (!gtk_toggle_button_get_active (self))
+    return;
+
+  active_session = active_session_lookup ();
+  if (active_session == NULL)
+    {
+      gtk_toggle_button_set_active (self, FALSE);
+      return;
+    }
+
+  gtk_toggle_button_set_active (window->timeline_play_button, FALSE);
+
+  /* Start from the latest window, the tail loads slide it forward */
+  first = tkm_session_entry_get_first_timestamp (
+    active_session, tkmv_settings_get_time_source (settings));
+  last = tkm_session_entry_get_last_timestamp (
+    active_session, tkmv_settings_get_time_source (settings));
+  span = tkm_settings_get_data_time_span (
+    tkmv_settings_get_tkm_settings (settings));
+
+  window->live_pending = FALSE;
+  window->live_generation = 0;
+
+  tkmv_application_load_data (
+    tkmv_application_instance (), tkm_session_entry_get_hash (active_session),
+    (span > 0 && last > first + span) ? (guint)(last - span) : first);
+
+  window->live_source
+    = g_timeout_add (LIVE_POLL_INTERVAL_MS, live_poll_timeout, window);
+}
+
+static gboolean
+live_poll_timeout (gpointer user_data)
+{
+  TkmvWindow *window = (TkmvWindow *)user_data;
+  TkmSessionEntry *active_session = active_session_lookup ();
+
+  g_assert (window);
+
+  /* One tail load at a time, a slow disk skips ticks instead of queueing */
+  if (active_session == NULL || window->live_pending)
+    return G_SOURCE_CONTINUE;
+
+  window->live_pending = TRUE;
+  tkmv_application_load_tail (tkmv_application_instance (),
+                              tkm_session_entry_get_hash (active_session));
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+timeline_play_button_toggled (GtkToggleButton *self, gpointer user_data)
+{
+  TkmvWindow *window = (TkmvWindow *)user_data;
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  TkmSessionEntry *active_session = NULL;
+  gulong span = 0;
+  guint last = 0;
+
+  g_assert (window);
+
+  if (window->play_tick != 0)
+    {
+      gtk_widget_remove_tick_callback (GTK_WIDGET (window), window->play_tick);
+      window->play_tick = 0;
+    }
+
+  if (!gtk_toggle_button_get_active (self))
+    {
+      tkmv_dashboard_view_clear_cursor (window->dashboard_view);
+      tools_set_timestamp_text (
+        window, tkmv_settings_get_time_source (settings),
+        gtk_range_get_value (GTK_RANGE (window->timestamp_scale)));
+      return;
+    }
+
+  active_session = active_session_lookup ();
+  if (active_session == NULL)
+    {
+      gtk_toggle_button_set_active (self, FALSE);
+      return;
+    }
+
+  gtk_toggle_button_set_active (window->timeline_live_button, FALSE);
+
+  /* Play the window loaded from the timestamp scale */
+  last = tkm_session_entry_get_last_timestamp (
+    active_session, tkmv_settings_get_time_source (settings));
+  span = tkm_settings_get_data_time_span (
+    tkmv_settings_get_tkm_settings (settings));
+
+  window->play_start
+    = gtk_range_get_value (GTK_RANGE (window->timestamp_scale));
+  window->play_end = last;
+  if (span > 0 && window->play_start + span < last)
+    window->play_end = window->play_start + span;
+
+  if (window->play_end <= window->play_start)
+    {
+      gtk_toggle_button_set_active (self, FALSE);
+      return;
+    }
+
+  window->play_cursor = window->play_start;
+  window->play_frame_time = 0;
+  window->play_tick = gtk_widget_add_tick_callback (
+    GTK_WIDGET (window), play_tick_callback, window, NULL);
+}
+
+static gboolean
+play_tick_callback (GtkWidget *widget, GdkFrameClock *frame_clock,
+                    gpointer user_data)
+{
+  TkmvWindow *window = (TkmvWindow *)user_data;
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  gint64 frame_time = gdk_frame_clock_get_frame_time (frame_clock);
+  gint speed_index = gtk_combo_box_get_active (
+    GTK_COMBO_BOX (window->play_speed_combobox));
+  double width = (window->play_end - window->play_start)
+                 / PLAY_WINDOW_FRACTION;
+
+  TKMV_UNUSED (widget);
+
+  /* Advance by the time since the last frame, whatever the frame rate */
+  if (window->play_frame_time != 0 && speed_index >= 0
+      && speed_index < (gint)G_N_ELEMENTS (play_speeds))
+    window->play_cursor += (double)(frame_time - window->play_frame_time)
+                           / G_USEC_PER_SEC * play_speeds[speed_index];
+  window->play_frame_time = frame_time;
+
+  if (window->play_cursor >= window->play_end)
+    {
+      window->play_tick = 0;
+      gtk_toggle_button_set_active (window->timeline_play_button, FALSE);
+      return G_SOURCE_REMOVE;
+    }
+
+  tkmv_dashboard_view_set_cursor (window->dashboard_view,
+                                  window->play_cursor - width,
+                                  window->play_cursor);
+  tools_set_timestamp_text (window, tkmv_settings_get_time_source (settings),
+                            (guint)window->play_cursor);
+
+  return G_SOURCE_CONTINUE;
+}
+
 static void
 window_toolbar_init (TkmvWindow *self)
 {
@@ -526,6 +806,10 @@ window_toolbar_init (TkmvWindow *self)
                     G_CALLBACK (tools_timestamp_scale_value_changed), self);
   g_signal_connect (G_OBJECT (self->timeline_refresh_button), "clicked",
                     G_CALLBACK (timeline_refresh_button_clicked), self);
+  g_signal_connect (G_OBJECT (self->timeline_live_button), "toggled",
+                    G_CALLBACK (timeline_live_button_toggled), self);
+  g_signal_connect (G_OBJECT (self->timeline_play_button), "toggled",
+                    G_CALLBACK (timeline_play_button_toggled), self);
 }
 
 static void
@@ -537,6 +821,32 @@ tools_visible_child_changed (GObject *stack, GParamSpec *pspec,
   TKMV_UNUSED (self);
 }
 
+static void
+views_visible_child_changed (GObject *stack, GParamSpec *pspec,
+                             TkmvWindow *self)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  TkmSessionEntry *active_session = NULL;
+
+  TKMV_UNUSED (pspec);
+
+  tkm_context_set_visible_view (
+    context, adw_view_stack_get_visible_child_name (ADW_VIEW_STACK (stack)));
+
+  /* Pages hidden during the last update catch up now */
+  views_refresh_schedule (self);
+
+  /* Pages shown for the first time since the load fill their tables */
+  if (tkm_context_get_missing_tables (context) == 0)
+    return;
+
+  active_session = active_session_lookup ();
+  if (active_session != NULL)
+    tkmv_application_load_tables (tkmv_application_instance (),
+                                  tkm_session_entry_get_hash (active_session));
+}
+
 static void
 load_window_size (TkmvWindow *self)
 {
@@ -562,6 +872,30 @@ close_window_signal (TkmvWindow *self, gpointer user_data)
 
   gtk_window_get_default_size (GTK_WINDOW (self), &width, &height);
   tkmv_settings_set_main_window_size (settings, width, height);
+
+  if (self->live_source != 0)
+    {
+      g_source_remove (self->live_source);
+      self->live_source = 0;
+    }
+
+  if (self->live_frame_source != 0)
+    {
+      g_source_remove (self->live_frame_source);
+      self->live_frame_source = 0;
+    }
+
+  if (self->play_tick != 0)
+    {
+      gtk_widget_remove_tick_callback (GTK_WIDGET (self), self->play_tick);
+      self->play_tick = 0;
+    }
+
+  if (self->refresh_source != 0)
+    {
+      g_source_remove (self->refresh_source);
+      self->refresh_source = 0;
+    }
 }
 
 static void
@@ -831,12 +1165,109 @@ update_views_content_invoke (gpointer _self)
   g_assert (window);
 
   tkmv_window_update_toolbar (window);
-  tkmv_dashboard_view_update_content (window->dashboard_view);
-  tkmv_systeminfo_reload_entries (window->systeminfo_view, context);
-  tkmv_processes_reload_entries (window->processes_view, context);
+  window->tables_generation = tkm_context_get_tables_generation (context);
+  tkm_context_data_unlock (context);
+
+  /*
+   * Views are only rebuilt when shown, a refresh in progress starts over
+   * with the new data.
+   */
+  window->views_dirty = WINDOW_VIEWS_ALL;
+  window->refresh_view = -1;
+  views_refresh_schedule (window);
+
+  return FALSE;
+}
+
+static gint
+window_visible_view (TkmvWindow *self)
+{
+  const gchar *name = adw_view_stack_get_visible_child_name (self->stack);
+
+  for (gint i = 0; i < WINDOW_VIEW_COUNT; i++)
+    {
+      if (g_strcmp0 (name, window_view_names[i]) == 0)
+        return i;
+    }
+
+  return -1;
+}
+
+static void
+views_refresh_schedule (TkmvWindow *self)
+{
+  gint view = window_visible_view (self);
+
+  if (self->refresh_source != 0 || view < 0)
+    return;
+
+  if ((self->views_dirty & WINDOW_VIEW_BIT (view)) != 0)
+    self->refresh_source = g_idle_add (views_refresh_invoke, self);
+}
+
+static gboolean
+views_refresh_invoke (gpointer _self)
+{
+  TkmvWindow *window = (TkmvWindow *)_self;
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  gint view = window_visible_view (window);
+  gboolean more = FALSE;
+
+  g_assert (window);
+
+  window->refresh_source = 0;
+
+  if (view < 0 || (window->views_dirty & WINDOW_VIEW_BIT (view)) == 0)
+    return FALSE;
+
+  /* A load is swapping the data, retry later instead of blocking */
+  if (!tkm_context_data_try_lock (context))
+    {
+      window->refresh_source
+        = g_timeout_add (VIEWS_REFRESH_RETRY_MS, views_refresh_invoke, window);
+      return FALSE;
+    }
+
+  /* A view left half refreshed starts over */
+  if (view != window->refresh_view)
+    {
+      window->refresh_view = view;
+      window->refresh_slice = 0;
+    }
+
+  switch (view)
+    {
+    case WINDOW_VIEW_DASHBOARD:
+      tkmv_dashboard_view_update_content (window->dashboard_view);
+      break;
+    case WINDOW_VIEW_PROCESSES:
+      more = tkmv_processes_reload_slice (window->processes_view, context,
+                                          window->refresh_slice);
+      break;
+    case WINDOW_VIEW_SYSTEMINFO:
+      more = tkmv_systeminfo_reload_slice (window->systeminfo_view, context,
+                                           window->refresh_slice);
+      break;
+    default:
+      break;
+    }
 
   tkm_context_data_unlock (context);
 
+  if (more)
+    {
+      /* Let input and redraws in between the slices */
+      window->refresh_slice++;
+      window->refresh_source = g_idle_add (views_refresh_invoke, window);
+    }
+  else
+    {
+      window->views_dirty &= ~WINDOW_VIEW_BIT (view);
+      window->refresh_view = -1;
+      window->refresh_slice = 0;
+    }
+
   return FALSE;
 }
 
@@ -852,6 +1283,158 @@ tkmv_window_update_views_content (TkmvWindow *window)
   g_main_context_invoke (NULL, update_views_content_invoke, window);
 }
 
+static gboolean
+update_charts_content_invoke (gpointer _self)
+{
+  TkmvWindow *window = (TkmvWindow *)_self;
+
+  g_assert (window);
+
+  /* Charts take the data lock themselves when they rebuild */
+  tkmv_dashboard_view_update_charts (window->dashboard_view);
+  update_tables_content (window);
+
+  return FALSE;
+}
+
+/*
+ * The tail loads add rows to the tables the views list, and chunks evicted
+ * over the memory budget drop some of them.
+ */
+static void
+update_tables_content (TkmvWindow *window)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+
+  if (tkm_context_get_tables_generation (context)
+      != window->tables_generation)
+    tkmv_window_update_views_content (window);
+}
+
+void
+tkmv_window_update_charts_content (TkmvWindow *window)
+{
+  g_assert (window);
+  g_main_context_invoke (NULL, update_charts_content_invoke, window);
+}
+
+static void
+live_content_refresh (TkmvWindow *window)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  TkmSessionEntry *active_session = active_session_lookup ();
+  guint generation = tkm_context_get_data_generation (context);
+  gulong span = 0;
+  guint first = 0;
+  guint last = 0;
+  guint start = 0;
+
+  /* Nothing new arrived since the last refresh */
+  if (active_session == NULL || generation == window->live_generation)
+    return;
+
+  window->live_generation = generation;
+  window->live_frame_time = g_get_monotonic_time ();
+
+  first = tkm_session_entry_get_first_timestamp (
+    active_session, tkmv_settings_get_time_source (settings));
+  last = tkm_session_entry_get_last_timestamp (
+    active_session, tkmv_settings_get_time_source (settings));
+  span = tkm_settings_get_data_time_span (
+    tkmv_settings_get_tkm_settings (settings));
+  start = (span > 0 && last > first + span) ? (guint)(last - span) : first;
+
+  /* Follow the session end without reloading the window */
+  g_signal_handlers_block_by_func (window->timestamp_scale,
+                                   tools_timestamp_scale_value_changed,
+                                   window);
+  gtk_range_set_range (GTK_RANGE (window->timestamp_scale), first, last);
+  gtk_range_set_value (GTK_RANGE (window->timestamp_scale), start);
+  g_signal_handlers_unblock_by_func (window->timestamp_scale,
+                                     tools_timestamp_scale_value_changed,
+                                     window);
+  tools_set_timestamp_text (window, tkmv_settings_get_time_source (settings),
+                            start);
+
+  tkmv_dashboard_view_update_charts (window->dashboard_view);
+  update_tables_content (window);
+}
+
+static gboolean
+live_frame_timeout (gpointer user_data)
+{
+  TkmvWindow *window = (TkmvWindow *)user_data;
+
+  window->live_frame_source = 0;
+  live_content_refresh (window);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+live_content_schedule (TkmvWindow *window)
+{
+  gint64 elapsed = g_get_monotonic_time () - window->live_frame_time;
+
+  if (window->live_frame_source != 0)
+    return;
+
+  /* Redraw at most once a frame however fast the rows arrive */
+  if (elapsed < LIVE_FRAME_INTERVAL_MS * G_TIME_SPAN_MILLISECOND)
+    {
+      window->live_frame_source = g_timeout_add (
+        LIVE_FRAME_INTERVAL_MS - (guint)(elapsed / G_TIME_SPAN_MILLISECOND),
+        live_frame_timeout, window);
+      return;
+    }
+
+  live_content_refresh (window);
+}
+
+static gboolean
+update_live_content_invoke (gpointer _self)
+{
+  TkmvWindow *window = (TkmvWindow *)_self;
+
+  g_assert (window);
+
+  window->live_pending = FALSE;
+
+  if (gtk_toggle_button_get_active (window->timeline_live_button))
+    live_content_schedule (window);
+
+  return FALSE;
+}
+
+static gboolean
+update_stream_content_invoke (gpointer _self)
+{
+  TkmvWindow *window = (TkmvWindow *)_self;
+
+  g_assert (window);
+  live_content_schedule (window);
+
+  return FALSE;
+}
+
+void
+tkmv_window_update_stream_content (TkmvWindow *window)
+{
+  g_assert (window);
+  g_main_context_invoke (NULL, update_stream_content_invoke, window);
+}
+
+void
+tkmv_window_update_live_content (TkmvWindow *window)
+{
+  g_assert (window);
+  g_main_context_invoke (NULL, update_live_content_invoke, window);
+}
+
 void
 tkmv_window_request_update_data (TkmvWindow *window)
 {
@@ -29,6 +29,9 @@ G_DECLARE_FINAL_TYPE (TkmvWindow, tkmv_window, TKMV, WINDOW,
                       AdwApplicationWindow)
 
 void tkmv_window_update_views_content (TkmvWindow *window);
+void tkmv_window_update_charts_content (TkmvWindow *window);
+void tkmv_window_update_live_content (TkmvWindow *window);
+void tkmv_window_update_stream_content (TkmvWindow *window);
 void tkmv_window_request_update_data (TkmvWindow *window);
 
 void tkmv_window_progress_spinner_start (TkmvWindow *window);
@@ -0,0 +1,1178 @@
+/* tkmv-chart.c
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tkmv-chart.h"
+#include "tkm-context.h"
+#include "tkm-task.h"
+#include "tkmv-application.h"
+#include "tkmv-types.h"
+
+#include "libkplot/extern.h"
+
+#include <math.h>
+#include <pango/pangocairo.h>
+
+/*
+ * The plot model is shared between the render worker, which rebuilds and
+ * draws it, and the main thread, which looks up hover values in the model
+ * the current raster was drawn from. The last reference frees the plot.
+ * Appends change the samples of a model in place, under its lock.
+ */
+struct _TkmvChartModel {
+  GMutex lock;
+  struct kplot *plot;
+  cairo_surface_t *raster;
+  double raster_min;
+  double raster_max;
+};
+
+typedef struct _ChartRenderJob {
+  TkmTask task; /* has to be first, the pool hands us back a TkmTask */
+  TkmvChart *chart;
+  gpointer data;
+  TaskStatusType status;
+
+  cairo_surface_t *surface;
+  TkmvChartModel *model;
+  guint serial;
+  guint update;
+  guint generation;
+  guint epoch;
+  int width;
+  int height;
+  int scale;
+  gboolean view_set;
+  double view_min;
+  double view_max;
+
+  gboolean area_valid;
+  double area_x;
+  double area_width;
+  double area_min;
+  double area_max;
+} ChartRenderJob;
+
+/* Zoom factor per scroll step and the narrowest range we zoom into */
+#define CHART_ZOOM_STEP 1.25
+#define CHART_MIN_SPAN 2.0
+
+/* Hover tooltip rows listed before the rest is summarised */
+#define CHART_HOVER_MAX_ROWS 16
+
+/* Narrowest strip in device pixels worth drawing on its own thread */
+#define CHART_TILE_MIN_WIDTH 512
+/* Fewest drawn pairs per strip worth drawing on its own thread */
+#define CHART_TILE_MIN_PAIRS 32768
+
+/*
+ * Strips of one render, claimed in turn by the render thread and the tile
+ * pool workers. Workers picking the job up late find nothing left to draw.
+ */
+typedef struct _ChartTiles {
+  void (*func) (void *);
+  void **args;
+  gint count;
+  gint next;
+  gint done;
+  GMutex lock;
+  GCond cond;
+} ChartTiles;
+
+static TkmvChartModel *chart_model_new (struct kplot *plot);
+static void chart_model_build (TkmvChart *chart, ChartRenderJob *job);
+static void chart_model_clear (gpointer _model);
+static void chart_model_unref (TkmvChartModel *model);
+static void chart_draw_function (GtkDrawingArea *area, cairo_t *cr,
+                                 int width, int height, gpointer data);
+static void chart_schedule_render (TkmvChart *chart, int width, int height,
+                                   int scale);
+static gboolean chart_render_exec (TkmTask *task, gpointer _context);
+static void chart_render_status (TaskStatusType status, TkmTask *task);
+static gboolean chart_render_complete_invoke (gpointer _job);
+static size_t chart_plot_pairs (const struct kplot *plot, gboolean view_set,
+                                double view_min, double view_max);
+static GThreadPool *chart_tile_pool (void);
+static void chart_tile_worker (gpointer _tiles, gpointer data);
+static void chart_tiles_claim (ChartTiles *tiles);
+static void chart_tiles_clear (gpointer _tiles);
+static void chart_tiles_run (void (*func) (void *), void **args, size_t count,
+                             void *data);
+static void chart_paint_raster (TkmvChartModel *model, cairo_t *cr);
+static void chart_paint_surface (TkmvChart *chart, cairo_t *cr, int height);
+static gboolean chart_series_color (const struct kplot *plot, size_t index,
+                                    const struct kdatacfg *cfg, double *rgba);
+static void chart_paint_hover (TkmvChart *chart, cairo_t *cr, int width,
+                               int height);
+static void chart_viewport_changed (TkmvChart *chart, double min, double max);
+static void chart_pointer_motion (GtkEventControllerMotion *controller,
+                                  double x, double y, gpointer data);
+static void chart_pointer_leave (GtkEventControllerMotion *controller,
+                                 gpointer data);
+static gboolean chart_scroll (GtkEventControllerScroll *controller, double dx,
+                              double dy, gpointer data);
+static void chart_drag_begin (GtkGestureDrag *gesture, double x, double y,
+                              gpointer data);
+static void chart_drag_update (GtkGestureDrag *gesture, double offset_x,
+                               double offset_y, gpointer data);
+static void chart_pressed (GtkGestureClick *gesture, int n_press, double x,
+                           double y, gpointer data);
+
+TkmvChart *
+tkmv_chart_new (GtkDrawingArea *area, TkmvChartBuildFunc build_func,
+                TkmvChartSnapshotFunc snapshot_func,
+                GDestroyNotify snapshot_free, gpointer user_data)
+{
+  TkmvChart *chart = g_new0 (TkmvChart, 1);
+  GtkEventController *motion = NULL;
+  GtkEventController *scroll = NULL;
+  GtkGesture *drag = NULL;
+  GtkGesture *click = NULL;
+
+  g_assert (area);
+  g_assert (build_func);
+
+  chart->area = area;
+  chart->build_func = build_func;
+  chart->snapshot_func = snapshot_func;
+  chart->snapshot_free = snapshot_free;
+  chart->user_data = user_data;
+  g_ref_count_init (&chart->rc);
+
+  g_object_add_weak_pointer (G_OBJECT (area), (gpointer *)&chart->area);
+  gtk_drawing_area_set_draw_func (area, chart_draw_function, chart, NULL);
+
+  /* Wheel zooms around the pointer, dragging pans, double click resets */
+  motion = gtk_event_controller_motion_new ();
+  g_signal_connect (motion, "motion", G_CALLBACK (chart_pointer_motion),
+                    chart);
+  g_signal_connect (motion, "leave", G_CALLBACK (chart_pointer_leave), chart);
+  gtk_widget_add_controller (GTK_WIDGET (area), motion);
+
+  scroll
+    = gtk_event_controller_scroll_new (GTK_EVENT_CONTROLLER_SCROLL_VERTICAL);
+  g_signal_connect (scroll, "scroll", G_CALLBACK (chart_scroll), chart);
+  gtk_widget_add_controller (GTK_WIDGET (area), scroll);
+
+  drag = gtk_gesture_drag_new ();
+  g_signal_connect (drag, "drag-begin", G_CALLBACK (chart_drag_begin), chart);
+  g_signal_connect (drag, "drag-update", G_CALLBACK (chart_drag_update),
+                    chart);
+  gtk_widget_add_controller (GTK_WIDGET (area), GTK_EVENT_CONTROLLER (drag));
+
+  click = gtk_gesture_click_new ();
+  g_signal_connect (click, "pressed", G_CALLBACK (chart_pressed), chart);
+  gtk_widget_add_controller (GTK_WIDGET (area), GTK_EVENT_CONTROLLER (click));
+
+  return chart;
+}
+
+TkmvChart *
+tkmv_chart_ref (TkmvChart *chart)
+{
+  g_assert (chart);
+  g_ref_count_inc (&chart->rc);
+  return chart;
+}
+
+void
+tkmv_chart_unref (TkmvChart *chart)
+{
+  g_assert (chart);
+
+  if (g_ref_count_dec (&chart->rc) == TRUE)
+    {
+      if (chart->area != NULL)
+        g_object_remove_weak_pointer (G_OBJECT (chart->area),
+                                      (gpointer *)&chart->area);
+
+      if (chart->surface != NULL)
+        cairo_surface_destroy (chart->surface);
+
+      chart_model_unref (chart->surface_model);
+      chart_model_unref (chart->model);
+      g_free (chart);
+    }
+}
+
+void
+tkmv_chart_invalidate (TkmvChart *chart)
+{
+  g_assert (chart);
+
+  chart->serial++;
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+void
+tkmv_chart_update (TkmvChart *chart)
+{
+  g_assert (chart);
+
+  chart->update++;
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+void
+tkmv_chart_set_raster_func (TkmvChart *chart, TkmvChartRasterFunc raster_func)
+{
+  g_assert (chart);
+
+  chart->raster_func = raster_func;
+  tkmv_chart_invalidate (chart);
+}
+
+void
+tkmv_chart_set_append_func (TkmvChart *chart, TkmvChartAppendFunc append_func)
+{
+  g_assert (chart);
+
+  chart->append_func = append_func;
+  tkmv_chart_invalidate (chart);
+}
+
+void
+tkmv_chart_set_viewport_func (TkmvChart *chart,
+                              TkmvChartViewportFunc viewport_func,
+                              gpointer user_data)
+{
+  g_assert (chart);
+
+  chart->viewport_func = viewport_func;
+  chart->viewport_data = user_data;
+}
+
+void
+tkmv_chart_set_viewport (TkmvChart *chart, double min, double max)
+{
+  g_assert (chart);
+
+  if (max <= min)
+    return;
+
+  chart->view_set = TRUE;
+  chart->view_min = min;
+  chart->view_max = max;
+
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+void
+tkmv_chart_reset_viewport (TkmvChart *chart)
+{
+  g_assert (chart);
+
+  if (!chart->view_set)
+    return;
+
+  chart->view_set = FALSE;
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+gboolean
+tkmv_chart_get_viewport (TkmvChart *chart, double *min, double *max)
+{
+  g_assert (chart);
+
+  if (chart->view_set)
+    {
+      *min = chart->view_min;
+      *max = chart->view_max;
+      return TRUE;
+    }
+
+  /* Without a viewport the chart shows what the last raster spans */
+  if (chart->surface_area_valid
+      && chart->surface_area_max > chart->surface_area_min)
+    {
+      *min = chart->surface_area_min;
+      *max = chart->surface_area_max;
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+void
+tkmv_chart_set_hover_func (TkmvChart *chart, TkmvChartHoverFunc hover_func,
+                           gpointer user_data)
+{
+  g_assert (chart);
+
+  chart->hover_func = hover_func;
+  chart->hover_data = user_data;
+}
+
+void
+tkmv_chart_set_hover (TkmvChart *chart, double x)
+{
+  g_assert (chart);
+
+  if (chart->hover_set && chart->hover_x == x)
+    return;
+
+  chart->hover_set = TRUE;
+  chart->hover_x = x;
+
+  /* The raster key is unchanged so this only repaints the overlay */
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+void
+tkmv_chart_clear_hover (TkmvChart *chart)
+{
+  g_assert (chart);
+
+  if (!chart->hover_set)
+    return;
+
+  chart->hover_set = FALSE;
+  if (chart->area != NULL)
+    gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+}
+
+static TkmvChartModel *
+chart_model_new (struct kplot *plot)
+{
+  TkmvChartModel *model = g_atomic_rc_box_new0 (TkmvChartModel);
+
+  g_mutex_init (&model->lock);
+  model->plot = plot;
+
+  return model;
+}
+
+static void
+chart_model_build (TkmvChart *chart, ChartRenderJob *job)
+{
+  struct kplot *plot = NULL;
+
+  g_clear_pointer (&chart->model, chart_model_unref);
+  plot = chart->build_func (job->data);
+  if (plot == NULL)
+    return;
+
+  chart->model = chart_model_new (plot);
+  chart->plot_extrema = kplot_get_plotcfg (plot)->extrema;
+
+  if (chart->raster_func != NULL)
+    chart->model->raster
+      = chart->raster_func (job->data, &chart->model->raster_min,
+                            &chart->model->raster_max);
+}
+
+static void
+chart_model_clear (gpointer _model)
+{
+  TkmvChartModel *model = (TkmvChartModel *)_model;
+
+  g_mutex_clear (&model->lock);
+  kplot_free (model->plot);
+  if (model->raster != NULL)
+    cairo_surface_destroy (model->raster);
+}
+
+static void
+chart_model_unref (TkmvChartModel *model)
+{
+  if (model != NULL)
+    g_atomic_rc_box_release_full (model, chart_model_clear);
+}
+
+static void
+chart_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
+                     int height, gpointer data)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  TkmvChart *chart = (TkmvChart *)data;
+  int scale = gtk_widget_get_scale_factor (GTK_WIDGET (area));
+
+  g_assert (chart);
+
+  /* Paint whatever we have, a stale raster is better than a blank area */
+  if (chart->surface != NULL)
+    chart_paint_surface (chart, cr, height);
+
+  if (chart->hover_set && chart->surface_model != NULL)
+    chart_paint_hover (chart, cr, width, height);
+
+  if (chart->surface == NULL || chart->surface_serial != chart->serial
+      || chart->surface_update != chart->update
+      || chart->surface_generation != tkm_context_get_data_generation (context)
+      || chart->surface_width != width || chart->surface_height != height
+      || chart->surface_scale != scale
+      || chart->surface_view_set != chart->view_set
+      || (chart->view_set
+          && (chart->surface_view_min != chart->view_min
+              || chart->surface_view_max != chart->view_max)))
+    {
+      chart_schedule_render (chart, width, height, scale);
+    }
+}
+
+static void
+chart_schedule_render (TkmvChart *chart, int width, int height, int scale)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  ChartRenderJob *job = NULL;
+
+  /* The completion will queue a new draw which checks the key again */
+  if (chart->render_pending)
+    return;
+
+  if (width <= 0 || height <= 0)
+    return;
+
+  job = g_new0 (ChartRenderJob, 1);
+  job->chart = tkmv_chart_ref (chart);
+  job->serial = chart->serial;
+  job->update = chart->update;
+  job->width = width;
+  job->height = height;
+  job->scale = scale;
+  job->view_set = chart->view_set;
+  job->view_min = chart->view_min;
+  job->view_max = chart->view_max;
+
+  if (chart->snapshot_func != NULL)
+    job->data = chart->snapshot_func (chart->user_data);
+  else
+    job->data = chart->user_data;
+
+  tkm_task_init (TKM_TASK (job), chart_render_status, chart_render_exec);
+
+  chart->render_pending = TRUE;
+  if (!tkm_task_run (TKM_TASK (job), context->taskpool))
+    {
+      g_warning ("Fail to queue chart render");
+      chart->render_pending = FALSE;
+
+      if (chart->snapshot_func != NULL && chart->snapshot_free != NULL)
+        chart->snapshot_free (job->data);
+
+      tkmv_chart_unref (job->chart);
+      tkm_task_clear (TKM_TASK (job));
+      g_free (job);
+    }
+}
+
+static gboolean
+chart_render_exec (TkmTask *task, gpointer _context)
+{
+  ChartRenderJob *job = (ChartRenderJob *)task;
+  TkmContext *context = (TkmContext *)_context;
+  TkmvChart *chart = NULL;
+  struct kplot *plot = NULL;
+  struct kplotcfg *plotcfg = NULL;
+  struct kpair offs, dims, minv, maxv;
+  cairo_t *cr = NULL;
+  guint tiles = 0;
+
+  g_assert (job);
+  g_assert (context);
+
+  chart = job->chart;
+
+  /*
+   * Only one render per chart is in flight so the worker owns the plot
+   * model here. Rebuild it only if the dataset or the chart inputs changed,
+   * a resize or an expose just draws the retained model again. When the
+   * data was only extended at its end, a chart that can append extends its
+   * model instead.
+   */
+  tkm_context_data_lock (context);
+  job->generation = tkm_context_get_data_generation (context);
+  job->epoch = tkm_context_get_data_epoch (context);
+  if (chart->model == NULL || chart->plot_serial != job->serial
+      || chart->plot_epoch != job->epoch)
+    {
+      chart_model_build (chart, job);
+    }
+  else if (chart->plot_generation != job->generation
+           || chart->plot_update != job->update)
+    {
+      gboolean appended = FALSE;
+
+      if (chart->append_func != NULL && chart->model->raster == NULL)
+        {
+          g_mutex_lock (&chart->model->lock);
+          appended = chart->append_func (job->data, chart->model->plot);
+          g_mutex_unlock (&chart->model->lock);
+        }
+
+      if (!appended)
+        chart_model_build (chart, job);
+    }
+  chart->plot_serial = job->serial;
+  chart->plot_update = job->update;
+  chart->plot_generation = job->generation;
+  chart->plot_epoch = job->epoch;
+  tkm_context_data_unlock (context);
+
+  if (chart->model == NULL)
+    return FALSE;
+
+  plot = chart->model->plot;
+
+  /*
+   * A viewport only pins the x range of the retained model, y is fitted
+   * to the visible data from the range index when not fixed by the chart.
+   */
+  plotcfg = kplot_get_plotcfg (plot);
+  plotcfg->extrema = chart->plot_extrema;
+  if (chart->model->raster != NULL
+      && !(plotcfg->extrema & (EXTREMA_XMIN | EXTREMA_XMAX)))
+    {
+      plotcfg->extrema |= EXTREMA_XMIN | EXTREMA_XMAX;
+      plotcfg->extrema_xmin = chart->model->raster_min;
+      plotcfg->extrema_xmax = chart->model->raster_max;
+    }
+  if (job->view_set)
+    {
+      plotcfg->extrema |= EXTREMA_XMIN | EXTREMA_XMAX | EXTREMA_YVIEW;
+      plotcfg->extrema_xmin = job->view_min;
+      plotcfg->extrema_xmax = job->view_max;
+    }
+
+  job->surface = cairo_image_surface_create (
+    CAIRO_FORMAT_ARGB32, job->width * job->scale, job->height * job->scale);
+  if (cairo_surface_status (job->surface) != CAIRO_STATUS_SUCCESS)
+    return FALSE;
+
+  /*
+   * A single dense chart on a large surface is still one cairo job, split
+   * its data into vertical strips drawn in parallel when it is wide enough
+   * and has enough pairs in view to outweigh compositing the strips.
+   */
+  tiles = MIN (g_get_num_processors (),
+               (guint)(job->width * job->scale / CHART_TILE_MIN_WIDTH));
+  if (tiles > 1)
+    tiles = MIN (tiles, (guint)(chart_plot_pairs (plot, job->view_set,
+                                                  job->view_min,
+                                                  job->view_max)
+                                / CHART_TILE_MIN_PAIRS));
+
+  cairo_surface_set_device_scale (job->surface, job->scale, job->scale);
+  cr = cairo_create (job->surface);
+  if (tiles > 1)
+    kplot_draw_tiles (plot, job->width, job->height, cr, tiles,
+                      chart_tiles_run, NULL);
+  else
+    kplot_draw (plot, job->width, job->height, cr);
+  if (chart->model->raster != NULL)
+    chart_paint_raster (chart->model, cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (job->surface);
+
+  if (kplot_get_area (plot, &offs, &dims, &minv, &maxv))
+    {
+      job->area_valid = TRUE;
+      job->area_x = offs.x;
+      job->area_width = dims.x;
+      job->area_min = minv.x;
+      job->area_max = maxv.x;
+    }
+
+  /* The raster keeps the model it shows alive for hover lookups */
+  job->model = g_atomic_rc_box_acquire (chart->model);
+
+  return TRUE;
+}
+
+static void
+chart_render_status (TaskStatusType status, TkmTask *task)
+{
+  ChartRenderJob *job = (ChartRenderJob *)task;
+
+  g_assert (job);
+
+  job->status = status;
+  g_main_context_invoke (NULL, chart_render_complete_invoke, job);
+}
+
+static gboolean
+chart_render_complete_invoke (gpointer _job)
+{
+  ChartRenderJob *job = (ChartRenderJob *)_job;
+  TkmvChart *chart = NULL;
+
+  g_assert (job);
+
+  /* The worker still signals the task after the status callback returns */
+  tkm_task_wait (TKM_TASK (job));
+
+  chart = job->chart;
+  chart->render_pending = FALSE;
+
+  if (job->status == TASK_STATUS_COMPLETE)
+    {
+      if (chart->surface != NULL)
+        cairo_surface_destroy (chart->surface);
+
+      chart->surface = job->surface;
+      chart_model_unref (chart->surface_model);
+      chart->surface_model = job->model;
+      chart->surface_serial = job->serial;
+      chart->surface_update = job->update;
+      chart->surface_generation = job->generation;
+      chart->surface_width = job->width;
+      chart->surface_height = job->height;
+      chart->surface_scale = job->scale;
+      chart->surface_view_set = job->view_set;
+      chart->surface_view_min = job->view_min;
+      chart->surface_view_max = job->view_max;
+      chart->surface_area_valid = job->area_valid;
+      chart->surface_area_x = job->area_x;
+      chart->surface_area_width = job->area_width;
+      chart->surface_area_min = job->area_min;
+      chart->surface_area_max = job->area_max;
+      job->surface = NULL;
+      job->model = NULL;
+
+      if (chart->area != NULL)
+        gtk_widget_queue_draw (GTK_WIDGET (chart->area));
+    }
+
+  if (job->surface != NULL)
+    cairo_surface_destroy (job->surface);
+  chart_model_unref (job->model);
+
+  if (chart->snapshot_func != NULL && chart->snapshot_free != NULL)
+    chart->snapshot_free (job->data);
+
+  tkm_task_clear (TKM_TASK (job));
+
+  tkmv_chart_unref (chart);
+  g_free (job);
+
+  return FALSE;
+}
+
+/* Pairs drawn by the plot, series are sorted by x */
+static size_t
+chart_plot_pairs (const struct kplot *plot, gboolean view_set,
+                  double view_min, double view_max)
+{
+  size_t pairs = 0;
+
+  for (size_t i = 0; i < plot->datasz; i++)
+    {
+      for (size_t j = 0; j < plot->datas[i].datasz; j++)
+        {
+          const struct kdata *d = plot->datas[i].datas[j];
+
+          if (view_set)
+            pairs += kdata_xindex (d, view_max) - kdata_xindex (d, view_min);
+          else
+            pairs += d->pairsz;
+        }
+    }
+
+  return pairs;
+}
+
+/*
+ * Render jobs already own a task pool thread and may all be waiting on
+ * their strips, so strips go to a pool of their own kept for the process
+ * lifetime rather than to the task pool.
+ */
+static GThreadPool *
+chart_tile_pool (void)
+{
+  static GThreadPool *pool = NULL;
+
+  if (g_once_init_enter (&pool))
+    {
+      GThreadPool *tile_pool = g_thread_pool_new (
+        chart_tile_worker, NULL, MAX (1, g_get_num_processors () - 1), TRUE,
+        NULL);
+
+      if (tile_pool == NULL)
+        g_warning ("Fail to create the chart tile pool");
+      g_once_init_leave (&pool, tile_pool);
+    }
+
+  return pool;
+}
+
+static void
+chart_tile_worker (gpointer _tiles, gpointer data)
+{
+  ChartTiles *tiles = (ChartTiles *)_tiles;
+
+  g_assert (tiles);
+  TKMV_UNUSED (data);
+
+  chart_tiles_claim (tiles);
+  g_atomic_rc_box_release_full (tiles, chart_tiles_clear);
+}
+
+static void
+chart_tiles_claim (ChartTiles *tiles)
+{
+  gint index = 0;
+
+  while ((index = g_atomic_int_add (&tiles->next, 1)) < tiles->count)
+    {
+      tiles->func (tiles->args[index]);
+
+      g_mutex_lock (&tiles->lock);
+      if (++tiles->done == tiles->count)
+        g_cond_signal (&tiles->cond);
+      g_mutex_unlock (&tiles->lock);
+    }
+}
+
+static void
+chart_tiles_clear (gpointer _tiles)
+{
+  ChartTiles *tiles = (ChartTiles *)_tiles;
+
+  g_mutex_clear (&tiles->lock);
+  g_cond_clear (&tiles->cond);
+}
+
+static void
+chart_tiles_run (void (*func) (void *), void **args, size_t count,
+                 void *data)
+{
+  ChartTiles *tiles = g_atomic_rc_box_new0 (ChartTiles);
+  GThreadPool *pool = chart_tile_pool ();
+
+  TKMV_UNUSED (data);
+
+  tiles->func = func;
+  tiles->args = args;
+  tiles->count = (gint)count;
+  g_mutex_init (&tiles->lock);
+  g_cond_init (&tiles->cond);
+
+  /*
+   * The render thread draws strips as well, so the strips are done even
+   * when the tile pool is busy with another chart. It only waits for the
+   * strips a worker already started.
+   */
+  for (size_t i = 1; i < count && pool != NULL; i++)
+    {
+      if (!g_thread_pool_push (pool, g_atomic_rc_box_acquire (tiles), NULL))
+        g_atomic_rc_box_release_full (tiles, chart_tiles_clear);
+    }
+
+  chart_tiles_claim (tiles);
+
+  g_mutex_lock (&tiles->lock);
+  while (tiles->done < tiles->count)
+    g_cond_wait (&tiles->cond, &tiles->lock);
+  g_mutex_unlock (&tiles->lock);
+
+  g_atomic_rc_box_release_full (tiles, chart_tiles_clear);
+}
+
+static void
+chart_paint_raster (TkmvChartModel *model, cairo_t *cr)
+{
+  cairo_surface_t *raster = NULL;
+  cairo_pattern_t *pattern = NULL;
+  struct kpair offs, dims, minv, maxv;
+  double start = 0;
+  double end = 0;
+
+  g_assert (model);
+
+  raster = model->raster;
+  if (!kplot_get_area (model->plot, &offs, &dims, &minv, &maxv)
+      || maxv.x <= minv.x || model->raster_max <= model->raster_min)
+    return;
+
+  start = offs.x + (model->raster_min - minv.x) / (maxv.x - minv.x) * dims.x;
+  end = offs.x + (model->raster_max - minv.x) / (maxv.x - minv.x) * dims.x;
+
+  /* Cells are scaled as blocks, smoothing would blur neighbouring rows */
+  cairo_save (cr);
+  cairo_rectangle (cr, offs.x, offs.y, dims.x, dims.y);
+  cairo_clip (cr);
+  cairo_translate (cr, start, offs.y);
+  cairo_scale (cr, (end - start) / cairo_image_surface_get_width (raster),
+               dims.y / cairo_image_surface_get_height (raster));
+  cairo_set_source_surface (cr, raster, 0, 0);
+  pattern = cairo_get_source (cr);
+  cairo_pattern_set_filter (pattern, CAIRO_FILTER_NEAREST);
+  cairo_paint (cr);
+  cairo_restore (cr);
+}
+
+static void
+chart_paint_surface (TkmvChart *chart, cairo_t *cr, int height)
+{
+  double view_min = 0;
+  double view_max = 0;
+  double scale_x = 0;
+  double offset_x = 0;
+
+  g_assert (chart);
+
+  if (!chart->surface_area_valid || chart->surface_area_width <= 0
+      || chart->surface_area_max <= chart->surface_area_min
+      || !tkmv_chart_get_viewport (chart, &view_min, &view_max))
+    {
+      cairo_set_source_surface (cr, chart->surface, 0, 0);
+      cairo_paint (cr);
+      return;
+    }
+
+  /*
+   * Until the render for the current viewport lands, stretch the data area
+   * of the last raster to the new range so zoom and pan follow the pointer.
+   * Axes and labels outside the data area are painted as they are.
+   */
+  scale_x = (chart->surface_area_max - chart->surface_area_min)
+            / (view_max - view_min);
+  offset_x = chart->surface_area_x
+             + (chart->surface_area_min - view_min) / (view_max - view_min)
+                 * chart->surface_area_width;
+
+  cairo_save (cr);
+  cairo_rectangle (cr, 0, 0, chart->surface_area_x, height);
+  cairo_rectangle (cr, chart->surface_area_x + chart->surface_area_width, 0,
+                   chart->surface_width, height);
+  cairo_clip (cr);
+  cairo_set_source_surface (cr, chart->surface, 0, 0);
+  cairo_paint (cr);
+  cairo_restore (cr);
+
+  cairo_save (cr);
+  cairo_rectangle (cr, chart->surface_area_x, 0, chart->surface_area_width,
+                   height);
+  cairo_clip (cr);
+  cairo_translate (cr, offset_x, 0);
+  cairo_scale (cr, scale_x, 1);
+  cairo_set_source_surface (cr, chart->surface, -chart->surface_area_x, 0);
+  cairo_paint (cr);
+  cairo_restore (cr);
+}
+
+static gboolean
+chart_series_color (const struct kplot *plot, size_t index,
+                    const struct kdatacfg *cfg, double *rgba)
+{
+  const struct kplotccfg *clr = &cfg->line.clr;
+
+  if (clr->type == KPLOTCTYPE_DEFAULT && plot->cfg.clrsz > 0)
+    clr = &plot->cfg.clrs[index % plot->cfg.clrsz];
+  else if (clr->type == KPLOTCTYPE_PALETTE && plot->cfg.clrsz > 0)
+    clr = &plot->cfg.clrs[clr->palette % plot->cfg.clrsz];
+
+  if (clr->type != KPLOTCTYPE_RGBA)
+    return FALSE;
+
+  for (guint i = 0; i < 4; i++)
+    rgba[i] = clr->rgba[i];
+
+  return TRUE;
+}
+
+static void
+chart_paint_hover (TkmvChart *chart, cairo_t *cr, int width, int height)
+{
+  const struct kplot *plot = NULL;
+  g_autoptr (GString) rows = g_string_new (NULL);
+  g_autofree gchar *header = NULL;
+  g_autofree gchar *markup = NULL;
+  PangoLayout *layout = NULL;
+  char label[128];
+  double view_min = 0;
+  double view_max = 0;
+  double sample_x = 0;
+  double rgba[4];
+  double x = 0;
+  double box_x = 0;
+  gboolean have_sample = FALSE;
+  guint row_count = 0;
+  guint hidden = 0;
+  int text_width = 0;
+  int text_height = 0;
+
+  g_assert (chart);
+
+  if (!chart->surface_area_valid || chart->surface_area_width <= 0
+      || !tkmv_chart_get_viewport (chart, &view_min, &view_max)
+      || chart->hover_x < view_min || chart->hover_x > view_max)
+    return;
+
+  x = chart->surface_area_x
+      + (chart->hover_x - view_min) / (view_max - view_min)
+          * chart->surface_area_width;
+
+  cairo_save (cr);
+  cairo_set_source_rgba (cr, 0.5, 0.5, 0.5, 0.8);
+  cairo_set_line_width (cr, 1.0);
+  cairo_move_to (cr, floor (x) + 0.5, 0);
+  cairo_line_to (cr, floor (x) + 0.5, height);
+  cairo_stroke (cr);
+  cairo_restore (cr);
+
+  /*
+   * The model the raster was drawn from stays alive until the raster is
+   * replaced, the worker only touches its caches or appends under the
+   * model lock so the samples can be read here. Every series is sorted by
+   * time, the nearest sample is a binary search away whatever the size of
+   * the loaded data.
+   */
+  plot = chart->surface_model->plot;
+  g_mutex_lock (&chart->surface_model->lock);
+  for (size_t i = 0; i < plot->datasz; i++)
+    {
+      for (size_t j = 0; j < plot->datas[i].datasz; j++)
+        {
+          const struct kdata *d = plot->datas[i].datas[j];
+          g_autofree gchar *value = NULL;
+          struct kpair kp, prev;
+          size_t pos = 0;
+
+          if (d->pairsz == 0)
+            continue;
+
+          pos = kdata_xindex (d, chart->hover_x);
+          if (pos == d->pairsz)
+            pos--;
+
+          kdata_get (d, pos, &kp);
+          if (pos > 0 && kdata_get (d, pos - 1, &prev)
+              && chart->hover_x - prev.x < kp.x - chart->hover_x)
+            kp = prev;
+
+          if (!isfinite (kp.y))
+            continue;
+
+          if (row_count == CHART_HOVER_MAX_ROWS)
+            {
+              hidden++;
+              continue;
+            }
+
+          if (!have_sample)
+            {
+              sample_x = kp.x;
+              have_sample = TRUE;
+            }
+
+          if (plot->cfg.yticlabelfmt != NULL)
+            plot->cfg.yticlabelfmt (kp.y, label, sizeof (label));
+          else
+            g_snprintf (label, sizeof (label), "%g", kp.y);
+
+          if (!chart_series_color (plot, i, &plot->datas[i].cfgs[j], rgba))
+            rgba[0] = rgba[1] = rgba[2] = 0.5;
+
+          value = g_markup_escape_text (label, -1);
+          g_string_append_printf (
+            rows, "\n<span foreground=\"#%02x%02x%02x\">\u25CF</span> %s",
+            (guint)(CLAMP (rgba[0], 0.0, 1.0) * 255),
+            (guint)(CLAMP (rgba[1], 0.0, 1.0) * 255),
+            (guint)(CLAMP (rgba[2], 0.0, 1.0) * 255), value);
+          row_count++;
+        }
+    }
+  g_mutex_unlock (&chart->surface_model->lock);
+
+  if (!have_sample)
+    return;
+
+  if (hidden > 0)
+    g_string_append_printf (rows, "\n+%u more", hidden);
+
+  if (plot->cfg.xticlabelfmt != NULL)
+    plot->cfg.xticlabelfmt (sample_x, label, sizeof (label));
+  else
+    g_snprintf (label, sizeof (label), "%g", sample_x);
+
+  header = g_markup_printf_escaped ("<b>%s</b>", label);
+  markup = g_strconcat (header, rows->str, NULL);
+
+  layout = gtk_widget_create_pango_layout (GTK_WIDGET (chart->area), NULL);
+  pango_layout_set_markup (layout, markup, -1);
+  pango_layout_get_pixel_size (layout, &text_width, &text_height);
+
+  /* Keep the tooltip next to the crosshair, on the side with room for it */
+  box_x = x + 8;
+  if (box_x + text_width + 12 > width)
+    box_x = MAX (x - 8 - text_width - 12, 0);
+
+  cairo_save (cr);
+  cairo_set_source_rgba (cr, 0.1, 0.1, 0.1, 0.8);
+  cairo_rectangle (cr, box_x, 8, text_width + 12, text_height + 8);
+  cairo_fill (cr);
+  cairo_set_source_rgba (cr, 1.0, 1.0, 1.0, 1.0);
+  cairo_move_to (cr, box_x + 6, 12);
+  pango_cairo_show_layout (cr, layout);
+  cairo_restore (cr);
+
+  g_object_unref (layout);
+}
+
+static void
+chart_viewport_changed (TkmvChart *chart, double min, double max)
+{
+  g_assert (chart);
+
+  if (max - min < CHART_MIN_SPAN)
+    return;
+
+  tkmv_chart_set_viewport (chart, min, max);
+
+  if (chart->viewport_func != NULL)
+    chart->viewport_func (chart, FALSE, min, max, chart->viewport_data);
+}
+
+static void
+chart_pointer_motion (GtkEventControllerMotion *controller, double x,
+                      double y, gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+  double min = 0;
+  double max = 0;
+  double hover = 0;
+
+  TKMV_UNUSED (controller);
+  TKMV_UNUSED (y);
+
+  chart->pointer_x = x;
+
+  if (!chart->surface_area_valid || chart->surface_area_width <= 0
+      || x < chart->surface_area_x
+      || x > chart->surface_area_x + chart->surface_area_width
+      || !tkmv_chart_get_viewport (chart, &min, &max))
+    {
+      chart_pointer_leave (controller, data);
+      return;
+    }
+
+  hover = min + (x - chart->surface_area_x) / chart->surface_area_width
+                  * (max - min);
+
+  tkmv_chart_set_hover (chart, hover);
+
+  if (chart->hover_func != NULL)
+    chart->hover_func (chart, TRUE, hover, chart->hover_data);
+}
+
+static void
+chart_pointer_leave (GtkEventControllerMotion *controller, gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+
+  TKMV_UNUSED (controller);
+
+  if (!chart->hover_set)
+    return;
+
+  tkmv_chart_clear_hover (chart);
+
+  if (chart->hover_func != NULL)
+    chart->hover_func (chart, FALSE, 0, chart->hover_data);
+}
+
+static gboolean
+chart_scroll (GtkEventControllerScroll *controller, double dx, double dy,
+              gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+  double min = 0;
+  double max = 0;
+  double anchor = 0;
+  double factor = 0;
+  double pos = 0;
+
+  TKMV_UNUSED (controller);
+  TKMV_UNUSED (dx);
+
+  if (!chart->surface_area_valid || chart->surface_area_width <= 0
+      || !tkmv_chart_get_viewport (chart, &min, &max))
+    return FALSE;
+
+  /* Keep the value under the pointer where it is */
+  pos = CLAMP ((chart->pointer_x - chart->surface_area_x)
+                 / chart->surface_area_width,
+               0.0, 1.0);
+  anchor = min + pos * (max - min);
+  factor = pow (CHART_ZOOM_STEP, dy);
+
+  chart_viewport_changed (chart, anchor - (anchor - min) * factor,
+                          anchor + (max - anchor) * factor);
+
+  return TRUE;
+}
+
+static void
+chart_drag_begin (GtkGestureDrag *gesture, double x, double y, gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+
+  TKMV_UNUSED (gesture);
+  TKMV_UNUSED (x);
+  TKMV_UNUSED (y);
+
+  if (!tkmv_chart_get_viewport (chart, &chart->drag_min, &chart->drag_max))
+    chart->drag_min = chart->drag_max = 0;
+}
+
+static void
+chart_drag_update (GtkGestureDrag *gesture, double offset_x, double offset_y,
+                   gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+  double shift = 0;
+
+  TKMV_UNUSED (gesture);
+  TKMV_UNUSED (offset_y);
+
+  if (chart->drag_max <= chart->drag_min || chart->surface_area_width <= 0
+      || offset_x == 0)
+    return;
+
+  shift = offset_x / chart->surface_area_width
+          * (chart->drag_max - chart->drag_min);
+
+  chart_viewport_changed (chart, chart->drag_min - shift,
+                          chart->drag_max - shift);
+}
+
+static void
+chart_pressed (GtkGestureClick *gesture, int n_press, double x, double y,
+               gpointer data)
+{
+  TkmvChart *chart = (TkmvChart *)data;
+
+  TKMV_UNUSED (gesture);
+  TKMV_UNUSED (x);
+  TKMV_UNUSED (y);
+
+  if (n_press != 2 || !chart->view_set)
+    return;
+
+  tkmv_chart_reset_viewport (chart);
+
+  if (chart->viewport_func != NULL)
+    chart->viewport_func (chart, TRUE, 0, 0, chart->viewport_data);
+}
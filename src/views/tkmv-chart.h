@@ -0,0 +1,175 @@
+/* tkmv-chart.h
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+#include "libkplot/kplot.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Build callback executed on a task pool thread with the context data lock
+ * held. It returns the plot model with its data attached, the chart keeps
+ * it until the inputs change. It must not touch any GTK object, everything
+ * it needs from the UI has to be captured by the snapshot callback.
+ */
+typedef struct kplot *(*TkmvChartBuildFunc) (gpointer data);
+
+/*
+ * Snapshot callback executed on the main thread before a render is queued.
+ * The returned pointer is passed to the build callback and released with
+ * the snapshot free function once the render is done.
+ */
+typedef gpointer (*TkmvChartSnapshotFunc) (gpointer user_data);
+
+/*
+ * Raster callback for charts drawing their data as an image rather than
+ * as plot series. It runs right after the build callback with the same
+ * lock held and returns an image spanning [min, max] of the x axis and
+ * the whole y axis, or NULL. The chart paints it into the data area of
+ * the plot, and without a fixed x range the plot spans the image.
+ */
+typedef cairo_surface_t *(*TkmvChartRasterFunc) (gpointer data, double *min,
+                                                 double *max);
+
+/*
+ * Append callback executed instead of the build callback, on the same
+ * thread and with the same lock held, when the loaded data was only
+ * extended at its end since the plot was built or the chart was updated.
+ * It extends the retained plot in place and returns FALSE if it can not,
+ * the plot is then built again from scratch.
+ */
+typedef gboolean (*TkmvChartAppendFunc) (gpointer data, struct kplot *plot);
+
+typedef struct _TkmvChart TkmvChart;
+typedef struct _TkmvChartModel TkmvChartModel;
+
+/*
+ * Viewport callback executed on the main thread when the user zooms or
+ * pans the chart, or resets it to the whole data range. The range is in
+ * data units of the x axis, it is not meaningful on reset.
+ */
+typedef void (*TkmvChartViewportFunc) (TkmvChart *chart, gboolean reset,
+                                       double min, double max,
+                                       gpointer user_data);
+
+/*
+ * Hover callback executed on the main thread when the pointer moves over
+ * the data area of the chart or leaves it. The position is in data units
+ * of the x axis, it is not meaningful when the chart is left.
+ */
+typedef void (*TkmvChartHoverFunc) (TkmvChart *chart, gboolean active,
+                                    double x, gpointer user_data);
+
+struct _TkmvChart {
+  GtkDrawingArea *area;
+  TkmvChartBuildFunc build_func;
+  TkmvChartSnapshotFunc snapshot_func;
+  GDestroyNotify snapshot_free;
+  TkmvChartRasterFunc raster_func;
+  TkmvChartAppendFunc append_func;
+  gpointer user_data;
+
+  /* Retained plot model and the inputs it was built from */
+  TkmvChartModel *model;
+  guint plot_serial;
+  guint plot_update;
+  guint plot_generation;
+  guint plot_epoch;
+  unsigned int plot_extrema;
+
+  /* Visible x range, the whole data range while not set */
+  gboolean view_set;
+  double view_min;
+  double view_max;
+  TkmvChartViewportFunc viewport_func;
+  gpointer viewport_data;
+
+  /* Pointer and drag state of the zoom and pan gestures */
+  double pointer_x;
+  double drag_min;
+  double drag_max;
+
+  /* Crosshair position shared by the charts of a page */
+  gboolean hover_set;
+  double hover_x;
+  TkmvChartHoverFunc hover_func;
+  gpointer hover_data;
+
+  /* Last rendered raster, the model drawn and the key it was rendered for */
+  cairo_surface_t *surface;
+  TkmvChartModel *surface_model;
+  guint surface_serial;
+  guint surface_update;
+  guint surface_generation;
+  int surface_width;
+  int surface_height;
+  int surface_scale;
+  gboolean surface_view_set;
+  double surface_view_min;
+  double surface_view_max;
+
+  /* Data area of the last raster and the x range it spans */
+  gboolean surface_area_valid;
+  double surface_area_x;
+  double surface_area_width;
+  double surface_area_min;
+  double surface_area_max;
+
+  /* Bumped by invalidate when the chart inputs change, by update when
+   * they only moved on */
+  guint serial;
+  guint update;
+  gboolean render_pending;
+
+  grefcount rc;
+};
+
+TkmvChart *tkmv_chart_new (GtkDrawingArea *area,
+                           TkmvChartBuildFunc build_func,
+                           TkmvChartSnapshotFunc snapshot_func,
+                           GDestroyNotify snapshot_free, gpointer user_data);
+TkmvChart *tkmv_chart_ref (TkmvChart *chart);
+void tkmv_chart_unref (TkmvChart *chart);
+
+void tkmv_chart_invalidate (TkmvChart *chart);
+void tkmv_chart_update (TkmvChart *chart);
+
+void tkmv_chart_set_raster_func (TkmvChart *chart,
+                                 TkmvChartRasterFunc raster_func);
+void tkmv_chart_set_append_func (TkmvChart *chart,
+                                 TkmvChartAppendFunc append_func);
+
+void tkmv_chart_set_viewport_func (TkmvChart *chart,
+                                   TkmvChartViewportFunc viewport_func,
+                                   gpointer user_data);
+void tkmv_chart_set_viewport (TkmvChart *chart, double min, double max);
+void tkmv_chart_reset_viewport (TkmvChart *chart);
+gboolean tkmv_chart_get_viewport (TkmvChart *chart, double *min, double *max);
+
+void tkmv_chart_set_hover_func (TkmvChart *chart,
+                                TkmvChartHoverFunc hover_func,
+                                gpointer user_data);
+void tkmv_chart_set_hover (TkmvChart *chart, double x);
+void tkmv_chart_clear_hover (TkmvChart *chart);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (TkmvChart, tkmv_chart_unref);
+
+G_END_DECLS
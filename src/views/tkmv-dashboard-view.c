@@ -23,6 +23,7 @@
 #include "tkm-procevent-entry.h"
 #include "tkm-settings.h"
 #include "tkmv-application.h"
+#include "tkmv-chart.h"
 #include "tkmv-types.h"
 
 #include "libkplot/kplot.h"
@@ -30,36 +31,62 @@
 #include <math.h>
 
 #define KPOINTS_OPTIMIZATION_START_LIMIT (1024)
+#define VIEWPORT_FETCH_DELAY_MS (200)
+
+/* Cores drawn as lines with a legend, more are drawn as a heatmap */
+#define CORES_LINES_MAX (16)
+#define CORES_HEATMAP_BUCKETS (2048)
+
+/* Series of a history chart kept in rings and the smallest ring we keep */
+#define HISTORY_SERIES_MAX (6)
+#define HISTORY_RING_MIN (1024)
+
+static const double cores_colors[CORES_LINES_MAX][3] = {
+  { 1.0, 0.0, 0.0 },       { 0.0, 0.0, 1.0 },       { 0.0, 1.0, 0.0 },
+  { 0.4, 0.0, 0.6 },       { 0.9, 0.4, 0.3 },       { 1.0, 0.639, 0.0 },
+  { 0.494, 0.145, 0.325 }, { 0.114, 0.169, 0.325 }, { 0.0, 0.529, 0.318 },
+  { 1.0, 0.8, 0.667 },     { 0.671, 0.322, 0.212 }, { 0.761, 0.765, 0.78 },
+  { 0.514, 0.463, 0.612 }, { 1.0, 0.0, 0.302 },     { 0.373, 0.341, 0.31 },
+  { 0.161, 0.678, 1.0 },
+};
 
 static void tkmv_dashboard_view_widgets_init (TkmvDashboardView *self);
 static void update_current_values_frame (TkmvDashboardView *view);
-static void cores_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                         int width, int height,
-                                         gpointer data);
-static void events_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                          int width, int height,
-                                          gpointer data);
-static void cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                       int width, int height, gpointer data);
-static void mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                       int width, int height, gpointer data);
-static void psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                       int width, int height, gpointer data);
-static void cores_history_draw_function_safe (GtkDrawingArea *area,
-                                              cairo_t *cr, int width,
-                                              int height, gpointer data);
-static void events_history_draw_function_safe (GtkDrawingArea *area,
-                                               cairo_t *cr, int width,
-                                               int height, gpointer data);
-static void cpu_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                            int width, int height,
-                                            gpointer data);
-static void mem_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                            int width, int height,
-                                            gpointer data);
-static void psi_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                            int width, int height,
-                                            gpointer data);
+static struct kplot *cores_history_build_function (gpointer data);
+static cairo_surface_t *cores_heatmap_raster_function (gpointer data,
+                                                       double *min,
+                                                       double *max);
+static struct kplot *events_history_build_function (gpointer data);
+static struct kplot *cpu_history_build_function (gpointer data);
+static struct kplot *mem_history_build_function (gpointer data);
+static struct kplot *psi_history_build_function (gpointer data);
+static gboolean cpu_history_append_function (gpointer data,
+                                             struct kplot *plot);
+static gboolean mem_history_append_function (gpointer data,
+                                             struct kplot *plot);
+static gboolean psi_history_append_function (gpointer data,
+                                             struct kplot *plot);
+static gpointer history_snapshot_function (gpointer user_data);
+static void history_viewport_changed (TkmvChart *chart, gboolean reset,
+                                      double min, double max,
+                                      gpointer user_data);
+static void history_hover_changed (TkmvChart *chart, gboolean active,
+                                   double x, gpointer user_data);
+static gboolean viewport_fetch_timeout (gpointer user_data);
+
+/*
+ * Playback cursor captured for a render of the history charts kept in
+ * rings, they only show the samples in [cursor_min, cursor_max] then.
+ */
+typedef struct _HistorySnapshot {
+  gboolean cursor_set;
+  double cursor_min;
+  double cursor_max;
+} HistorySnapshot;
+
+/* Reads the time and the series values of a row, FALSE if not a sample */
+typedef gboolean (*HistoryRowFunc) (gpointer entry, DataTimeSource source,
+                                    double *x, double *values);
 
 struct _TkmvDashboardView {
   GtkBox parent_instance;
@@ -71,6 +98,23 @@ struct _TkmvDashboardView {
   GtkDrawingArea *history_mem_drawing_area;
   GtkDrawingArea *history_psi_drawing_area;
 
+  /* Offscreen rendered charts */
+  TkmvChart *history_cores_chart;
+  TkmvChart *history_events_chart;
+  TkmvChart *history_cpu_chart;
+  TkmvChart *history_mem_chart;
+  TkmvChart *history_psi_chart;
+
+  /* Shared viewport of the history charts waiting to be fetched */
+  guint viewport_fetch_source;
+  double viewport_min;
+  double viewport_max;
+
+  /* Playback window the history charts scroll through */
+  gboolean cursor_set;
+  double cursor_min;
+  double cursor_max;
+
   /* Current data */
   GtkLevelBar *cpu_all_level_bar;
   GtkLabel *cpu_all_level_label;
@@ -106,11 +150,31 @@ struct _TkmvDashboardView {
 
 G_DEFINE_TYPE (TkmvDashboardView, tkmv_dashboard_view, GTK_TYPE_BOX)
 
+static void
+tkmv_dashboard_view_finalize (GObject *object)
+{
+  TkmvDashboardView *self = (TkmvDashboardView *)object;
+
+  if (self->viewport_fetch_source != 0)
+    g_source_remove (self->viewport_fetch_source);
+
+  tkmv_chart_unref (self->history_cores_chart);
+  tkmv_chart_unref (self->history_events_chart);
+  tkmv_chart_unref (self->history_cpu_chart);
+  tkmv_chart_unref (self->history_mem_chart);
+  tkmv_chart_unref (self->history_psi_chart);
+
+  G_OBJECT_CLASS (tkmv_dashboard_view_parent_class)->finalize (object);
+}
+
 static void
 tkmv_dashboard_view_class_init (TkmvDashboardViewClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  object_class->finalize = tkmv_dashboard_view_finalize;
+
   gtk_widget_class_set_template_from_resource (
     widget_class,
     "/ro/fxdata/taskmonitor/viewer/gtk/tkmv-dashboard-view.ui");
@@ -194,19 +258,165 @@ tkmv_dashboard_view_init (TkmvDashboardView *self)
 static void
 tkmv_dashboard_view_widgets_init (TkmvDashboardView *self)
 {
-  TKMV_UNUSED (self);
-  gtk_drawing_area_set_draw_func (self->history_cores_drawing_area,
-                                  cores_history_draw_function_safe, self,
-                                  NULL);
-  gtk_drawing_area_set_draw_func (self->history_events_drawing_area,
-                                  events_history_draw_function_safe, self,
-                                  NULL);
-  gtk_drawing_area_set_draw_func (self->history_cpu_drawing_area,
-                                  cpu_history_draw_function_safe, self, NULL);
-  gtk_drawing_area_set_draw_func (self->history_mem_drawing_area,
-                                  mem_history_draw_function_safe, self, NULL);
-  gtk_drawing_area_set_draw_func (self->history_psi_drawing_area,
-                                  psi_history_draw_function_safe, self, NULL);
+  /* The series charts and the current values, never the process tables */
+  tkm_context_register_view (
+    tkmv_application_get_context (tkmv_application_instance ()),
+    "dashboard",
+    EPOOL_TABLE_BIT (EPOOL_TABLE_CPUSTAT)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_MEMINFO)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_PRESSURE)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_PROCEVENT));
+
+  self->history_cores_chart
+    = tkmv_chart_new (self->history_cores_drawing_area,
+                      cores_history_build_function, NULL, NULL, self);
+  tkmv_chart_set_raster_func (self->history_cores_chart,
+                              cores_heatmap_raster_function);
+  self->history_events_chart
+    = tkmv_chart_new (self->history_events_drawing_area,
+                      events_history_build_function, NULL, NULL, self);
+  self->history_cpu_chart = tkmv_chart_new (
+    self->history_cpu_drawing_area, cpu_history_build_function,
+    history_snapshot_function, g_free, self);
+  tkmv_chart_set_append_func (self->history_cpu_chart,
+                              cpu_history_append_function);
+  self->history_mem_chart = tkmv_chart_new (
+    self->history_mem_drawing_area, mem_history_build_function,
+    history_snapshot_function, g_free, self);
+  tkmv_chart_set_append_func (self->history_mem_chart,
+                              mem_history_append_function);
+  self->history_psi_chart = tkmv_chart_new (
+    self->history_psi_drawing_area, psi_history_build_function,
+    history_snapshot_function, g_free, self);
+  tkmv_chart_set_append_func (self->history_psi_chart,
+                              psi_history_append_function);
+
+  tkmv_chart_set_viewport_func (self->history_cores_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->history_events_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->history_cpu_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->history_mem_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->history_psi_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_hover_func (self->history_cores_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->history_events_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->history_cpu_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->history_mem_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->history_psi_chart,
+                             history_hover_changed, self);
+}
+
+static void
+history_viewport_changed (TkmvChart *chart, gboolean reset, double min,
+                          double max, gpointer user_data)
+{
+  TkmvDashboardView *self = (TkmvDashboardView *)user_data;
+  TkmvChart *charts[] = {
+    self->history_cores_chart, self->history_events_chart,
+    self->history_cpu_chart,   self->history_mem_chart,
+    self->history_psi_chart,
+  };
+
+  /* All history charts share the time axis */
+  for (guint i = 0; i < G_N_ELEMENTS (charts); i++)
+    {
+      if (charts[i] == chart)
+        continue;
+
+      if (reset)
+        tkmv_chart_reset_viewport (charts[i]);
+      else
+        tkmv_chart_set_viewport (charts[i], min, max);
+    }
+
+  if (self->viewport_fetch_source != 0)
+    {
+      g_source_remove (self->viewport_fetch_source);
+      self->viewport_fetch_source = 0;
+    }
+
+  if (reset)
+    return;
+
+  /* Fetch once the wheel or the drag settles */
+  self->viewport_min = min;
+  self->viewport_max = max;
+  self->viewport_fetch_source = g_timeout_add (VIEWPORT_FETCH_DELAY_MS,
+                                               viewport_fetch_timeout, self);
+}
+
+static void
+history_hover_changed (TkmvChart *chart, gboolean active, double x,
+                       gpointer user_data)
+{
+  TkmvDashboardView *self = (TkmvDashboardView *)user_data;
+  TkmvChart *charts[] = {
+    self->history_cores_chart, self->history_events_chart,
+    self->history_cpu_chart,   self->history_mem_chart,
+    self->history_psi_chart,
+  };
+
+  /* Every chart of the page shows the crosshair at the same time */
+  for (guint i = 0; i < G_N_ELEMENTS (charts); i++)
+    {
+      if (charts[i] == chart)
+        continue;
+
+      if (active)
+        tkmv_chart_set_hover (charts[i], x);
+      else
+        tkmv_chart_clear_hover (charts[i]);
+    }
+}
+
+static gboolean
+viewport_fetch_timeout (gpointer user_data)
+{
+  TkmvDashboardView *self = (TkmvDashboardView *)user_data;
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  GPtrArray *sessions = tkm_context_get_session_entries (context);
+  TkmSessionEntry *active_session = NULL;
+  int width = gtk_widget_get_width (GTK_WIDGET (self->history_cpu_drawing_area));
+  double resolution = 0;
+  guint step = 0;
+
+  self->viewport_fetch_source = 0;
+
+  if (sessions == NULL || width <= 0 || self->viewport_max <= 0)
+    return G_SOURCE_REMOVE;
+
+  for (guint i = 0; i < sessions->len; i++)
+    {
+      if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
+        active_session = g_ptr_array_index (sessions, i);
+    }
+
+  if (active_session == NULL)
+    return G_SOURCE_REMOVE;
+
+  /*
+   * The entrypool only queries what is outside the loaded range. Zoomed
+   * out past a couple of seconds per pixel it samples one row per pixel
+   * column, raw rows would only be decimated away when drawing.
+   */
+  resolution = (self->viewport_max - self->viewport_min) / width;
+  if (resolution >= 2)
+    step = (guint)resolution;
+
+  tkmv_application_load_viewport (
+    tkmv_application_instance (), tkm_session_entry_get_hash (active_session),
+    (guint)MAX (self->viewport_min, 0), (guint)ceil (self->viewport_max) + 1,
+    step);
+
+  return G_SOURCE_REMOVE;
 }
 
 static void
@@ -264,185 +474,325 @@ cores_update_labels (TkmvDashboardView *self, TkmSessionEntry *active_session)
 {
   g_assert (active_session);
   const guint cpu_count = tkm_session_entry_get_device_cpus (active_session);
+  GtkLabel *labels[] = {
+    self->core0_entry_label,  self->core1_entry_label,
+    self->core2_entry_label,  self->core3_entry_label,
+    self->core4_entry_label,  self->core5_entry_label,
+    self->core6_entry_label,  self->core7_entry_label,
+    self->core8_entry_label,  self->core9_entry_label,
+    self->core10_entry_label, self->core11_entry_label,
+    self->core12_entry_label, self->core13_entry_label,
+    self->core14_entry_label, self->core15_entry_label,
+  };
+
+  /* The heatmap names the cores on its own axis, the legend is for lines */
+  for (guint i = 0; i < G_N_ELEMENTS (labels); i++)
+    gtk_widget_set_visible (GTK_WIDGET (labels[i]),
+                            i < cpu_count && cpu_count <= CORES_LINES_MAX);
+}
 
-  if (cpu_count > 0)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core0_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core0_entry_label), FALSE);
-    }
+static TkmSessionEntry *
+cores_active_session (void)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  GPtrArray *sessions = tkm_context_get_session_entries (context);
 
-  if (cpu_count > 1)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core1_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core1_entry_label), FALSE);
-    }
+  if (sessions == NULL)
+    return NULL;
 
-  if (cpu_count > 2)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core2_entry_label), TRUE);
-    }
-  else
+  for (guint i = 0; i < sessions->len; i++)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core2_entry_label), FALSE);
+      if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
+        return g_ptr_array_index (sessions, i);
     }
 
-  if (cpu_count > 3)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core3_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core3_entry_label), FALSE);
-    }
+  return NULL;
+}
 
-  if (cpu_count > 4)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core4_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core4_entry_label), FALSE);
-    }
+static gboolean
+cores_entry_index (TkmCpuStatEntry *entry, guint cpu_count, guint *index)
+{
+  const gchar *name = tkm_cpustat_entry_get_name (entry);
+  guint64 core = 0;
+  gchar *end = NULL;
 
-  if (cpu_count > 5)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core5_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core5_entry_label), FALSE);
-    }
+  /* Per core rows are named cpuN, plain cpu is the aggregate */
+  if (name == NULL || !g_str_has_prefix (name, "cpu")
+      || !g_ascii_isdigit (name[3]))
+    return FALSE;
 
-  if (cpu_count > 6)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core6_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core6_entry_label), FALSE);
-    }
+  core = g_ascii_strtoull (name + 3, &end, 10);
+  if (*end != '\0' || core >= cpu_count)
+    return FALSE;
 
-  if (cpu_count > 7)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core7_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core7_entry_label), FALSE);
-    }
+  *index = (guint)core;
 
-  if (cpu_count > 8)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core8_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core8_entry_label), FALSE);
-    }
+  return TRUE;
+}
 
-  if (cpu_count > 9)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core9_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core9_entry_label), FALSE);
-    }
+static void
+core_format (double val, char *buf, size_t sz)
+{
+  g_assert (buf);
+  snprintf (buf, sz, "cpu%u", (guint)val);
+}
 
-  if (cpu_count > 10)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core10_entry_label), TRUE);
-    }
-  else
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core10_entry_label), FALSE);
-    }
+static struct kplot *
+cores_history_build_function (gpointer data)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  GPtrArray *cpu_data = tkm_context_get_cpustat_entries (context);
+  TkmSessionEntry *active_session = cores_active_session ();
+  g_autofree GArray **series = NULL;
+  guint cpu_count = 0;
+
+  struct kplotcfg plotcfg;
+  struct kplot *p;
+
+  TKMV_UNUSED (data);
 
-  if (cpu_count > 11)
+  if (active_session != NULL)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core11_entry_label), TRUE);
+      cpu_count = tkm_session_entry_get_device_cpus (active_session);
+      g_assert (cpu_count > 0);
     }
-  else
+
+  kplotcfg_defaults (&plotcfg);
+  plotcfg.grid = GRID_ALL;
+  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
+  plotcfg.extrema_ymin = 0;
+  plotcfg.extrema_ymax = 100;
+  plotcfg.xticlabelfmt = timestamp_format;
+  plotcfg.yticlabelfmt = percent_format;
+
+  /*
+   * Past the legend size the cores are drawn by the raster callback as a
+   * heatmap, the plot only carries the axes with one unit per core.
+   */
+  if (cpu_count > CORES_LINES_MAX)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core11_entry_label), FALSE);
+      plotcfg.grid = GRID_X;
+      plotcfg.extrema_ymax = cpu_count;
+      plotcfg.yticlabelfmt = core_format;
+
+      return kplot_alloc (&plotcfg);
     }
 
-  if (cpu_count > 12)
+  p = kplot_alloc (&plotcfg);
+
+  if (cpu_data == NULL || cpu_count == 0)
+    return p;
+
+  /* One pass over the rows groups the samples of all cores */
+  series = g_new0 (GArray *, cpu_count);
+  for (guint i = 0; i < cpu_count; i++)
+    series[i] = g_array_new (FALSE, FALSE, sizeof (struct kpair));
+
+  for (guint i = 0; i < cpu_data->len; i++)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core12_entry_label), TRUE);
+      TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
+      struct kpair kp;
+      guint core = 0;
+
+      if (!cores_entry_index (entry, cpu_count, &core))
+        continue;
+
+      kp.x = tkm_cpustat_entry_get_timestamp (
+        entry, tkmv_settings_get_time_source (settings));
+      kp.y = tkm_cpustat_entry_get_all (entry);
+
+      /* On large sets only keep the samples where the load changes */
+      if (cpu_data->len >= KPOINTS_OPTIMIZATION_START_LIMIT
+          && series[core]->len > 0
+          && g_array_index (series[core], struct kpair,
+                            series[core]->len - 1).y
+               == kp.y)
+        continue;
+
+      g_array_append_val (series[core], kp);
     }
-  else
+
+  for (guint i = 0; i < cpu_count; i++)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core12_entry_label), FALSE);
+      struct kdatacfg cfg;
+      struct kdata *d = NULL;
+      gsize len = series[i]->len;
+      struct kpair *pairs
+        = (struct kpair *)(gpointer)g_array_free (series[i], FALSE);
+
+      if (len == 0)
+        {
+          g_free (pairs);
+          continue;
+        }
+
+      d = kdata_column_alloc_pairs (pairs, len, g_free, pairs);
+      if (d == NULL)
+        {
+          g_free (pairs);
+          continue;
+        }
+
+      kdatacfg_defaults (&cfg);
+      cfg.line.sz = 1.0;
+      cfg.line.clr.type = KPLOTCTYPE_RGBA;
+      cfg.line.clr.rgba[0] = cores_colors[i][0];
+      cfg.line.clr.rgba[1] = cores_colors[i][1];
+      cfg.line.clr.rgba[2] = cores_colors[i][2];
+      cfg.line.clr.rgba[3] = 1.0;
+
+      kplot_attach_data (p, d, KPLOT_LINES, &cfg);
+      kdata_destroy (d);
     }
 
-  if (cpu_count > 13)
+  return p;
+}
+
+static guint32
+cores_heatmap_pixel (double load)
+{
+  double t = CLAMP (load / 100.0, 0.0, 1.0);
+  guint r, g, b;
+
+  /* Dark blue when idle through orange to red at full load */
+  if (t < 0.5)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core13_entry_label), TRUE);
+      r = (guint)(20 + t * 2 * (240 - 20));
+      g = (guint)(30 + t * 2 * (160 - 30));
+      b = (guint)(90 + t * 2 * (40 - 90));
     }
   else
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core13_entry_label), FALSE);
+      r = (guint)(240 + (t - 0.5) * 2 * (220 - 240));
+      g = (guint)(160 + (t - 0.5) * 2 * (20 - 160));
+      b = (guint)(40 + (t - 0.5) * 2 * (20 - 40));
     }
 
-  if (cpu_count > 14)
-    {
-      gtk_widget_set_visible (GTK_WIDGET (self->core14_entry_label), TRUE);
-    }
-  else
+  return 0xff000000u | (r << 16) | (g << 8) | b;
+}
+
+static cairo_surface_t *
+cores_heatmap_raster_function (gpointer data, double *min, double *max)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  GPtrArray *cpu_data = tkm_context_get_cpustat_entries (context);
+  TkmSessionEntry *active_session = cores_active_session ();
+  g_autofree double *cells = NULL;
+  cairo_surface_t *surface = NULL;
+  unsigned char *pixels = NULL;
+  double start = 0;
+  double end = 0;
+  guint cpu_count = 0;
+  guint buckets = 0;
+  int stride = 0;
+
+  TKMV_UNUSED (data);
+
+  if (active_session == NULL || cpu_data == NULL || cpu_data->len == 0)
+    return NULL;
+
+  cpu_count = tkm_session_entry_get_device_cpus (active_session);
+  if (cpu_count <= CORES_LINES_MAX)
+    return NULL;
+
+  /* Rows are ordered by time, the ends give the span of the image */
+  start = tkm_cpustat_entry_get_timestamp (
+    g_ptr_array_index (cpu_data, 0), tkmv_settings_get_time_source (settings));
+  end = tkm_cpustat_entry_get_timestamp (
+    g_ptr_array_index (cpu_data, cpu_data->len - 1),
+    tkmv_settings_get_time_source (settings));
+  if (end <= start)
+    return NULL;
+
+  /* About one bucket per sample of a core, capped to a screen width */
+  buckets = CLAMP (cpu_data->len / (cpu_count + 1), 1, CORES_HEATMAP_BUCKETS);
+
+  /* Each cell keeps the peak load of its core over its time bucket */
+  cells = g_new (double, (gsize)cpu_count * buckets);
+  for (gsize i = 0; i < (gsize)cpu_count * buckets; i++)
+    cells[i] = -1;
+
+  for (guint i = 0; i < cpu_data->len; i++)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core14_entry_label), FALSE);
+      TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
+      double load = 0;
+      guint bucket = 0;
+      guint core = 0;
+
+      if (!cores_entry_index (entry, cpu_count, &core))
+        continue;
+
+      bucket = (guint)((tkm_cpustat_entry_get_timestamp (
+                          entry, tkmv_settings_get_time_source (settings))
+                        - start)
+                       / (end - start) * buckets);
+      bucket = MIN (bucket, buckets - 1);
+
+      load = tkm_cpustat_entry_get_all (entry);
+      if (load > cells[(gsize)core * buckets + bucket])
+        cells[(gsize)core * buckets + bucket] = load;
     }
 
-  if (cpu_count > 15)
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, buckets,
+                                        cpu_count);
+  if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core15_entry_label), TRUE);
+      cairo_surface_destroy (surface);
+      return NULL;
     }
-  else
+
+  /* Core 0 is the bottom row, buckets without samples stay transparent */
+  cairo_surface_flush (surface);
+  pixels = cairo_image_surface_get_data (surface);
+  stride = cairo_image_surface_get_stride (surface);
+  for (guint core = 0; core < cpu_count; core++)
     {
-      gtk_widget_set_visible (GTK_WIDGET (self->core15_entry_label), FALSE);
+      guint32 *row = (guint32 *)(gpointer)(pixels
+                                           + (gsize)(cpu_count - 1 - core)
+                                               * stride);
+
+      for (guint bucket = 0; bucket < buckets; bucket++)
+        {
+          double load = cells[(gsize)core * buckets + bucket];
+
+          row[bucket] = load < 0 ? 0 : cores_heatmap_pixel (load);
+        }
     }
+  cairo_surface_mark_dirty (surface);
+
+  *min = start;
+  *max = end;
+
+  return surface;
 }
 
-static void
-cores_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
-                             int height, gpointer data)
+static struct kplot *
+events_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
   TkmvSettings *settings
     = tkmv_application_get_settings (tkmv_application_instance ());
   GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *cpu_data = tkm_context_get_cpustat_entries (context);
+  GPtrArray *events_data = tkm_context_get_procevent_entries (context);
   TkmSessionEntry *active_session = NULL;
 
-  struct kdata *d1 = NULL; /* core0 */
-  struct kdata *d2 = NULL; /* core1 */
-  struct kdata *d3 = NULL; /* core2 */
-  struct kdata *d4 = NULL; /* core3 */
-  struct kdata *d5 = NULL; /* core4 */
-  struct kdata *d6 = NULL; /* core5 */
-  struct kdata *d7 = NULL; /* core6 */
-  struct kdata *d8 = NULL; /* core7 */
-  struct kdata *d9 = NULL; /* core8 */
-  struct kdata *d10 = NULL; /* core9 */
-  struct kdata *d11 = NULL; /* core10 */
-  struct kdata *d12 = NULL; /* core11 */
-  struct kdata *d13 = NULL; /* core12 */
-  struct kdata *d14 = NULL; /* core13 */
-  struct kdata *d15 = NULL; /* core14 */
-  struct kdata *d16 = NULL; /* core15 */
+  struct kdata *d1 = NULL; /* Forks */
+  struct kdata *d2 = NULL; /* Execs */
+  struct kdata *d3 = NULL; /* Exits */
+  struct kdata *d4 = NULL; /* UIDs */
+  struct kdata *d5 = NULL; /* GIDs */
 
   struct kplotcfg plotcfg;
   struct kplot *p;
 
-  TKMV_UNUSED (area);
   TKMV_UNUSED (data);
 
   if (sessions != NULL)
@@ -457,687 +807,99 @@ cores_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
 
       g_assert (active_session);
       g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
-
-      cores_update_labels (TKMV_DASHBOARD_VIEW (data), active_session);
     }
 
-  if (cpu_data != NULL)
+  if (events_data != NULL)
     {
-      const guint cpu_count = tkm_session_entry_get_device_cpus (active_session);
-
-      g_autofree guint *core0_entry_index_set = NULL;
-      guint core0_entry_count = 0;
-      g_autofree guint *core1_entry_index_set = NULL;
-      guint core1_entry_count = 0;
-      g_autofree guint *core2_entry_index_set = NULL;
-      guint core2_entry_count = 0;
-      g_autofree guint *core3_entry_index_set = NULL;
-      guint core3_entry_count = 0;
-      g_autofree guint *core4_entry_index_set = NULL;
-      guint core4_entry_count = 0;
-      g_autofree guint *core5_entry_index_set = NULL;
-      guint core5_entry_count = 0;
-      g_autofree guint *core6_entry_index_set = NULL;
-      guint core6_entry_count = 0;
-      g_autofree guint *core7_entry_index_set = NULL;
-      guint core7_entry_count = 0;
-      g_autofree guint *core8_entry_index_set = NULL;
-      guint core8_entry_count = 0;
-      g_autofree guint *core9_entry_index_set = NULL;
-      guint core9_entry_count = 0;
-      g_autofree guint *core10_entry_index_set = NULL;
-      guint core10_entry_count = 0;
-      g_autofree guint *core11_entry_index_set = NULL;
-      guint core11_entry_count = 0;
-      g_autofree guint *core12_entry_index_set = NULL;
-      guint core12_entry_count = 0;
-      g_autofree guint *core13_entry_index_set = NULL;
-      guint core13_entry_count = 0;
-      g_autofree guint *core14_entry_index_set = NULL;
-      guint core14_entry_count = 0;
-      g_autofree guint *core15_entry_index_set = NULL;
-      guint core15_entry_count = 0;
-
-      if (cpu_count > 0)
-        core0_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 1)
-        core1_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 2)
-        core2_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 3)
-        core3_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 4)
-        core4_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 5)
-        core5_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 6)
-        core6_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 7)
-        core7_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 8)
-        core8_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 9)
-        core9_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 10)
-        core10_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 11)
-        core11_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 12)
-        core12_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 13)
-        core13_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 14)
-        core14_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      if (cpu_count > 15)
-        core15_entry_index_set = calloc (cpu_data->len, sizeof(guint));
-
-      if (cpu_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
+      g_autofree guint *entry_index_set = calloc (events_data->len, sizeof(guint));
+      guint entry_count = 0;
+
+      if (events_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
+        {
+          for (guint i = 0; i < events_data->len; i++)
+            entry_index_set[entry_count++] = i;
+        }
+      else
         {
-          for (guint i = 0; i < cpu_data->len; i++)
+          entry_index_set[entry_count++] = 0;
+          for (guint i = 1; i < events_data->len; i++)
             {
-              TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
+              TkmProcEventEntry *prev_entry =
+                g_ptr_array_index (events_data, entry_index_set[entry_count - 1]);
+              TkmProcEventEntry *entry = g_ptr_array_index (events_data, i);
+              gboolean should_add = false;
 
-              if ((cpu_count > 0) && g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu0") == 0)
-                {
-                  core0_entry_index_set[core0_entry_count++] = i;
-                }
-              else if ((cpu_count > 1) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu1") == 0)
-                {
-                  core1_entry_index_set[core1_entry_count++] = i;
-                }
-              else if ((cpu_count > 2) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu2") == 0)
-                {
-                  core2_entry_index_set[core2_entry_count++] = i;
-                }
-              else if ((cpu_count > 3) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu3") == 0)
-                {
-                  core3_entry_index_set[core3_entry_count++] = i;
-                }
-              else if ((cpu_count > 4) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu4") == 0)
-                {
-                  core4_entry_index_set[core4_entry_count++] = i;
-                }
-              else if ((cpu_count > 5) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu5") == 0)
-                {
-                  core5_entry_index_set[core5_entry_count++] = i;
-                }
-              else if ((cpu_count > 6) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu6") == 0)
-                {
-                  core6_entry_index_set[core6_entry_count++] = i;
-                }
-              else if ((cpu_count > 7) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu7") == 0)
+              if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_FORKS)
+                  != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_FORKS))
                 {
-                  core7_entry_index_set[core7_entry_count++] = i;
+                  should_add = true;
                 }
-              else if ((cpu_count > 8) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu8") == 0)
+              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXECS)
+                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_EXECS))
                 {
-                  core8_entry_index_set[core8_entry_count++] = i;
+                  should_add = true;
                 }
-              else if ((cpu_count > 9) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu9") == 0)
+              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXITS)
+                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_EXITS))
                 {
-                  core9_entry_index_set[core9_entry_count++] = i;
+                  should_add = true;
                 }
-              else if ((cpu_count > 10) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu10") == 0)
+              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_UIDS)
+                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_UIDS))
                 {
-                  core10_entry_index_set[core10_entry_count++] = i;
+                  should_add = true;
                 }
-              else if ((cpu_count > 11) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu11") == 0)
+              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_GIDS)
+                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_GIDS))
                 {
-                  core11_entry_index_set[core11_entry_count++] = i;
+                  should_add = true;
                 }
-              else if ((cpu_count > 12) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu12") == 0)
+
+              if (should_add || (i == (events_data->len - 1)))
                 {
-                  core12_entry_index_set[core12_entry_count++] = i;
-                }
-              else if ((cpu_count > 13) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu13") == 0)
-                {
-                  core13_entry_index_set[core13_entry_count++] = i;
-                }
-              else if ((cpu_count > 14) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu14") == 0)
-                {
-                  core14_entry_index_set[core14_entry_count++] = i;
-                }
-              else if ((cpu_count > 15) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu15") == 0)
-                {
-                  core15_entry_index_set[core15_entry_count++] = i;
+                  entry_index_set[entry_count++] = i;
                 }
             }
         }
-      else
-        {
-          for (guint i = 0; i < cpu_data->len; i++)
-            {
-              TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
 
-              if ((cpu_count > 0) && g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu0") == 0)
-                {
-                  if (core0_entry_count == 0)
-                    {
-                      core0_entry_index_set[core0_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core0_entry_index_set[core0_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core0_entry_index_set[core0_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 1) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu1") == 0)
-                {
-                  if (core1_entry_count == 0)
-                    {
-                      core1_entry_index_set[core1_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core1_entry_index_set[core1_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core1_entry_index_set[core1_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 2) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu2") == 0)
-                {
-                  if (core2_entry_count == 0)
-                    {
-                      core2_entry_index_set[core2_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core2_entry_index_set[core2_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core2_entry_index_set[core2_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 3) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu3") == 0)
-                {
-                  if (core3_entry_count == 0)
-                    {
-                      core3_entry_index_set[core3_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core3_entry_index_set[core3_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core3_entry_index_set[core3_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 4) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu4") == 0)
-                {
-                  if (core4_entry_count == 0)
-                    {
-                      core4_entry_index_set[core4_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core4_entry_index_set[core4_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core4_entry_index_set[core4_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 5) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu5") == 0)
-                {
-                  if (core5_entry_count == 0)
-                    {
-                      core5_entry_index_set[core5_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core5_entry_index_set[core5_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core5_entry_index_set[core5_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 6) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu6") == 0)
-                {
-                  if (core6_entry_count == 0)
-                    {
-                      core6_entry_index_set[core6_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core6_entry_index_set[core6_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core6_entry_index_set[core6_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 7) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu7") == 0)
-                {
-                  if (core7_entry_count == 0)
-                    {
-                      core7_entry_index_set[core7_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core7_entry_index_set[core7_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core7_entry_index_set[core7_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 8) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu8") == 0)
-                {
-                  if (core8_entry_count == 0)
-                    {
-                      core8_entry_index_set[core8_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core8_entry_index_set[core8_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core8_entry_index_set[core8_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 9) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu9") == 0)
-                {
-                  if (core9_entry_count == 0)
-                    {
-                      core9_entry_index_set[core9_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data, core9_entry_index_set[core9_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core9_entry_index_set[core9_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 10) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu10") == 0)
-                {
-                  if (core10_entry_count == 0)
-                    {
-                      core10_entry_index_set[core10_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core10_entry_index_set[core10_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core10_entry_index_set[core10_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 11) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu11") == 0)
-                {
-                  if (core11_entry_count == 0)
-                    {
-                      core11_entry_index_set[core11_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core11_entry_index_set[core11_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core11_entry_index_set[core11_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 12) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu12") == 0)
-                {
-                  if (core12_entry_count == 0)
-                    {
-                      core12_entry_index_set[core12_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core12_entry_index_set[core12_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core12_entry_index_set[core12_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 13) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu13") == 0)
-                {
-                  if (core13_entry_count == 0)
-                    {
-                      core13_entry_index_set[core13_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core13_entry_index_set[core13_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core13_entry_index_set[core13_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 14) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu14") == 0)
-                {
-                  if (core14_entry_count == 0)
-                    {
-                      core14_entry_index_set[core14_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core14_entry_index_set[core14_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core14_entry_index_set[core14_entry_count++] = i;
-                        }
-                    }
-                }
-              else if ((cpu_count > 15) &&
-                       g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu15") == 0)
-                {
-                  if (core15_entry_count == 0)
-                    {
-                      core15_entry_index_set[core15_entry_count++] = i;
-                    }
-                  else
-                    {
-                      TkmCpuStatEntry *prev_entry =
-                        g_ptr_array_index (cpu_data,
-                                           core15_entry_index_set[core15_entry_count - 1]);
-
-                      if (tkm_cpustat_entry_get_all (entry)
-                          != tkm_cpustat_entry_get_all (prev_entry))
-                        {
-                          core15_entry_index_set[core15_entry_count++] = i;
-                        }
-                    }
-                }
-            }
-        }
-
-      if (core0_entry_count > 0)
-        {
-          d1 = kdata_array_alloc (NULL, core0_entry_count);
-        }
-      if (core1_entry_count > 0)
-        {
-          d2 = kdata_array_alloc (NULL, core1_entry_count);
-        }
-      if (core2_entry_count > 0)
-        {
-          d3 = kdata_array_alloc (NULL, core2_entry_count);
-        }
-      if (core3_entry_count > 0)
-        {
-          d4 = kdata_array_alloc (NULL, core3_entry_count);
-        }
-      if (core4_entry_count > 0)
-        {
-          d5 = kdata_array_alloc (NULL, core4_entry_count);
-        }
-      if (core5_entry_count > 0)
-        {
-          d6 = kdata_array_alloc (NULL, core5_entry_count);
-        }
-      if (core6_entry_count > 0)
-        {
-          d7 = kdata_array_alloc (NULL, core6_entry_count);
-        }
-      if (core7_entry_count > 0)
-        {
-          d8 = kdata_array_alloc (NULL, core7_entry_count);
-        }
-      if (core8_entry_count > 0)
-        {
-          d9 = kdata_array_alloc (NULL, core8_entry_count);
-        }
-      if (core9_entry_count > 0)
-        {
-          d10 = kdata_array_alloc (NULL, core9_entry_count);
-        }
-      if (core10_entry_count > 0)
-        {
-          d11 = kdata_array_alloc (NULL, core10_entry_count);
-        }
-      if (core11_entry_count > 0)
-        {
-          d12 = kdata_array_alloc (NULL, core11_entry_count);
-        }
-      if (core12_entry_count > 0)
-        {
-          d13 = kdata_array_alloc (NULL, core12_entry_count);
-        }
-      if (core13_entry_count > 0)
-        {
-          d14 = kdata_array_alloc (NULL, core13_entry_count);
-        }
-      if (core14_entry_count > 0)
-        {
-          d15 = kdata_array_alloc (NULL, core14_entry_count);
-        }
-      if (core15_entry_count > 0)
-        {
-          d16 = kdata_array_alloc (NULL, core15_entry_count);
-        }
-
-      for (guint i = 0; i < core0_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core0_entry_index_set[i]);
-
-          d1->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d1->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core1_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core1_entry_index_set[i]);
-
-          d2->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d2->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core2_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core2_entry_index_set[i]);
-
-          d3->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d3->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core3_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core3_entry_index_set[i]);
-
-          d4->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d4->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core4_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core4_entry_index_set[i]);
-
-          d5->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d5->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core5_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core5_entry_index_set[i]);
-
-          d6->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d6->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core6_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core6_entry_index_set[i]);
-
-          d7->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d7->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core7_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core7_entry_index_set[i]);
-
-          d8->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d8->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core8_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core8_entry_index_set[i]);
-
-          d9->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d9->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core9_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core9_entry_index_set[i]);
-
-          d10->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d10->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core10_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core10_entry_index_set[i]);
-
-          d11->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d11->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core11_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core11_entry_index_set[i]);
-
-          d12->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d12->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core12_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core12_entry_index_set[i]);
-
-          d13->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d13->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core13_entry_count; i++)
+      if (entry_count > 0)
         {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core13_entry_index_set[i]);
-
-          d14->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d14->pairs[i].y = tkm_cpustat_entry_get_all (entry);
+          g_debug ("Dashboard procevent EVENTS entry_count = %u", entry_count);
+          d1 = kdata_array_alloc (NULL, entry_count);
+          d2 = kdata_array_alloc (NULL, entry_count);
+          d3 = kdata_array_alloc (NULL, entry_count);
+          d4 = kdata_array_alloc (NULL, entry_count);
+          d5 = kdata_array_alloc (NULL, entry_count);
         }
-      for (guint i = 0; i < core14_entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core14_entry_index_set[i]);
 
-          d15->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d15->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-        }
-      for (guint i = 0; i < core15_entry_count; i++)
+      for (guint i = 0; i < entry_count; i++)
         {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, core15_entry_index_set[i]);
+          TkmProcEventEntry *entry = g_ptr_array_index (events_data, entry_index_set[i]);
 
-          d16->pairs[i].x = tkm_cpustat_entry_get_timestamp (
+          d1->pairs[i].x = tkm_procevent_entry_get_timestamp (
             entry, tkmv_settings_get_time_source (settings));
-          d16->pairs[i].y = tkm_cpustat_entry_get_all (entry);
+          d1->pairs[i].y
+            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_FORKS);
+          d2->pairs[i].x = d1->pairs[i].x;
+          d2->pairs[i].y
+            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXECS);
+          d3->pairs[i].x = d1->pairs[i].x;
+          d3->pairs[i].y
+            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXITS);
+          d4->pairs[i].x = d1->pairs[i].x;
+          d4->pairs[i].y
+            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_UIDS);
+          d5->pairs[i].x = d1->pairs[i].x;
+          d5->pairs[i].y
+            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_GIDS);
         }
     }
 
   kplotcfg_defaults (&plotcfg);
   plotcfg.grid = GRID_ALL;
-  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
+  plotcfg.extrema = EXTREMA_YMIN;
   plotcfg.extrema_ymin = 0;
-  plotcfg.extrema_ymax = 100;
   plotcfg.xticlabelfmt = timestamp_format;
-  plotcfg.yticlabelfmt = percent_format;
 
   p = kplot_alloc (&plotcfg);
 
@@ -1205,419 +967,318 @@ cores_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
 
       kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
     }
-  if (d6 != NULL)
-    {
-      struct kdatacfg d6_cfg;
-
-      kdatacfg_defaults (&d6_cfg);
-      d6_cfg.line.sz = 1.0;
-      d6_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d6_cfg.line.clr.rgba[0] = 1.0;
-      d6_cfg.line.clr.rgba[1] = 0.639;
-      d6_cfg.line.clr.rgba[2] = 0.0;
-      d6_cfg.line.clr.rgba[3] = 1.0;
 
-      kplot_attach_data (p, d6, KPLOT_LINES, &d6_cfg);
-    }
-  if (d7 != NULL)
-    {
-      struct kdatacfg d7_cfg;
+  kdata_destroy (d1);
+  kdata_destroy (d2);
+  kdata_destroy (d3);
+  kdata_destroy (d4);
+  kdata_destroy (d5);
 
-      kdatacfg_defaults (&d7_cfg);
-      d7_cfg.line.sz = 1.0;
-      d7_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d7_cfg.line.clr.rgba[0] = 0.494;
-      d7_cfg.line.clr.rgba[1] = 0.145;
-      d7_cfg.line.clr.rgba[2] = 0.325;
-      d7_cfg.line.clr.rgba[3] = 1.0;
+  return p;
+}
 
-      kplot_attach_data (p, d7, KPLOT_LINES, &d7_cfg);
-    }
-  if (d8 != NULL)
-    {
-      struct kdatacfg d8_cfg;
+static gpointer
+history_snapshot_function (gpointer user_data)
+{
+  TkmvDashboardView *self = (TkmvDashboardView *)user_data;
+  HistorySnapshot *snapshot = g_new0 (HistorySnapshot, 1);
 
-      kdatacfg_defaults (&d8_cfg);
-      d8_cfg.line.sz = 1.0;
-      d8_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d8_cfg.line.clr.rgba[0] = 0.114;
-      d8_cfg.line.clr.rgba[1] = 0.169;
-      d8_cfg.line.clr.rgba[2] = 0.325;
-      d8_cfg.line.clr.rgba[3] = 1.0;
+  snapshot->cursor_set = self->cursor_set;
+  snapshot->cursor_min = self->cursor_min;
+  snapshot->cursor_max = self->cursor_max;
 
-      kplot_attach_data (p, d8, KPLOT_LINES, &d8_cfg);
-    }
-  if (d9 != NULL)
-    {
-      struct kdatacfg d9_cfg;
+  return snapshot;
+}
 
-      kdatacfg_defaults (&d9_cfg);
-      d9_cfg.line.sz = 1.0;
-      d9_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d9_cfg.line.clr.rgba[0] = 0.0;
-      d9_cfg.line.clr.rgba[1] = 0.529;
-      d9_cfg.line.clr.rgba[2] = 0.318;
-      d9_cfg.line.clr.rgba[3] = 1.0;
+/* Index of the first row later than x, rows are ordered by time */
+static guint
+history_rows_after (GPtrArray *rows, HistoryRowFunc row_func,
+                    DataTimeSource source, double x)
+{
+  double values[HISTORY_SERIES_MAX];
+  guint lo = 0;
+  guint hi = rows->len;
 
-      kplot_attach_data (p, d9, KPLOT_LINES, &d9_cfg);
-    }
-  if (d10 != NULL)
+  while (lo < hi)
     {
-      struct kdatacfg d10_cfg;
-
-      kdatacfg_defaults (&d10_cfg);
-      d10_cfg.line.sz = 1.0;
-      d10_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d10_cfg.line.clr.rgba[0] = 1.0;
-      d10_cfg.line.clr.rgba[1] = 0.8;
-      d10_cfg.line.clr.rgba[2] = 0.667;
-      d10_cfg.line.clr.rgba[3] = 1.0;
+      guint mid = lo + (hi - lo) / 2;
+      double mid_x = 0;
 
-      kplot_attach_data (p, d10, KPLOT_LINES, &d10_cfg);
+      row_func (g_ptr_array_index (rows, mid), source, &mid_x, values);
+      if (mid_x <= x)
+        lo = mid + 1;
+      else
+        hi = mid;
     }
-  if (d11 != NULL)
-    {
-      struct kdatacfg d11_cfg;
 
-      kdatacfg_defaults (&d11_cfg);
-      d11_cfg.line.sz = 1.0;
-      d11_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d11_cfg.line.clr.rgba[0] = 0.671;
-      d11_cfg.line.clr.rgba[1] = 0.322;
-      d11_cfg.line.clr.rgba[2] = 0.212;
-      d11_cfg.line.clr.rgba[3] = 1.0;
+  return lo;
+}
 
-      kplot_attach_data (p, d11, KPLOT_LINES, &d11_cfg);
-    }
-  if (d12 != NULL)
-    {
-      struct kdatacfg d12_cfg;
+/*
+ * Samples of the rows past after and up to the cursor window if set, the
+ * first of them is returned in first and their count in count.
+ */
+static void
+history_rows_span (GPtrArray *rows, HistoryRowFunc row_func,
+                   const HistorySnapshot *snapshot, double after,
+                   guint *first, guint *count)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  DataTimeSource source = tkmv_settings_get_time_source (settings);
+  double values[HISTORY_SERIES_MAX];
 
-      kdatacfg_defaults (&d12_cfg);
-      d12_cfg.line.sz = 1.0;
-      d12_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d12_cfg.line.clr.rgba[0] = 0.761;
-      d12_cfg.line.clr.rgba[1] = 0.765;
-      d12_cfg.line.clr.rgba[2] = 0.78;
-      d12_cfg.line.clr.rgba[3] = 1.0;
+  *first = history_rows_after (rows, row_func, source, after);
+  *count = 0;
 
-      kplot_attach_data (p, d12, KPLOT_LINES, &d12_cfg);
-    }
-  if (d13 != NULL)
+  for (guint i = *first; i < rows->len; i++)
     {
-      struct kdatacfg d13_cfg;
+      double x = 0;
+
+      if (!row_func (g_ptr_array_index (rows, i), source, &x, values))
+        continue;
 
-      kdatacfg_defaults (&d13_cfg);
-      d13_cfg.line.sz = 1.0;
-      d13_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d13_cfg.line.clr.rgba[0] = 0.514;
-      d13_cfg.line.clr.rgba[1] = 0.463;
-      d13_cfg.line.clr.rgba[2] = 0.612;
-      d13_cfg.line.clr.rgba[3] = 1.0;
+      if (snapshot->cursor_set && x > snapshot->cursor_max)
+        break;
 
-      kplot_attach_data (p, d13, KPLOT_LINES, &d13_cfg);
+      (*count)++;
     }
-  if (d14 != NULL)
-    {
-      struct kdatacfg d14_cfg;
+}
 
-      kdatacfg_defaults (&d14_cfg);
-      d14_cfg.line.sz = 1.0;
-      d14_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d14_cfg.line.clr.rgba[0] = 1.0;
-      d14_cfg.line.clr.rgba[1] = 0.0;
-      d14_cfg.line.clr.rgba[2] = 0.302;
-      d14_cfg.line.clr.rgba[3] = 1.0;
+/* Push count samples of the rows from first on, each series to its ring */
+static void
+history_rings_push (struct kdata **rings, guint n_rings, GPtrArray *rows,
+                    HistoryRowFunc row_func, guint first, guint count)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  DataTimeSource source = tkmv_settings_get_time_source (settings);
+  double values[HISTORY_SERIES_MAX];
 
-      kplot_attach_data (p, d14, KPLOT_LINES, &d14_cfg);
-    }
-  if (d15 != NULL)
+  for (guint i = first; i < rows->len && count > 0; i++)
     {
-      struct kdatacfg d15_cfg;
+      double x = 0;
 
-      kdatacfg_defaults (&d15_cfg);
-      d15_cfg.line.sz = 1.0;
-      d15_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d15_cfg.line.clr.rgba[0] = 0.373;
-      d15_cfg.line.clr.rgba[1] = 0.341;
-      d15_cfg.line.clr.rgba[2] = 0.31;
-      d15_cfg.line.clr.rgba[3] = 1.0;
+      if (!row_func (g_ptr_array_index (rows, i), source, &x, values))
+        continue;
 
-      kplot_attach_data (p, d15, KPLOT_LINES, &d15_cfg);
+      for (guint j = 0; j < n_rings; j++)
+        kdata_ring_push (rings[j], x, values[j]);
+      count--;
     }
-  if (d16 != NULL)
-    {
-      struct kdatacfg d16_cfg;
+}
 
-      kdatacfg_defaults (&d16_cfg);
-      d16_cfg.line.sz = 1.0;
-      d16_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d16_cfg.line.clr.rgba[0] = 0.161;
-      d16_cfg.line.clr.rgba[1] = 0.678;
-      d16_cfg.line.clr.rgba[2] = 1.0;
-      d16_cfg.line.clr.rgba[3] = 1.0;
+/* Oldest time a history chart shows, the cursor window or the loaded rows */
+static double
+history_rows_start (GPtrArray *rows, HistoryRowFunc row_func,
+                    const HistorySnapshot *snapshot)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  double values[HISTORY_SERIES_MAX];
+  double x = -INFINITY;
 
-      kplot_attach_data (p, d16, KPLOT_LINES, &d16_cfg);
-    }
+  if (snapshot->cursor_set)
+    return snapshot->cursor_min;
 
-  kplot_draw (p, width, height, cr);
+  if (rows->len > 0)
+    row_func (g_ptr_array_index (rows, 0),
+              tkmv_settings_get_time_source (settings), &x, values);
 
-  if (d1 != NULL)
-    kdata_destroy (d1);
-  if (d2 != NULL)
-    kdata_destroy (d2);
-  if (d3 != NULL)
-    kdata_destroy (d3);
-  if (d4 != NULL)
-    kdata_destroy (d4);
-  if (d5 != NULL)
-    kdata_destroy (d5);
-  if (d6 != NULL)
-    kdata_destroy (d6);
-  if (d7 != NULL)
-    kdata_destroy (d7);
-  if (d8 != NULL)
-    kdata_destroy (d8);
-  if (d9 != NULL)
-    kdata_destroy (d9);
-  if (d10 != NULL)
-    kdata_destroy (d10);
-  if (d11 != NULL)
-    kdata_destroy (d11);
-  if (d12 != NULL)
-    kdata_destroy (d12);
-  if (d13 != NULL)
-    kdata_destroy (d13);
-  if (d14 != NULL)
-    kdata_destroy (d14);
-  if (d15 != NULL)
-    kdata_destroy (d15);
-  if (d16 != NULL)
-    kdata_destroy (d16);
-
-  kplot_free (p);
+  return x;
 }
 
-static void
-events_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
-                              int height, gpointer data)
+/*
+ * Fill one ring per series from the rows. The rings get room for twice
+ * the samples so the appends that follow rarely need a rebuild.
+ */
+static gboolean
+history_rings_new (struct kdata **rings, guint n_rings, GPtrArray *rows,
+                   HistoryRowFunc row_func, const HistorySnapshot *snapshot)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
-  GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *events_data = tkm_context_get_procevent_entries (context);
-  TkmSessionEntry *active_session = NULL;
+  double start = history_rows_start (rows, row_func, snapshot);
+  guint first = 0;
+  guint count = 0;
 
-  struct kdata *d1 = NULL; /* Forks */
-  struct kdata *d2 = NULL; /* Execs */
-  struct kdata *d3 = NULL; /* Exits */
-  struct kdata *d4 = NULL; /* UIDs */
-  struct kdata *d5 = NULL; /* GIDs */
+  g_assert (n_rings <= HISTORY_SERIES_MAX);
 
-  struct kplotcfg plotcfg;
-  struct kplot *p;
+  history_rows_span (rows, row_func, snapshot, nextafter (start, -INFINITY),
+                     &first, &count);
+  if (count == 0)
+    return FALSE;
 
-  TKMV_UNUSED (area);
-  TKMV_UNUSED (data);
+  g_debug ("Dashboard history ring samples = %u", count);
 
-  if (sessions != NULL)
+  for (guint i = 0; i < n_rings; i++)
     {
-      for (guint i = 0; i < sessions->len; i++)
+      rings[i] = kdata_ring_alloc (MAX (2 * count, HISTORY_RING_MIN));
+      if (rings[i] == NULL)
         {
-          if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
-            {
-              active_session = g_ptr_array_index (sessions, i);
-            }
+          for (guint j = 0; j < i; j++)
+            g_clear_pointer (&rings[j], kdata_destroy);
+          return FALSE;
         }
-
-      g_assert (active_session);
-      g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
     }
 
-  if (events_data != NULL)
-    {
-      g_autofree guint *entry_index_set = calloc (events_data->len, sizeof(guint));
-      guint entry_count = 0;
+  history_rings_push (rings, n_rings, rows, row_func, first, count);
 
-      if (events_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
-        {
-          for (guint i = 0; i < events_data->len; i++)
-            entry_index_set[entry_count++] = i;
-        }
-      else
-        {
-          entry_index_set[entry_count++] = 0;
-          for (guint i = 1; i < events_data->len; i++)
-            {
-              TkmProcEventEntry *prev_entry =
-                g_ptr_array_index (events_data, entry_index_set[entry_count - 1]);
-              TkmProcEventEntry *entry = g_ptr_array_index (events_data, i);
-              gboolean should_add = false;
+  return TRUE;
+}
 
-              if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_FORKS)
-                  != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_FORKS))
-                {
-                  should_add = true;
-                }
-              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXECS)
-                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_EXECS))
-                {
-                  should_add = true;
-                }
-              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXITS)
-                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_EXITS))
-                {
-                  should_add = true;
-                }
-              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_UIDS)
-                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_UIDS))
-                {
-                  should_add = true;
-                }
-              else if (tkm_procevent_entry_get_data (entry, PEVENT_DATA_GIDS)
-                       != tkm_procevent_entry_get_data (prev_entry, PEVENT_DATA_GIDS))
-                {
-                  should_add = true;
-                }
+/*
+ * Extend the rings of a plot built by history_rings_new() with the rows
+ * past its last sample and drop the samples that scrolled out. It fails
+ * if the rings would overflow or the cursor went back in time.
+ */
+static gboolean
+history_rings_append (struct kplot *plot, guint n_rings, GPtrArray *rows,
+                      HistoryRowFunc row_func, const HistorySnapshot *snapshot)
+{
+  struct kdata *rings[HISTORY_SERIES_MAX];
+  double start = 0;
+  struct kpair last;
+  guint first = 0;
+  guint count = 0;
 
-              if (should_add || (i == (events_data->len - 1)))
-                {
-                  entry_index_set[entry_count++] = i;
-                }
-            }
-        }
+  if (rows == NULL || plot->datasz != n_rings)
+    return FALSE;
 
-      if (entry_count > 0)
-        {
-          g_debug ("Dashboard procevent EVENTS entry_count = %u", entry_count);
-          d1 = kdata_array_alloc (NULL, entry_count);
-          d2 = kdata_array_alloc (NULL, entry_count);
-          d3 = kdata_array_alloc (NULL, entry_count);
-          d4 = kdata_array_alloc (NULL, entry_count);
-          d5 = kdata_array_alloc (NULL, entry_count);
-        }
+  for (guint i = 0; i < n_rings; i++)
+    {
+      rings[i] = plot->datas[i].datas[0];
+      if (rings[i]->type != KDATA_RING)
+        return FALSE;
+    }
 
-      for (guint i = 0; i < entry_count; i++)
-        {
-          TkmProcEventEntry *entry = g_ptr_array_index (events_data, entry_index_set[i]);
+  if (!kdata_get (rings[0], rings[0]->pairsz - 1, &last)
+      || (snapshot->cursor_set && last.x > snapshot->cursor_max))
+    return FALSE;
 
-          d1->pairs[i].x = tkm_procevent_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d1->pairs[i].y
-            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_FORKS);
-          d2->pairs[i].x = d1->pairs[i].x;
-          d2->pairs[i].y
-            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXECS);
-          d3->pairs[i].x = d1->pairs[i].x;
-          d3->pairs[i].y
-            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_EXITS);
-          d4->pairs[i].x = d1->pairs[i].x;
-          d4->pairs[i].y
-            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_UIDS);
-          d5->pairs[i].x = d1->pairs[i].x;
-          d5->pairs[i].y
-            = tkm_procevent_entry_get_data (entry, PEVENT_DATA_GIDS);
-        }
+  start = history_rows_start (rows, row_func, snapshot);
+  for (guint i = 0; i < n_rings; i++)
+    {
+      while (rings[i]->pairsz > 0 && rings[i]->pairs[0].x < start)
+        kdata_ring_pop (rings[i]);
     }
 
-  kplotcfg_defaults (&plotcfg);
-  plotcfg.grid = GRID_ALL;
-  plotcfg.extrema = EXTREMA_YMIN;
-  plotcfg.extrema_ymin = 0;
-  plotcfg.xticlabelfmt = timestamp_format;
+  history_rows_span (rows, row_func, snapshot, last.x, &first, &count);
+  if (count > rings[0]->d.ring.cap - rings[0]->pairsz)
+    return FALSE;
 
-  p = kplot_alloc (&plotcfg);
+  history_rings_push (rings, n_rings, rows, row_func, first, count);
 
-  if (d1 != NULL)
+  if (snapshot->cursor_set)
     {
-      struct kdatacfg d1_cfg;
+      kplot_get_plotcfg (plot)->extrema_xmin = snapshot->cursor_min;
+      kplot_get_plotcfg (plot)->extrema_xmax = snapshot->cursor_max;
+    }
 
-      kdatacfg_defaults (&d1_cfg);
-      d1_cfg.line.sz = 1.0;
-      d1_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d1_cfg.line.clr.rgba[0] = 1.0;
-      d1_cfg.line.clr.rgba[3] = 1.0;
+  return TRUE;
+}
 
-      kplot_attach_data (p, d1, KPLOT_LINES, &d1_cfg);
-    }
-  if (d2 != NULL)
-    {
-      struct kdatacfg d2_cfg;
+/* Pin the x axis of a history chart to the cursor window while playing */
+static void
+history_plotcfg_cursor (struct kplotcfg *plotcfg,
+                        const HistorySnapshot *snapshot)
+{
+  if (!snapshot->cursor_set)
+    return;
 
-      kdatacfg_defaults (&d2_cfg);
-      d2_cfg.line.sz = 1.0;
-      d2_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d2_cfg.line.clr.rgba[2] = 1.0;
-      d2_cfg.line.clr.rgba[3] = 1.0;
+  plotcfg->extrema |= EXTREMA_XMIN | EXTREMA_XMAX;
+  plotcfg->extrema_xmin = snapshot->cursor_min;
+  plotcfg->extrema_xmax = snapshot->cursor_max;
+}
 
-      kplot_attach_data (p, d2, KPLOT_LINES, &d2_cfg);
-    }
-  if (d3 != NULL)
-    {
-      struct kdatacfg d3_cfg;
+static gboolean
+cpu_history_row (gpointer entry, DataTimeSource source, double *x,
+                 double *values)
+{
+  *x = tkm_cpustat_entry_get_timestamp (entry, source);
 
-      kdatacfg_defaults (&d3_cfg);
-      d3_cfg.line.sz = 1.0;
-      d3_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d3_cfg.line.clr.rgba[1] = 1.0;
-      d3_cfg.line.clr.rgba[3] = 1.0;
+  /* The cores have their own chart */
+  if (g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu") != 0)
+    return FALSE;
 
-      kplot_attach_data (p, d3, KPLOT_LINES, &d3_cfg);
-    }
-  if (d4 != NULL)
-    {
-      struct kdatacfg d4_cfg;
+  values[0] = tkm_cpustat_entry_get_all (entry);
+  values[1] = tkm_cpustat_entry_get_usr (entry);
+  values[2] = tkm_cpustat_entry_get_sys (entry);
+  values[3] = tkm_cpustat_entry_get_iow (entry);
 
-      kdatacfg_defaults (&d4_cfg);
-      d4_cfg.line.sz = 1.0;
-      d4_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d4_cfg.line.clr.rgba[0] = 0.4;
-      d4_cfg.line.clr.rgba[1] = 0.0;
-      d4_cfg.line.clr.rgba[2] = 0.6;
-      d4_cfg.line.clr.rgba[3] = 1.0;
+  return TRUE;
+}
 
-      kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
-    }
-  if (d5 != NULL)
-    {
-      struct kdatacfg d5_cfg;
+static gboolean
+cpu_history_append_function (gpointer data, struct kplot *plot)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
 
-      kdatacfg_defaults (&d5_cfg);
-      d5_cfg.line.sz = 1.0;
-      d5_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d5_cfg.line.clr.rgba[0] = 0.9;
-      d5_cfg.line.clr.rgba[1] = 0.4;
-      d5_cfg.line.clr.rgba[2] = 0.3;
-      d5_cfg.line.clr.rgba[3] = 1.0;
+  return history_rings_append (plot, 4,
+                               tkm_context_get_cpustat_entries (context),
+                               cpu_history_row, data);
+}
 
-      kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
-    }
+static gboolean
+mem_history_row (gpointer entry, DataTimeSource source, double *x,
+                 double *values)
+{
+  *x = tkm_meminfo_entry_get_timestamp (entry, source);
+  values[0] = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_TOTAL);
+  values[1] = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_FREE);
+  values[2] = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_AVAIL);
+  values[3] = tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_TOTAL);
+  values[4] = tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_FREE);
+
+  return TRUE;
+}
 
-  kplot_draw (p, width, height, cr);
+static gboolean
+mem_history_append_function (gpointer data, struct kplot *plot)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
 
-  kdata_destroy (d1);
-  kdata_destroy (d2);
-  kdata_destroy (d3);
-  kdata_destroy (d4);
-  kdata_destroy (d5);
+  return history_rings_append (plot, 5,
+                               tkm_context_get_meminfo_entries (context),
+                               mem_history_row, data);
+}
 
-  kplot_free (p);
+static gboolean
+psi_history_row (gpointer entry, DataTimeSource source, double *x,
+                 double *values)
+{
+  *x = tkm_pressure_entry_get_timestamp (entry, source);
+  values[0] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_CPU_SOME_AVG10);
+  values[1] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_CPU_SOME_AVG60);
+  values[2] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_MEM_SOME_AVG10);
+  values[3] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_MEM_SOME_AVG60);
+  values[4] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_IO_SOME_AVG10);
+  values[5] = tkm_pressure_entry_get_data_avg (entry, PSI_DATA_IO_SOME_AVG60);
+
+  return TRUE;
 }
 
-static void
-cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
-                           int height, gpointer data)
+static gboolean
+psi_history_append_function (gpointer data, struct kplot *plot)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+
+  return history_rings_append (plot, 6,
+                               tkm_context_get_pressure_entries (context),
+                               psi_history_row, data);
+}
+
+static struct kplot *
+cpu_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
   GPtrArray *sessions = tkm_context_get_session_entries (context);
   GPtrArray *cpu_data = tkm_context_get_cpustat_entries (context);
   TkmSessionEntry *active_session = NULL;
 
+  struct kdata *rings[4] = { NULL };
   struct kdata *d1 = NULL; /* all */
   struct kdata *d2 = NULL; /* usr */
   struct kdata *d3 = NULL; /* sys */
@@ -1626,9 +1287,6 @@ cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   struct kplotcfg plotcfg;
   struct kplot *p;
 
-  TKMV_UNUSED (area);
-  TKMV_UNUSED (data);
-
   if (sessions != NULL)
     {
       for (guint i = 0; i < sessions->len; i++)
@@ -1643,91 +1301,14 @@ cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
     }
 
-  if (cpu_data != NULL)
+  if (cpu_data != NULL
+      && history_rings_new (rings, G_N_ELEMENTS (rings), cpu_data,
+                            cpu_history_row, data))
     {
-      g_autofree guint *entry_index_set = calloc (cpu_data->len, sizeof(guint));
-      guint entry_count = 0;
-
-      if (cpu_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
-        {
-          for (guint i = 0; i < cpu_data->len; i++)
-            {
-              TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
-
-              if (g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu") == 0)
-                {
-                  entry_index_set[entry_count++] = i;
-                }
-            }
-        }
-      else
-        {
-          entry_index_set[entry_count++] = 0;
-          for (guint i = 1; i < cpu_data->len; i++)
-            {
-              TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, i);
-
-              if (g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu") == 0)
-                {
-                  TkmCpuStatEntry *prev_entry =
-                    g_ptr_array_index (cpu_data, entry_index_set[entry_count - 1]);
-                  gboolean should_add = false;
-
-                  if (tkm_cpustat_entry_get_all (entry)
-                      != tkm_cpustat_entry_get_all (prev_entry))
-                    {
-                      should_add = true;
-                    }
-                  else if (tkm_cpustat_entry_get_usr (entry)
-                           != tkm_cpustat_entry_get_usr (prev_entry))
-                    {
-                      should_add = true;
-                    }
-                  else if (tkm_cpustat_entry_get_sys (entry)
-                           != tkm_cpustat_entry_get_sys (prev_entry))
-                    {
-                      should_add = true;
-                    }
-                  else if (tkm_cpustat_entry_get_iow (entry)
-                           != tkm_cpustat_entry_get_iow (prev_entry))
-                    {
-                      should_add = true;
-                    }
-
-                  if (should_add)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-            }
-        }
-
-      if (entry_count > 0)
-        {
-          g_debug ("Dashboard cpustat CPU entry_count = %u", entry_count);
-          d1 = kdata_array_alloc (NULL, entry_count);
-          d2 = kdata_array_alloc (NULL, entry_count);
-          d3 = kdata_array_alloc (NULL, entry_count);
-          d4 = kdata_array_alloc (NULL, entry_count);
-        }
-
-      for (guint i = 0; i < entry_count; i++)
-        {
-          TkmCpuStatEntry *entry = g_ptr_array_index (cpu_data, entry_index_set[i]);
-
-          if (g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu") == 0)
-            {
-              d1->pairs[i].x = tkm_cpustat_entry_get_timestamp (
-                entry, tkmv_settings_get_time_source (settings));
-              d1->pairs[i].y = tkm_cpustat_entry_get_all (entry);
-              d2->pairs[i].x = d1->pairs[i].x;
-              d2->pairs[i].y = tkm_cpustat_entry_get_usr (entry);
-              d3->pairs[i].x = d1->pairs[i].x;
-              d3->pairs[i].y = tkm_cpustat_entry_get_sys (entry);
-              d4->pairs[i].x = d1->pairs[i].x;
-              d4->pairs[i].y = tkm_cpustat_entry_get_iow (entry);
-            }
-        }
+      d1 = rings[0];
+      d2 = rings[1];
+      d3 = rings[2];
+      d4 = rings[3];
     }
 
   kplotcfg_defaults (&plotcfg);
@@ -1738,6 +1319,7 @@ cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   plotcfg.xticlabelfmt = timestamp_format;
   plotcfg.yticlabelfmt = percent_format;
 
+  history_plotcfg_cursor (&plotcfg, data);
   p = kplot_alloc (&plotcfg);
 
   if (d1 != NULL)
@@ -1791,28 +1373,24 @@ cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
     }
 
-  kplot_draw (p, width, height, cr);
-
   kdata_destroy (d1);
   kdata_destroy (d2);
   kdata_destroy (d3);
   kdata_destroy (d4);
 
-  kplot_free (p);
+  return p;
 }
 
-static void
-mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
-                           int height, gpointer data)
+static struct kplot *
+mem_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
   GPtrArray *sessions = tkm_context_get_session_entries (context);
   GPtrArray *mem_data = tkm_context_get_meminfo_entries (context);
   TkmSessionEntry *active_session = NULL;
 
+  struct kdata *rings[5] = { NULL };
   struct kdata *d1 = NULL; /* MemTotal */
   struct kdata *d2 = NULL; /* MemFree */
   struct kdata *d3 = NULL; /* MemAvail */
@@ -1822,9 +1400,6 @@ mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   struct kplotcfg plotcfg;
   struct kplot *p;
 
-  TKMV_UNUSED (area);
-  TKMV_UNUSED (data);
-
   if (sessions != NULL)
     {
       for (guint i = 0; i < sessions->len; i++)
@@ -1839,90 +1414,15 @@ mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
     }
 
-  if (mem_data != NULL)
+  if (mem_data != NULL
+      && history_rings_new (rings, G_N_ELEMENTS (rings), mem_data,
+                            mem_history_row, data))
     {
-      g_autofree guint *entry_index_set = calloc (mem_data->len, sizeof(guint));
-      guint entry_count = 0;
-
-      if (mem_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
-        {
-          for (guint i = 0; i < mem_data->len; i++)
-            entry_index_set[entry_count++] = i;
-        }
-      else
-        {
-          entry_index_set[entry_count++] = 0;
-          for (guint i = 1; i < mem_data->len; i++)
-            {
-              TkmMemInfoEntry *prev_entry =
-                g_ptr_array_index (mem_data, entry_index_set[entry_count - 1]);
-              TkmMemInfoEntry *entry = g_ptr_array_index (mem_data, i);
-              gboolean should_add = false;
-
-              if (tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_TOTAL)
-                  != tkm_meminfo_entry_get_data (prev_entry, MINFO_DATA_MEM_TOTAL))
-                {
-                  should_add = true;
-                }
-              else if (tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_FREE)
-                       != tkm_meminfo_entry_get_data (prev_entry, MINFO_DATA_MEM_FREE))
-                {
-                  should_add = true;
-                }
-              else if (tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_AVAIL)
-                       != tkm_meminfo_entry_get_data (prev_entry, MINFO_DATA_MEM_AVAIL))
-                {
-                  should_add = true;
-                }
-              else if (tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_TOTAL)
-                       != tkm_meminfo_entry_get_data (prev_entry, MINFO_DATA_SWAP_TOTAL))
-                {
-                  should_add = true;
-                }
-              else if (tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_FREE)
-                       != tkm_meminfo_entry_get_data (prev_entry, MINFO_DATA_SWAP_FREE))
-                {
-                  should_add = true;
-                }
-
-              if (should_add || (i == (mem_data->len - 1)))
-                {
-                  entry_index_set[entry_count++] = i;
-                }
-            }
-        }
-
-      if (entry_count > 0)
-        {
-          g_debug ("Dashboard meminfo MEM entry_count = %u", entry_count);
-          d1 = kdata_array_alloc (NULL, entry_count);
-          d2 = kdata_array_alloc (NULL, entry_count);
-          d3 = kdata_array_alloc (NULL, entry_count);
-          d4 = kdata_array_alloc (NULL, entry_count);
-          d5 = kdata_array_alloc (NULL, entry_count);
-        }
-
-      for (guint i = 0; i < entry_count; i++)
-        {
-          TkmMemInfoEntry *entry = g_ptr_array_index (mem_data, entry_index_set[i]);
-
-          d1->pairs[i].x = tkm_meminfo_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d1->pairs[i].y
-            = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_TOTAL);
-          d2->pairs[i].x = d1->pairs[i].x;
-          d2->pairs[i].y
-            = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_FREE);
-          d3->pairs[i].x = d1->pairs[i].x;
-          d3->pairs[i].y
-            = tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_AVAIL);
-          d4->pairs[i].x = d1->pairs[i].x;
-          d4->pairs[i].y
-            = tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_TOTAL);
-          d5->pairs[i].x = d1->pairs[i].x;
-          d5->pairs[i].y
-            = tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_FREE);
-        }
+      d1 = rings[0];
+      d2 = rings[1];
+      d3 = rings[2];
+      d4 = rings[3];
+      d5 = rings[4];
     }
 
   kplotcfg_defaults (&plotcfg);
@@ -1932,6 +1432,7 @@ mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   plotcfg.xticlabelfmt = timestamp_format;
   plotcfg.yticlabelfmt = memory_format;
 
+  history_plotcfg_cursor (&plotcfg, data);
   p = kplot_alloc (&plotcfg);
 
   if (d1 != NULL)
@@ -1999,29 +1500,25 @@ mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
     }
 
-  kplot_draw (p, width, height, cr);
-
   kdata_destroy (d1);
   kdata_destroy (d2);
   kdata_destroy (d3);
   kdata_destroy (d4);
   kdata_destroy (d5);
 
-  kplot_free (p);
+  return p;
 }
 
-static void
-psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
-                           int height, gpointer data)
+static struct kplot *
+psi_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
   GPtrArray *sessions = tkm_context_get_session_entries (context);
   GPtrArray *psi_data = tkm_context_get_pressure_entries (context);
   TkmSessionEntry *active_session = NULL;
 
+  struct kdata *rings[6] = { NULL };
   struct kdata *d1 = NULL; /* CPUSome10 */
   struct kdata *d2 = NULL; /* CPUSome60 */
   struct kdata *d3 = NULL; /* MEMSome10 */
@@ -2032,9 +1529,6 @@ psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   struct kplotcfg plotcfg;
   struct kplot *p = NULL;
 
-  TKMV_UNUSED (area);
-  TKMV_UNUSED (data);
-
   if (sessions != NULL)
     {
       for (guint i = 0; i < sessions->len; i++)
@@ -2049,99 +1543,16 @@ psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
     }
 
-  if (psi_data != NULL)
+  if (psi_data != NULL
+      && history_rings_new (rings, G_N_ELEMENTS (rings), psi_data,
+                            psi_history_row, data))
     {
-      g_autofree guint *entry_index_set = calloc (psi_data->len, sizeof(guint));
-      guint entry_count = 0;
-
-      if (psi_data->len < KPOINTS_OPTIMIZATION_START_LIMIT)
-        {
-          for (guint i = 0; i < psi_data->len; i++)
-            entry_index_set[entry_count++] = i;
-        }
-      else
-        {
-          entry_index_set[entry_count++] = 0;
-          for (guint i = 1; i < psi_data->len; i++)
-            {
-              TkmPressureEntry *prev_entry =
-                g_ptr_array_index (psi_data, entry_index_set[entry_count - 1]);
-              TkmPressureEntry *entry = g_ptr_array_index (psi_data, i);
-              gboolean should_add = false;
-
-              if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_CPU_SOME_AVG10)
-                  != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_CPU_SOME_AVG10))
-                {
-                  should_add = true;
-                }
-              else if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_CPU_SOME_AVG60)
-                       != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_CPU_SOME_AVG60))
-                {
-                  should_add = true;
-                }
-              else if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_MEM_SOME_AVG10)
-                       != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_MEM_SOME_AVG10))
-                {
-                  should_add = true;
-                }
-              else if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_MEM_SOME_AVG60)
-                       != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_MEM_SOME_AVG60))
-                {
-                  should_add = true;
-                }
-              else if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_IO_SOME_AVG10)
-                       != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_IO_SOME_AVG10))
-                {
-                  should_add = true;
-                }
-              else if (tkm_pressure_entry_get_data_avg (entry, PSI_DATA_IO_SOME_AVG60)
-                       != tkm_pressure_entry_get_data_avg (prev_entry, PSI_DATA_IO_SOME_AVG60))
-                {
-                  should_add = true;
-                }
-
-              if (should_add || (i == (psi_data->len - 1)))
-                {
-                  entry_index_set[entry_count++] = i;
-                }
-            }
-        }
-
-      if (entry_count > 0)
-        {
-          g_debug ("Dashboard pressure PSI entry_count = %u", entry_count);
-          d1 = kdata_array_alloc (NULL, entry_count);
-          d2 = kdata_array_alloc (NULL, entry_count);
-          d3 = kdata_array_alloc (NULL, entry_count);
-          d4 = kdata_array_alloc (NULL, entry_count);
-          d5 = kdata_array_alloc (NULL, entry_count);
-          d6 = kdata_array_alloc (NULL, entry_count);
-        }
-
-      for (guint i = 0; i < entry_count; i++)
-        {
-          TkmPressureEntry *entry = g_ptr_array_index (psi_data, entry_index_set[i]);
-
-          d1->pairs[i].x = tkm_pressure_entry_get_timestamp (
-            entry, tkmv_settings_get_time_source (settings));
-          d1->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_CPU_SOME_AVG10);
-          d2->pairs[i].x = d1->pairs[i].x;
-          d2->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_CPU_SOME_AVG60);
-          d3->pairs[i].x = d1->pairs[i].x;
-          d3->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_MEM_SOME_AVG10);
-          d4->pairs[i].x = d1->pairs[i].x;
-          d4->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_MEM_SOME_AVG60);
-          d5->pairs[i].x = d1->pairs[i].x;
-          d5->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_IO_SOME_AVG10);
-          d6->pairs[i].x = d1->pairs[i].x;
-          d6->pairs[i].y = tkm_pressure_entry_get_data_avg (
-            entry, PSI_DATA_IO_SOME_AVG60);
-        }
+      d1 = rings[0];
+      d2 = rings[1];
+      d3 = rings[2];
+      d4 = rings[3];
+      d5 = rings[4];
+      d6 = rings[5];
     }
 
   kplotcfg_defaults (&plotcfg);
@@ -2151,6 +1562,7 @@ psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   plotcfg.xticlabelfmt = timestamp_format;
   plotcfg.yticlabelfmt = pressure_format;
 
+  history_plotcfg_cursor (&plotcfg, data);
   p = kplot_alloc (&plotcfg);
 
   if (d1 != NULL)
@@ -2232,8 +1644,6 @@ psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
       kplot_attach_data (p, d6, KPLOT_LINES, &d6_cfg);
     }
 
-  kplot_draw (p, width, height, cr);
-
   kdata_destroy (d1);
   kdata_destroy (d2);
   kdata_destroy (d3);
@@ -2241,7 +1651,7 @@ psi_history_draw_function (GtkDrawingArea *area, cairo_t *cr, int width,
   kdata_destroy (d5);
   kdata_destroy (d6);
 
-  kplot_free (p);
+  return p;
 }
 
 static void
@@ -2279,6 +1689,8 @@ update_current_values_frame (TkmvDashboardView *view)
   g_assert (active_session);
   g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
 
+  cores_update_labels (view, active_session);
+
   cpu_entry = g_ptr_array_index (cpu_data, 0);
   g_assert (cpu_entry); /* we should have an entry */
 
@@ -2339,90 +1751,89 @@ update_current_values_frame (TkmvDashboardView *view)
   gtk_label_set_text (view->swap_level_label, buf);
 }
 
-static void
-cpu_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr, int width,
-                                int height, gpointer data)
+void
+tkmv_dashboard_view_update_content (TkmvDashboardView *view)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
+  g_assert (view);
+
+  update_current_values_frame (view);
 
-  if (tkm_context_data_try_lock (context))
+  /* A new window starts zoomed out */
+  if (view->viewport_fetch_source != 0)
     {
-      cpu_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
+      g_source_remove (view->viewport_fetch_source);
+      view->viewport_fetch_source = 0;
     }
+  tkmv_chart_reset_viewport (view->history_cpu_chart);
+  tkmv_chart_reset_viewport (view->history_mem_chart);
+  tkmv_chart_reset_viewport (view->history_cores_chart);
+  tkmv_chart_reset_viewport (view->history_events_chart);
+  tkmv_chart_reset_viewport (view->history_psi_chart);
+
+  tkmv_chart_invalidate (view->history_cpu_chart);
+  tkmv_chart_invalidate (view->history_mem_chart);
+  tkmv_chart_invalidate (view->history_cores_chart);
+  tkmv_chart_invalidate (view->history_events_chart);
+  tkmv_chart_invalidate (view->history_psi_chart);
 }
 
-static void
-mem_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr, int width,
-                                int height, gpointer data)
+void
+tkmv_dashboard_view_update_charts (TkmvDashboardView *view)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
+  g_assert (view);
 
-  if (tkm_context_data_try_lock (context))
-    {
-      mem_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
-    }
+  /* New rows at the end are appended, replaced data is built again */
+  tkmv_chart_update (view->history_cpu_chart);
+  tkmv_chart_update (view->history_mem_chart);
+  tkmv_chart_update (view->history_cores_chart);
+  tkmv_chart_update (view->history_events_chart);
+  tkmv_chart_update (view->history_psi_chart);
 }
 
-static void
-psi_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr, int width,
-                                int height, gpointer data)
+void
+tkmv_dashboard_view_set_cursor (TkmvDashboardView *view, double min,
+                                double max)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
+  g_assert (view);
 
-  if (tkm_context_data_try_lock (context))
-    {
-      psi_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
-    }
-}
+  if (max <= min)
+    return;
 
-static void
-events_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                   int width, int height, gpointer data)
-{
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
+  view->cursor_min = min;
+  view->cursor_max = max;
 
-  if (tkm_context_data_try_lock (context))
+  /* Entering playback builds the rings of the window, then they scroll */
+  if (!view->cursor_set)
     {
-      events_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
+      view->cursor_set = TRUE;
+      tkmv_chart_invalidate (view->history_cpu_chart);
+      tkmv_chart_invalidate (view->history_mem_chart);
+      tkmv_chart_invalidate (view->history_psi_chart);
     }
-}
-
-static void
-cores_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                  int width, int height, gpointer data)
-{
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
-
-  if (tkm_context_data_try_lock (context))
+  else
     {
-      cores_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
+      tkmv_chart_update (view->history_cpu_chart);
+      tkmv_chart_update (view->history_mem_chart);
+      tkmv_chart_update (view->history_psi_chart);
     }
-}
 
-static void psi_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                            int width, int height,
-                                            gpointer data);
+  /* The cores and events are not kept in rings, they just pan along */
+  tkmv_chart_set_viewport (view->history_cores_chart, min, max);
+  tkmv_chart_set_viewport (view->history_events_chart, min, max);
+}
 
 void
-tkmv_dashboard_view_update_content (TkmvDashboardView *view)
+tkmv_dashboard_view_clear_cursor (TkmvDashboardView *view)
 {
   g_assert (view);
 
-  update_current_values_frame (view);
-  gtk_widget_queue_draw (GTK_WIDGET (view->history_cpu_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (view->history_mem_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (view->history_cores_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (view->history_events_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (view->history_psi_drawing_area));
-}
+  if (!view->cursor_set)
+    return;
 
+  view->cursor_set = FALSE;
+  tkmv_chart_invalidate (view->history_cpu_chart);
+  tkmv_chart_invalidate (view->history_mem_chart);
+  tkmv_chart_invalidate (view->history_psi_chart);
+  tkmv_chart_reset_viewport (view->history_cores_chart);
+  tkmv_chart_reset_viewport (view->history_events_chart);
+}
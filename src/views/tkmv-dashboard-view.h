@@ -28,5 +28,9 @@ G_DECLARE_FINAL_TYPE (TkmvDashboardView, tkmv_dashboard_view, TKMV,
                       DASHBOARD_VIEW, GtkBox)
 
 void tkmv_dashboard_view_update_content (TkmvDashboardView *view);
+void tkmv_dashboard_view_update_charts (TkmvDashboardView *view);
+void tkmv_dashboard_view_set_cursor (TkmvDashboardView *view, double min,
+                                     double max);
+void tkmv_dashboard_view_clear_cursor (TkmvDashboardView *view);
 
 G_END_DECLS
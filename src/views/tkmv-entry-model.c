@@ -0,0 +1,814 @@
+/* tkmv-entry-model.c
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tkmv-entry-model.h"
+#include "tkm-task.h"
+#include "tkmv-application.h"
+#include "tkmv-types.h"
+
+#include <string.h>
+
+/*
+ * Iterators keep the index of the entry in user_data, the position of
+ * the row in user_data2.
+ */
+#define ITER_ENTRY(iter) (GPOINTER_TO_UINT ((iter)->user_data))
+#define ITER_POSITION(iter) (GPOINTER_TO_UINT ((iter)->user_data2))
+
+/* Tables up to this many rows are sorted inline on the main thread */
+#define ENTRY_MODEL_SORT_INLINE_ROWS (512)
+
+/* Sort keys of one column for every entry of the snapshot */
+typedef struct _EntryModelKeys {
+  guint len;
+  gchar **text;
+  gdouble *number;
+} EntryModelKeys;
+
+typedef struct _EntryModelSortJob {
+  TkmTask parent;
+
+  TkmvEntryModel *model;
+  GPtrArray *entries;
+  TkmvEntryModelGetFunc get_func;
+  gint stamp;
+  guint serial;
+
+  guint n_sort;
+  gint columns[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  GType types[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  GtkSortType orders[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  EntryModelKeys *keys[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  gboolean keys_built[TKMV_ENTRY_MODEL_SORT_DEPTH];
+
+  guint *order;
+  TaskStatusType status;
+} EntryModelSortJob;
+
+typedef struct _EntryModelSortData {
+  guint n_sort;
+  EntryModelKeys **keys;
+  const GtkSortType *orders;
+} EntryModelSortData;
+
+struct _TkmvEntryModel {
+  GObject parent_instance;
+
+  gint n_columns;
+  GType *types;
+  TkmvEntryModelGetFunc get_func;
+  GBoxedCopyFunc ref_func;
+  GDestroyNotify unref_func;
+
+  /* Referenced entries in load order and the entry shown at each row */
+  GPtrArray *entries;
+  guint *order;
+  gint stamp;
+
+  /* Sort keys per column, built once per snapshot on first use */
+  EntryModelKeys **keys;
+
+  /* Sort columns by priority, the first one is the sortable column */
+  guint n_sort;
+  gint sort_columns[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  GtkSortType sort_orders[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  guint sort_serial;
+  gboolean sort_pending;
+};
+
+static void tkmv_entry_model_tree_model_init (GtkTreeModelIface *iface);
+static void tkmv_entry_model_tree_sortable_init (GtkTreeSortableIface *iface);
+
+static void entry_model_iter_set (TkmvEntryModel *model, GtkTreeIter *iter,
+                                  guint position);
+static void entry_model_keys_clear (TkmvEntryModel *model);
+static void entry_model_sort (TkmvEntryModel *model, gboolean notify);
+static gboolean entry_model_sort_exec (TkmTask *task, gpointer context);
+static void entry_model_sort_status (TaskStatusType status, TkmTask *task);
+static gboolean entry_model_sort_complete_invoke (gpointer _job);
+
+G_DEFINE_TYPE_WITH_CODE (
+  TkmvEntryModel, tkmv_entry_model, G_TYPE_OBJECT,
+  G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL,
+                         tkmv_entry_model_tree_model_init)
+    G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_SORTABLE,
+                           tkmv_entry_model_tree_sortable_init))
+
+static void
+tkmv_entry_model_finalize (GObject *object)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (object);
+
+  entry_model_keys_clear (model);
+
+  g_clear_pointer (&model->entries, g_ptr_array_unref);
+  g_free (model->order);
+  g_free (model->keys);
+  g_free (model->types);
+
+  G_OBJECT_CLASS (tkmv_entry_model_parent_class)->finalize (object);
+}
+
+static void
+tkmv_entry_model_class_init (TkmvEntryModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = tkmv_entry_model_finalize;
+}
+
+static void
+tkmv_entry_model_init (TkmvEntryModel *self)
+{
+  self->stamp = g_random_int ();
+}
+
+static void
+entry_model_iter_set (TkmvEntryModel *model, GtkTreeIter *iter,
+                      guint position)
+{
+  iter->stamp = model->stamp;
+  iter->user_data = GUINT_TO_POINTER (model->order[position]);
+  iter->user_data2 = GUINT_TO_POINTER (position);
+  iter->user_data3 = NULL;
+}
+
+static guint
+entry_model_length (TkmvEntryModel *model)
+{
+  return model->entries != NULL ? model->entries->len : 0;
+}
+
+static GtkTreeModelFlags
+entry_model_get_flags (GtkTreeModel *tree_model)
+{
+  TKMV_UNUSED (tree_model);
+  return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint
+entry_model_get_n_columns (GtkTreeModel *tree_model)
+{
+  return TKMV_ENTRY_MODEL (tree_model)->n_columns;
+}
+
+static GType
+entry_model_get_column_type (GtkTreeModel *tree_model, gint index)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+
+  g_return_val_if_fail (index >= 0 && index < model->n_columns,
+                        G_TYPE_INVALID);
+
+  return model->types[index];
+}
+
+static gboolean
+entry_model_get_iter (GtkTreeModel *tree_model, GtkTreeIter *iter,
+                      GtkTreePath *path)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+  gint position;
+
+  if (gtk_tree_path_get_depth (path) != 1)
+    return FALSE;
+
+  position = gtk_tree_path_get_indices (path)[0];
+  if (position < 0 || (guint)position >= entry_model_length (model))
+    return FALSE;
+
+  entry_model_iter_set (model, iter, (guint)position);
+
+  return TRUE;
+}
+
+static GtkTreePath *
+entry_model_get_path (GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+
+  g_return_val_if_fail (iter->stamp == model->stamp, NULL);
+
+  return gtk_tree_path_new_from_indices ((gint)ITER_POSITION (iter), -1);
+}
+
+static void
+entry_model_get_value (GtkTreeModel *tree_model, GtkTreeIter *iter,
+                       gint column, GValue *value)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+
+  g_return_if_fail (iter->stamp == model->stamp);
+  g_return_if_fail (column >= 0 && column < model->n_columns);
+
+  g_value_init (value, model->types[column]);
+  model->get_func (g_ptr_array_index (model->entries, ITER_ENTRY (iter)),
+                   column, value);
+}
+
+static gboolean
+entry_model_iter_next (GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+  guint position = ITER_POSITION (iter) + 1;
+
+  if (iter->stamp != model->stamp || position >= entry_model_length (model))
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  entry_model_iter_set (model, iter, position);
+
+  return TRUE;
+}
+
+static gboolean
+entry_model_iter_previous (GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+  guint position = ITER_POSITION (iter);
+
+  if (iter->stamp != model->stamp || position == 0)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  entry_model_iter_set (model, iter, position - 1);
+
+  return TRUE;
+}
+
+static gboolean
+entry_model_iter_nth_child (GtkTreeModel *tree_model, GtkTreeIter *iter,
+                            GtkTreeIter *parent, gint n)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (tree_model);
+
+  if (parent != NULL || n < 0 || (guint)n >= entry_model_length (model))
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  entry_model_iter_set (model, iter, (guint)n);
+
+  return TRUE;
+}
+
+static gboolean
+entry_model_iter_children (GtkTreeModel *tree_model, GtkTreeIter *iter,
+                           GtkTreeIter *parent)
+{
+  return entry_model_iter_nth_child (tree_model, iter, parent, 0);
+}
+
+static gboolean
+entry_model_iter_has_child (GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  TKMV_UNUSED (tree_model);
+  TKMV_UNUSED (iter);
+  return FALSE;
+}
+
+static gint
+entry_model_iter_n_children (GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+  if (iter != NULL)
+    return 0;
+
+  return (gint)entry_model_length (TKMV_ENTRY_MODEL (tree_model));
+}
+
+static gboolean
+entry_model_iter_parent (GtkTreeModel *tree_model, GtkTreeIter *iter,
+                         GtkTreeIter *child)
+{
+  TKMV_UNUSED (tree_model);
+  TKMV_UNUSED (child);
+  iter->stamp = 0;
+  return FALSE;
+}
+
+static void
+tkmv_entry_model_tree_model_init (GtkTreeModelIface *iface)
+{
+  iface->get_flags = entry_model_get_flags;
+  iface->get_n_columns = entry_model_get_n_columns;
+  iface->get_column_type = entry_model_get_column_type;
+  iface->get_iter = entry_model_get_iter;
+  iface->get_path = entry_model_get_path;
+  iface->get_value = entry_model_get_value;
+  iface->iter_next = entry_model_iter_next;
+  iface->iter_previous = entry_model_iter_previous;
+  iface->iter_children = entry_model_iter_children;
+  iface->iter_has_child = entry_model_iter_has_child;
+  iface->iter_n_children = entry_model_iter_n_children;
+  iface->iter_nth_child = entry_model_iter_nth_child;
+  iface->iter_parent = entry_model_iter_parent;
+}
+
+static void
+entry_model_keys_free (gpointer data)
+{
+  EntryModelKeys *keys = (EntryModelKeys *)data;
+
+  if (keys->text != NULL)
+    {
+      for (guint i = 0; i < keys->len; i++)
+        g_free (keys->text[i]);
+      g_free (keys->text);
+    }
+
+  g_free (keys->number);
+}
+
+static void
+entry_model_keys_release (EntryModelKeys *keys)
+{
+  if (keys != NULL)
+    g_atomic_rc_box_release_full (keys, entry_model_keys_free);
+}
+
+static void
+entry_model_keys_clear (TkmvEntryModel *model)
+{
+  if (model->keys == NULL)
+    return;
+
+  for (gint i = 0; i < model->n_columns; i++)
+    g_clear_pointer (&model->keys[i], entry_model_keys_release);
+}
+
+/*
+ * Collation keys for text and raw values for numbers, so comparing two
+ * rows is a strcmp or a subtraction instead of reading two GValues and
+ * collating UTF-8 on every comparison.
+ */
+static EntryModelKeys *
+entry_model_keys_new (GPtrArray *entries, TkmvEntryModelGetFunc get_func,
+                      gint column, GType type)
+{
+  EntryModelKeys *keys = g_atomic_rc_box_new0 (EntryModelKeys);
+  gboolean text = g_type_is_a (type, G_TYPE_STRING);
+
+  keys->len = entries->len;
+  if (text)
+    keys->text = g_new0 (gchar *, entries->len);
+  else
+    keys->number = g_new0 (gdouble, entries->len);
+
+  for (guint i = 0; i < entries->len; i++)
+    {
+      GValue value = G_VALUE_INIT;
+
+      g_value_init (&value, type);
+      get_func (g_ptr_array_index (entries, i), column, &value);
+
+      if (text)
+        {
+          const gchar *str = g_value_get_string (&value);
+
+          if (str != NULL)
+            keys->text[i] = g_utf8_collate_key (str, -1);
+        }
+      else
+        {
+          GValue number = G_VALUE_INIT;
+
+          g_value_init (&number, G_TYPE_DOUBLE);
+          if (g_value_transform (&value, &number))
+            keys->number[i] = g_value_get_double (&number);
+          g_value_unset (&number);
+        }
+
+      g_value_unset (&value);
+    }
+
+  return keys;
+}
+
+static gint
+entry_model_order_compare (gconstpointer a, gconstpointer b, gpointer data)
+{
+  EntryModelSortData *sort_data = (EntryModelSortData *)data;
+  guint ia = *(const guint *)a;
+  guint ib = *(const guint *)b;
+
+  for (guint k = 0; k < sort_data->n_sort; k++)
+    {
+      EntryModelKeys *keys = sort_data->keys[k];
+      gint ret = 0;
+
+      if (keys->text != NULL)
+        {
+          /* NULL text sorts first */
+          if (keys->text[ia] == NULL || keys->text[ib] == NULL)
+            ret = (keys->text[ia] != NULL) - (keys->text[ib] != NULL);
+          else
+            ret = strcmp (keys->text[ia], keys->text[ib]);
+        }
+      else if (keys->number[ia] != keys->number[ib])
+        {
+          ret = (keys->number[ia] > keys->number[ib]) ? 1 : -1;
+        }
+
+      if (ret != 0)
+        return (sort_data->orders[k] == GTK_SORT_DESCENDING) ? -ret : ret;
+    }
+
+  /* Equal rows keep their load order */
+  return (ia > ib) - (ia < ib);
+}
+
+static guint *
+entry_model_order_new (guint length, guint n_sort, EntryModelKeys **keys,
+                       const GtkSortType *orders)
+{
+  EntryModelSortData sort_data
+    = { .n_sort = n_sort, .keys = keys, .orders = orders };
+  guint *order = g_new (guint, MAX (length, 1));
+
+  for (guint i = 0; i < length; i++)
+    order[i] = i;
+
+  if (n_sort > 0 && length > 1)
+    g_qsort_with_data (order, (gint)length, sizeof (guint),
+                       entry_model_order_compare, &sort_data);
+
+  return order;
+}
+
+/* Take over a permutation of the rows and tell the views about it */
+static void
+entry_model_order_apply (TkmvEntryModel *model, guint *order, gboolean notify)
+{
+  guint length = entry_model_length (model);
+  g_autofree guint *positions = NULL;
+  g_autofree gint *new_order = NULL;
+  g_autoptr (GtkTreePath) path = NULL;
+
+  if (!notify || length == 0)
+    {
+      g_free (model->order);
+      model->order = order;
+      return;
+    }
+
+  positions = g_new (guint, length);
+  for (guint i = 0; i < length; i++)
+    positions[model->order[i]] = i;
+
+  new_order = g_new (gint, length);
+  for (guint i = 0; i < length; i++)
+    new_order[i] = (gint)positions[order[i]];
+
+  g_free (model->order);
+  model->order = order;
+
+  path = gtk_tree_path_new ();
+  gtk_tree_model_rows_reordered (GTK_TREE_MODEL (model), path, NULL,
+                                 new_order);
+}
+
+static void
+entry_model_sort_inline (TkmvEntryModel *model, gboolean notify)
+{
+  EntryModelKeys *keys[TKMV_ENTRY_MODEL_SORT_DEPTH] = { NULL };
+
+  for (guint k = 0; k < model->n_sort; k++)
+    {
+      gint column = model->sort_columns[k];
+
+      if (model->keys[column] == NULL)
+        model->keys[column]
+          = entry_model_keys_new (model->entries, model->get_func, column,
+                                  model->types[column]);
+
+      keys[k] = model->keys[column];
+    }
+
+  entry_model_order_apply (model,
+                           entry_model_order_new (entry_model_length (model),
+                                                  model->n_sort, keys,
+                                                  model->sort_orders),
+                           notify);
+}
+
+static void
+entry_model_sort_job_free (EntryModelSortJob *job)
+{
+  for (guint k = 0; k < job->n_sort; k++)
+    entry_model_keys_release (job->keys[k]);
+
+  g_ptr_array_unref (job->entries);
+  g_object_unref (job->model);
+  g_free (job->order);
+  tkm_task_clear (TKM_TASK (job));
+  g_free (job);
+}
+
+static void
+entry_model_sort (TkmvEntryModel *model, gboolean notify)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  guint length = entry_model_length (model);
+  EntryModelSortJob *job = NULL;
+
+  model->sort_serial++;
+
+  if (length <= ENTRY_MODEL_SORT_INLINE_ROWS || model->n_sort == 0)
+    {
+      entry_model_sort_inline (model, notify);
+      return;
+    }
+
+  /* The completion sorts again if the inputs changed in the meantime */
+  if (model->sort_pending)
+    return;
+
+  job = g_new0 (EntryModelSortJob, 1);
+  job->model = g_object_ref (model);
+  job->entries = g_ptr_array_ref (model->entries);
+  job->get_func = model->get_func;
+  job->stamp = model->stamp;
+  job->serial = model->sort_serial;
+  job->n_sort = model->n_sort;
+
+  for (guint k = 0; k < model->n_sort; k++)
+    {
+      gint column = model->sort_columns[k];
+
+      job->columns[k] = column;
+      job->types[k] = model->types[column];
+      job->orders[k] = model->sort_orders[k];
+      if (model->keys[column] != NULL)
+        job->keys[k] = g_atomic_rc_box_acquire (model->keys[column]);
+    }
+
+  tkm_task_init (TKM_TASK (job), entry_model_sort_status,
+                 entry_model_sort_exec);
+
+  model->sort_pending = TRUE;
+  if (!tkm_task_run (TKM_TASK (job), context->taskpool))
+    {
+      g_warning ("Fail to queue table sort");
+      model->sort_pending = FALSE;
+      entry_model_sort_job_free (job);
+      entry_model_sort_inline (model, notify);
+    }
+}
+
+static gboolean
+entry_model_sort_exec (TkmTask *task, gpointer context)
+{
+  EntryModelSortJob *job = (EntryModelSortJob *)task;
+
+  TKMV_UNUSED (context);
+  g_assert (job);
+
+  /* The entries are referenced and never change once loaded */
+  for (guint k = 0; k < job->n_sort; k++)
+    {
+      if (job->keys[k] != NULL)
+        continue;
+
+      job->keys[k] = entry_model_keys_new (job->entries, job->get_func,
+                                           job->columns[k], job->types[k]);
+      job->keys_built[k] = TRUE;
+    }
+
+  job->order = entry_model_order_new (job->entries->len, job->n_sort,
+                                      job->keys, job->orders);
+
+  return TRUE;
+}
+
+static void
+entry_model_sort_status (TaskStatusType status, TkmTask *task)
+{
+  EntryModelSortJob *job = (EntryModelSortJob *)task;
+
+  g_assert (job);
+
+  job->status = status;
+  g_main_context_invoke (NULL, entry_model_sort_complete_invoke, job);
+}
+
+static gboolean
+entry_model_sort_complete_invoke (gpointer _job)
+{
+  EntryModelSortJob *job = (EntryModelSortJob *)_job;
+  TkmvEntryModel *model = NULL;
+
+  g_assert (job);
+
+  /* The worker still signals the task after the status callback returns */
+  tkm_task_wait (TKM_TASK (job));
+
+  model = job->model;
+  model->sort_pending = FALSE;
+
+  if (job->status == TASK_STATUS_COMPLETE && job->stamp == model->stamp)
+    {
+      for (guint k = 0; k < job->n_sort; k++)
+        if (job->keys_built[k] && model->keys[job->columns[k]] == NULL)
+          model->keys[job->columns[k]]
+            = g_atomic_rc_box_acquire (job->keys[k]);
+
+      if (job->serial == model->sort_serial)
+        {
+          entry_model_order_apply (model, g_steal_pointer (&job->order),
+                                   TRUE);
+          entry_model_sort_job_free (job);
+          return FALSE;
+        }
+    }
+
+  if (job->stamp != model->stamp || job->serial != model->sort_serial)
+    entry_model_sort (model, TRUE);
+
+  entry_model_sort_job_free (job);
+
+  return FALSE;
+}
+
+static void
+entry_model_sort_columns_set (TkmvEntryModel *model, guint n_sort,
+                              const gint *columns, const GtkSortType *orders)
+{
+  model->n_sort = MIN (n_sort, TKMV_ENTRY_MODEL_SORT_DEPTH);
+  for (guint k = 0; k < model->n_sort; k++)
+    {
+      model->sort_columns[k] = columns[k];
+      model->sort_orders[k] = orders[k];
+    }
+
+  gtk_tree_sortable_sort_column_changed (GTK_TREE_SORTABLE (model));
+  entry_model_sort (model, TRUE);
+}
+
+static gboolean
+entry_model_get_sort_column_id (GtkTreeSortable *sortable,
+                                gint *sort_column_id, GtkSortType *order)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (sortable);
+
+  if (sort_column_id != NULL)
+    *sort_column_id = model->n_sort > 0
+                        ? model->sort_columns[0]
+                        : GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+
+  if (order != NULL)
+    *order = model->n_sort > 0 ? model->sort_orders[0] : GTK_SORT_ASCENDING;
+
+  return model->n_sort > 0;
+}
+
+/*
+ * Choosing a column makes it the primary sort column, the previously
+ * chosen ones stay as tie breakers in the order they were chosen.
+ */
+static void
+entry_model_set_sort_column_id (GtkTreeSortable *sortable,
+                                gint sort_column_id, GtkSortType order)
+{
+  TkmvEntryModel *model = TKMV_ENTRY_MODEL (sortable);
+  gint columns[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  GtkSortType orders[TKMV_ENTRY_MODEL_SORT_DEPTH];
+  guint n_sort = 0;
+
+  g_return_if_fail (sort_column_id < model->n_columns);
+
+  if (sort_column_id < 0)
+    {
+      entry_model_sort_columns_set (model, 0, columns, orders);
+      return;
+    }
+
+  if (model->n_sort > 0 && model->sort_columns[0] == sort_column_id
+      && model->sort_orders[0] == order)
+    return;
+
+  columns[n_sort] = sort_column_id;
+  orders[n_sort++] = order;
+
+  for (guint k = 0; k < model->n_sort && n_sort < TKMV_ENTRY_MODEL_SORT_DEPTH;
+       k++)
+    {
+      if (model->sort_columns[k] == sort_column_id)
+        continue;
+
+      columns[n_sort] = model->sort_columns[k];
+      orders[n_sort++] = model->sort_orders[k];
+    }
+
+  entry_model_sort_columns_set (model, n_sort, columns, orders);
+}
+
+static gboolean
+entry_model_has_default_sort_func (GtkTreeSortable *sortable)
+{
+  TKMV_UNUSED (sortable);
+  return FALSE;
+}
+
+/* Columns sort by their values, custom compare functions are not used */
+static void
+tkmv_entry_model_tree_sortable_init (GtkTreeSortableIface *iface)
+{
+  iface->get_sort_column_id = entry_model_get_sort_column_id;
+  iface->set_sort_column_id = entry_model_set_sort_column_id;
+  iface->has_default_sort_func = entry_model_has_default_sort_func;
+}
+
+TkmvEntryModel *
+tkmv_entry_model_new (gint n_columns, const GType *types,
+                      TkmvEntryModelGetFunc get_func, GBoxedCopyFunc ref_func,
+                      GDestroyNotify unref_func)
+{
+  TkmvEntryModel *model = g_object_new (TKMV_TYPE_ENTRY_MODEL, NULL);
+
+  g_assert (n_columns > 0);
+  g_assert (types);
+  g_assert (get_func);
+
+  model->n_columns = n_columns;
+  model->types = g_memdup2 (types, sizeof (GType) * (gsize)n_columns);
+  model->get_func = get_func;
+  model->ref_func = ref_func;
+  model->unref_func = unref_func;
+  model->keys = g_new0 (EntryModelKeys *, n_columns);
+
+  return model;
+}
+
+void
+tkmv_entry_model_set_entries (TkmvEntryModel *model, GPtrArray *entries,
+                              guint first, guint count)
+{
+  g_return_if_fail (TKMV_IS_ENTRY_MODEL (model));
+  g_return_if_fail (entries != NULL);
+  g_return_if_fail (first + count <= entries->len);
+
+  g_clear_pointer (&model->entries, g_ptr_array_unref);
+  g_free (model->order);
+
+  model->entries = g_ptr_array_new_full (count, model->unref_func);
+  for (guint i = 0; i < count; i++)
+    {
+      gpointer entry = g_ptr_array_index (entries, first + i);
+
+      g_ptr_array_add (model->entries, model->ref_func != NULL
+                                         ? model->ref_func (entry)
+                                         : entry);
+    }
+
+  model->order = g_new (guint, MAX (count, 1));
+  for (guint i = 0; i < count; i++)
+    model->order[i] = i;
+
+  model->stamp++;
+  entry_model_keys_clear (model);
+  entry_model_sort (model, FALSE);
+}
+
+gpointer
+tkmv_entry_model_get_entry (TkmvEntryModel *model, GtkTreeIter *iter)
+{
+  g_return_val_if_fail (TKMV_IS_ENTRY_MODEL (model), NULL);
+  g_return_val_if_fail (iter->stamp == model->stamp, NULL);
+
+  return g_ptr_array_index (model->entries, ITER_ENTRY (iter));
+}
+
+void
+tkmv_entry_model_set_sort_columns (TkmvEntryModel *model, guint n_sort,
+                                   const gint *columns,
+                                   const GtkSortType *orders)
+{
+  g_return_if_fail (TKMV_IS_ENTRY_MODEL (model));
+  g_return_if_fail (n_sort <= TKMV_ENTRY_MODEL_SORT_DEPTH);
+
+  for (guint k = 0; k < n_sort; k++)
+    g_return_if_fail (columns[k] >= 0 && columns[k] < model->n_columns);
+
+  entry_model_sort_columns_set (model, n_sort, columns, orders);
+}
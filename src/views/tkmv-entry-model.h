@@ -0,0 +1,67 @@
+/* tkmv-entry-model.h
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Value callback filling a cell of the table from the entry backing its
+ * row. The value is already initialized to the type of the column. It is
+ * called for the rows the view shows and, from a task pool thread, to
+ * build the sort keys of a column, so it must only read the entry.
+ */
+typedef void (*TkmvEntryModelGetFunc) (gpointer entry, gint column,
+                                       GValue *value);
+
+/* Number of columns a table can be sorted by at once */
+#define TKMV_ENTRY_MODEL_SORT_DEPTH (3)
+
+#define TKMV_TYPE_ENTRY_MODEL (tkmv_entry_model_get_type ())
+
+G_DECLARE_FINAL_TYPE (TkmvEntryModel, tkmv_entry_model, TKMV, ENTRY_MODEL,
+                      GObject)
+
+TkmvEntryModel *tkmv_entry_model_new (gint n_columns, const GType *types,
+                                      TkmvEntryModelGetFunc get_func,
+                                      GBoxedCopyFunc ref_func,
+                                      GDestroyNotify unref_func);
+
+/*
+ * Replace the rows of the table with count entries of the array starting
+ * at first. The entries are referenced, the array is not retained. The
+ * model must not be attached to a view while its rows are replaced.
+ */
+void tkmv_entry_model_set_entries (TkmvEntryModel *model, GPtrArray *entries,
+                                   guint first, guint count);
+
+/*
+ * Sort by the given columns in priority order. Sort keys are computed
+ * once per snapshot and large tables are sorted on the task pool, the
+ * rows are reordered when the sort completes.
+ */
+void tkmv_entry_model_set_sort_columns (TkmvEntryModel *model, guint n_sort,
+                                        const gint *columns,
+                                        const GtkSortType *orders);
+
+gpointer tkmv_entry_model_get_entry (TkmvEntryModel *model,
+                                     GtkTreeIter *iter);
+
+G_END_DECLS
@@ -0,0 +1,628 @@
+/* tkmv-process-stats.c
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tkmv-process-stats.h"
+#include "tkm-ctxinfo-entry.h"
+#include "tkm-procacct-entry.h"
+#include "tkm-procinfo-entry.h"
+#include "tkm-task.h"
+#include "tkmv-application.h"
+#include "tkmv-types.h"
+
+#include <math.h>
+
+/* Minimum rows aggregated by a chunk, smaller loads are a single job */
+#define PROCESS_STATS_CHUNK_ROWS (16384)
+
+/* Rows aggregated between two checks of the cancellation token */
+#define PROCESS_STATS_CANCEL_ROWS (4096)
+
+/* Percentile reported next to the average and maximum CPU usage */
+#define PROCESS_STATS_CPU_PERCENTILE (95)
+
+/* Samples of one process or context seen by a chunk */
+typedef struct _ProcessStatsPartial {
+  gpointer first;
+  gpointer last;
+  guint samples;
+  gdouble cpu_sum;
+  glong cpu_max;
+  glong mem_rss_max;
+  glong mem_pss_max;
+  GArray *cpu;
+} ProcessStatsPartial;
+
+/* How the entries of a table are grouped and what is sampled from them */
+typedef struct _ProcessStatsAccess {
+  GHashFunc hash;
+  GEqualFunc equal;
+  GBoxedCopyFunc ref;
+  GDestroyNotify unref;
+  gconstpointer (*key) (gpointer entry);
+  gulong (*timestamp) (gpointer entry);
+  glong (*cpu) (gpointer entry);
+  glong (*mem_rss) (gpointer entry);
+  glong (*mem_pss) (gpointer entry);
+  gpointer (*row_new) (ProcessStatsPartial *partial);
+  GDestroyNotify row_free;
+} ProcessStatsAccess;
+
+typedef struct _ProcessStatsRun ProcessStatsRun;
+
+typedef struct _ProcessStatsChunk {
+  TkmTask parent;
+
+  ProcessStatsRun *run;
+  guint start;
+  guint end;
+  GHashTable *partials;
+} ProcessStatsChunk;
+
+struct _ProcessStatsRun {
+  ProcessStatsSource source;
+  const ProcessStatsAccess *access;
+  GPtrArray *entries;
+
+  TkmTaskGroup *group;
+  guint n_chunks;
+  ProcessStatsChunk **chunks;
+  GPtrArray *rows;
+
+  TkmvProcessStatsFunc func;
+  gpointer user_data;
+  GDestroyNotify user_data_free;
+};
+
+static gboolean process_stats_chunk_exec (TkmTask *task, gpointer context);
+static void process_stats_run_complete (TkmTaskGroup *group,
+                                        gboolean complete, gpointer _run);
+static gboolean process_stats_complete_invoke (gpointer _run);
+
+static void
+process_stats_clear (gpointer data)
+{
+  TkmvProcessStats *stats = (TkmvProcessStats *)data;
+
+  g_free (stats->name);
+  g_free (stats->id);
+}
+
+TkmvProcessStats *
+tkmv_process_stats_ref (TkmvProcessStats *stats)
+{
+  g_assert (stats);
+  return g_atomic_rc_box_acquire (stats);
+}
+
+void
+tkmv_process_stats_unref (TkmvProcessStats *stats)
+{
+  g_assert (stats);
+  g_atomic_rc_box_release_full (stats, process_stats_clear);
+}
+
+static gint
+process_stats_long_compare (gconstpointer a, gconstpointer b)
+{
+  glong la = *(const glong *)a;
+  glong lb = *(const glong *)b;
+
+  return (la > lb) - (la < lb);
+}
+
+static glong
+process_stats_percentile (GArray *values, guint percent)
+{
+  guint rank = 0;
+
+  if (values == NULL || values->len == 0)
+    return 0;
+
+  /* nearest rank */
+  g_array_sort (values, process_stats_long_compare);
+  rank = (values->len * percent + 99) / 100;
+
+  return g_array_index (values, glong, MAX (rank, 1) - 1);
+}
+
+static TkmvProcessStats *
+process_stats_new (ProcessStatsPartial *partial)
+{
+  TkmvProcessStats *stats = g_atomic_rc_box_new0 (TkmvProcessStats);
+
+  stats->samples = partial->samples;
+  stats->cpu_avg = lround (partial->cpu_sum / MAX (partial->samples, 1));
+  stats->cpu_max = partial->cpu_max;
+  stats->cpu_p95
+    = process_stats_percentile (partial->cpu, PROCESS_STATS_CPU_PERCENTILE);
+  stats->mem_rss_max = partial->mem_rss_max;
+  stats->mem_pss_max = partial->mem_pss_max;
+
+  return stats;
+}
+
+static gconstpointer
+procinfo_key (gpointer entry)
+{
+  return GINT_TO_POINTER (
+    tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry, PINFO_DATA_PID));
+}
+
+static gulong
+procinfo_timestamp (gpointer entry)
+{
+  return tkm_procinfo_entry_get_timestamp ((TkmProcInfoEntry *)entry,
+                                           DATA_TIME_SOURCE_MONOTONIC);
+}
+
+static glong
+procinfo_cpu (gpointer entry)
+{
+  return tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry,
+                                      PINFO_DATA_CPU_PERCENT);
+}
+
+static glong
+procinfo_mem_rss (gpointer entry)
+{
+  return tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry,
+                                      PINFO_DATA_MEM_RSS);
+}
+
+static glong
+procinfo_mem_pss (gpointer entry)
+{
+  return tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry,
+                                      PINFO_DATA_MEM_PSS);
+}
+
+static gpointer
+procinfo_row_new (ProcessStatsPartial *partial)
+{
+  TkmProcInfoEntry *first = (TkmProcInfoEntry *)partial->first;
+  TkmProcInfoEntry *last = (TkmProcInfoEntry *)partial->last;
+  TkmvProcessStats *stats = process_stats_new (partial);
+
+  stats->name = g_strdup (tkm_procinfo_entry_get_name (last));
+  stats->id = g_strdup (tkm_procinfo_entry_get_context (last));
+  stats->pid = tkm_procinfo_entry_get_data (last, PINFO_DATA_PID);
+  stats->ppid = tkm_procinfo_entry_get_data (last, PINFO_DATA_PPID);
+  stats->cpu_time
+    = MAX (tkm_procinfo_entry_get_data (last, PINFO_DATA_CPU_TIME)
+             - tkm_procinfo_entry_get_data (first, PINFO_DATA_CPU_TIME),
+           0);
+
+  return stats;
+}
+
+static gconstpointer
+ctxinfo_key (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_id ((TkmCtxInfoEntry *)entry);
+}
+
+static gulong
+ctxinfo_timestamp (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_timestamp ((TkmCtxInfoEntry *)entry,
+                                          DATA_TIME_SOURCE_MONOTONIC);
+}
+
+static glong
+ctxinfo_cpu (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_data ((TkmCtxInfoEntry *)entry,
+                                     CTXINFO_DATA_CPU_PERCENT);
+}
+
+static glong
+ctxinfo_mem_rss (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_data ((TkmCtxInfoEntry *)entry,
+                                     CTXINFO_DATA_MEM_RSS);
+}
+
+static glong
+ctxinfo_mem_pss (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_data ((TkmCtxInfoEntry *)entry,
+                                     CTXINFO_DATA_MEM_PSS);
+}
+
+static gpointer
+ctxinfo_row_new (ProcessStatsPartial *partial)
+{
+  TkmCtxInfoEntry *first = (TkmCtxInfoEntry *)partial->first;
+  TkmCtxInfoEntry *last = (TkmCtxInfoEntry *)partial->last;
+  TkmvProcessStats *stats = process_stats_new (partial);
+
+  stats->name = g_strdup (tkm_ctxinfo_entry_get_name (last));
+  stats->id = g_strdup (tkm_ctxinfo_entry_get_id (last));
+  stats->cpu_time
+    = MAX (tkm_ctxinfo_entry_get_data (last, CTXINFO_DATA_CPU_TIME)
+             - tkm_ctxinfo_entry_get_data (first, CTXINFO_DATA_CPU_TIME),
+           0);
+
+  return stats;
+}
+
+static gconstpointer
+procacct_key (gpointer entry)
+{
+  return GINT_TO_POINTER (
+    tkm_procacct_entry_get_data ((TkmProcAcctEntry *)entry, PACCT_DATA_PID));
+}
+
+static gulong
+procacct_timestamp (gpointer entry)
+{
+  return tkm_procacct_entry_get_timestamp ((TkmProcAcctEntry *)entry,
+                                           DATA_TIME_SOURCE_MONOTONIC);
+}
+
+/* Averages recomputed from the total and count deltas */
+static const TkmProcAcctDataType procacct_delay_avg[][3] = {
+  { PACCT_DATA_CPU_DELAY_AVG, PACCT_DATA_CPU_DELAY_TOTAL,
+    PACCT_DATA_CPU_COUNT },
+  { PACCT_DATA_SWAPIN_DELAY_AVG, PACCT_DATA_SWAPIN_DELAY_TOTAL,
+    PACCT_DATA_SWAPIN_COUNT },
+  { PACCT_DATA_BLKIO_DELAY_AVG, PACCT_DATA_BLKIO_DELAY_TOTAL,
+    PACCT_DATA_BLKIO_COUNT },
+  { PACCT_DATA_FREEPAGE_DELAY_AVG, PACCT_DATA_FREEPAGE_DELAY_TOTAL,
+    PACCT_DATA_FREEPAGE_COUNT },
+  { PACCT_DATA_TRASHING_DELAY_AVG, PACCT_DATA_TRASHING_DELAY_TOTAL,
+    PACCT_DATA_TRASHING_COUNT },
+};
+
+static gpointer
+procacct_row_new (ProcessStatsPartial *partial)
+{
+  TkmProcAcctEntry *first = (TkmProcAcctEntry *)partial->first;
+  TkmProcAcctEntry *last = (TkmProcAcctEntry *)partial->last;
+  TkmProcAcctEntry *entry = tkm_procacct_entry_new ();
+
+  tkm_procacct_entry_set_name (entry, tkm_procacct_entry_get_name (last));
+  for (DataTimeSource t = DATA_TIME_SOURCE_SYSTEM;
+       t <= DATA_TIME_SOURCE_RECEIVE; t++)
+    tkm_procacct_entry_set_timestamp (
+      entry, t, tkm_procacct_entry_get_timestamp (last, t));
+
+  /* Accounting counters are cumulative, the window shows their deltas */
+  for (TkmProcAcctDataType type = PACCT_DATA_PID;
+       type <= PACCT_DATA_TRASHING_DELAY_AVG; type++)
+    {
+      glong value = tkm_procacct_entry_get_data (last, type);
+
+      switch (type)
+        {
+        case PACCT_DATA_PID:
+        case PACCT_DATA_PPID:
+        case PACCT_DATA_UID:
+        case PACCT_DATA_GID:
+        case PACCT_DATA_HIGH_WATER_RSS:
+        case PACCT_DATA_HIGH_WATER_VM:
+          break;
+        default:
+          value = MAX (value - tkm_procacct_entry_get_data (first, type), 0);
+          break;
+        }
+
+      tkm_procacct_entry_set_data (entry, type, value);
+    }
+
+  for (guint i = 0; i < G_N_ELEMENTS (procacct_delay_avg); i++)
+    {
+      glong total
+        = tkm_procacct_entry_get_data (entry, procacct_delay_avg[i][1]);
+      glong count
+        = tkm_procacct_entry_get_data (entry, procacct_delay_avg[i][2]);
+
+      tkm_procacct_entry_set_data (entry, procacct_delay_avg[i][0],
+                                   count > 0 ? total / count : 0);
+    }
+
+  return entry;
+}
+
+static const ProcessStatsAccess process_stats_access[] = {
+  [PROCESS_STATS_SOURCE_PROCINFO] = {
+    g_direct_hash, g_direct_equal,
+    (GBoxedCopyFunc)tkm_procinfo_entry_ref,
+    (GDestroyNotify)tkm_procinfo_entry_unref,
+    procinfo_key, procinfo_timestamp,
+    procinfo_cpu, procinfo_mem_rss, procinfo_mem_pss,
+    procinfo_row_new, (GDestroyNotify)tkmv_process_stats_unref,
+  },
+  [PROCESS_STATS_SOURCE_CTXINFO] = {
+    g_str_hash, g_str_equal,
+    (GBoxedCopyFunc)tkm_ctxinfo_entry_ref,
+    (GDestroyNotify)tkm_ctxinfo_entry_unref,
+    ctxinfo_key, ctxinfo_timestamp,
+    ctxinfo_cpu, ctxinfo_mem_rss, ctxinfo_mem_pss,
+    ctxinfo_row_new, (GDestroyNotify)tkmv_process_stats_unref,
+  },
+  [PROCESS_STATS_SOURCE_PROCACCT] = {
+    g_direct_hash, g_direct_equal,
+    (GBoxedCopyFunc)tkm_procacct_entry_ref,
+    (GDestroyNotify)tkm_procacct_entry_unref,
+    procacct_key, procacct_timestamp,
+    NULL, NULL, NULL,
+    procacct_row_new, (GDestroyNotify)tkm_procacct_entry_unref,
+  },
+};
+
+static ProcessStatsPartial *
+process_stats_partial_new (const ProcessStatsAccess *access, gpointer entry)
+{
+  ProcessStatsPartial *partial = g_new0 (ProcessStatsPartial, 1);
+
+  partial->first = entry;
+  partial->last = entry;
+  if (access->cpu != NULL)
+    partial->cpu = g_array_new (FALSE, FALSE, sizeof (glong));
+
+  return partial;
+}
+
+static void
+process_stats_partial_free (gpointer data)
+{
+  ProcessStatsPartial *partial = (ProcessStatsPartial *)data;
+
+  if (partial->cpu != NULL)
+    g_array_free (partial->cpu, TRUE);
+
+  g_free (partial);
+}
+
+static void
+process_stats_partial_add (const ProcessStatsAccess *access,
+                           ProcessStatsPartial *partial, gpointer entry)
+{
+  gulong timestamp = access->timestamp (entry);
+
+  if (timestamp < access->timestamp (partial->first))
+    partial->first = entry;
+  if (timestamp >= access->timestamp (partial->last))
+    partial->last = entry;
+
+  partial->samples++;
+
+  if (access->cpu != NULL)
+    {
+      glong cpu = access->cpu (entry);
+      glong mem_rss = access->mem_rss (entry);
+      glong mem_pss = access->mem_pss (entry);
+
+      g_array_append_val (partial->cpu, cpu);
+      partial->cpu_sum += cpu;
+      partial->cpu_max = MAX (partial->cpu_max, cpu);
+      partial->mem_rss_max = MAX (partial->mem_rss_max, mem_rss);
+      partial->mem_pss_max = MAX (partial->mem_pss_max, mem_pss);
+    }
+}
+
+static void
+process_stats_partial_merge (const ProcessStatsAccess *access,
+                             ProcessStatsPartial *partial,
+                             ProcessStatsPartial *other)
+{
+  if (access->timestamp (other->first) < access->timestamp (partial->first))
+    partial->first = other->first;
+  if (access->timestamp (other->last) >= access->timestamp (partial->last))
+    partial->last = other->last;
+
+  partial->samples += other->samples;
+  partial->cpu_sum += other->cpu_sum;
+  partial->cpu_max = MAX (partial->cpu_max, other->cpu_max);
+  partial->mem_rss_max = MAX (partial->mem_rss_max, other->mem_rss_max);
+  partial->mem_pss_max = MAX (partial->mem_pss_max, other->mem_pss_max);
+
+  if (partial->cpu != NULL)
+    g_array_append_vals (partial->cpu, other->cpu->data, other->cpu->len);
+}
+
+static gboolean
+process_stats_chunk_exec (TkmTask *task, gpointer context)
+{
+  ProcessStatsChunk *chunk = (ProcessStatsChunk *)task;
+  const ProcessStatsAccess *access = NULL;
+
+  TKMV_UNUSED (context);
+  g_assert (chunk);
+
+  access = chunk->run->access;
+  chunk->partials = g_hash_table_new_full (access->hash, access->equal, NULL,
+                                           process_stats_partial_free);
+
+  for (guint i = chunk->start; i < chunk->end; i++)
+    {
+      gpointer entry = g_ptr_array_index (chunk->run->entries, i);
+      gconstpointer key = access->key (entry);
+      ProcessStatsPartial *partial = NULL;
+
+      /* A newer window or a failed sibling makes the result useless */
+      if ((i - chunk->start) % PROCESS_STATS_CANCEL_ROWS == 0
+          && tkm_task_is_cancelled (task))
+        return FALSE;
+
+      partial = g_hash_table_lookup (chunk->partials, key);
+      if (partial == NULL)
+        {
+          partial = process_stats_partial_new (access, entry);
+          g_hash_table_insert (chunk->partials, (gpointer)key, partial);
+        }
+
+      process_stats_partial_add (access, partial, entry);
+    }
+
+  return TRUE;
+}
+
+/* Fold the partials of every chunk into the first one and build the rows */
+static GPtrArray *
+process_stats_merge (ProcessStatsRun *run)
+{
+  const ProcessStatsAccess *access = run->access;
+  GHashTable *merged = run->chunks[0]->partials;
+  GPtrArray *rows = NULL;
+  GHashTableIter iter;
+  gpointer key = NULL;
+  gpointer value = NULL;
+
+  for (guint c = 1; c < run->n_chunks; c++)
+    {
+      g_hash_table_iter_init (&iter, run->chunks[c]->partials);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          ProcessStatsPartial *partial = g_hash_table_lookup (merged, key);
+
+          if (partial != NULL)
+            {
+              process_stats_partial_merge (access, partial, value);
+              continue;
+            }
+
+          g_hash_table_iter_steal (&iter);
+          g_hash_table_insert (merged, key, value);
+        }
+    }
+
+  rows = g_ptr_array_new_full (g_hash_table_size (merged), access->row_free);
+
+  g_hash_table_iter_init (&iter, merged);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_ptr_array_add (rows, access->row_new (value));
+
+  return rows;
+}
+
+static void
+process_stats_run_complete (TkmTaskGroup *group, gboolean complete,
+                            gpointer _run)
+{
+  ProcessStatsRun *run = (ProcessStatsRun *)_run;
+
+  TKMV_UNUSED (group);
+  g_assert (run);
+
+  /* Runs on the last chunk to complete, it merges the partials of all */
+  if (complete)
+    run->rows = process_stats_merge (run);
+
+  g_main_context_invoke (NULL, process_stats_complete_invoke, run);
+}
+
+static gboolean
+process_stats_complete_invoke (gpointer _run)
+{
+  ProcessStatsRun *run = (ProcessStatsRun *)_run;
+
+  g_assert (run);
+
+  for (guint c = 0; c < run->n_chunks; c++)
+    {
+      ProcessStatsChunk *chunk = run->chunks[c];
+
+      /* The group completes after every chunk was signalled */
+      tkm_task_clear (TKM_TASK (chunk));
+
+      if (chunk->partials != NULL)
+        g_hash_table_destroy (chunk->partials);
+
+      g_free (chunk);
+    }
+
+  run->func (run->source, run->rows, run->user_data);
+
+  if (run->rows != NULL)
+    g_ptr_array_unref (run->rows);
+
+  if (run->user_data_free != NULL)
+    run->user_data_free (run->user_data);
+
+  g_ptr_array_unref (run->entries);
+  tkm_task_group_unref (run->group);
+  g_free (run->chunks);
+  g_free (run);
+
+  return FALSE;
+}
+
+void
+tkmv_process_stats_compute (ProcessStatsSource source, GPtrArray *entries,
+                            TkmTaskGroup *group, TkmvProcessStatsFunc func,
+                            gpointer user_data, GDestroyNotify user_data_free)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  ProcessStatsRun *run = g_new0 (ProcessStatsRun, 1);
+  guint step = 0;
+
+  g_assert (entries);
+  g_assert (func);
+
+  run->source = source;
+  run->access = &process_stats_access[source];
+  run->func = func;
+  run->user_data = user_data;
+  run->user_data_free = user_data_free;
+  /* A group of our own to be notified, cancelled along with the caller's */
+  if (group != NULL)
+    run->group = tkm_task_group_new_with_cancellable (group->cancellable);
+  else
+    run->group = tkm_task_group_new ();
+
+  /* Loads replace the context arrays, the chunks read our own references */
+  run->entries = g_ptr_array_new_full (entries->len, run->access->unref);
+  for (guint i = 0; i < entries->len; i++)
+    g_ptr_array_add (run->entries,
+                     run->access->ref (g_ptr_array_index (entries, i)));
+
+  run->n_chunks = CLAMP (entries->len / PROCESS_STATS_CHUNK_ROWS, 1,
+                         g_get_num_processors ());
+  run->chunks = g_new0 (ProcessStatsChunk *, run->n_chunks);
+  step = (entries->len + run->n_chunks - 1) / run->n_chunks;
+
+  for (guint c = 0; c < run->n_chunks; c++)
+    {
+      ProcessStatsChunk *chunk = g_new0 (ProcessStatsChunk, 1);
+
+      chunk->run = run;
+      chunk->start = MIN (c * step, entries->len);
+      chunk->end = MIN (chunk->start + step, entries->len);
+      run->chunks[c] = chunk;
+
+      tkm_task_init (TKM_TASK (chunk), NULL, process_stats_chunk_exec);
+      tkm_task_set_priority (TKM_TASK (chunk), TASK_PRIORITY_BACKGROUND);
+      tkm_task_group_add (run->group, TKM_TASK (chunk));
+    }
+
+  for (guint c = 0; c < run->n_chunks; c++)
+    {
+      /* A chunk that can't be queued completes failed right away */
+      if (!tkm_task_run (TKM_TASK (run->chunks[c]), context->taskpool))
+        {
+          g_warning ("Fail to queue process statistics");
+          tkm_task_group_cancel (run->group);
+        }
+    }
+
+  /* Every chunk is in the group before it is notified */
+  tkm_task_group_notify (run->group, process_stats_run_complete, run);
+}
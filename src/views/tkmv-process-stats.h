@@ -0,0 +1,72 @@
+/* tkmv-process-stats.h
+ *
+ * Copyright 2022 Alin Popa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "tkm-task.h"
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum _ProcessStatsSource {
+  PROCESS_STATS_SOURCE_PROCINFO,
+  PROCESS_STATS_SOURCE_CTXINFO,
+  PROCESS_STATS_SOURCE_PROCACCT,
+} ProcessStatsSource;
+
+/* Statistics of one process or context over all the loaded samples */
+typedef struct _TkmvProcessStats {
+  gchar *name;
+  gchar *id; /* context name of a process, id of a context */
+  glong pid;
+  glong ppid;
+  guint samples;
+  glong cpu_time;
+  glong cpu_avg;
+  glong cpu_max;
+  glong cpu_p95;
+  glong mem_rss_max;
+  glong mem_pss_max;
+} TkmvProcessStats;
+
+TkmvProcessStats *tkmv_process_stats_ref (TkmvProcessStats *stats);
+void tkmv_process_stats_unref (TkmvProcessStats *stats);
+
+/*
+ * Called on the main thread with the aggregated rows, TkmvProcessStats
+ * for processes and contexts and TkmProcAcctEntry holding the counter
+ * deltas for accounting. The rows are NULL if the computation failed.
+ */
+typedef void (*TkmvProcessStatsFunc) (ProcessStatsSource source,
+                                      GPtrArray *rows, gpointer user_data);
+
+/*
+ * Aggregate the entries per process (per context for ctxinfo) in parallel
+ * background chunks on the task pool. The entries are referenced so the
+ * caller only needs to hold the data lock for the duration of the call.
+ * The chunks share the cancellation token of group if set, cancelling it
+ * fails the computation.
+ */
+void tkmv_process_stats_compute (ProcessStatsSource source,
+                                 GPtrArray *entries, TkmTaskGroup *group,
+                                 TkmvProcessStatsFunc func,
+                                 gpointer user_data,
+                                 GDestroyNotify user_data_free);
+
+G_END_DECLS
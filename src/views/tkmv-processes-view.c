@@ -25,6 +25,9 @@
 #include "tkm-meminfo-entry.h"
 #include "tkm-settings.h"
 #include "tkmv-application.h"
+#include "tkmv-chart.h"
+#include "tkmv-entry-model.h"
+#include "tkmv-process-stats.h"
 #include "tkmv-types.h"
 
 #include "libkplot/kplot.h"
@@ -93,6 +96,63 @@ enum {
   PROCACCT_NUM_COLUMNS
 };
 
+enum {
+  COLUMN_PROCSTATS_NAME,
+  COLUMN_PROCSTATS_PID,
+  COLUMN_PROCSTATS_PPID,
+  COLUMN_PROCSTATS_CONTEXT,
+  COLUMN_PROCSTATS_CPU_TIME,
+  COLUMN_PROCSTATS_CPU_AVG,
+  COLUMN_PROCSTATS_CPU_MAX,
+  COLUMN_PROCSTATS_CPU_P95,
+  COLUMN_PROCSTATS_MEM_RSS_MAX,
+  COLUMN_PROCSTATS_MEM_PSS_MAX,
+  COLUMN_PROCSTATS_SAMPLES,
+  PROCSTATS_NUM_COLUMNS
+};
+
+enum {
+  COLUMN_CTXSTATS_NAME,
+  COLUMN_CTXSTATS_ID,
+  COLUMN_CTXSTATS_CPU_TIME,
+  COLUMN_CTXSTATS_CPU_AVG,
+  COLUMN_CTXSTATS_CPU_MAX,
+  COLUMN_CTXSTATS_CPU_P95,
+  COLUMN_CTXSTATS_MEM_RSS_MAX,
+  COLUMN_CTXSTATS_MEM_PSS_MAX,
+  COLUMN_CTXSTATS_SAMPLES,
+  CTXSTATS_NUM_COLUMNS
+};
+
+/* The chart selection reads the same key columns in both table modes */
+G_STATIC_ASSERT (COLUMN_PROCSTATS_NAME == COLUMN_PROCINFO_NAME);
+G_STATIC_ASSERT (COLUMN_PROCSTATS_PID == COLUMN_PROCINFO_PID);
+G_STATIC_ASSERT (COLUMN_CTXSTATS_NAME == COLUMN_CTXINFO_NAME);
+G_STATIC_ASSERT (COLUMN_CTXSTATS_ID == COLUMN_CTXINFO_ID);
+
+/* Window statistics requested for the tables of a reload */
+typedef struct _ProcessStatsRequest {
+  TkmvProcessesView *view;
+  guint serial;
+} ProcessStatsRequest;
+
+/* Selection of a history chart as captured on the main thread */
+typedef struct _HistorySelection {
+  GList *keys;
+  GDestroyNotify key_free;
+  ProcessChartMode mode;
+  guint top_count;
+} HistorySelection;
+
+/* How the rows of a table map to the series of a history chart */
+typedef struct _HistorySeriesSource {
+  GHashFunc hash;
+  GEqualFunc equal;
+  gconstpointer (*key) (gpointer entry);
+  gulong (*timestamp) (gpointer entry, DataTimeSource source);
+  double (*value) (gpointer entry);
+} HistorySeriesSource;
+
 static void tkmv_processes_view_widgets_init (TkmvProcessesView *self);
 static void procinfo_add_columns (TkmvProcessesView *self);
 static void procinfo_selection_changed (GtkTreeSelection *selection,
@@ -104,56 +164,66 @@ static void procacct_add_columns (TkmvProcessesView *self);
 static void procacct_selection_changed (GtkTreeSelection *selection,
                                         gpointer data);
 static void create_tables (TkmvProcessesView *self);
-
-static void procinfo_list_store_append_entry (GtkListStore *list_store,
-                                              TkmProcInfoEntry *entry,
-                                              GtkTreeIter *iter);
+static void stats_add_columns (GtkTreeView *treeview, const gchar **titles,
+                               guint n_columns, gint expand_column);
+static void tables_set_aggregate (TkmvProcessesView *self,
+                                  gboolean aggregate);
+static void aggregate_toggled (GtkToggleButton *button, gpointer user_data);
+
+static void procinfo_entry_get_value (gpointer entry, gint column,
+                                      GValue *value);
 static void reload_procinfo_entries (TkmvProcessesView *view,
                                      TkmContext *context);
-static void ctxinfo_list_store_append_entry (GtkListStore *list_store,
-                                             TkmCtxInfoEntry *entry,
-                                             GtkTreeIter *iter);
+static void ctxinfo_entry_get_value (gpointer entry, gint column,
+                                     GValue *value);
 static void reload_ctxinfo_entries (TkmvProcessesView *view,
                                     TkmContext *context);
-static void procacct_list_store_append_entry (GtkListStore *list_store,
-                                              TkmProcAcctEntry *entry,
-                                              GtkTreeIter *iter);
+static void procacct_entry_get_value (gpointer entry, gint column,
+                                      GValue *value);
 static void reload_procacct_entries (TkmvProcessesView *view,
                                      TkmContext *context);
-
-static void procinfo_cpu_history_draw_function (GtkDrawingArea *area,
-                                                cairo_t *cr, int width,
-                                                int height, gpointer data);
-static void procinfo_mem_history_draw_function (GtkDrawingArea *area,
-                                                cairo_t *cr, int width,
-                                                int height, gpointer data);
-static void procinfo_cpu_history_draw_function_safe (GtkDrawingArea *area,
-                                                     cairo_t *cr, int width,
-                                                     int height,
-                                                     gpointer data);
-static void procinfo_mem_history_draw_function_safe (GtkDrawingArea *area,
-                                                     cairo_t *cr, int width,
-                                                     int height,
-                                                     gpointer data);
-static void ctxinfo_cpu_history_draw_function (GtkDrawingArea *area,
-                                               cairo_t *cr, int width,
-                                               int height, gpointer data);
-static void ctxinfo_mem_history_draw_function (GtkDrawingArea *area,
-                                               cairo_t *cr, int width,
-                                               int height, gpointer data);
-static void ctxinfo_cpu_history_draw_function_safe (GtkDrawingArea *area,
-                                                    cairo_t *cr, int width,
-                                                    int height, gpointer data);
-static void ctxinfo_mem_history_draw_function_safe (GtkDrawingArea *area,
-                                                    cairo_t *cr, int width,
-                                                    int height, gpointer data);
+static void procstats_entry_get_value (gpointer entry, gint column,
+                                       GValue *value);
+static void ctxstats_entry_get_value (gpointer entry, gint column,
+                                      GValue *value);
+static void reload_stats_reset (TkmvProcessesView *view);
+static gboolean reload_tables_slice (TkmvProcessesView *view,
+                                     TkmContext *context, guint slice);
+static void processes_charts_reset (TkmvProcessesView *view);
+static void reload_stats_entries (TkmvProcessesView *view,
+                                  ProcessStatsSource source,
+                                  GPtrArray *entries);
+static void stats_entries_ready (ProcessStatsSource source, GPtrArray *rows,
+                                 gpointer user_data);
+
+static gpointer procinfo_selection_snapshot (gpointer data);
+static gpointer ctxinfo_selection_snapshot (gpointer data);
+static void history_selection_free (gpointer data);
+static struct kplot *procinfo_cpu_history_build_function (gpointer data);
+static struct kplot *procinfo_mem_history_build_function (gpointer data);
+static struct kplot *ctxinfo_cpu_history_build_function (gpointer data);
+static struct kplot *ctxinfo_mem_history_build_function (gpointer data);
+static void history_viewport_changed (TkmvChart *chart, gboolean reset,
+                                      double min, double max,
+                                      gpointer user_data);
+static void history_hover_changed (TkmvChart *chart, gboolean active,
+                                   double x, gpointer user_data);
+static void history_settings_changed (GSettings *gsettings, gchar *key,
+                                      gpointer user_data);
 
 struct _TkmvProcessesView {
   GtkBox parent_instance;
 
-  GtkListStore *procinfo_store;
-  GtkListStore *ctxinfo_store;
-  GtkListStore *procacct_store;
+  TkmvEntryModel *procinfo_model;
+  TkmvEntryModel *ctxinfo_model;
+  TkmvEntryModel *procacct_model;
+  TkmvEntryModel *procstats_model;
+  TkmvEntryModel *ctxstats_model;
+
+  /* Tables aggregate the whole loaded window instead of its first sample */
+  gboolean aggregate;
+  guint stats_serial;
+  TkmTaskGroup *stats_group;
 
   /* Template widgets */
   GtkScrolledWindow *procinfo_scrolled_window;
@@ -172,6 +242,12 @@ struct _TkmvProcessesView {
   GtkDrawingArea *ctxinfo_history_cpu_drawing_area;
   GtkDrawingArea *ctxinfo_history_mem_drawing_area;
 
+  /* Offscreen rendered charts */
+  TkmvChart *procinfo_history_cpu_chart;
+  TkmvChart *procinfo_history_mem_chart;
+  TkmvChart *ctxinfo_history_cpu_chart;
+  TkmvChart *ctxinfo_history_mem_chart;
+
   GtkLabel *procinfo_cpu_entry1_label;
   GtkLabel *procinfo_cpu_entry2_label;
   GtkLabel *procinfo_cpu_entry3_label;
@@ -197,11 +273,39 @@ struct _TkmvProcessesView {
 
 G_DEFINE_TYPE (TkmvProcessesView, tkmv_processes_view, GTK_TYPE_BOX)
 
+static void
+tkmv_processes_view_finalize (GObject *object)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)object;
+
+  tkmv_chart_unref (self->procinfo_history_cpu_chart);
+  tkmv_chart_unref (self->procinfo_history_mem_chart);
+  tkmv_chart_unref (self->ctxinfo_history_cpu_chart);
+  tkmv_chart_unref (self->ctxinfo_history_mem_chart);
+
+  if (self->stats_group != NULL)
+    {
+      tkm_task_group_cancel (self->stats_group);
+      tkm_task_group_unref (self->stats_group);
+    }
+
+  g_clear_object (&self->procinfo_model);
+  g_clear_object (&self->ctxinfo_model);
+  g_clear_object (&self->procacct_model);
+  g_clear_object (&self->procstats_model);
+  g_clear_object (&self->ctxstats_model);
+
+  G_OBJECT_CLASS (tkmv_processes_view_parent_class)->finalize (object);
+}
+
 static void
 tkmv_processes_view_class_init (TkmvProcessesViewClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  object_class->finalize = tkmv_processes_view_finalize;
+
   gtk_widget_class_set_template_from_resource (
     widget_class,
     "/ro/fxdata/taskmonitor/viewer/gtk/tkmv-processes-view.ui");
@@ -277,6 +381,9 @@ tkmv_processes_view_class_init (TkmvProcessesViewClass *klass)
                                         ctxinfo_mem_entry4_label);
   gtk_widget_class_bind_template_child (widget_class, TkmvProcessesView,
                                         ctxinfo_mem_entry5_label);
+
+  /* Bind callbacks */
+  gtk_widget_class_bind_template_callback (widget_class, aggregate_toggled);
 }
 
 static void
@@ -289,24 +396,131 @@ tkmv_processes_view_init (TkmvProcessesView *self)
 static void
 tkmv_processes_view_widgets_init (TkmvProcessesView *self)
 {
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+
+  tkm_context_register_view (
+    tkmv_application_get_context (tkmv_application_instance ()),
+    "processes",
+    EPOOL_TABLE_BIT (EPOOL_TABLE_PROCINFO)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_CTXINFO)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_PROCACCT));
+
   create_tables (self);
 
-  gtk_drawing_area_set_draw_func (self->procinfo_history_cpu_drawing_area,
-                                  procinfo_cpu_history_draw_function_safe,
-                                  self, NULL);
-  gtk_drawing_area_set_draw_func (self->procinfo_history_mem_drawing_area,
-                                  procinfo_mem_history_draw_function_safe,
-                                  self, NULL);
-  gtk_drawing_area_set_draw_func (self->ctxinfo_history_cpu_drawing_area,
-                                  ctxinfo_cpu_history_draw_function_safe, self,
-                                  NULL);
-  gtk_drawing_area_set_draw_func (self->ctxinfo_history_mem_drawing_area,
-                                  ctxinfo_mem_history_draw_function_safe, self,
-                                  NULL);
+  self->procinfo_history_cpu_chart = tkmv_chart_new (
+    self->procinfo_history_cpu_drawing_area,
+    procinfo_cpu_history_build_function, procinfo_selection_snapshot,
+    history_selection_free, self);
+  self->procinfo_history_mem_chart = tkmv_chart_new (
+    self->procinfo_history_mem_drawing_area,
+    procinfo_mem_history_build_function, procinfo_selection_snapshot,
+    history_selection_free, self);
+  self->ctxinfo_history_cpu_chart = tkmv_chart_new (
+    self->ctxinfo_history_cpu_drawing_area,
+    ctxinfo_cpu_history_build_function, ctxinfo_selection_snapshot,
+    history_selection_free, self);
+  self->ctxinfo_history_mem_chart = tkmv_chart_new (
+    self->ctxinfo_history_mem_drawing_area,
+    ctxinfo_mem_history_build_function, ctxinfo_selection_snapshot,
+    history_selection_free, self);
+
+  tkmv_chart_set_viewport_func (self->procinfo_history_cpu_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->procinfo_history_mem_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->ctxinfo_history_cpu_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_viewport_func (self->ctxinfo_history_mem_chart,
+                                history_viewport_changed, self);
+  tkmv_chart_set_hover_func (self->procinfo_history_cpu_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->procinfo_history_mem_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->ctxinfo_history_cpu_chart,
+                             history_hover_changed, self);
+  tkmv_chart_set_hover_func (self->ctxinfo_history_mem_chart,
+                             history_hover_changed, self);
+
+  g_signal_connect_object (settings->gsettings, "changed::process-chart-mode",
+                           G_CALLBACK (history_settings_changed), self, 0);
+  g_signal_connect_object (settings->gsettings,
+                           "changed::process-chart-top-count",
+                           G_CALLBACK (history_settings_changed), self, 0);
+
   /* ProcAcct tab is optional */
   gtk_widget_set_visible (GTK_WIDGET (self->procacct_scrolled_window), FALSE);
 }
 
+static void
+history_viewport_changed (TkmvChart *chart, gboolean reset, double min,
+                          double max, gpointer user_data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)user_data;
+  TkmvChart *charts[] = {
+    self->procinfo_history_cpu_chart,
+    self->procinfo_history_mem_chart,
+    self->ctxinfo_history_cpu_chart,
+    self->ctxinfo_history_mem_chart,
+  };
+
+  /*
+   * Process charts share the time axis of the loaded window. They zoom and
+   * pan together within it, the process tables pin the window start so no
+   * additional data is fetched for them.
+   */
+  for (guint i = 0; i < G_N_ELEMENTS (charts); i++)
+    {
+      if (charts[i] == chart)
+        continue;
+
+      if (reset)
+        tkmv_chart_reset_viewport (charts[i]);
+      else
+        tkmv_chart_set_viewport (charts[i], min, max);
+    }
+}
+
+static void
+history_hover_changed (TkmvChart *chart, gboolean active, double x,
+                       gpointer user_data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)user_data;
+  TkmvChart *charts[] = {
+    self->procinfo_history_cpu_chart,
+    self->procinfo_history_mem_chart,
+    self->ctxinfo_history_cpu_chart,
+    self->ctxinfo_history_mem_chart,
+  };
+
+  /* Every chart of the page shows the crosshair at the same time */
+  for (guint i = 0; i < G_N_ELEMENTS (charts); i++)
+    {
+      if (charts[i] == chart)
+        continue;
+
+      if (active)
+        tkmv_chart_set_hover (charts[i], x);
+      else
+        tkmv_chart_clear_hover (charts[i]);
+    }
+}
+
+static void
+history_settings_changed (GSettings *gsettings, gchar *key,
+                          gpointer user_data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)user_data;
+
+  TKMV_UNUSED (gsettings);
+  TKMV_UNUSED (key);
+
+  tkmv_chart_invalidate (self->procinfo_history_cpu_chart);
+  tkmv_chart_invalidate (self->procinfo_history_mem_chart);
+  tkmv_chart_invalidate (self->ctxinfo_history_cpu_chart);
+  tkmv_chart_invalidate (self->ctxinfo_history_mem_chart);
+}
+
 static void
 procinfo_add_columns (TkmvProcessesView *self)
 {
@@ -395,26 +609,6 @@ procinfo_add_columns (TkmvProcessesView *self)
   gtk_tree_view_append_column (self->procinfo_treeview, column);
 }
 
-gboolean
-limit_selection_function (GtkTreeSelection *selection, GtkTreeModel *model,
-                          GtkTreePath *path, gboolean path_currently_selected,
-                          gpointer data)
-{
-  TKM_UNUSED (model);
-  TKM_UNUSED (path);
-  TKM_UNUSED (data);
-
-  if (!path_currently_selected)
-    {
-      if (gtk_tree_selection_count_selected_rows (selection) < 5)
-        {
-          return TRUE;
-        }
-      return FALSE;
-    }
-  return TRUE;
-}
-
 static void
 procinfo_selection_foreach_get_pid (GtkTreeModel *model, GtkTreePath *path,
                                     GtkTreeIter *iter, gpointer data)
@@ -556,8 +750,8 @@ procinfo_selection_changed (GtkTreeSelection *selection, gpointer data)
                               FALSE);
     }
 
-  gtk_widget_queue_draw (GTK_WIDGET (self->procinfo_history_cpu_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (self->procinfo_history_mem_drawing_area));
+  tkmv_chart_invalidate (self->procinfo_history_cpu_chart);
+  tkmv_chart_invalidate (self->procinfo_history_mem_chart);
 
   g_list_free (selected_pids);
   g_list_free_full (selected_names, g_free);
@@ -772,8 +966,8 @@ ctxinfo_selection_changed (GtkTreeSelection *selection, gpointer data)
                               FALSE);
     }
 
-  gtk_widget_queue_draw (GTK_WIDGET (self->ctxinfo_history_cpu_drawing_area));
-  gtk_widget_queue_draw (GTK_WIDGET (self->ctxinfo_history_mem_drawing_area));
+  tkmv_chart_invalidate (self->ctxinfo_history_cpu_chart);
+  tkmv_chart_invalidate (self->ctxinfo_history_mem_chart);
 
   g_list_free_full (selected_names, g_free);
 }
@@ -1094,283 +1288,151 @@ procacct_selection_changed (GtkTreeSelection *selection, gpointer data)
   TKMV_UNUSED (data);
 }
 
-int
-procinfo_sort_iter_compare_func (GtkTreeModel *model, GtkTreeIter *a,
-                                 GtkTreeIter *b, gpointer userdata)
-{
-  int sortcol = GPOINTER_TO_INT (userdata);
-  int ret = 0; /* default if egual */
-
-  switch (sortcol)
-    {
-    case COLUMN_PROCINFO_NAME:
-    {
-      char *name1, *name2;
-
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_NAME, &name1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_NAME, &name2, -1);
-
-      if (name1 == NULL || name2 == NULL)
-        {
-          if (name1 == NULL && name2 == NULL)
-            break;   /* both equal => ret = 0 */
-
-          ret = (name1 == NULL) ? -1 : 1;
-        }
-      else
-        {
-          ret = g_utf8_collate (name1, name2);
-        }
-
-      g_free (name1);
-      g_free (name2);
-    }
-    break;
-
-    case COLUMN_PROCINFO_CONTEXT:
-    {
-      char *name1, *name2;
-
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_CONTEXT, &name1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_CONTEXT, &name2, -1);
-
-      if (name1 == NULL || name2 == NULL)
-        {
-          if (name1 == NULL && name2 == NULL)
-            break;   /* both equal => ret = 0 */
-
-          ret = (name1 == NULL) ? -1 : 1;
-        }
-      else
-        {
-          ret = g_utf8_collate (name1, name2);
-        }
-
-      g_free (name1);
-      g_free (name2);
-    }
-    break;
-
-    case COLUMN_PROCINFO_PID:
-    {
-      guint pid1, pid2;
-
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_PID, &pid1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_PID, &pid2, -1);
-
-      if (pid1 != pid2)
-        {
-          ret = (pid1 > pid2) ? 1 : -1;
-        }
-    }
-    break;
+static const GType procinfo_column_types[PROCINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_STRING,
+  G_TYPE_UINT,   G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+};
 
-    case COLUMN_PROCINFO_PPID:
-    {
-      guint ppid1, ppid2;
+static const GType ctxinfo_column_types[CTXINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT,
+  G_TYPE_UINT,   G_TYPE_UINT,   G_TYPE_UINT,
+};
 
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_PPID, &ppid1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_PPID, &ppid2, -1);
+static const GType procacct_column_types[PROCACCT_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,
+};
 
-      if (ppid1 != ppid2)
-        {
-          ret = (ppid1 > ppid2) ? 1 : -1;
-        }
-    }
-    break;
+static const gint procinfo_sort_columns[] = {
+  COLUMN_PROCINFO_CPU_PERCENT,
+  COLUMN_PROCINFO_MEM_RSS,
+  COLUMN_PROCINFO_NAME,
+};
 
-    case COLUMN_PROCINFO_CPU_TIME:
-    {
-      guint val1, val2;
+static const GtkSortType procinfo_sort_orders[] = {
+  GTK_SORT_DESCENDING,
+  GTK_SORT_DESCENDING,
+  GTK_SORT_ASCENDING,
+};
 
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_CPU_TIME, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_CPU_TIME, &val2, -1);
+static const gint ctxinfo_sort_columns[] = {
+  COLUMN_CTXINFO_CPU_PERCENT,
+  COLUMN_CTXINFO_MEM_RSS,
+  COLUMN_CTXINFO_NAME,
+};
 
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+static const GtkSortType ctxinfo_sort_orders[] = {
+  GTK_SORT_DESCENDING,
+  GTK_SORT_DESCENDING,
+  GTK_SORT_ASCENDING,
+};
 
-    case COLUMN_PROCINFO_CPU_PERCENT:
-    {
-      guint val1, val2;
+static const GType procstats_column_types[PROCSTATS_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_STRING,
+  G_TYPE_UINT,   G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+  G_TYPE_UINT,   G_TYPE_UINT, G_TYPE_UINT,
+};
 
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_CPU_PERCENT, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_CPU_PERCENT, &val2, -1);
+static const gchar *procstats_column_titles[PROCSTATS_NUM_COLUMNS] = {
+  "Name",   "PID",    "PPID",   "Context", "CPUTime", "CPUAvg",
+  "CPUMax", "CPUP95", "RSSMax", "PSSMax",  "Samples",
+};
 
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+static const GType ctxstats_column_types[CTXSTATS_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+  G_TYPE_UINT,   G_TYPE_UINT,   G_TYPE_UINT, G_TYPE_UINT,
+};
 
-    case COLUMN_PROCINFO_MEM_RSS:
-    {
-      guint val1, val2;
+static const gchar *ctxstats_column_titles[CTXSTATS_NUM_COLUMNS] = {
+  "Name",   "ID",     "CPUTime", "CPUAvg",  "CPUMax",
+  "CPUP95", "RSSMax", "PSSMax",  "Samples",
+};
 
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_MEM_RSS, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_MEM_RSS, &val2, -1);
+static const gint procstats_sort_columns[] = {
+  COLUMN_PROCSTATS_CPU_AVG,
+  COLUMN_PROCSTATS_MEM_RSS_MAX,
+  COLUMN_PROCSTATS_NAME,
+};
 
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+static const gint ctxstats_sort_columns[] = {
+  COLUMN_CTXSTATS_CPU_AVG,
+  COLUMN_CTXSTATS_MEM_RSS_MAX,
+  COLUMN_CTXSTATS_NAME,
+};
 
-    case COLUMN_PROCINFO_MEM_PSS:
+static void
+stats_add_columns (GtkTreeView *treeview, const gchar **titles,
+                   guint n_columns, gint expand_column)
+{
+  for (guint i = 0; i < n_columns; i++)
     {
-      guint val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_PROCINFO_MEM_PSS, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_PROCINFO_MEM_PSS, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+      GtkCellRenderer *renderer = gtk_cell_renderer_text_new ();
+      GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes (
+        titles[i], renderer, "text", i, NULL);
 
-    default:
-      g_return_val_if_reached (0);
+      gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_AUTOSIZE);
+      gtk_tree_view_column_set_expand (column, (gint)i == expand_column);
+      gtk_tree_view_column_set_sort_column_id (column, i);
+      gtk_tree_view_append_column (treeview, column);
     }
-
-  return ret;
 }
 
-int
-ctxinfo_sort_iter_compare_func (GtkTreeModel *model, GtkTreeIter *a,
-                                GtkTreeIter *b, gpointer userdata)
+static void
+tables_set_aggregate (TkmvProcessesView *self, gboolean aggregate)
 {
-  int sortcol = GPOINTER_TO_INT (userdata);
-  int ret = 0; /* default if egual */
-
-  switch (sortcol)
-    {
-    case COLUMN_CTXINFO_NAME:
-    {
-      char *name1, *name2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_NAME, &name1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_NAME, &name2, -1);
-
-      if (name1 == NULL || name2 == NULL)
-        {
-          if (name1 == NULL && name2 == NULL)
-            break;   /* both equal => ret = 0 */
-
-          ret = (name1 == NULL) ? -1 : 1;
-        }
-      else
-        {
-          ret = g_utf8_collate (name1, name2);
-        }
-
-      g_free (name1);
-      g_free (name2);
-    }
-    break;
-
-    case COLUMN_CTXINFO_ID:
-    {
-      char *name1, *name2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_ID, &name1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_ID, &name2, -1);
+  GtkTreeView *treeviews[] = {
+    self->procinfo_treeview,
+    self->ctxinfo_treeview,
+  };
 
-      if (name1 == NULL || name2 == NULL)
-        {
-          if (name1 == NULL && name2 == NULL)
-            break;   /* both equal => ret = 0 */
-
-          ret = (name1 == NULL) ? -1 : 1;
-        }
-      else
-        {
-          ret = g_utf8_collate (name1, name2);
-        }
-
-      g_free (name1);
-      g_free (name2);
-    }
-    break;
-
-    case COLUMN_CTXINFO_CPU_TIME:
-    {
-      guint val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_CPU_TIME, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_CPU_TIME, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+  self->aggregate = aggregate;
 
-    case COLUMN_CTXINFO_CPU_PERCENT:
+  for (guint i = 0; i < G_N_ELEMENTS (treeviews); i++)
     {
-      guint val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_CPU_PERCENT, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_CPU_PERCENT, &val2, -1);
+      GtkTreeViewColumn *column = NULL;
 
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
+      while ((column = gtk_tree_view_get_column (treeviews[i], 0)) != NULL)
+        gtk_tree_view_remove_column (treeviews[i], column);
     }
-    break;
 
-    case COLUMN_CTXINFO_MEM_RSS:
+  if (aggregate)
     {
-      guint val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_MEM_RSS, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_MEM_RSS, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
+      gtk_tree_view_set_model (self->procinfo_treeview,
+                               GTK_TREE_MODEL (self->procstats_model));
+      stats_add_columns (self->procinfo_treeview, procstats_column_titles,
+                         PROCSTATS_NUM_COLUMNS, COLUMN_PROCSTATS_NAME);
+      gtk_tree_view_set_model (self->ctxinfo_treeview,
+                               GTK_TREE_MODEL (self->ctxstats_model));
+      stats_add_columns (self->ctxinfo_treeview, ctxstats_column_titles,
+                         CTXSTATS_NUM_COLUMNS, COLUMN_CTXSTATS_NAME);
     }
-    break;
-
-    case COLUMN_CTXINFO_MEM_PSS:
+  else
     {
-      guint val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_CTXINFO_MEM_PSS, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_CTXINFO_MEM_PSS, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
+      gtk_tree_view_set_model (self->procinfo_treeview,
+                               GTK_TREE_MODEL (self->procinfo_model));
+      procinfo_add_columns (self);
+      gtk_tree_view_set_model (self->ctxinfo_treeview,
+                               GTK_TREE_MODEL (self->ctxinfo_model));
+      ctxinfo_add_columns (self);
     }
-    break;
-
-    default:
-      g_return_val_if_reached (0);
-    }
-
-  return ret;
 }
 
 static void
 create_tables (TkmvProcessesView *self)
 {
-  /* create procinfo store */
-  self->procinfo_store = gtk_list_store_new (
-    PROCINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT,
-    G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT);
+  /* create procinfo model */
+  self->procinfo_model = tkmv_entry_model_new (
+    PROCINFO_NUM_COLUMNS, procinfo_column_types, procinfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_procinfo_entry_ref,
+    (GDestroyNotify)tkm_procinfo_entry_unref);
   gtk_tree_view_set_model (self->procinfo_treeview,
-                           GTK_TREE_MODEL (self->procinfo_store));
+                           GTK_TREE_MODEL (self->procinfo_model));
   procinfo_add_columns (self);
 
   /* register selection handler */
@@ -1378,54 +1440,22 @@ create_tables (TkmvProcessesView *self)
     = gtk_tree_view_get_selection (self->procinfo_treeview);
   gtk_tree_selection_set_mode (self->procinfo_treeview_select,
                                GTK_SELECTION_MULTIPLE);
-  gtk_tree_selection_set_select_function (
-    self->procinfo_treeview_select, limit_selection_function, NULL, NULL);
 
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_NAME,
-    procinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_PROCINFO_NAME),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_PID,
-    procinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_PROCINFO_PID),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_PPID,
-    procinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_PROCINFO_PPID),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_CONTEXT,
-    procinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_PROCINFO_CONTEXT), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_CPU_TIME,
-    procinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_PROCINFO_CPU_TIME), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_CPU_PERCENT,
-    procinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_PROCINFO_CPU_PERCENT), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_MEM_RSS,
-    procinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_PROCINFO_MEM_RSS),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_MEM_PSS,
-    procinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_PROCINFO_MEM_PSS),
-    NULL);
-  gtk_tree_sortable_set_sort_column_id (
-    GTK_TREE_SORTABLE (self->procinfo_store), COLUMN_PROCINFO_CPU_PERCENT,
-    GTK_SORT_DESCENDING);
+  /* heaviest first, header clicks keep the previous columns as ties */
+  tkmv_entry_model_set_sort_columns (self->procinfo_model,
+                                     G_N_ELEMENTS (procinfo_sort_columns),
+                                     procinfo_sort_columns, procinfo_sort_orders);
 
   g_signal_connect (G_OBJECT (self->procinfo_treeview_select), "changed",
                     G_CALLBACK (procinfo_selection_changed), self);
 
-  /* create ctxinfo store */
-  self->ctxinfo_store
-    = gtk_list_store_new (CTXINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_STRING,
-                          G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT);
+  /* create ctxinfo model */
+  self->ctxinfo_model = tkmv_entry_model_new (
+    CTXINFO_NUM_COLUMNS, ctxinfo_column_types, ctxinfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_ctxinfo_entry_ref,
+    (GDestroyNotify)tkm_ctxinfo_entry_unref);
   gtk_tree_view_set_model (self->ctxinfo_treeview,
-                           GTK_TREE_MODEL (self->ctxinfo_store));
+                           GTK_TREE_MODEL (self->ctxinfo_model));
   ctxinfo_add_columns (self);
 
   /* register selection handler */
@@ -1433,52 +1463,22 @@ create_tables (TkmvProcessesView *self)
     = gtk_tree_view_get_selection (self->ctxinfo_treeview);
   gtk_tree_selection_set_mode (self->ctxinfo_treeview_select,
                                GTK_SELECTION_MULTIPLE);
-  gtk_tree_selection_set_select_function (
-    self->ctxinfo_treeview_select, limit_selection_function, NULL, NULL);
 
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_NAME,
-    ctxinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_CTXINFO_NAME),
-    NULL);
-  gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (self->ctxinfo_store),
-                                   COLUMN_CTXINFO_ID,
-                                   ctxinfo_sort_iter_compare_func,
-                                   GINT_TO_POINTER (COLUMN_CTXINFO_ID), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_CPU_TIME,
-    ctxinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_CTXINFO_CPU_TIME), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_CPU_PERCENT,
-    ctxinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_CTXINFO_CPU_PERCENT), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_MEM_RSS,
-    ctxinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_CTXINFO_MEM_RSS),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_MEM_PSS,
-    ctxinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_CTXINFO_MEM_PSS),
-    NULL);
-  gtk_tree_sortable_set_sort_column_id (
-    GTK_TREE_SORTABLE (self->ctxinfo_store), COLUMN_CTXINFO_CPU_PERCENT,
-    GTK_SORT_DESCENDING);
+  /* heaviest first, header clicks keep the previous columns as ties */
+  tkmv_entry_model_set_sort_columns (self->ctxinfo_model,
+                                     G_N_ELEMENTS (ctxinfo_sort_columns),
+                                     ctxinfo_sort_columns, ctxinfo_sort_orders);
 
   g_signal_connect (G_OBJECT (self->ctxinfo_treeview_select), "changed",
                     G_CALLBACK (ctxinfo_selection_changed), self);
 
-  /* create procacct store */
-  self->procacct_store = gtk_list_store_new (
-    PROCACCT_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT,
-    G_TYPE_UINT, G_TYPE_UINT, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG);
+  /* create procacct model */
+  self->procacct_model = tkmv_entry_model_new (
+    PROCACCT_NUM_COLUMNS, procacct_column_types, procacct_entry_get_value,
+    (GBoxedCopyFunc)tkm_procacct_entry_ref,
+    (GDestroyNotify)tkm_procacct_entry_unref);
   gtk_tree_view_set_model (self->procacct_treeview,
-                           GTK_TREE_MODEL (self->procacct_store));
+                           GTK_TREE_MODEL (self->procacct_model));
   procacct_add_columns (self);
 
   /* register selection handler */
@@ -1488,35 +1488,91 @@ create_tables (TkmvProcessesView *self)
                                GTK_SELECTION_SINGLE);
   g_signal_connect (G_OBJECT (self->procacct_treeview_select), "changed",
                     G_CALLBACK (procacct_selection_changed), self);
+
+  /* create window statistics models, attached in aggregate mode */
+  self->procstats_model = tkmv_entry_model_new (
+    PROCSTATS_NUM_COLUMNS, procstats_column_types, procstats_entry_get_value,
+    (GBoxedCopyFunc)tkmv_process_stats_ref,
+    (GDestroyNotify)tkmv_process_stats_unref);
+  tkmv_entry_model_set_sort_columns (self->procstats_model,
+                                     G_N_ELEMENTS (procstats_sort_columns),
+                                     procstats_sort_columns,
+                                     procinfo_sort_orders);
+
+  self->ctxstats_model = tkmv_entry_model_new (
+    CTXSTATS_NUM_COLUMNS, ctxstats_column_types, ctxstats_entry_get_value,
+    (GBoxedCopyFunc)tkmv_process_stats_ref,
+    (GDestroyNotify)tkmv_process_stats_unref);
+  tkmv_entry_model_set_sort_columns (self->ctxstats_model,
+                                     G_N_ELEMENTS (ctxstats_sort_columns),
+                                     ctxstats_sort_columns,
+                                     ctxinfo_sort_orders);
+}
+
+static void
+aggregate_toggled (GtkToggleButton *button, gpointer user_data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)user_data;
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  guint slice = 0;
+
+  tables_set_aggregate (self, gtk_toggle_button_get_active (button));
+
+  /* Rebuild the tables of the loaded window in the new mode */
+  tkm_context_data_lock (context);
+  while (reload_tables_slice (self, context, slice))
+    slice++;
+  tkm_context_data_unlock (context);
 }
 
 static void
-procinfo_list_store_append_entry (GtkListStore *list_store,
-                                  TkmProcInfoEntry *entry, GtkTreeIter *iter)
-{
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_PROCINFO_NAME,
-    tkm_procinfo_entry_get_name (entry), COLUMN_PROCINFO_PID,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID),
-    COLUMN_PROCINFO_PPID,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_PPID),
-    COLUMN_PROCINFO_CONTEXT, tkm_procinfo_entry_get_context (entry),
-    COLUMN_PROCINFO_CPU_TIME,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_CPU_TIME),
-    COLUMN_PROCINFO_CPU_PERCENT,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_CPU_PERCENT),
-    COLUMN_PROCINFO_MEM_RSS,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_MEM_RSS),
-    COLUMN_PROCINFO_MEM_PSS,
-    tkm_procinfo_entry_get_data (entry, PINFO_DATA_MEM_PSS), -1);
+procinfo_entry_get_value (gpointer entry, gint column, GValue *value)
+{
+  TkmProcInfoEntry *e = (TkmProcInfoEntry *)entry;
+
+  switch (column)
+    {
+    case COLUMN_PROCINFO_NAME:
+      g_value_set_string (value, tkm_procinfo_entry_get_name (e));
+      break;
+    case COLUMN_PROCINFO_PID:
+      g_value_set_uint (value, tkm_procinfo_entry_get_data (e, PINFO_DATA_PID));
+      break;
+    case COLUMN_PROCINFO_PPID:
+      g_value_set_uint (value,
+                        tkm_procinfo_entry_get_data (e, PINFO_DATA_PPID));
+      break;
+    case COLUMN_PROCINFO_CONTEXT:
+      g_value_set_string (value, tkm_procinfo_entry_get_context (e));
+      break;
+    case COLUMN_PROCINFO_CPU_TIME:
+      g_value_set_uint (value,
+                        tkm_procinfo_entry_get_data (e, PINFO_DATA_CPU_TIME));
+      break;
+    case COLUMN_PROCINFO_CPU_PERCENT:
+      g_value_set_uint (
+        value, tkm_procinfo_entry_get_data (e, PINFO_DATA_CPU_PERCENT));
+      break;
+    case COLUMN_PROCINFO_MEM_RSS:
+      g_value_set_uint (value,
+                        tkm_procinfo_entry_get_data (e, PINFO_DATA_MEM_RSS));
+      break;
+    case COLUMN_PROCINFO_MEM_PSS:
+      g_value_set_uint (value,
+                        tkm_procinfo_entry_get_data (e, PINFO_DATA_MEM_PSS));
+      break;
+    default:
+      g_return_if_reached ();
+    }
 }
 
 static void
 reload_procinfo_entries (TkmvProcessesView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_procinfo_entries (context);
-  GtkTreeIter iter;
+  gulong timestamp = 0;
+  guint count = 1;
 
   if (entries == NULL)
     return;
@@ -1524,177 +1580,132 @@ reload_procinfo_entries (TkmvProcessesView *view, TkmContext *context)
   if (entries->len == 0)
     return;
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->procinfo_treeview), NULL);
-  gtk_list_store_clear (view->procinfo_store);
-
-  /* get first entry */
-  TkmProcInfoEntry *firstEntry = g_ptr_array_index (entries, 0);
-
-  tkm_procinfo_entry_set_index (firstEntry, 0);
-  procinfo_list_store_append_entry (view->procinfo_store, firstEntry, &iter);
+  if (view->aggregate)
+    {
+      reload_stats_entries (view, PROCESS_STATS_SOURCE_PROCINFO, entries);
+      return;
+    }
 
-  for (guint i = 1; i < entries->len; i++)
+  /* the table shows the rows of the first snapshot */
+  timestamp = tkm_procinfo_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                                DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
     {
-      TkmProcInfoEntry *entry = g_ptr_array_index (entries, i);
+      TkmProcInfoEntry *entry = g_ptr_array_index (entries, count);
 
-      tkm_procinfo_entry_set_index (entry, i);
       if (tkm_procinfo_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          == tkm_procinfo_entry_get_timestamp (firstEntry,
-                                               DATA_TIME_SOURCE_MONOTONIC))
-        {
-          procinfo_list_store_append_entry (view->procinfo_store, entry,
-                                            &iter);
-        }
-      else
-        {
-          break;
-        }
+          != timestamp)
+        break;
+
+      count++;
     }
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->procinfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->procinfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->procinfo_treeview),
-                           GTK_TREE_MODEL (view->procinfo_store));
-}
-
-static void
-ctxinfo_list_store_append_entry (GtkListStore *list_store,
-                                 TkmCtxInfoEntry *entry, GtkTreeIter *iter)
-{
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_CTXINFO_NAME,
-    tkm_ctxinfo_entry_get_name (entry), COLUMN_CTXINFO_ID,
-    tkm_ctxinfo_entry_get_id (entry), COLUMN_CTXINFO_CPU_TIME,
-    tkm_ctxinfo_entry_get_data (entry, CTXINFO_DATA_CPU_TIME),
-    COLUMN_CTXINFO_CPU_PERCENT,
-    tkm_ctxinfo_entry_get_data (entry, CTXINFO_DATA_CPU_PERCENT),
-    COLUMN_CTXINFO_MEM_RSS,
-    tkm_ctxinfo_entry_get_data (entry, CTXINFO_DATA_MEM_RSS),
-    COLUMN_CTXINFO_MEM_PSS,
-    tkm_ctxinfo_entry_get_data (entry, CTXINFO_DATA_MEM_PSS), -1);
+                           GTK_TREE_MODEL (view->procinfo_model));
 }
 
 static void
-reload_ctxinfo_entries (TkmvProcessesView *view, TkmContext *context)
+ctxinfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  GPtrArray *entries = tkm_context_get_ctxinfo_entries (context);
-  GtkTreeIter iter;
+  TkmCtxInfoEntry *e = (TkmCtxInfoEntry *)entry;
 
-  if (entries == NULL)
-    return;
-
-  if (entries->len == 0)
-    return;
+  switch (column)
+    {
+    case COLUMN_CTXINFO_NAME:
+      g_value_set_string (value, tkm_ctxinfo_entry_get_name (e));
+      break;
+    case COLUMN_CTXINFO_ID:
+      g_value_set_string (value, tkm_ctxinfo_entry_get_id (e));
+      break;
+    case COLUMN_CTXINFO_CPU_TIME:
+      g_value_set_uint (value,
+                        tkm_ctxinfo_entry_get_data (e, CTXINFO_DATA_CPU_TIME));
+      break;
+    case COLUMN_CTXINFO_CPU_PERCENT:
+      g_value_set_uint (
+        value, tkm_ctxinfo_entry_get_data (e, CTXINFO_DATA_CPU_PERCENT));
+      break;
+    case COLUMN_CTXINFO_MEM_RSS:
+      g_value_set_uint (value,
+                        tkm_ctxinfo_entry_get_data (e, CTXINFO_DATA_MEM_RSS));
+      break;
+    case COLUMN_CTXINFO_MEM_PSS:
+      g_value_set_uint (value,
+                        tkm_ctxinfo_entry_get_data (e, CTXINFO_DATA_MEM_PSS));
+      break;
+    default:
+      g_return_if_reached ();
+    }
+}
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->ctxinfo_treeview), NULL);
-  gtk_list_store_clear (view->ctxinfo_store);
+static void
+reload_ctxinfo_entries (TkmvProcessesView *view, TkmContext *context)
+{
+  GPtrArray *entries = tkm_context_get_ctxinfo_entries (context);
+  gulong timestamp = 0;
+  guint count = 1;
 
-  /* get first entry */
-  TkmCtxInfoEntry *firstEntry = g_ptr_array_index (entries, 0);
+  if (entries == NULL)
+    return;
 
-  tkm_ctxinfo_entry_set_index (firstEntry, 0);
-  ctxinfo_list_store_append_entry (view->ctxinfo_store, firstEntry, &iter);
+  if (entries->len == 0)
+    return;
 
-  for (guint i = 1; i < entries->len; i++)
+  if (view->aggregate)
     {
-      TkmCtxInfoEntry *entry = g_ptr_array_index (entries, i);
+      reload_stats_entries (view, PROCESS_STATS_SOURCE_CTXINFO, entries);
+      return;
+    }
+
+  /* the table shows the rows of the first snapshot */
+  timestamp = tkm_ctxinfo_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                               DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
+    {
+      TkmCtxInfoEntry *entry = g_ptr_array_index (entries, count);
 
-      tkm_ctxinfo_entry_set_index (entry, i);
       if (tkm_ctxinfo_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          == tkm_ctxinfo_entry_get_timestamp (firstEntry,
-                                              DATA_TIME_SOURCE_MONOTONIC))
-        {
-          ctxinfo_list_store_append_entry (view->ctxinfo_store, entry, &iter);
-        }
-      else
-        {
-          break;
-        }
+          != timestamp)
+        break;
+
+      count++;
     }
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->ctxinfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->ctxinfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->ctxinfo_treeview),
-                           GTK_TREE_MODEL (view->ctxinfo_store));
+                           GTK_TREE_MODEL (view->ctxinfo_model));
 }
 
 static void
-procacct_list_store_append_entry (GtkListStore *list_store,
-                                  TkmProcAcctEntry *entry, GtkTreeIter *iter)
-{
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_PROCACCT_NAME,
-    tkm_procacct_entry_get_name (entry), COLUMN_PROCACCT_PID,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_PID),
-    COLUMN_PROCACCT_PPID,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_PPID),
-    COLUMN_PROCACCT_UID, tkm_procacct_entry_get_data (entry, PACCT_DATA_UID),
-    COLUMN_PROCACCT_GID, tkm_procacct_entry_get_data (entry, PACCT_DATA_GID),
-    COLUMN_PROCACCT_UTIME,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_UTIME),
-    COLUMN_PROCACCT_STIME,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_STIME),
-    COLUMN_PROCACCT_CPU_COUNT,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CPU_COUNT),
-    COLUMN_PROCACCT_CPU_RUN_REAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CPU_RUN_REAL),
-    COLUMN_PROCACCT_CPU_RUN_VIRTUAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CPU_RUN_VIRTUAL),
-    COLUMN_PROCACCT_CPU_DELAY_TOTAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CPU_DELAY_TOTAL),
-    COLUMN_PROCACCT_CPU_DELAY_AVG,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CPU_DELAY_AVG),
-    COLUMN_PROCACCT_CORE_MEM,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_CORE_MEM),
-    COLUMN_PROCACCT_VIRT_MEM,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_VIRT_MEM),
-    COLUMN_PROCACCT_HIGH_WATER_RSS,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_HIGH_WATER_RSS),
-    COLUMN_PROCACCT_NVCSW,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_NVCSW),
-    COLUMN_PROCACCT_NIVCSW,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_NIVCSW),
-    COLUMN_PROCACCT_SWAPIN_COUNT,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_SWAPIN_COUNT),
-    COLUMN_PROCACCT_SWAPIN_DELAY_TOTAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_SWAPIN_DELAY_TOTAL),
-    COLUMN_PROCACCT_SWAPIN_DELAY_AVG,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_SWAPIN_DELAY_AVG),
-    COLUMN_PROCACCT_BLKIO_COUNT,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_BLKIO_COUNT),
-    COLUMN_PROCACCT_BLKIO_DELAY_TOTAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_BLKIO_DELAY_TOTAL),
-    COLUMN_PROCACCT_BLKIO_DELAY_AVG,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_BLKIO_DELAY_AVG),
-    COLUMN_PROCACCT_IO_STORAGE_READ,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_STORAGE_READ),
-    COLUMN_PROCACCT_IO_STORAGE_WRITE,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_STORAGE_WRITE),
-    COLUMN_PROCACCT_IO_READ_CHAR,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_READ_CHAR),
-    COLUMN_PROCACCT_IO_WRITE_CHAR,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_WRITE_CHAR),
-    COLUMN_PROCACCT_IO_READ_SYSCALLS,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_READ_SYSCALLS),
-    COLUMN_PROCACCT_IO_WRITE_SYSCALLS,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_IO_WRITE_SYSCALLS),
-    COLUMN_PROCACCT_FREEPAGE_COUNT,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_FREEPAGE_COUNT),
-    COLUMN_PROCACCT_FREEPAGE_DELAY_TOTAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_FREEPAGE_DELAY_TOTAL),
-    COLUMN_PROCACCT_FREEPAGE_DELAY_AVG,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_FREEPAGE_DELAY_AVG),
-    COLUMN_PROCACCT_TRASHING_COUNT,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_TRASHING_COUNT),
-    COLUMN_PROCACCT_TRASHING_DELAY_TOTAL,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_TRASHING_DELAY_TOTAL),
-    COLUMN_PROCACCT_TRASHING_DELAY_AVG,
-    tkm_procacct_entry_get_data (entry, PACCT_DATA_TRASHING_DELAY_AVG), -1);
+procacct_entry_get_value (gpointer entry, gint column, GValue *value)
+{
+  TkmProcAcctEntry *e = (TkmProcAcctEntry *)entry;
+  TkmProcAcctDataType type;
+
+  if (column == COLUMN_PROCACCT_NAME)
+    {
+      g_value_set_string (value, tkm_procacct_entry_get_name (e));
+      return;
+    }
+
+  /* the data columns follow the order of the procacct data types */
+  type = (TkmProcAcctDataType)(column - COLUMN_PROCACCT_PID);
+
+  if (column <= COLUMN_PROCACCT_GID)
+    g_value_set_uint (value, tkm_procacct_entry_get_data (e, type));
+  else
+    g_value_set_long (value, tkm_procacct_entry_get_data (e, type));
 }
 
 static void
 reload_procacct_entries (TkmvProcessesView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_procacct_entries (context);
-  GtkTreeIter iter;
+  gulong timestamp = 0;
+  guint count = 1;
 
   if (entries == NULL)
     {
@@ -1710,40 +1721,248 @@ reload_procacct_entries (TkmvProcessesView *view, TkmContext *context)
 
   gtk_widget_set_visible (GTK_WIDGET (view->procacct_scrolled_window), TRUE);
 
+  if (view->aggregate)
+    {
+      reload_stats_entries (view, PROCESS_STATS_SOURCE_PROCACCT, entries);
+      return;
+    }
+
+  /* The procacct entry come when ready so we should group the entries with */
+  /* some delay in mind. For now we use a 3 seconds delay since */
+  /* slowLaneInterval is normally much higher (eg 10s) */
+  timestamp = tkm_procacct_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                                DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
+    {
+      TkmProcAcctEntry *entry = g_ptr_array_index (entries, count);
+
+      if (tkm_procacct_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
+          > timestamp + 3)
+        break;
+
+      count++;
+    }
+
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->procacct_treeview), NULL);
-  gtk_list_store_clear (view->procacct_store);
+  tkmv_entry_model_set_entries (view->procacct_model, entries, 0, count);
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->procacct_treeview),
+                           GTK_TREE_MODEL (view->procacct_model));
+}
 
-  /* get first entry */
-  TkmProcAcctEntry *firstEntry = g_ptr_array_index (entries, 0);
+static void
+procstats_entry_get_value (gpointer entry, gint column, GValue *value)
+{
+  TkmvProcessStats *e = (TkmvProcessStats *)entry;
 
-  tkm_procacct_entry_set_index (firstEntry, 0);
-  procacct_list_store_append_entry (view->procacct_store, firstEntry, &iter);
+  switch (column)
+    {
+    case COLUMN_PROCSTATS_NAME:
+      g_value_set_string (value, e->name);
+      break;
+    case COLUMN_PROCSTATS_PID:
+      g_value_set_uint (value, e->pid);
+      break;
+    case COLUMN_PROCSTATS_PPID:
+      g_value_set_uint (value, e->ppid);
+      break;
+    case COLUMN_PROCSTATS_CONTEXT:
+      g_value_set_string (value, e->id);
+      break;
+    case COLUMN_PROCSTATS_CPU_TIME:
+      g_value_set_uint (value, e->cpu_time);
+      break;
+    case COLUMN_PROCSTATS_CPU_AVG:
+      g_value_set_uint (value, e->cpu_avg);
+      break;
+    case COLUMN_PROCSTATS_CPU_MAX:
+      g_value_set_uint (value, e->cpu_max);
+      break;
+    case COLUMN_PROCSTATS_CPU_P95:
+      g_value_set_uint (value, e->cpu_p95);
+      break;
+    case COLUMN_PROCSTATS_MEM_RSS_MAX:
+      g_value_set_uint (value, e->mem_rss_max);
+      break;
+    case COLUMN_PROCSTATS_MEM_PSS_MAX:
+      g_value_set_uint (value, e->mem_pss_max);
+      break;
+    case COLUMN_PROCSTATS_SAMPLES:
+      g_value_set_uint (value, e->samples);
+      break;
+    default:
+      g_return_if_reached ();
+    }
+}
 
-  for (guint i = 1; i < entries->len; i++)
+static void
+ctxstats_entry_get_value (gpointer entry, gint column, GValue *value)
+{
+  TkmvProcessStats *e = (TkmvProcessStats *)entry;
+
+  switch (column)
     {
-      TkmProcAcctEntry *entry = g_ptr_array_index (entries, i);
+    case COLUMN_CTXSTATS_NAME:
+      g_value_set_string (value, e->name);
+      break;
+    case COLUMN_CTXSTATS_ID:
+      g_value_set_string (value, e->id);
+      break;
+    case COLUMN_CTXSTATS_CPU_TIME:
+      g_value_set_uint (value, e->cpu_time);
+      break;
+    case COLUMN_CTXSTATS_CPU_AVG:
+      g_value_set_uint (value, e->cpu_avg);
+      break;
+    case COLUMN_CTXSTATS_CPU_MAX:
+      g_value_set_uint (value, e->cpu_max);
+      break;
+    case COLUMN_CTXSTATS_CPU_P95:
+      g_value_set_uint (value, e->cpu_p95);
+      break;
+    case COLUMN_CTXSTATS_MEM_RSS_MAX:
+      g_value_set_uint (value, e->mem_rss_max);
+      break;
+    case COLUMN_CTXSTATS_MEM_PSS_MAX:
+      g_value_set_uint (value, e->mem_pss_max);
+      break;
+    case COLUMN_CTXSTATS_SAMPLES:
+      g_value_set_uint (value, e->samples);
+      break;
+    default:
+      g_return_if_reached ();
+    }
+}
 
-      tkm_procacct_entry_set_index (entry, i);
+static void
+stats_request_free (gpointer data)
+{
+  ProcessStatsRequest *request = (ProcessStatsRequest *)data;
 
-      /* The procacct entry come when ready so we should group the entries with */
-      /* some delay in mind. For now we use a 3 seconds delay since */
-      /* slowLaneInterval is normally much higher (eg 10s) */
-      if (tkm_procacct_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          <= tkm_procacct_entry_get_timestamp (firstEntry,
-                                               DATA_TIME_SOURCE_MONOTONIC)
-          + 3)
-        {
-          procacct_list_store_append_entry (view->procacct_store, entry,
-                                            &iter);
-        }
-      else
-        {
-          break;
-        }
+  g_object_unref (request->view);
+  g_free (request);
+}
+
+static void
+reload_stats_entries (TkmvProcessesView *view, ProcessStatsSource source,
+                      GPtrArray *entries)
+{
+  ProcessStatsRequest *request = g_new0 (ProcessStatsRequest, 1);
+
+  request->view = g_object_ref (view);
+  request->serial = view->stats_serial;
+
+  tkmv_process_stats_compute (source, entries, view->stats_group,
+                              stats_entries_ready, request,
+                              stats_request_free);
+}
+
+static void
+table_select_first (GtkTreeSelection *selection)
+{
+  GtkTreePath *path = NULL;
+
+  if (gtk_tree_selection_count_selected_rows (selection) > 0)
+    return;
+
+  path = gtk_tree_path_new_from_indices (0, -1);
+  gtk_tree_selection_select_path (selection, path);
+  gtk_tree_path_free (path);
+}
+
+static void
+stats_entries_ready (ProcessStatsSource source, GPtrArray *rows,
+                     gpointer user_data)
+{
+  ProcessStatsRequest *request = (ProcessStatsRequest *)user_data;
+  TkmvProcessesView *view = request->view;
+  GtkTreeSelection *selection = NULL;
+  GtkTreeView *treeview = NULL;
+  TkmvEntryModel *model = NULL;
+
+  /* A newer reload or a mode change supersedes these rows */
+  if (rows == NULL || request->serial != view->stats_serial
+      || !view->aggregate)
+    return;
+
+  switch (source)
+    {
+    case PROCESS_STATS_SOURCE_PROCINFO:
+      treeview = view->procinfo_treeview;
+      model = view->procstats_model;
+      selection = view->procinfo_treeview_select;
+      break;
+    case PROCESS_STATS_SOURCE_CTXINFO:
+      treeview = view->ctxinfo_treeview;
+      model = view->ctxstats_model;
+      selection = view->ctxinfo_treeview_select;
+      break;
+    case PROCESS_STATS_SOURCE_PROCACCT:
+      treeview = view->procacct_treeview;
+      model = view->procacct_model;
+      break;
+    default:
+      g_return_if_reached ();
     }
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->procacct_treeview),
-                           GTK_TREE_MODEL (view->procacct_store));
+  gtk_tree_view_set_model (treeview, NULL);
+  tkmv_entry_model_set_entries (model, rows, 0, rows->len);
+  gtk_tree_view_set_model (treeview, GTK_TREE_MODEL (model));
+
+  if (selection != NULL)
+    table_select_first (selection);
+}
+
+static void
+history_selection_free (gpointer data)
+{
+  HistorySelection *selection = (HistorySelection *)data;
+
+  if (selection == NULL)
+    return;
+
+  g_list_free_full (selection->keys, selection->key_free);
+  g_free (selection);
+}
+
+static HistorySelection *
+history_selection_new (GtkTreeSelection *tree_selection,
+                       GtkTreeSelectionForeachFunc get_key,
+                       GDestroyNotify key_free)
+{
+  TkmvSettings *settings
+    = tkmv_application_get_settings (tkmv_application_instance ());
+  HistorySelection *selection = g_new0 (HistorySelection, 1);
+
+  gtk_tree_selection_selected_foreach (tree_selection, get_key,
+                                       &selection->keys);
+  selection->key_free = key_free;
+  selection->mode = tkmv_settings_get_process_chart_mode (settings);
+  selection->top_count
+    = MAX (tkmv_settings_get_process_chart_top_count (settings), 1);
+
+  return selection;
+}
+
+static gpointer
+procinfo_selection_snapshot (gpointer data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)data;
+
+  g_assert (self);
+
+  return history_selection_new (self->procinfo_treeview_select,
+                                procinfo_selection_foreach_get_pid, NULL);
+}
+
+static gpointer
+ctxinfo_selection_snapshot (gpointer data)
+{
+  TkmvProcessesView *self = (TkmvProcessesView *)data;
+
+  g_assert (self);
+
+  return history_selection_new (self->ctxinfo_treeview_select,
+                                ctxinfo_selection_foreach_get_id, g_free);
 }
 
 static void
@@ -1789,1176 +2008,401 @@ percent_format_procview (double val, char *buf, size_t sz)
   snprintf (buf, sz, "%u %%", (guint)val);
 }
 
-static void
-procinfo_cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                    int width, int height, gpointer data)
+static gconstpointer
+procinfo_row_key (gpointer entry)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
-  TkmvProcessesView *self = (TkmvProcessesView *)data;
-  GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *proc_info_data = tkm_context_get_procinfo_entries (context);
-  TkmSessionEntry *active_session = NULL;
-
-  struct kdata *d1 = NULL;
-  struct kdata *d2 = NULL;
-  struct kdata *d3 = NULL;
-  struct kdata *d4 = NULL;
-  struct kdata *d5 = NULL;
+  return GINT_TO_POINTER (
+    tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry, PINFO_DATA_PID));
+}
 
-  struct kplotcfg plotcfg;
-  struct kplot *p = NULL;
+static gulong
+procinfo_row_timestamp (gpointer entry, DataTimeSource source)
+{
+  return tkm_procinfo_entry_get_timestamp ((TkmProcInfoEntry *)entry, source);
+}
 
-  guint selected_count = 0;
-  GList *selected_pids = NULL;
+static double
+procinfo_row_cpu (gpointer entry)
+{
+  return tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry,
+                                      PINFO_DATA_CPU_PERCENT);
+}
 
-  TKMV_UNUSED (area);
+static double
+procinfo_row_mem (gpointer entry)
+{
+  return tkm_procinfo_entry_get_data ((TkmProcInfoEntry *)entry,
+                                      PINFO_DATA_MEM_RSS);
+}
 
-  if (sessions != NULL)
-    {
-      for (guint i = 0; i < sessions->len; i++)
-        {
-          if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
-            {
-              active_session = g_ptr_array_index (sessions, i);
-            }
-        }
+static gconstpointer
+ctxinfo_row_key (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_id ((TkmCtxInfoEntry *)entry);
+}
 
-      g_assert (active_session);
-      g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
-    }
+static gulong
+ctxinfo_row_timestamp (gpointer entry, DataTimeSource source)
+{
+  return tkm_ctxinfo_entry_get_timestamp ((TkmCtxInfoEntry *)entry, source);
+}
 
-  selected_count = gtk_tree_selection_count_selected_rows (
-    self->procinfo_treeview_select);
-  gtk_tree_selection_selected_foreach (self->procinfo_treeview_select,
-                                       procinfo_selection_foreach_get_pid,
-                                       &selected_pids);
+static double
+ctxinfo_row_cpu (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_data ((TkmCtxInfoEntry *)entry,
+                                     CTXINFO_DATA_CPU_PERCENT);
+}
 
-  if (proc_info_data != NULL)
-    {
-      g_autofree guint *entry_index_set = calloc (proc_info_data->len, sizeof(guint));
-      guint entry_count = 0;
+static double
+ctxinfo_row_mem (gpointer entry)
+{
+  return tkm_ctxinfo_entry_get_data ((TkmCtxInfoEntry *)entry,
+                                     CTXINFO_DATA_MEM_RSS);
+}
 
-      if (proc_info_data->len > 0)
-        {
-          if (selected_count > 0)
-            {
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 0)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d1 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d1->pairs[i].x = timestamp;
-                  d1->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 1)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 1)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d2 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d2->pairs[i].x = timestamp;
-                  d2->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 2)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 2)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d3 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d3->pairs[i].x = timestamp;
-                  d3->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 3)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 3)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d4 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d4->pairs[i].x = timestamp;
-                  d4->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 4)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 4)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d5 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d5->pairs[i].x = timestamp;
-                  d5->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_CPU_PERCENT);
-                }
-            }
-        }
-    }
+static const HistorySeriesSource procinfo_cpu_source = {
+  g_direct_hash, g_direct_equal, procinfo_row_key, procinfo_row_timestamp,
+  procinfo_row_cpu,
+};
 
-  g_list_free (selected_pids);
+static const HistorySeriesSource procinfo_mem_source = {
+  g_direct_hash, g_direct_equal, procinfo_row_key, procinfo_row_timestamp,
+  procinfo_row_mem,
+};
 
-  kplotcfg_defaults (&plotcfg);
-  plotcfg.grid = GRID_ALL;
-  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
-  plotcfg.extrema_ymin = 0;
-  if (active_session != NULL)
-    {
-      plotcfg.extrema_ymax
-        = (100 * tkm_session_entry_get_device_cpus (active_session));
-    }
-  else
-    {
-      plotcfg.extrema_ymax = 100;
-    }
-  plotcfg.xticlabelfmt = timestamp_format_procview;
-  plotcfg.yticlabelfmt = percent_format_procview;
+static const HistorySeriesSource ctxinfo_cpu_source = {
+  g_str_hash, g_str_equal, ctxinfo_row_key, ctxinfo_row_timestamp,
+  ctxinfo_row_cpu,
+};
 
-  p = kplot_alloc (&plotcfg);
+static const HistorySeriesSource ctxinfo_mem_source = {
+  g_str_hash, g_str_equal, ctxinfo_row_key, ctxinfo_row_timestamp,
+  ctxinfo_row_mem,
+};
 
-  if (d1 != NULL)
-    {
-      struct kdatacfg d1_cfg;
+static void
+history_series_color (guint index, double *rgba)
+{
+  /* The first ones match the legend labels */
+  static const double colors[][3] = {
+    { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, { 0.0, 1.0, 0.0 },
+    { 0.4, 0.0, 0.6 }, { 0.9, 0.4, 0.3 },
+  };
 
-      kdatacfg_defaults (&d1_cfg);
-      d1_cfg.line.sz = 1.0;
-      d1_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d1_cfg.line.clr.rgba[0] = 1.0;
-      d1_cfg.line.clr.rgba[3] = 1.0;
+  rgba[3] = 1.0;
 
-      kplot_attach_data (p, d1, KPLOT_LINES, &d1_cfg);
-    }
-  if (d2 != NULL)
+  if (index < G_N_ELEMENTS (colors))
     {
-      struct kdatacfg d2_cfg;
-
-      kdatacfg_defaults (&d2_cfg);
-      d2_cfg.line.sz = 1.0;
-      d2_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d2_cfg.line.clr.rgba[2] = 1.0;
-      d2_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d2, KPLOT_LINES, &d2_cfg);
+      rgba[0] = colors[index][0];
+      rgba[1] = colors[index][1];
+      rgba[2] = colors[index][2];
+      return;
     }
-  if (d3 != NULL)
-    {
-      struct kdatacfg d3_cfg;
 
-      kdatacfg_defaults (&d3_cfg);
-      d3_cfg.line.sz = 1.0;
-      d3_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d3_cfg.line.clr.rgba[1] = 1.0;
-      d3_cfg.line.clr.rgba[3] = 1.0;
+  /* Golden ratio steps keep neighbouring hues apart for any count */
+  {
+    float r = 0, g = 0, b = 0;
 
-      kplot_attach_data (p, d3, KPLOT_LINES, &d3_cfg);
-    }
-  if (d4 != NULL)
-    {
-      struct kdatacfg d4_cfg;
+    gtk_hsv_to_rgb ((float)fmod (index * 0.618033988749895, 1.0), 0.65f,
+                    0.85f, &r, &g, &b);
+    rgba[0] = r;
+    rgba[1] = g;
+    rgba[2] = b;
+  }
+}
 
-      kdatacfg_defaults (&d4_cfg);
-      d4_cfg.line.sz = 1.0;
-      d4_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d4_cfg.line.clr.rgba[0] = 0.4;
-      d4_cfg.line.clr.rgba[1] = 0.0;
-      d4_cfg.line.clr.rgba[2] = 0.6;
-      d4_cfg.line.clr.rgba[3] = 1.0;
+static gint
+history_series_rank_compare (gconstpointer a, gconstpointer b,
+                             gpointer user_data)
+{
+  const double *sums = (const double *)user_data;
+  double sa = sums[*(const guint *)a];
+  double sb = sums[*(const guint *)b];
 
-      kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
-    }
-  if (d5 != NULL)
-    {
-      struct kdatacfg d5_cfg;
+  if (sa != sb)
+    return sa < sb ? 1 : -1;
 
-      kdatacfg_defaults (&d5_cfg);
-      d5_cfg.line.sz = 1.0;
-      d5_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d5_cfg.line.clr.rgba[0] = 0.9;
-      d5_cfg.line.clr.rgba[1] = 0.4;
-      d5_cfg.line.clr.rgba[2] = 0.3;
-      d5_cfg.line.clr.rgba[3] = 1.0;
+  return *(const guint *)a < *(const guint *)b ? -1 : 1;
+}
 
-      kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
-    }
+static gint
+history_pair_compare (gconstpointer a, gconstpointer b)
+{
+  double xa = ((const struct kpair *)a)->x;
+  double xb = ((const struct kpair *)b)->x;
 
-  kplot_draw (p, width, height, cr);
+  return (xa > xb) - (xa < xb);
+}
 
-  kdata_destroy (d1);
-  kdata_destroy (d2);
-  kdata_destroy (d3);
-  kdata_destroy (d4);
-  kdata_destroy (d5);
+static gint
+history_double_compare (gconstpointer a, gconstpointer b)
+{
+  double xa = *(const double *)a;
+  double xb = *(const double *)b;
 
-  kplot_free (p);
+  return (xa > xb) - (xa < xb);
 }
 
 static void
-procinfo_mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                    int width, int height, gpointer data)
+history_series_attach (struct kplot *p, GArray *pairs, enum kplottype type,
+                       const double *rgba)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
-  TkmvProcessesView *self = (TkmvProcessesView *)data;
-  GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *proc_info_data = tkm_context_get_procinfo_entries (context);
-  TkmSessionEntry *active_session = NULL;
+  struct kdatacfg cfg;
+  struct kdata *d = NULL;
+  gsize len = pairs->len;
+  struct kpair *data = (struct kpair *)(gpointer)g_array_free (pairs, FALSE);
 
-  struct kdata *d1 = NULL;
-  struct kdata *d2 = NULL;
-  struct kdata *d3 = NULL;
-  struct kdata *d4 = NULL;
-  struct kdata *d5 = NULL;
-
-  struct kplotcfg plotcfg;
-  struct kplot *p = NULL;
-
-  guint selected_count = 0;
-  GList *selected_pids = NULL;
-
-  TKMV_UNUSED (area);
-
-  if (sessions != NULL)
+  if (len == 0)
     {
-      for (guint i = 0; i < sessions->len; i++)
-        {
-          if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
-            {
-              active_session = g_ptr_array_index (sessions, i);
-            }
-        }
-
-      g_assert (active_session);
-      g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
+      g_free (data);
+      return;
     }
 
-  selected_count = gtk_tree_selection_count_selected_rows (
-    self->procinfo_treeview_select);
-  gtk_tree_selection_selected_foreach (self->procinfo_treeview_select,
-                                       procinfo_selection_foreach_get_pid,
-                                       &selected_pids);
-
-  if (proc_info_data != NULL)
+  d = kdata_column_alloc_pairs (data, len, g_free, data);
+  if (d == NULL)
     {
-      g_autofree guint *entry_index_set = calloc (proc_info_data->len, sizeof(guint));
-      guint entry_count = 0;
-
-      if (proc_info_data->len > 0)
-        {
-          if (selected_count > 0)
-            {
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 0)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d1 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d1->pairs[i].x = timestamp;
-                  d1->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 1)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 1)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d2 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d2->pairs[i].x = timestamp;
-                  d2->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 2)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 2)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d3 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d3->pairs[i].x = timestamp;
-                  d3->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 3)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 3)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d4 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d4->pairs[i].x = timestamp;
-                  d4->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 4)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < proc_info_data->len; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, i);
-
-                  if (tkm_procinfo_entry_get_data (entry, PINFO_DATA_PID)
-                      == GPOINTER_TO_INT (g_list_nth (selected_pids, 4)->data))
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d5 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmProcInfoEntry *entry
-                    = g_ptr_array_index (proc_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_procinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d5->pairs[i].x = timestamp;
-                  d5->pairs[i].y = tkm_procinfo_entry_get_data (
-                    entry, PINFO_DATA_MEM_RSS);
-                }
-            }
-        }
+      g_free (data);
+      return;
     }
 
-  g_list_free (selected_pids);
-
-  kplotcfg_defaults (&plotcfg);
-  plotcfg.grid = GRID_ALL;
-  plotcfg.extrema = EXTREMA_YMIN;
-  plotcfg.extrema_ymin = 0;
-  plotcfg.xticlabelfmt = timestamp_format_procview;
-  plotcfg.yticlabelfmt = memory_format_procview;
-
-  p = kplot_alloc (&plotcfg);
-
-  if (d1 != NULL)
-    {
-      struct kdatacfg d1_cfg;
+  kdatacfg_defaults (&cfg);
+  cfg.line.sz = 1.0;
+  cfg.line.clr.type = KPLOTCTYPE_RGBA;
+  for (guint i = 0; i < 4; i++)
+    cfg.line.clr.rgba[i] = rgba[i];
 
-      kdatacfg_defaults (&d1_cfg);
-      d1_cfg.line.sz = 1.0;
-      d1_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d1_cfg.line.clr.rgba[0] = 1.0;
-      d1_cfg.line.clr.rgba[3] = 1.0;
+  kplot_attach_data (p, d, type, &cfg);
+  kdata_destroy (d);
+}
 
-      kplot_attach_data (p, d1, KPLOT_LINES, &d1_cfg);
-    }
-  if (d2 != NULL)
-    {
-      struct kdatacfg d2_cfg;
+/*
+ * Stack the series on a common time line, missing samples count as zero.
+ * The layers are attached from the topmost down so every area is filled
+ * over the one above it.
+ */
+static void
+history_series_attach_stacked (struct kplot *p, GArray **series,
+                               double (*colors)[4], guint count)
+{
+  g_autoptr (GArray) timeline = g_array_new (FALSE, FALSE, sizeof (double));
+  g_autofree double *acc = NULL;
+  g_autofree GArray **layers = g_new0 (GArray *, count);
+  guint len = 0;
 
-      kdatacfg_defaults (&d2_cfg);
-      d2_cfg.line.sz = 1.0;
-      d2_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d2_cfg.line.clr.rgba[2] = 1.0;
-      d2_cfg.line.clr.rgba[3] = 1.0;
+  for (guint i = 0; i < count; i++)
+    for (guint j = 0; j < series[i]->len; j++)
+      g_array_append_val (timeline,
+                          g_array_index (series[i], struct kpair, j).x);
 
-      kplot_attach_data (p, d2, KPLOT_LINES, &d2_cfg);
-    }
-  if (d3 != NULL)
+  g_array_sort (timeline, history_double_compare);
+  for (guint i = 0; i < timeline->len; i++)
     {
-      struct kdatacfg d3_cfg;
-
-      kdatacfg_defaults (&d3_cfg);
-      d3_cfg.line.sz = 1.0;
-      d3_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d3_cfg.line.clr.rgba[1] = 1.0;
-      d3_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d3, KPLOT_LINES, &d3_cfg);
+      if (len == 0
+          || g_array_index (timeline, double, i)
+               != g_array_index (timeline, double, len - 1))
+        g_array_index (timeline, double, len++)
+          = g_array_index (timeline, double, i);
     }
-  if (d4 != NULL)
-    {
-      struct kdatacfg d4_cfg;
+  g_array_set_size (timeline, len);
 
-      kdatacfg_defaults (&d4_cfg);
-      d4_cfg.line.sz = 1.0;
-      d4_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d4_cfg.line.clr.rgba[0] = 0.4;
-      d4_cfg.line.clr.rgba[1] = 0.0;
-      d4_cfg.line.clr.rgba[2] = 0.6;
-      d4_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
-    }
-  if (d5 != NULL)
+  acc = g_new0 (double, len);
+  for (guint i = 0; i < count; i++)
     {
-      struct kdatacfg d5_cfg;
+      guint j = 0;
 
-      kdatacfg_defaults (&d5_cfg);
-      d5_cfg.line.sz = 1.0;
-      d5_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d5_cfg.line.clr.rgba[0] = 0.9;
-      d5_cfg.line.clr.rgba[1] = 0.4;
-      d5_cfg.line.clr.rgba[2] = 0.3;
-      d5_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
+      layers[i] = g_array_sized_new (FALSE, FALSE, sizeof (struct kpair), len);
+      for (guint k = 0; k < len; k++)
+        {
+          double x = g_array_index (timeline, double, k);
+          struct kpair kp;
+
+          while (j < series[i]->len
+                 && g_array_index (series[i], struct kpair, j).x < x)
+            j++;
+          if (j < series[i]->len
+              && g_array_index (series[i], struct kpair, j).x == x)
+            acc[k] += g_array_index (series[i], struct kpair, j).y;
+
+          kp.x = x;
+          kp.y = acc[k];
+          g_array_append_val (layers[i], kp);
+        }
+      g_array_free (series[i], TRUE);
+      series[i] = NULL;
     }
 
-  kplot_draw (p, width, height, cr);
-
-  kdata_destroy (d1);
-  kdata_destroy (d2);
-  kdata_destroy (d3);
-  kdata_destroy (d4);
-  kdata_destroy (d5);
-
-  kplot_free (p);
+  for (guint i = count; i > 0; i--)
+    history_series_attach (p, layers[i - 1], KPLOT_AREA, colors[i - 1]);
 }
 
-static void
-ctxinfo_cpu_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                   int width, int height, gpointer data)
+/*
+ * Chart the rows of the selected processes or contexts. All selected
+ * series are grouped in a single pass over the rows, the ones beyond the
+ * configured count with the lowest totals are summed as others.
+ */
+static struct kplot *
+history_series_build (GPtrArray *rows, const HistorySeriesSource *source,
+                      HistorySelection *selection,
+                      const struct kplotcfg *plotcfg)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
   TkmvSettings *settings
     = tkmv_application_get_settings (tkmv_application_instance ());
-  TkmvProcessesView *self = (TkmvProcessesView *)data;
-  GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *ctx_info_data = tkm_context_get_ctxinfo_entries (context);
-  TkmSessionEntry *active_session = NULL;
-
-  struct kdata *d1 = NULL;
-  struct kdata *d2 = NULL;
-  struct kdata *d3 = NULL;
-  struct kdata *d4 = NULL;
-  struct kdata *d5 = NULL;
-
-  struct kplotcfg plotcfg;
-  struct kplot *p = NULL;
-
-  guint selected_count = 0;
-  GList *selected_ids = NULL;
-
-  TKMV_UNUSED (area);
-
-  if (sessions != NULL)
-    {
-      for (guint i = 0; i < sessions->len; i++)
+  DataTimeSource time_source = tkmv_settings_get_time_source (settings);
+  g_autoptr (GHashTable) index = NULL;
+  g_autofree GArray **series = NULL;
+  g_autofree GArray **shown = NULL;
+  g_autofree double (*colors)[4] = NULL;
+  g_autofree double *sums = NULL;
+  g_autofree guint *order = NULL;
+  g_autofree gboolean *kept = NULL;
+  GArray *others = NULL;
+  struct kplot *p = kplot_alloc (plotcfg);
+  guint count = 0;
+  guint shown_count = 0;
+  guint i = 0;
+
+  if (p == NULL || rows == NULL || selection == NULL)
+    return p;
+
+  count = g_list_length (selection->keys);
+  if (count == 0)
+    return p;
+
+  index = g_hash_table_new (source->hash, source->equal);
+  i = 0;
+  for (GList *l = selection->keys; l != NULL; l = l->next)
+    g_hash_table_insert (index, l->data, GUINT_TO_POINTER (++i));
+
+  series = g_new0 (GArray *, count);
+  sums = g_new0 (double, count);
+  for (i = 0; i < count; i++)
+    series[i] = g_array_new (FALSE, FALSE, sizeof (struct kpair));
+
+  for (guint r = 0; r < rows->len; r++)
+    {
+      gpointer entry = g_ptr_array_index (rows, r);
+      guint n = GPOINTER_TO_UINT (
+        g_hash_table_lookup (index, source->key (entry)));
+      struct kpair kp;
+
+      if (n == 0)
+        continue;
+
+      kp.x = source->timestamp (entry, time_source);
+      kp.y = source->value (entry);
+      g_array_append_val (series[n - 1], kp);
+      sums[n - 1] += kp.y;
+    }
+
+  order = g_new (guint, count);
+  kept = g_new0 (gboolean, count);
+  for (i = 0; i < count; i++)
+    order[i] = i;
+  g_qsort_with_data (order, count, sizeof (guint), history_series_rank_compare,
+                     sums);
+  for (i = 0; i < MIN (count, selection->top_count); i++)
+    kept[order[i]] = TRUE;
+
+  /* Kept series in selection order so colours follow the legend */
+  shown = g_new0 (GArray *, count + 1);
+  colors = g_malloc0_n (count + 1, sizeof (*colors));
+  for (i = 0; i < count; i++)
+    {
+      if (!kept[i])
         {
-          if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
-            {
-              active_session = g_ptr_array_index (sessions, i);
-            }
+          if (others == NULL)
+            others = g_array_new (FALSE, FALSE, sizeof (struct kpair));
+          g_array_append_vals (others, series[i]->data, series[i]->len);
+          g_array_free (series[i], TRUE);
+          continue;
         }
 
-      g_assert (active_session);
-      g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
+      history_series_color (i, colors[shown_count]);
+      shown[shown_count++] = series[i];
     }
 
-  selected_count
-    = gtk_tree_selection_count_selected_rows (self->ctxinfo_treeview_select);
-  gtk_tree_selection_selected_foreach (self->ctxinfo_treeview_select,
-                                       ctxinfo_selection_foreach_get_id,
-                                       &selected_ids);
-
-  if (ctx_info_data != NULL)
+  if (others != NULL)
     {
-      g_autofree guint *entry_index_set = calloc (ctx_info_data->len, sizeof(guint));
-      guint entry_count = 0;
+      guint len = 0;
 
-      if (ctx_info_data->len > 0)
+      g_array_sort (others, history_pair_compare);
+      for (i = 0; i < others->len; i++)
         {
-          if (selected_count > 0)
-            {
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 0)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d1 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d1->pairs[i].x = timestamp;
-                  d1->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 1)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 1)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d2 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d2->pairs[i].x = timestamp;
-                  d2->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 2)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 2)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d3 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d3->pairs[i].x = timestamp;
-                  d3->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 3)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 3)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d4 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d4->pairs[i].x = timestamp;
-                  d4->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_CPU_PERCENT);
-                }
-            }
-
-          if (selected_count > 4)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 4)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d5 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d5->pairs[i].x = timestamp;
-                  d5->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_CPU_PERCENT);
-                }
-            }
-        }
-    }
+          struct kpair *kp = &g_array_index (others, struct kpair, i);
 
-  g_list_free_full (selected_ids, g_free);
+          if (len > 0
+              && g_array_index (others, struct kpair, len - 1).x == kp->x)
+            g_array_index (others, struct kpair, len - 1).y += kp->y;
+          else
+            g_array_index (others, struct kpair, len++) = *kp;
+        }
+      g_array_set_size (others, len);
 
-  kplotcfg_defaults (&plotcfg);
-  plotcfg.grid = GRID_ALL;
-  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
-  plotcfg.extrema_ymin = 0;
-  if (active_session != NULL)
-    {
-      plotcfg.extrema_ymax
-        = (100 * tkm_session_entry_get_device_cpus (active_session));
+      colors[shown_count][0] = colors[shown_count][1]
+        = colors[shown_count][2] = 0.5;
+      colors[shown_count][3] = 1.0;
+      shown[shown_count++] = others;
     }
-  else
-    {
-      plotcfg.extrema_ymax = 100;
-    }
-  plotcfg.xticlabelfmt = timestamp_format_procview;
-  plotcfg.yticlabelfmt = percent_format_procview;
-
-  p = kplot_alloc (&plotcfg);
 
-  if (d1 != NULL)
+  if (selection->mode == PROCESS_CHART_MODE_STACKED)
     {
-      struct kdatacfg d1_cfg;
-
-      kdatacfg_defaults (&d1_cfg);
-      d1_cfg.line.sz = 1.0;
-      d1_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d1_cfg.line.clr.rgba[0] = 1.0;
-      d1_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d1, KPLOT_LINES, &d1_cfg);
+      history_series_attach_stacked (p, shown, colors, shown_count);
     }
-  if (d2 != NULL)
+  else
     {
-      struct kdatacfg d2_cfg;
-
-      kdatacfg_defaults (&d2_cfg);
-      d2_cfg.line.sz = 1.0;
-      d2_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d2_cfg.line.clr.rgba[2] = 1.0;
-      d2_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d2, KPLOT_LINES, &d2_cfg);
+      for (i = 0; i < shown_count; i++)
+        history_series_attach (p, shown[i], KPLOT_LINES, colors[i]);
     }
-  if (d3 != NULL)
-    {
-      struct kdatacfg d3_cfg;
 
-      kdatacfg_defaults (&d3_cfg);
-      d3_cfg.line.sz = 1.0;
-      d3_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d3_cfg.line.clr.rgba[1] = 1.0;
-      d3_cfg.line.clr.rgba[3] = 1.0;
+  return p;
+}
 
-      kplot_attach_data (p, d3, KPLOT_LINES, &d3_cfg);
-    }
-  if (d4 != NULL)
-    {
-      struct kdatacfg d4_cfg;
+static guint
+history_active_cpus (TkmContext *context)
+{
+  GPtrArray *sessions = tkm_context_get_session_entries (context);
 
-      kdatacfg_defaults (&d4_cfg);
-      d4_cfg.line.sz = 1.0;
-      d4_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d4_cfg.line.clr.rgba[0] = 0.4;
-      d4_cfg.line.clr.rgba[1] = 0.0;
-      d4_cfg.line.clr.rgba[2] = 0.6;
-      d4_cfg.line.clr.rgba[3] = 1.0;
+  if (sessions == NULL)
+    return 0;
 
-      kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
-    }
-  if (d5 != NULL)
+  for (guint i = 0; i < sessions->len; i++)
     {
-      struct kdatacfg d5_cfg;
-
-      kdatacfg_defaults (&d5_cfg);
-      d5_cfg.line.sz = 1.0;
-      d5_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d5_cfg.line.clr.rgba[0] = 0.9;
-      d5_cfg.line.clr.rgba[1] = 0.4;
-      d5_cfg.line.clr.rgba[2] = 0.3;
-      d5_cfg.line.clr.rgba[3] = 1.0;
+      TkmSessionEntry *session = g_ptr_array_index (sessions, i);
 
-      kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
+      if (tkm_session_entry_get_active (session))
+        return tkm_session_entry_get_device_cpus (session);
     }
 
-  kplot_draw (p, width, height, cr);
-
-  kdata_destroy (d1);
-  kdata_destroy (d2);
-  kdata_destroy (d3);
-  kdata_destroy (d4);
-  kdata_destroy (d5);
-
-  kplot_free (p);
+  return 0;
 }
 
-static void
-ctxinfo_mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
-                                   int width, int height, gpointer data)
+static struct kplot *
+procinfo_cpu_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
-  TkmvSettings *settings
-    = tkmv_application_get_settings (tkmv_application_instance ());
-  TkmvProcessesView *self = (TkmvProcessesView *)data;
-  GPtrArray *sessions = tkm_context_get_session_entries (context);
-  GPtrArray *ctx_info_data = tkm_context_get_ctxinfo_entries (context);
-  TkmSessionEntry *active_session = NULL;
-
-  struct kdata *d1 = NULL;
-  struct kdata *d2 = NULL;
-  struct kdata *d3 = NULL;
-  struct kdata *d4 = NULL;
-  struct kdata *d5 = NULL;
-
+  guint cpus = history_active_cpus (context);
   struct kplotcfg plotcfg;
-  struct kplot *p = NULL;
-
-  guint selected_count = 0;
-  GList *selected_ids = NULL;
 
-  TKMV_UNUSED (area);
-
-  if (sessions != NULL)
-    {
-      for (guint i = 0; i < sessions->len; i++)
-        {
-          if (tkm_session_entry_get_active (g_ptr_array_index (sessions, i)))
-            {
-              active_session = g_ptr_array_index (sessions, i);
-            }
-        }
-
-      g_assert (active_session);
-      g_assert (tkm_session_entry_get_device_cpus (active_session) > 0);
-    }
-
-  selected_count
-    = gtk_tree_selection_count_selected_rows (self->ctxinfo_treeview_select);
-  gtk_tree_selection_selected_foreach (self->ctxinfo_treeview_select,
-                                       ctxinfo_selection_foreach_get_id,
-                                       &selected_ids);
-
-  if (ctx_info_data != NULL)
-    {
-      g_autofree guint *entry_index_set = calloc (ctx_info_data->len, sizeof(guint));
-      guint entry_count = 0;
+  kplotcfg_defaults (&plotcfg);
+  plotcfg.grid = GRID_ALL;
+  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
+  plotcfg.extrema_ymin = 0;
+  plotcfg.extrema_ymax = 100 * MAX (cpus, 1);
+  plotcfg.xticlabelfmt = timestamp_format_procview;
+  plotcfg.yticlabelfmt = percent_format_procview;
 
-      if (ctx_info_data->len > 0)
-        {
-          if (selected_count > 0)
-            {
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 0)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d1 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d1->pairs[i].x = timestamp;
-                  d1->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 1)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 1)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d2 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d2->pairs[i].x = timestamp;
-                  d2->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 2)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 2)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d3 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d3->pairs[i].x = timestamp;
-                  d3->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 3)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 3)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d4 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d4->pairs[i].x = timestamp;
-                  d4->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_MEM_RSS);
-                }
-            }
-
-          if (selected_count > 4)
-            {
-              entry_count = 0;
-              for (guint i = 0; i < ctx_info_data->len; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, i);
-
-                  if (g_strcmp0 (tkm_ctxinfo_entry_get_id (entry),
-                                 (gchar *)g_list_nth (selected_ids, 4)->data)
-                      == 0)
-                    {
-                      entry_index_set[entry_count++] = i;
-                    }
-                }
-
-              if (entry_count > 0)
-                {
-                  d5 = kdata_array_alloc (NULL, entry_count);
-                }
-
-              for (guint i = 0; i < entry_count; i++)
-                {
-                  TkmCtxInfoEntry *entry
-                    = g_ptr_array_index (ctx_info_data, entry_index_set[i]);
-                  gulong timestamp = tkm_ctxinfo_entry_get_timestamp (
-                    entry, tkmv_settings_get_time_source (settings));
-
-                  d5->pairs[i].x = timestamp;
-                  d5->pairs[i].y = tkm_ctxinfo_entry_get_data (
-                    entry, CTXINFO_DATA_MEM_RSS);
-                }
-            }
-        }
-    }
+  return history_series_build (tkm_context_get_procinfo_entries (context),
+                               &procinfo_cpu_source, data, &plotcfg);
+}
 
-  g_list_free_full (selected_ids, g_free);
+static struct kplot *
+procinfo_mem_history_build_function (gpointer data)
+{
+  TkmContext *context
+    = tkmv_application_get_context (tkmv_application_instance ());
+  struct kplotcfg plotcfg;
 
   kplotcfg_defaults (&plotcfg);
   plotcfg.grid = GRID_ALL;
@@ -2967,164 +2411,113 @@ ctxinfo_mem_history_draw_function (GtkDrawingArea *area, cairo_t *cr,
   plotcfg.xticlabelfmt = timestamp_format_procview;
   plotcfg.yticlabelfmt = memory_format_procview;
 
-  p = kplot_alloc (&plotcfg);
-
-  if (d1 != NULL)
-    {
-      struct kdatacfg d1_cfg;
-
-      kdatacfg_defaults (&d1_cfg);
-      d1_cfg.line.sz = 1.0;
-      d1_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d1_cfg.line.clr.rgba[0] = 1.0;
-      d1_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d1, KPLOT_LINES, &d1_cfg);
-    }
-  if (d2 != NULL)
-    {
-      struct kdatacfg d2_cfg;
-
-      kdatacfg_defaults (&d2_cfg);
-      d2_cfg.line.sz = 1.0;
-      d2_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d2_cfg.line.clr.rgba[2] = 1.0;
-      d2_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d2, KPLOT_LINES, &d2_cfg);
-    }
-  if (d3 != NULL)
-    {
-      struct kdatacfg d3_cfg;
-
-      kdatacfg_defaults (&d3_cfg);
-      d3_cfg.line.sz = 1.0;
-      d3_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d3_cfg.line.clr.rgba[1] = 1.0;
-      d3_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d3, KPLOT_LINES, &d3_cfg);
-    }
-  if (d4 != NULL)
-    {
-      struct kdatacfg d4_cfg;
-
-      kdatacfg_defaults (&d4_cfg);
-      d4_cfg.line.sz = 1.0;
-      d4_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d4_cfg.line.clr.rgba[0] = 0.4;
-      d4_cfg.line.clr.rgba[1] = 0.0;
-      d4_cfg.line.clr.rgba[2] = 0.6;
-      d4_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d4, KPLOT_LINES, &d4_cfg);
-    }
-  if (d5 != NULL)
-    {
-      struct kdatacfg d5_cfg;
-
-      kdatacfg_defaults (&d5_cfg);
-      d5_cfg.line.sz = 1.0;
-      d5_cfg.line.clr.type = KPLOTCTYPE_RGBA;
-      d5_cfg.line.clr.rgba[0] = 0.9;
-      d5_cfg.line.clr.rgba[1] = 0.4;
-      d5_cfg.line.clr.rgba[2] = 0.3;
-      d5_cfg.line.clr.rgba[3] = 1.0;
-
-      kplot_attach_data (p, d5, KPLOT_LINES, &d5_cfg);
-    }
-
-  kplot_draw (p, width, height, cr);
-
-  kdata_destroy (d1);
-  kdata_destroy (d2);
-  kdata_destroy (d3);
-  kdata_destroy (d4);
-  kdata_destroy (d5);
-
-  kplot_free (p);
+  return history_series_build (tkm_context_get_procinfo_entries (context),
+                               &procinfo_mem_source, data, &plotcfg);
 }
 
-static void
-procinfo_cpu_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                         int width, int height, gpointer data)
+static struct kplot *
+ctxinfo_cpu_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
+  guint cpus = history_active_cpus (context);
+  struct kplotcfg plotcfg;
 
-  if (tkm_context_data_try_lock (context))
-    {
-      procinfo_cpu_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
-    }
+  kplotcfg_defaults (&plotcfg);
+  plotcfg.grid = GRID_ALL;
+  plotcfg.extrema = EXTREMA_YMAX | EXTREMA_YMIN;
+  plotcfg.extrema_ymin = 0;
+  plotcfg.extrema_ymax = 100 * MAX (cpus, 1);
+  plotcfg.xticlabelfmt = timestamp_format_procview;
+  plotcfg.yticlabelfmt = percent_format_procview;
+
+  return history_series_build (tkm_context_get_ctxinfo_entries (context),
+                               &ctxinfo_cpu_source, data, &plotcfg);
 }
 
-static void
-procinfo_mem_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                         int width, int height, gpointer data)
+static struct kplot *
+ctxinfo_mem_history_build_function (gpointer data)
 {
   TkmContext *context
     = tkmv_application_get_context (tkmv_application_instance ());
+  struct kplotcfg plotcfg;
 
-  if (tkm_context_data_try_lock (context))
-    {
-      procinfo_mem_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
-    }
+  kplotcfg_defaults (&plotcfg);
+  plotcfg.grid = GRID_ALL;
+  plotcfg.extrema = EXTREMA_YMIN;
+  plotcfg.extrema_ymin = 0;
+  plotcfg.xticlabelfmt = timestamp_format_procview;
+  plotcfg.yticlabelfmt = memory_format_procview;
+
+  return history_series_build (tkm_context_get_ctxinfo_entries (context),
+                               &ctxinfo_mem_source, data, &plotcfg);
 }
 
 static void
-ctxinfo_cpu_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                        int width, int height, gpointer data)
+reload_stats_reset (TkmvProcessesView *view)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
+  /* Statistics still computing for a previous window are dropped */
+  view->stats_serial++;
 
-  if (tkm_context_data_try_lock (context))
+  if (view->stats_group != NULL)
     {
-      ctxinfo_cpu_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
+      tkm_task_group_cancel (view->stats_group);
+      tkm_task_group_unref (view->stats_group);
     }
+  view->stats_group = tkm_task_group_new ();
 }
 
-static void
-ctxinfo_mem_history_draw_function_safe (GtkDrawingArea *area, cairo_t *cr,
-                                        int width, int height, gpointer data)
+static gboolean
+reload_tables_slice (TkmvProcessesView *view, TkmContext *context,
+                     guint slice)
 {
-  TkmContext *context
-    = tkmv_application_get_context (tkmv_application_instance ());
-
-  if (tkm_context_data_try_lock (context))
-    {
-      ctxinfo_mem_history_draw_function (area, cr, width, height, data);
-      tkm_context_data_unlock (context);
+  switch (slice)
+    {
+    case 0:
+      reload_stats_reset (view);
+      reload_procinfo_entries (view, context);
+      return TRUE;
+    case 1:
+      reload_ctxinfo_entries (view, context);
+      return TRUE;
+    case 2:
+      reload_procacct_entries (view, context);
+      return TRUE;
+    default:
+      break;
     }
+
+  /* select first entry in proc and context tables */
+  table_select_first (view->procinfo_treeview_select);
+  table_select_first (view->ctxinfo_treeview_select);
+
+  return FALSE;
 }
 
-void
-tkmv_processes_reload_entries (TkmvProcessesView *view, TkmContext *context)
+gboolean
+tkmv_processes_reload_slice (TkmvProcessesView *view, TkmContext *context,
+                             guint slice)
 {
-  guint selected_count = 0;
+  if (reload_tables_slice (view, context, slice))
+    return TRUE;
 
-  reload_procinfo_entries (view, context);
-  reload_ctxinfo_entries (view, context);
-  reload_procacct_entries (view, context);
+  processes_charts_reset (view);
 
-  /* select first entry in proc and context tables */
-  selected_count = gtk_tree_selection_count_selected_rows (
-    view->procinfo_treeview_select);
-  if (selected_count == 0)
-    {
-      GtkTreePath *path = gtk_tree_path_new_from_indices (0, -1);
-      gtk_tree_selection_select_path (view->procinfo_treeview_select, path);
-    }
+  return FALSE;
+}
 
-  selected_count
-    = gtk_tree_selection_count_selected_rows (view->ctxinfo_treeview_select);
-  if (selected_count == 0)
-    {
-      GtkTreePath *path = gtk_tree_path_new_from_indices (0, -1);
-      gtk_tree_selection_select_path (view->ctxinfo_treeview_select, path);
-    }
+static void
+processes_charts_reset (TkmvProcessesView *view)
+{
+  /* A new window starts zoomed out */
+  tkmv_chart_reset_viewport (view->procinfo_history_cpu_chart);
+  tkmv_chart_reset_viewport (view->procinfo_history_mem_chart);
+  tkmv_chart_reset_viewport (view->ctxinfo_history_cpu_chart);
+  tkmv_chart_reset_viewport (view->ctxinfo_history_mem_chart);
+
+  tkmv_chart_invalidate (view->procinfo_history_cpu_chart);
+  tkmv_chart_invalidate (view->procinfo_history_mem_chart);
+  tkmv_chart_invalidate (view->ctxinfo_history_cpu_chart);
+  tkmv_chart_invalidate (view->ctxinfo_history_mem_chart);
 }
 
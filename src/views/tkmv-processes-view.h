@@ -29,7 +29,11 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE (TkmvProcessesView, tkmv_processes_view, TKMV,
                       PROCESSES_VIEW, GtkBox)
 
-void tkmv_processes_reload_entries (TkmvProcessesView *view,
-                                    TkmContext *context);
+/*
+ * Reload step slice of the loaded window so the tables can be rebuilt
+ * over several main loop iterations, TRUE while steps remain.
+ */
+gboolean tkmv_processes_reload_slice (TkmvProcessesView *view,
+                                      TkmContext *context, guint slice);
 
 G_END_DECLS
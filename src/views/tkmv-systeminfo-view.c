@@ -22,6 +22,8 @@
 #include "tkm-diskstat-entry.h"
 #include "tkm-meminfo-entry.h"
 #include "tkm-wireless-entry.h"
+#include "tkmv-application.h"
+#include "tkmv-entry-model.h"
 #include "tkmv-types.h"
 
 enum {
@@ -104,40 +106,35 @@ static void diskinfo_selection_changed (GtkTreeSelection *selection,
                                         gpointer data);
 static void create_tables (TkmvSysteminfoView *self);
 
-static void cpuinfo_list_store_append_entry (GtkListStore *list_store,
-                                             TkmCpuStatEntry *entry,
-                                             GtkTreeIter *iter);
+static void cpuinfo_entry_get_value (gpointer entry, gint column,
+                                     GValue *value);
 static void reload_cpuinfo_entries (TkmvSysteminfoView *view,
                                     TkmContext *context);
-static void meminfo_list_store_append_entry (GtkListStore *list_store,
-                                             TkmMemInfoEntry *entry,
-                                             GtkTreeIter *iter);
+static void meminfo_entry_get_value (gpointer entry, gint column,
+                                     GValue *value);
 static void reload_meminfo_entries (TkmvSysteminfoView *view,
                                     TkmContext *context);
-static void buddyinfo_list_store_append_entry (GtkListStore *list_store,
-                                               TkmBuddyInfoEntry *entry,
-                                               GtkTreeIter *iter);
+static void buddyinfo_entry_get_value (gpointer entry, gint column,
+                                       GValue *value);
 static void reload_buddyinfo_entries (TkmvSysteminfoView *view,
                                       TkmContext *context);
-static void wlaninfo_list_store_append_entry (GtkListStore *list_store,
-                                              TkmWirelessEntry *entry,
-                                              GtkTreeIter *iter);
+static void wlaninfo_entry_get_value (gpointer entry, gint column,
+                                      GValue *value);
 static void reload_wlaninfo_entries (TkmvSysteminfoView *view,
                                      TkmContext *context);
-static void diskinfo_list_store_append_entry (GtkListStore *list_store,
-                                              TkmDiskStatEntry *entry,
-                                              GtkTreeIter *iter);
+static void diskinfo_entry_get_value (gpointer entry, gint column,
+                                      GValue *value);
 static void reload_diskinfo_entries (TkmvSysteminfoView *view,
                                      TkmContext *context);
 
 struct _TkmvSysteminfoView {
   GtkBox parent_instance;
 
-  GtkListStore *cpuinfo_store;
-  GtkListStore *meminfo_store;
-  GtkListStore *buddyinfo_store;
-  GtkListStore *wlaninfo_store;
-  GtkListStore *diskinfo_store;
+  TkmvEntryModel *cpuinfo_model;
+  TkmvEntryModel *meminfo_model;
+  TkmvEntryModel *buddyinfo_model;
+  TkmvEntryModel *wlaninfo_model;
+  TkmvEntryModel *diskinfo_model;
 
   /* Template widgets */
   GtkScrolledWindow *cpuinfo_scrolled_window;
@@ -159,11 +156,28 @@ struct _TkmvSysteminfoView {
 
 G_DEFINE_TYPE (TkmvSysteminfoView, tkmv_systeminfo_view, GTK_TYPE_BOX)
 
+static void
+tkmv_systeminfo_view_finalize (GObject *object)
+{
+  TkmvSysteminfoView *self = (TkmvSysteminfoView *)object;
+
+  g_clear_object (&self->cpuinfo_model);
+  g_clear_object (&self->meminfo_model);
+  g_clear_object (&self->buddyinfo_model);
+  g_clear_object (&self->wlaninfo_model);
+  g_clear_object (&self->diskinfo_model);
+
+  G_OBJECT_CLASS (tkmv_systeminfo_view_parent_class)->finalize (object);
+}
+
 static void
 tkmv_systeminfo_view_class_init (TkmvSysteminfoViewClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  object_class->finalize = tkmv_systeminfo_view_finalize;
+
   gtk_widget_class_set_template_from_resource (
     widget_class,
     "/ro/fxdata/taskmonitor/viewer/gtk/tkmv-systeminfo-view.ui");
@@ -210,6 +224,15 @@ tkmv_systeminfo_view_init (TkmvSysteminfoView *self)
 static void
 tkmv_systeminfo_view_widgets_init (TkmvSysteminfoView *self)
 {
+  tkm_context_register_view (
+    tkmv_application_get_context (tkmv_application_instance ()),
+    "systeminfo",
+    EPOOL_TABLE_BIT (EPOOL_TABLE_CPUSTAT)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_MEMINFO)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_BUDDYINFO)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_WIRELESS)
+      | EPOOL_TABLE_BIT (EPOOL_TABLE_DISKSTAT));
+
   create_tables (self);
 }
 
@@ -635,223 +658,43 @@ diskinfo_selection_changed (GtkTreeSelection *selection, gpointer data)
   TKMV_UNUSED (data);
 }
 
-int
-diskinfo_sort_iter_compare_func (GtkTreeModel *model, GtkTreeIter *a,
-                                 GtkTreeIter *b, gpointer userdata)
-{
-  int sortcol = GPOINTER_TO_INT (userdata);
-  int ret = 0; /* default if egual */
-
-  switch (sortcol)
-    {
-    case COLUMN_DISKINFO_NAME:
-    {
-      char *name1, *name2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_NAME, &name1, -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_NAME, &name2, -1);
-
-      if (name1 == NULL || name2 == NULL)
-        {
-          if (name1 == NULL && name2 == NULL)
-            break;   /* both equal => ret = 0 */
-
-          ret = (name1 == NULL) ? -1 : 1;
-        }
-      else
-        {
-          ret = g_utf8_collate (name1, name2);
-        }
-
-      g_free (name1);
-      g_free (name2);
-    }
-    break;
-
-    case COLUMN_DISKINFO_MAJOR:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_MAJOR, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_MAJOR, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_MINOR:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_MINOR, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_MINOR, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_IO_SPENT_MS:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_IO_SPENT_MS, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_IO_SPENT_MS, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_READS_MERGED:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_READS_MERGED, &val1, -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_READS_MERGED, &val2, -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_WRITES_MERGED:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_WRITES_MERGED, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_WRITES_MERGED, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_IO_INPROGRESS:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_IO_INPROGRESS, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_IO_INPROGRESS, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_IO_WEIGHTED_MS:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_IO_WEIGHTED_MS, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_IO_WEIGHTED_MS, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_READS_SPENT_MS:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_READS_SPENT_MS, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_READS_SPENT_MS, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_WRITES_SPENT_MS:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_WRITES_SPENT_MS, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_WRITES_SPENT_MS, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_READS_COMPLETED:
-    {
-      glong val1, val2;
-
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_READS_COMPLETED, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_READS_COMPLETED, &val2,
-                          -1);
-
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
-
-    case COLUMN_DISKINFO_WRITES_COMPLETED:
-    {
-      glong val1, val2;
+static const GType cpuinfo_column_types[CPUINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+};
 
-      gtk_tree_model_get (model, a, COLUMN_DISKINFO_WRITES_COMPLETED, &val1,
-                          -1);
-      gtk_tree_model_get (model, b, COLUMN_DISKINFO_WRITES_COMPLETED, &val2,
-                          -1);
+static const GType meminfo_column_types[MEMINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG,
+  G_TYPE_ULONG,  G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG,
+  G_TYPE_ULONG,  G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG,
+};
 
-      if (val1 != val2)
-        {
-          ret = (val1 > val2) ? 1 : -1;
-        }
-    }
-    break;
+static const GType buddyinfo_column_types[BUDDYINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING,
+  G_TYPE_STRING,
+  G_TYPE_STRING,
+};
 
-    default:
-      g_return_val_if_reached (0);
-    }
+static const GType wlaninfo_column_types[WLANINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT,
+  G_TYPE_INT,    G_TYPE_INT,    G_TYPE_INT, G_TYPE_INT, G_TYPE_INT,
+};
 
-  return ret;
-}
+static const GType diskinfo_column_types[DISKINFO_NUM_COLUMNS] = {
+  G_TYPE_STRING, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+  G_TYPE_LONG,   G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
+};
 
 static void
 create_tables (TkmvSysteminfoView *self)
 {
-  /* create cpuinfo store */
-  self->cpuinfo_store
-    = gtk_list_store_new (CPUINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_UINT,
-                          G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT);
+  /* create cpuinfo model */
+  self->cpuinfo_model = tkmv_entry_model_new (
+    CPUINFO_NUM_COLUMNS, cpuinfo_column_types, cpuinfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_cpustat_entry_ref,
+    (GDestroyNotify)tkm_cpustat_entry_unref);
   gtk_tree_view_set_model (self->cpuinfo_treeview,
-                           GTK_TREE_MODEL (self->cpuinfo_store));
+                           GTK_TREE_MODEL (self->cpuinfo_model));
   cpuinfo_add_columns (self);
 
   /* register selection handler */
@@ -862,13 +705,13 @@ create_tables (TkmvSysteminfoView *self)
   g_signal_connect (G_OBJECT (self->cpuinfo_treeview_select), "changed",
                     G_CALLBACK (cpuinfo_selection_changed), self);
 
-  /* create meminfo store */
-  self->meminfo_store = gtk_list_store_new (
-    MEMINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_ULONG, G_TYPE_ULONG,
-    G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG,
-    G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG, G_TYPE_ULONG);
+  /* create meminfo model */
+  self->meminfo_model = tkmv_entry_model_new (
+    MEMINFO_NUM_COLUMNS, meminfo_column_types, meminfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_meminfo_entry_ref,
+    (GDestroyNotify)tkm_meminfo_entry_unref);
   gtk_tree_view_set_model (self->meminfo_treeview,
-                           GTK_TREE_MODEL (self->meminfo_store));
+                           GTK_TREE_MODEL (self->meminfo_model));
   meminfo_add_columns (self);
 
   /* register selection handler */
@@ -879,11 +722,13 @@ create_tables (TkmvSysteminfoView *self)
   g_signal_connect (G_OBJECT (self->meminfo_treeview_select), "changed",
                     G_CALLBACK (meminfo_selection_changed), self);
 
-  /* create buddyinfo store */
-  self->buddyinfo_store = gtk_list_store_new (
-    BUDDYINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
+  /* create buddyinfo model */
+  self->buddyinfo_model = tkmv_entry_model_new (
+    BUDDYINFO_NUM_COLUMNS, buddyinfo_column_types, buddyinfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_buddyinfo_entry_ref,
+    (GDestroyNotify)tkm_buddyinfo_entry_unref);
   gtk_tree_view_set_model (self->buddyinfo_treeview,
-                           GTK_TREE_MODEL (self->buddyinfo_store));
+                           GTK_TREE_MODEL (self->buddyinfo_model));
   buddyinfo_add_columns (self);
 
   /* register selection handler */
@@ -894,13 +739,13 @@ create_tables (TkmvSysteminfoView *self)
   g_signal_connect (G_OBJECT (self->buddyinfo_treeview_select), "changed",
                     G_CALLBACK (buddyinfo_selection_changed), self);
 
-  /* create wlaninfo store */
-  self->wlaninfo_store
-    = gtk_list_store_new (WLANINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_STRING,
-                          G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT,
-                          G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT);
+  /* create wlaninfo model */
+  self->wlaninfo_model = tkmv_entry_model_new (
+    WLANINFO_NUM_COLUMNS, wlaninfo_column_types, wlaninfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_wireless_entry_ref,
+    (GDestroyNotify)tkm_wireless_entry_unref);
   gtk_tree_view_set_model (self->wlaninfo_treeview,
-                           GTK_TREE_MODEL (self->wlaninfo_store));
+                           GTK_TREE_MODEL (self->wlaninfo_model));
   wlaninfo_add_columns (self);
 
   /* register selection handler */
@@ -911,13 +756,13 @@ create_tables (TkmvSysteminfoView *self)
   g_signal_connect (G_OBJECT (self->wlaninfo_treeview_select), "changed",
                     G_CALLBACK (wlaninfo_selection_changed), self);
 
-  /* create diskinfo store */
-  self->diskinfo_store = gtk_list_store_new (
-    DISKINFO_NUM_COLUMNS, G_TYPE_STRING, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG,
-    G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG, G_TYPE_LONG);
+  /* create diskinfo model */
+  self->diskinfo_model = tkmv_entry_model_new (
+    DISKINFO_NUM_COLUMNS, diskinfo_column_types, diskinfo_entry_get_value,
+    (GBoxedCopyFunc)tkm_diskstat_entry_ref,
+    (GDestroyNotify)tkm_diskstat_entry_unref);
   gtk_tree_view_set_model (self->diskinfo_treeview,
-                           GTK_TREE_MODEL (self->diskinfo_store));
+                           GTK_TREE_MODEL (self->diskinfo_model));
   diskinfo_add_columns (self);
 
   /* register selection handler */
@@ -926,52 +771,8 @@ create_tables (TkmvSysteminfoView *self)
   gtk_tree_selection_set_mode (self->diskinfo_treeview_select,
                                GTK_SELECTION_SINGLE);
 
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_NAME,
-    diskinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_DISKINFO_NAME),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_MINOR,
-    diskinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_DISKINFO_MINOR),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_MAJOR,
-    diskinfo_sort_iter_compare_func, GINT_TO_POINTER (COLUMN_DISKINFO_MAJOR),
-    NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_IO_SPENT_MS,
-    diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_IO_SPENT_MS), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_READS_MERGED,
-    diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_READS_MERGED), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_WRITES_MERGED,
-    diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_WRITES_MERGED), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_IO_INPROGRESS,
-    diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_IO_INPROGRESS), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store), COLUMN_DISKINFO_READS_SPENT_MS,
-    diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_READS_SPENT_MS), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store),
-    COLUMN_DISKINFO_READS_COMPLETED, diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_READS_COMPLETED), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store),
-    COLUMN_DISKINFO_WRITES_SPENT_MS, diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_WRITES_SPENT_MS), NULL);
-  gtk_tree_sortable_set_sort_func (
-    GTK_TREE_SORTABLE (self->diskinfo_store),
-    COLUMN_DISKINFO_WRITES_COMPLETED, diskinfo_sort_iter_compare_func,
-    GINT_TO_POINTER (COLUMN_DISKINFO_WRITES_COMPLETED), NULL);
   gtk_tree_sortable_set_sort_column_id (
-    GTK_TREE_SORTABLE (self->diskinfo_store),
+    GTK_TREE_SORTABLE (self->diskinfo_model),
     COLUMN_DISKINFO_WRITES_COMPLETED, GTK_SORT_DESCENDING);
 
   g_signal_connect (G_OBJECT (self->diskinfo_treeview_select), "changed",
@@ -979,23 +780,37 @@ create_tables (TkmvSysteminfoView *self)
 }
 
 static void
-cpuinfo_list_store_append_entry (GtkListStore *list_store,
-                                 TkmCpuStatEntry *entry, GtkTreeIter *iter)
+cpuinfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (list_store, iter, COLUMN_CPUINFO_NAME,
-                      tkm_cpustat_entry_get_name (entry), COLUMN_CPUINFO_ALL,
-                      tkm_cpustat_entry_get_all (entry), COLUMN_CPUINFO_SYS,
-                      tkm_cpustat_entry_get_sys (entry), COLUMN_CPUINFO_USR,
-                      tkm_cpustat_entry_get_usr (entry), COLUMN_CPUINFO_IOW,
-                      tkm_cpustat_entry_get_iow (entry), -1);
+  TkmCpuStatEntry *e = (TkmCpuStatEntry *)entry;
+
+  switch (column)
+    {
+    case COLUMN_CPUINFO_NAME:
+      g_value_set_string (value, tkm_cpustat_entry_get_name (e));
+      break;
+    case COLUMN_CPUINFO_ALL:
+      g_value_set_uint (value, tkm_cpustat_entry_get_all (e));
+      break;
+    case COLUMN_CPUINFO_SYS:
+      g_value_set_uint (value, tkm_cpustat_entry_get_sys (e));
+      break;
+    case COLUMN_CPUINFO_USR:
+      g_value_set_uint (value, tkm_cpustat_entry_get_usr (e));
+      break;
+    case COLUMN_CPUINFO_IOW:
+      g_value_set_uint (value, tkm_cpustat_entry_get_iow (e));
+      break;
+    default:
+      g_return_if_reached ();
+    }
 }
 
 static void
 reload_cpuinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_cpustat_entries (context);
-  GtkTreeIter iter;
+  guint count = 1;
 
   if (entries == NULL)
     return;
@@ -1003,71 +818,42 @@ reload_cpuinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
   if (entries->len == 0)
     return;
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->cpuinfo_treeview), NULL);
-  gtk_list_store_clear (view->cpuinfo_store);
-
-  /* our first entry is "cpu" with overall values */
-  TkmCpuStatEntry *statEntry = g_ptr_array_index (entries, 0);
-
-  tkm_cpustat_entry_set_index (statEntry, 0);
-  cpuinfo_list_store_append_entry (view->cpuinfo_store, statEntry, &iter);
-
-  for (guint i = 1; i < entries->len; i++)
-    {
-      TkmCpuStatEntry *entry = g_ptr_array_index (entries, i);
-
-      tkm_cpustat_entry_set_index (entry, i);
-
-      /* we only list first entry of cpu with cores */
-      if (g_strcmp0 (tkm_cpustat_entry_get_name (entry), "cpu") != 0)
-        {
-          cpuinfo_list_store_append_entry (view->cpuinfo_store, entry, &iter);
-        }
-      else
-        {
-          break;
-        }
-    }
+  /* our first entry is "cpu" with overall values and we only list */
+  /* the cores following it */
+  while (count < entries->len
+         && g_strcmp0 (
+              tkm_cpustat_entry_get_name (g_ptr_array_index (entries, count)),
+              "cpu")
+                != 0)
+    count++;
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->cpuinfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->cpuinfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->cpuinfo_treeview),
-                           GTK_TREE_MODEL (view->cpuinfo_store));
+                           GTK_TREE_MODEL (view->cpuinfo_model));
 }
 
 static void
-meminfo_list_store_append_entry (GtkListStore *list_store,
-                                 TkmMemInfoEntry *entry, GtkTreeIter *iter)
+meminfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_MEMINFO_NAME, "main", COLUMN_MEMINFO_MEM_TOTAL,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_TOTAL),
-    COLUMN_MEMINFO_MEM_FREE,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_FREE),
-    COLUMN_MEMINFO_MEM_AVAIL,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_AVAIL),
-    COLUMN_MEMINFO_MEM_CACHED,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_CACHED),
-    COLUMN_MEMINFO_MEM_PERCENT,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_MEM_PERCENT),
-    COLUMN_MEMINFO_SWAP_TOTAL,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_TOTAL),
-    COLUMN_MEMINFO_SWAP_FREE,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_FREE),
-    COLUMN_MEMINFO_SWAP_CACHED,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_CACHED),
-    COLUMN_MEMINFO_SWAP_PERCENT,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_SWAP_PERCENT),
-    COLUMN_MEMINFO_CMA_TOTAL,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_CMA_TOTAL),
-    COLUMN_MEMINFO_CMA_FREE,
-    tkm_meminfo_entry_get_data (entry, MINFO_DATA_CMA_FREE), -1);
+  TkmMemInfoEntry *e = (TkmMemInfoEntry *)entry;
+  TkmMemInfoDataType type;
+
+  if (column == COLUMN_MEMINFO_NAME)
+    {
+      g_value_set_string (value, "main");
+      return;
+    }
+
+  /* the data columns follow the order of the meminfo data types */
+  type = (TkmMemInfoDataType)(column - COLUMN_MEMINFO_MEM_TOTAL);
+  g_value_set_ulong (value, tkm_meminfo_entry_get_data (e, type));
 }
 
 static void
 reload_meminfo_entries (TkmvSysteminfoView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_meminfo_entries (context);
-  GtkTreeIter iter;
 
   if (entries == NULL)
     return;
@@ -1076,34 +862,38 @@ reload_meminfo_entries (TkmvSysteminfoView *view, TkmContext *context)
     return;
 
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->meminfo_treeview), NULL);
-  gtk_list_store_clear (view->meminfo_store);
-
-  TkmMemInfoEntry *entry = g_ptr_array_index (entries, 0);
-
-  tkm_meminfo_entry_set_index (entry, 0);
-  meminfo_list_store_append_entry (view->meminfo_store, entry, &iter);
-
+  tkmv_entry_model_set_entries (view->meminfo_model, entries, 0, 1);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->meminfo_treeview),
-                           GTK_TREE_MODEL (view->meminfo_store));
+                           GTK_TREE_MODEL (view->meminfo_model));
 }
 
 static void
-buddyinfo_list_store_append_entry (GtkListStore *list_store,
-                                   TkmBuddyInfoEntry *entry, GtkTreeIter *iter)
+buddyinfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_BUDDYINFO_NAME,
-    tkm_buddyinfo_entry_get_name (entry), COLUMN_BUDDYINFO_ZONE,
-    tkm_buddyinfo_entry_get_zone (entry), COLUMN_BUDDYINFO_DATA,
-    tkm_buddyinfo_entry_get_data (entry), -1);
+  TkmBuddyInfoEntry *e = (TkmBuddyInfoEntry *)entry;
+
+  switch (column)
+    {
+    case COLUMN_BUDDYINFO_NAME:
+      g_value_set_string (value, tkm_buddyinfo_entry_get_name (e));
+      break;
+    case COLUMN_BUDDYINFO_ZONE:
+      g_value_set_string (value, tkm_buddyinfo_entry_get_zone (e));
+      break;
+    case COLUMN_BUDDYINFO_DATA:
+      g_value_set_string (value, tkm_buddyinfo_entry_get_data (e));
+      break;
+    default:
+      g_return_if_reached ();
+    }
 }
 
 static void
 reload_buddyinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_buddyinfo_entries (context);
-  GtkTreeIter iter;
+  gulong timestamp = 0;
+  guint count = 1;
 
   if (entries == NULL)
     return;
@@ -1111,68 +901,54 @@ reload_buddyinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
   if (entries->len == 0)
     return;
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->buddyinfo_treeview), NULL);
-  gtk_list_store_clear (view->buddyinfo_store);
-
-  /* get first entry */
-  TkmBuddyInfoEntry *firstEntry = g_ptr_array_index (entries, 0);
-
-  tkm_buddyinfo_entry_set_index (firstEntry, 0);
-  buddyinfo_list_store_append_entry (view->buddyinfo_store, firstEntry, &iter);
-
-  for (guint i = 1; i < entries->len; i++)
+  /* the table shows the rows of the first snapshot */
+  timestamp = tkm_buddyinfo_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                                 DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
     {
-      TkmBuddyInfoEntry *entry = g_ptr_array_index (entries, i);
+      TkmBuddyInfoEntry *entry = g_ptr_array_index (entries, count);
 
-      tkm_buddyinfo_entry_set_index (entry, i);
       if (tkm_buddyinfo_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          == tkm_buddyinfo_entry_get_timestamp (firstEntry,
-                                                DATA_TIME_SOURCE_MONOTONIC))
-        {
-          buddyinfo_list_store_append_entry (view->buddyinfo_store, entry,
-                                             &iter);
-        }
-      else
-        {
-          break;
-        }
+          != timestamp)
+        break;
+
+      count++;
     }
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->buddyinfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->buddyinfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->buddyinfo_treeview),
-                           GTK_TREE_MODEL (view->buddyinfo_store));
+                           GTK_TREE_MODEL (view->buddyinfo_model));
 }
 
 static void
-wlaninfo_list_store_append_entry (GtkListStore *list_store,
-                                  TkmWirelessEntry *entry, GtkTreeIter *iter)
+wlaninfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_WLANINFO_NAME,
-    tkm_wireless_entry_get_name (entry), COLUMN_WLANINFO_STATUS,
-    tkm_wireless_entry_get_status (entry), COLUMN_WLANINFO_QUALITY_LINK,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_QUALITY_LINK),
-    COLUMN_WLANINFO_QUALITY_LEVEL,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_QUALITY_LEVEL),
-    COLUMN_WLANINFO_QUALITY_NOISE,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_QUALITY_NOISE),
-    COLUMN_WLANINFO_DISCARDED_NWID,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_DISCARDED_NWID),
-    COLUMN_WLANINFO_DISCARDED_CRYPT,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_DISCARDED_CRYPT),
-    COLUMN_WLANINFO_DISCARDED_FRAG,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_DISCARDED_FRAG),
-    COLUMN_WLANINFO_DISCARDED_MISC,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_DISCARDED_MISC),
-    COLUMN_WLANINFO_MISSED_BEACON,
-    tkm_wireless_entry_get_data (entry, WLAN_DATA_MISSED_BEACON), -1);
+  TkmWirelessEntry *e = (TkmWirelessEntry *)entry;
+  TkmWirelessDataType type;
+
+  switch (column)
+    {
+    case COLUMN_WLANINFO_NAME:
+      g_value_set_string (value, tkm_wireless_entry_get_name (e));
+      break;
+    case COLUMN_WLANINFO_STATUS:
+      g_value_set_string (value, tkm_wireless_entry_get_status (e));
+      break;
+    default:
+      /* the data columns follow the order of the wireless data types */
+      type = (TkmWirelessDataType)(column - COLUMN_WLANINFO_QUALITY_LINK);
+      g_value_set_int (value, tkm_wireless_entry_get_data (e, type));
+      break;
+    }
 }
 
 static void
 reload_wlaninfo_entries (TkmvSysteminfoView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_wireless_entries (context);
-  GtkTreeIter iter;
+  gulong timestamp = 0;
+  guint count = 1;
 
   if (entries == NULL)
     return;
@@ -1180,73 +956,49 @@ reload_wlaninfo_entries (TkmvSysteminfoView *view, TkmContext *context)
   if (entries->len == 0)
     return;
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->wlaninfo_treeview), NULL);
-  gtk_list_store_clear (view->wlaninfo_store);
-
-  /* get first entry */
-  TkmWirelessEntry *firstEntry = g_ptr_array_index (entries, 0);
-
-  tkm_wireless_entry_set_index (firstEntry, 0);
-  wlaninfo_list_store_append_entry (view->wlaninfo_store, firstEntry, &iter);
-
-  for (guint i = 1; i < entries->len; i++)
+  /* the table shows the rows of the first snapshot */
+  timestamp = tkm_wireless_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                                DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
     {
-      TkmWirelessEntry *entry = g_ptr_array_index (entries, i);
+      TkmWirelessEntry *entry = g_ptr_array_index (entries, count);
 
-      tkm_wireless_entry_set_index (entry, i);
       if (tkm_wireless_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          == tkm_wireless_entry_get_timestamp (firstEntry,
-                                               DATA_TIME_SOURCE_MONOTONIC))
-        {
-          wlaninfo_list_store_append_entry (view->wlaninfo_store, entry,
-                                            &iter);
-        }
-      else
-        {
-          break;
-        }
+          != timestamp)
+        break;
+
+      count++;
     }
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->wlaninfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->wlaninfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->wlaninfo_treeview),
-                           GTK_TREE_MODEL (view->wlaninfo_store));
+                           GTK_TREE_MODEL (view->wlaninfo_model));
 }
 
 static void
-diskinfo_list_store_append_entry (GtkListStore *list_store,
-                                  TkmDiskStatEntry *entry, GtkTreeIter *iter)
+diskinfo_entry_get_value (gpointer entry, gint column, GValue *value)
 {
-  gtk_list_store_append (list_store, iter);
-  gtk_list_store_set (
-    list_store, iter, COLUMN_DISKINFO_NAME,
-    tkm_diskstat_entry_get_name (entry), COLUMN_DISKINFO_MAJOR,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_MAJOR),
-    COLUMN_DISKINFO_MINOR,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_MINOR),
-    COLUMN_DISKINFO_READS_COMPLETED,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_READS_COMPLETED),
-    COLUMN_DISKINFO_READS_MERGED,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_READS_MERGED),
-    COLUMN_DISKINFO_READS_SPENT_MS,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_READS_SPENT_MS),
-    COLUMN_DISKINFO_WRITES_COMPLETED,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_WRITES_COMPLETED),
-    COLUMN_DISKINFO_WRITES_MERGED,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_WRITES_MERGED),
-    COLUMN_DISKINFO_WRITES_SPENT_MS,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_WRITES_SPENT_MS),
-    COLUMN_DISKINFO_IO_INPROGRESS,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_IO_INPROGRESS),
-    COLUMN_DISKINFO_IO_SPENT_MS,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_IO_SPENT_MS),
-    COLUMN_DISKINFO_IO_WEIGHTED_MS,
-    tkm_diskstat_entry_get_data (entry, DISKSTAT_DATA_IO_WEIGHTED_MS), -1);
+  TkmDiskStatEntry *e = (TkmDiskStatEntry *)entry;
+  TkmDiskStatDataType type;
+
+  if (column == COLUMN_DISKINFO_NAME)
+    {
+      g_value_set_string (value, tkm_diskstat_entry_get_name (e));
+      return;
+    }
+
+  /* the data columns follow the order of the diskstat data types */
+  type = (TkmDiskStatDataType)(column - COLUMN_DISKINFO_MAJOR);
+  g_value_set_long (value, tkm_diskstat_entry_get_data (e, type));
 }
 
 static void
 reload_diskinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
 {
   GPtrArray *entries = tkm_context_get_diskstat_entries (context);
-  GtkTreeIter iter;
+  gulong timestamp = 0;
+  guint count = 1;
 
   if (entries == NULL)
     return;
@@ -1254,43 +1006,48 @@ reload_diskinfo_entries (TkmvSysteminfoView *view, TkmContext *context)
   if (entries->len == 0)
     return;
 
-  gtk_tree_view_set_model (GTK_TREE_VIEW (view->diskinfo_treeview), NULL);
-  gtk_list_store_clear (view->diskinfo_store);
-
-  /* get first entry */
-  TkmDiskStatEntry *firstEntry = g_ptr_array_index (entries, 0);
-
-  tkm_diskstat_entry_set_index (firstEntry, 0);
-  diskinfo_list_store_append_entry (view->diskinfo_store, firstEntry, &iter);
-
-  for (guint i = 1; i < entries->len; i++)
+  /* the table shows the rows of the first snapshot */
+  timestamp = tkm_diskstat_entry_get_timestamp (g_ptr_array_index (entries, 0),
+                                                DATA_TIME_SOURCE_MONOTONIC);
+  while (count < entries->len)
     {
-      TkmDiskStatEntry *entry = g_ptr_array_index (entries, i);
+      TkmDiskStatEntry *entry = g_ptr_array_index (entries, count);
 
-      tkm_diskstat_entry_set_index (entry, i);
       if (tkm_diskstat_entry_get_timestamp (entry, DATA_TIME_SOURCE_MONOTONIC)
-          == tkm_diskstat_entry_get_timestamp (firstEntry,
-                                               DATA_TIME_SOURCE_MONOTONIC))
-        {
-          diskinfo_list_store_append_entry (view->diskinfo_store, entry,
-                                            &iter);
-        }
-      else
-        {
-          break;
-        }
+          != timestamp)
+        break;
+
+      count++;
     }
 
+  gtk_tree_view_set_model (GTK_TREE_VIEW (view->diskinfo_treeview), NULL);
+  tkmv_entry_model_set_entries (view->diskinfo_model, entries, 0, count);
   gtk_tree_view_set_model (GTK_TREE_VIEW (view->diskinfo_treeview),
-                           GTK_TREE_MODEL (view->diskinfo_store));
+                           GTK_TREE_MODEL (view->diskinfo_model));
 }
 
-void
-tkmv_systeminfo_reload_entries (TkmvSysteminfoView *view, TkmContext *context)
+gboolean
+tkmv_systeminfo_reload_slice (TkmvSysteminfoView *view, TkmContext *context,
+                              guint slice)
 {
-  reload_cpuinfo_entries (view, context);
-  reload_meminfo_entries (view, context);
-  reload_buddyinfo_entries (view, context);
-  reload_wlaninfo_entries (view, context);
-  reload_diskinfo_entries (view, context);
+  switch (slice)
+    {
+    case 0:
+      reload_cpuinfo_entries (view, context);
+      break;
+    case 1:
+      reload_meminfo_entries (view, context);
+      break;
+    case 2:
+      reload_buddyinfo_entries (view, context);
+      break;
+    case 3:
+      reload_wlaninfo_entries (view, context);
+      break;
+    default:
+      reload_diskinfo_entries (view, context);
+      return FALSE;
+    }
+
+  return TRUE;
 }
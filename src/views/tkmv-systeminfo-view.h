@@ -28,7 +28,8 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE (TkmvSysteminfoView, tkmv_systeminfo_view, TKMV,
                       SYSTEMINFO_VIEW, GtkBox)
 
-void tkmv_systeminfo_reload_entries (TkmvSysteminfoView *view,
-                                     TkmContext *context);
+/* Reload table slice only, TRUE while tables remain */
+gboolean tkmv_systeminfo_reload_slice (TkmvSysteminfoView *view,
+                                       TkmContext *context, guint slice);
 
 G_END_DECLS
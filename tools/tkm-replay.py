@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+#
+# SPDX license identifier: GPL-3.0-or-later
+#
+# Copyright (C) 2019-2022 Alin Popa
+#
+# Replay a taskmonitor capture database as a record stream, the input of
+# tkmviewer --stream. Each line holds the name of the table a record
+# belongs to followed by tab separated Column=Value fields:
+#
+#   tkmSysProcStat<TAB>SystemTime=1650000000<TAB>CPUStatName=cpu0<TAB>...
+#
+# The session record goes first, then the rows of every table in the order
+# of their system time, paced as they were captured unless --speed is 0.
+#
+#   tkm-replay.py capture.db | tkmviewer --stream -
+#   tkm-replay.py --socket /tmp/tkm.sock capture.db &
+#   tkmviewer --stream unix:/tmp/tkm.sock
+#
+
+import argparse
+import heapq
+import os
+import socket
+import sqlite3
+import sys
+import time
+
+SESSIONS_TABLE = "tkmSessions"
+DEVICES_TABLE = "tkmDevices"
+
+# Tables the viewer decodes from a stream, see libtkm/tkm-types.h
+TABLES = [
+    "tkmProcInfo",
+    "tkmContextInfo",
+    "tkmProcAcct",
+    "tkmSysProcStat",
+    "tkmSysProcMemInfo",
+    "tkmProcEvent",
+    "tkmSysProcPressure",
+    "tkmSysProcBuddyInfo",
+    "tkmSysProcWireless",
+    "tkmSysProcDiskStats",
+]
+
+
+def record(table, names, row):
+    fields = [table]
+
+    for name, value in zip(names, row):
+        # Missing values are left out, the viewer drops rows holding NULLs
+        if value is None:
+            continue
+        value = str(value).replace("\t", " ").replace("\n", " ")
+        fields.append("%s=%s" % (name, value))
+
+    return "\t".join(fields) + "\n"
+
+
+def session_lookup(db, session_hash):
+    sql = "SELECT Id, Name, Hash, CoreCount, Device FROM %s" % SESSIONS_TABLE
+    if session_hash is not None:
+        rows = db.execute(sql + " WHERE Hash IS ?", (session_hash,)).fetchall()
+    else:
+        rows = db.execute(sql + " ORDER BY Id DESC LIMIT 1").fetchall()
+
+    return rows[0] if rows else None
+
+
+def device_name(db, device):
+    try:
+        row = db.execute(
+            "SELECT Name FROM %s WHERE Id IS ?" % DEVICES_TABLE, (device,)
+        ).fetchone()
+    except sqlite3.Error:
+        return None
+
+    return row[0] if row else None
+
+
+def table_rows(db, table, session_id):
+    try:
+        cursor = db.execute(
+            "SELECT * FROM '%s' WHERE SessionId IS ? "
+            "ORDER BY SystemTime, rowid" % table,
+            (session_id,),
+        )
+    except sqlite3.Error as error:
+        print("Skip table %s: %s" % (table, error), file=sys.stderr)
+        return
+
+    names = [column[0] for column in cursor.description]
+    time_index = names.index("SystemTime")
+
+    for row in cursor:
+        yield (row[time_index], table, names, row)
+
+
+def replay(db, output, session_hash, speed):
+    session = session_lookup(db, session_hash)
+    if session is None:
+        print("No session to replay", file=sys.stderr)
+        return 1
+
+    session_id, name, hash_, core_count, device = session
+    fields = [
+        SESSIONS_TABLE,
+        "Name=%s" % name,
+        "Hash=%s" % hash_,
+        "CoreCount=%s" % core_count,
+    ]
+    device = device_name(db, device)
+    if device is not None:
+        fields.append("DeviceName=%s" % device)
+    output.write("\t".join(fields) + "\n")
+    output.flush()
+
+    rows = heapq.merge(
+        *[table_rows(db, table, session_id) for table in TABLES],
+        key=lambda row: row[0],
+    )
+
+    first_time = None
+    start = time.monotonic()
+    for system_time, table, names, row in rows:
+        if speed > 0:
+            if first_time is None:
+                first_time = system_time
+            delay = (system_time - first_time) / speed
+            delay -= time.monotonic() - start
+            if delay > 0:
+                output.flush()
+                time.sleep(delay)
+
+        output.write(record(table, names, row))
+
+    output.flush()
+
+    return 0
+
+
+def socket_output(path):
+    if os.path.exists(path):
+        os.unlink(path)
+
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(path)
+    server.listen(1)
+
+    print("Waiting for a reader on %s" % path, file=sys.stderr)
+    connection, _ = server.accept()
+    server.close()
+    os.unlink(path)
+
+    return connection.makefile("w", encoding="utf-8")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Replay a taskmonitor capture as a tkmviewer record stream"
+    )
+    parser.add_argument("database", help="capture database to replay")
+    parser.add_argument(
+        "--session", help="hash of the session, the last one by default"
+    )
+    parser.add_argument(
+        "--socket", help="serve the stream on this Unix socket, not stdout"
+    )
+    parser.add_argument(
+        "--speed",
+        type=float,
+        default=1.0,
+        help="replay speed over the capture time, 0 writes without pauses",
+    )
+    args = parser.parse_args()
+
+    db = sqlite3.connect("file:%s?mode=ro" % args.database, uri=True)
+    output = socket_output(args.socket) if args.socket else sys.stdout
+
+    try:
+        return replay(db, output, args.session, args.speed)
+    except BrokenPipeError:
+        # The viewer went away, nothing left to replay to
+        return 0
+    finally:
+        db.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())